@@ -29,6 +29,8 @@ void WriteLog(char *, char *, char *);
 // Global macro definitions
 #define WIN_WIDTH 800
 #define WIN_HEIGHT 600
+#define SPHERE_STACKS 20		// Latitudes
+#define SPHERE_SLICES 20		// Longitudes
 
 // Global variable declaration
 HWND ghwnd = NULL;
@@ -36,7 +38,7 @@ DWORD dwStyle;
 WINDOWPLACEMENT wpPrev = { sizeof(WINDOWPLACEMENT) };
 char FileName_log[] = "Log.txt";
 float gClearColor[4];		// RGBA
-int sphere_PtCnt;
+int gNumSphereIndices;
 
 bool gbActiveWindow = false;
 bool gbEscapeKeyPressed = false;
@@ -49,7 +51,7 @@ ID3D11RenderTargetView *gpID3D11RenderTargetView = NULL;
 
 ID3D11VertexShader *gpID3D11VertexShader = NULL;
 ID3D11PixelShader *gpID3D11PixelShader = NULL;
-ID3D11Buffer* gpID3D11Buffer_VBO_Sphere[2];			// Vertex Buffer Object for Sphere
+ID3D11Buffer* gpID3D11Buffer_VBO_Sphere[2];			// Vertex Buffer Object for Sphere ([0]-Position, [1]-Indices)
 ID3D11InputLayout *gpID3D11InputLayout = NULL;
 ID3D11Buffer *gpID3D11Buffer_ConstantBuffer = NULL;
 
@@ -59,6 +61,7 @@ ID3D11DepthStencilView *gpID3D11DepthStencilView = NULL;
 struct CBUFFER {
 	XMMATRIX WorldViewMatrix;
 	XMMATRIX ProjectionMatrix;
+	XMVECTOR Color;			// Per draw constant color of sphere
 };
 XMMATRIX gPerspProjMatrix;
 
@@ -232,7 +235,7 @@ HRESULT Initialize(void) {
 	// Function declaration
 	void LogD3DInfo(D3D_DRIVER_TYPE, D3D_FEATURE_LEVEL);
 	void* CreateCompileAndSetShader(const char *, char *, char *, void *);
-	HRESULT CreateBufferAndCopyData(ID3D11Buffer **, D3D11_BUFFER_DESC, const float *, size_t);
+	HRESULT CreateBufferAndCopyData(ID3D11Buffer **, D3D11_BUFFER_DESC, const void *, size_t);
 	HRESULT Resize(int, int);
 	void Uninitialize(void);
 
@@ -293,15 +296,16 @@ HRESULT Initialize(void) {
 		"cbuffer ConstantBuffer {" \
 			"float4x4 worldViewMatrix;" \
 			"float4x4 ProjectionMatrix;" \
+			"float4 color;" \
 		"}" \
 		"struct output_vertex {" \
 			"float4 position : SV_POSITION;" \
 			"float4 color : COLOR;" \
 		"};" \
-		"output_vertex main(float4 pos : POSITION, float4 col : COLOR) {" \
+		"output_vertex main(float4 pos : POSITION) {" \
 			"output_vertex output;" \
 			"output.position = mul(ProjectionMatrix, mul(worldViewMatrix, pos));" \
-			"output.color = col;" \
+			"output.color = color;" \
 			"return output;" \
 		"}";
 	void *result = CreateCompileAndSetShader(VSSrcCode, "VS", "vs_5_0", (void *)gpID3D11VertexShader);
@@ -328,7 +332,7 @@ HRESULT Initialize(void) {
 	result = NULL;
 
 	// Initialize, create and set - Input Layout
-	D3D11_INPUT_ELEMENT_DESC inputElementDesc[2];
+	D3D11_INPUT_ELEMENT_DESC inputElementDesc[1];
 	inputElementDesc[0].SemanticName = "POSITION";
 	inputElementDesc[0].SemanticIndex = 0;
 	inputElementDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
@@ -337,14 +341,6 @@ HRESULT Initialize(void) {
 	inputElementDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 	inputElementDesc[0].InstanceDataStepRate = 0;
 
-	inputElementDesc[1].SemanticName = "COLOR";
-	inputElementDesc[1].SemanticIndex = 0;
-	inputElementDesc[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	inputElementDesc[1].AlignedByteOffset = 0;
-	inputElementDesc[1].InputSlot = 1;
-	inputElementDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	inputElementDesc[1].InstanceDataStepRate = 0;
-
 	hr = gpID3D11Device->CreateInputLayout(inputElementDesc, _ARRAYSIZE(inputElementDesc), pID3DBlob_VertexShaderCode->GetBufferPointer(), pID3DBlob_VertexShaderCode->GetBufferSize(), &gpID3D11InputLayout);
 	pID3DBlob_VertexShaderCode->Release();
 	pID3DBlob_VertexShaderCode = NULL;
@@ -356,14 +352,13 @@ HRESULT Initialize(void) {
 		WriteLog(FileName_log, "a+", "ID3D11Device::CreateInputLayout() succeeded..\n");
 	gpID3D11DeviceContext->IASetInputLayout(gpID3D11InputLayout);
 
-	// Initialize arrays of vertices, color, etc...
-	sphere_PtCnt = GenSphere(1.0f, 20, 20);
-	float *SphereVertices = getSphereVertices();
-	float *SphereColors = setSphereColor(sphere_PtCnt, 1.0f, 1.0f, 1.0f);
-	float *SphereNormals = getSphereNormals();
-	UINT sizeofVertices = sizeof(float) * sphere_PtCnt * 3;
-	UINT sizeofColors = sizeof(float) * sphere_PtCnt * 3;
-	UINT sizeofNormals = sizeof(float) * sphere_PtCnt * 3;
+	// Initialize arrays of vertices and indices (shared vertices, color is a per draw constant)
+	// On stack, so no early return below can leak them; sized from same constants as GenSphere() call
+	float SphereVertices[SPHERE_VERTEX_COUNT(SPHERE_STACKS, SPHERE_SLICES) * 3];
+	unsigned short SphereIndices[SPHERE_INDEX_COUNT(SPHERE_STACKS, SPHERE_SLICES)];
+	UINT sizeofVertices = sizeof(SphereVertices);
+	UINT sizeofIndices = sizeof(SphereIndices);
+	gNumSphereIndices = GenSphere(1.0f, SPHERE_STACKS, SPHERE_SLICES, SphereVertices, NULL, NULL, SphereIndices);
 
 	// For Sphere
 	// Create Vertex Buffer
@@ -378,13 +373,13 @@ HRESULT Initialize(void) {
 	if(FAILED(hr))
 		return hr;
 
-	// Color
+	// Indices
 	ZeroMemory((void *)&bufferDesc, sizeof(D3D11_BUFFER_DESC));
 	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	bufferDesc.ByteWidth = sizeofNormals;
-	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bufferDesc.ByteWidth = sizeofIndices;
+	bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	hr = CreateBufferAndCopyData(&gpID3D11Buffer_VBO_Sphere[1], bufferDesc, SphereNormals, sizeofNormals);
+	hr = CreateBufferAndCopyData(&gpID3D11Buffer_VBO_Sphere[1], bufferDesc, SphereIndices, sizeofIndices);
 	if(FAILED(hr))
 		return hr;
 
@@ -495,7 +490,7 @@ void* CreateCompileAndSetShader(const char *shaderCode, char *shaderName, char*
 	return (void *)pID3DBlob_ShaderCode;
 }
 
-HRESULT CreateBufferAndCopyData(ID3D11Buffer **buffer, D3D11_BUFFER_DESC description, const float *data, size_t size) {
+HRESULT CreateBufferAndCopyData(ID3D11Buffer **buffer, D3D11_BUFFER_DESC description, const void *data, size_t size) {
 	// Variable declaration
 	HRESULT hr = S_OK;
 	
@@ -511,7 +506,11 @@ HRESULT CreateBufferAndCopyData(ID3D11Buffer **buffer, D3D11_BUFFER_DESC descrip
 	// Copy data from array into above buffer
 	D3D11_MAPPED_SUBRESOURCE mappedSubresource;
 	ZeroMemory((void *)&mappedSubresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
-	gpID3D11DeviceContext->Map(*buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+	hr = gpID3D11DeviceContext->Map(*buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+	if(FAILED(hr)) {
+		WriteLog(FileName_log, "a+", "ID3D11DeviceContext::Map() failed !!!\n");
+		return hr;
+	}
 	memcpy(mappedSubresource.pData, data, size);
 	gpID3D11DeviceContext->Unmap(*buffer, 0);
 
@@ -618,11 +617,7 @@ void Display(void) {
 	stride = sizeof(float) * 3;
 	offset = 0;
 	gpID3D11DeviceContext->IASetVertexBuffers(0, 1, &gpID3D11Buffer_VBO_Sphere[0], &stride, &offset);
-	stride = sizeof(float) * 3;
-	offset = 0;
-	gpID3D11DeviceContext->IASetVertexBuffers(1, 1, &gpID3D11Buffer_VBO_Sphere[1], &stride, &offset);
-// for indexed arrays
-// gpID3D11DeviceContext->IASetIndexBuffer(gpID3D1Buffer_VBO_Sphere_IndexedBuffer, DXGI_FORMAT_R16_UINT, 0);
+	gpID3D11DeviceContext->IASetIndexBuffer(gpID3D11Buffer_VBO_Sphere[1], DXGI_FORMAT_R16_UINT, 0);
 
 	// Set geometry primitive
 	gpID3D11DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -640,10 +635,11 @@ void Display(void) {
 	CBUFFER constantBuffer_Sphere;
 	constantBuffer_Sphere.WorldViewMatrix = wvMatrix;
 	constantBuffer_Sphere.ProjectionMatrix = projectionMatrix;
+	constantBuffer_Sphere.Color = XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
 	gpID3D11DeviceContext->UpdateSubresource(gpID3D11Buffer_ConstantBuffer, 0, NULL, &constantBuffer_Sphere, 0, 0);
 
 	// Draw vertex buffer to render target
-	gpID3D11DeviceContext->Draw(sphere_PtCnt, 0);
+	gpID3D11DeviceContext->DrawIndexed(gNumSphereIndices, 0, 0);
 
 	// Switch between buffers
 	gpIDXGISwapChain->Present(0, 0);
@@ -651,7 +647,6 @@ void Display(void) {
 
 void Uninitialize(void) {
 	// Code
-	deleteSphere();
 	if(gpID3D11RasterizerState) {
 		gpID3D11RasterizerState->Release();
 		gpID3D11RasterizerState = NULL;
@@ -29,6 +29,8 @@ void WriteLog(char *, char *, char *);
 // Global macro definitions
 #define WIN_WIDTH 800
 #define WIN_HEIGHT 600
+#define SPHERE_STACKS 20		// Latitudes
+#define SPHERE_SLICES 20		// Longitudes
 
 // Global variable declaration
 HWND ghwnd = NULL;
@@ -36,7 +38,7 @@ DWORD dwStyle;
 WINDOWPLACEMENT wpPrev = { sizeof(WINDOWPLACEMENT) };
 char FileName_log[] = "Log.txt";
 float gClearColor[4];		// RGBA
-int sphere_PtCnt;
+int gNumSphereIndices;
 
 bool gbActiveWindow = false;
 bool gbEscapeKeyPressed = false;
@@ -51,7 +53,7 @@ ID3D11RenderTargetView *gpID3D11RenderTargetView = NULL;
 
 ID3D11VertexShader *gpID3D11VertexShader = NULL;
 ID3D11PixelShader *gpID3D11PixelShader = NULL;
-ID3D11Buffer* gpID3D11Buffer_VBO_Sphere[2];			// Vertex Buffer Object for Sphere
+ID3D11Buffer* gpID3D11Buffer_VBO_Sphere[3];			// Vertex Buffer Object for Sphere ([0]-Position, [1]-Normals, [2]-Indices)
 ID3D11InputLayout *gpID3D11InputLayout = NULL;
 ID3D11Buffer *gpID3D11Buffer_ConstantBuffer = NULL;
 
@@ -247,7 +249,7 @@ HRESULT Initialize(void) {
 	// Function declaration
 	void LogD3DInfo(D3D_DRIVER_TYPE, D3D_FEATURE_LEVEL);
 	void* CreateCompileAndSetShader(const char *, char *, char *, void *);
-	HRESULT CreateBufferAndCopyData(ID3D11Buffer **, D3D11_BUFFER_DESC, const float *, size_t);
+	HRESULT CreateBufferAndCopyData(ID3D11Buffer **, D3D11_BUFFER_DESC, const void *, size_t);
 	HRESULT Resize(int, int);
 	void Uninitialize(void);
 
@@ -380,14 +382,15 @@ HRESULT Initialize(void) {
 		WriteLog(FileName_log, "a+", "ID3D11Device::CreateInputLayout() succeeded..\n");
 	gpID3D11DeviceContext->IASetInputLayout(gpID3D11InputLayout);
 
-	// Initialize arrays of vertices, color, etc...
-	sphere_PtCnt = GenSphere(1.0f, 20, 20);
-	float *SphereVertices = getSphereVertices();
-	float *SphereColors = setSphereColor(sphere_PtCnt, 1.0f, 1.0f, 1.0f);
-	float *SphereNormals = getSphereNormals();
-	UINT sizeofVertices = sizeof(float) * sphere_PtCnt * 3;
-	UINT sizeofColors = sizeof(float) * sphere_PtCnt * 3;
-	UINT sizeofNormals = sizeof(float) * sphere_PtCnt * 3;
+	// Initialize arrays of vertices, normals and indices (shared vertices, color is a per draw constant)
+	// On stack, so no early return below can leak them; sized from same constants as GenSphere() call
+	float SphereVertices[SPHERE_VERTEX_COUNT(SPHERE_STACKS, SPHERE_SLICES) * 3];
+	float SphereNormals[SPHERE_VERTEX_COUNT(SPHERE_STACKS, SPHERE_SLICES) * 3];
+	unsigned short SphereIndices[SPHERE_INDEX_COUNT(SPHERE_STACKS, SPHERE_SLICES)];
+	UINT sizeofVertices = sizeof(SphereVertices);
+	UINT sizeofNormals = sizeof(SphereNormals);
+	UINT sizeofIndices = sizeof(SphereIndices);
+	gNumSphereIndices = GenSphere(1.0f, SPHERE_STACKS, SPHERE_SLICES, SphereVertices, SphereNormals, NULL, SphereIndices);
 
 	// For Sphere
 	// Create Vertex Buffer
@@ -402,7 +405,7 @@ HRESULT Initialize(void) {
 	if(FAILED(hr))
 		return hr;
 
-	// Color
+	// Normals
 	ZeroMemory((void *)&bufferDesc, sizeof(D3D11_BUFFER_DESC));
 	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
 	bufferDesc.ByteWidth = sizeofNormals;
@@ -412,6 +415,16 @@ HRESULT Initialize(void) {
 	if(FAILED(hr))
 		return hr;
 
+	// Indices
+	ZeroMemory((void *)&bufferDesc, sizeof(D3D11_BUFFER_DESC));
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth = sizeofIndices;
+	bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	hr = CreateBufferAndCopyData(&gpID3D11Buffer_VBO_Sphere[2], bufferDesc, SphereIndices, sizeofIndices);
+	if(FAILED(hr))
+		return hr;
+
 	// Create and set constant buffer
 	ZeroMemory((void *)&bufferDesc, sizeof(D3D11_BUFFER_DESC));
 	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
@@ -519,7 +532,7 @@ void* CreateCompileAndSetShader(const char *shaderCode, char *shaderName, char*
 	return (void *)pID3DBlob_ShaderCode;
 }
 
-HRESULT CreateBufferAndCopyData(ID3D11Buffer **buffer, D3D11_BUFFER_DESC description, const float *data, size_t size) {
+HRESULT CreateBufferAndCopyData(ID3D11Buffer **buffer, D3D11_BUFFER_DESC description, const void *data, size_t size) {
 	// Variable declaration
 	HRESULT hr = S_OK;
 	
@@ -535,7 +548,11 @@ HRESULT CreateBufferAndCopyData(ID3D11Buffer **buffer, D3D11_BUFFER_DESC descrip
 	// Copy data from array into above buffer
 	D3D11_MAPPED_SUBRESOURCE mappedSubresource;
 	ZeroMemory((void *)&mappedSubresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
-	gpID3D11DeviceContext->Map(*buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+	hr = gpID3D11DeviceContext->Map(*buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+	if(FAILED(hr)) {
+		WriteLog(FileName_log, "a+", "ID3D11DeviceContext::Map() failed !!!\n");
+		return hr;
+	}
 	memcpy(mappedSubresource.pData, data, size);
 	gpID3D11DeviceContext->Unmap(*buffer, 0);
 
@@ -645,8 +662,7 @@ void Display(void) {
 	stride = sizeof(float) * 3;
 	offset = 0;
 	gpID3D11DeviceContext->IASetVertexBuffers(1, 1, &gpID3D11Buffer_VBO_Sphere[1], &stride, &offset);
-// for indexed arrays
-// gpID3D11DeviceContext->IASetIndexBuffer(gpID3D1Buffer_VBO_Sphere_IndexedBuffer, DXGI_FORMAT_R16_UINT, 0);
+	gpID3D11DeviceContext->IASetIndexBuffer(gpID3D11Buffer_VBO_Sphere[2], DXGI_FORMAT_R16_UINT, 0);
 
 	// Set geometry primitive
 	gpID3D11DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -675,7 +691,7 @@ void Display(void) {
 	gpID3D11DeviceContext->UpdateSubresource(gpID3D11Buffer_ConstantBuffer, 0, NULL, &constantBuffer_Sphere, 0, 0);
 
 	// Draw vertex buffer to render target
-	gpID3D11DeviceContext->Draw(sphere_PtCnt, 0);
+	gpID3D11DeviceContext->DrawIndexed(gNumSphereIndices, 0, 0);
 
 	// Update variables for animation
 	angle += 0.0001f;
@@ -688,7 +704,6 @@ void Display(void) {
 
 void Uninitialize(void) {
 	// Code
-	deleteSphere();
 	if(gpID3D11RasterizerState) {
 		gpID3D11RasterizerState->Release();
 		gpID3D11RasterizerState = NULL;
@@ -706,6 +721,8 @@ void Uninitialize(void) {
 		gpID3D11Buffer_VBO_Sphere[0] = NULL;
 		gpID3D11Buffer_VBO_Sphere[1]->Release();
 		gpID3D11Buffer_VBO_Sphere[1] = NULL;
+		gpID3D11Buffer_VBO_Sphere[2]->Release();
+		gpID3D11Buffer_VBO_Sphere[2] = NULL;
 	}
 	if(gpID3D11PixelShader) {
 		gpID3D11PixelShader->Release();
@@ -1,166 +1,117 @@
 // Sphere for DirectX
+// Indexed (shared vertices) sphere written into caller provided arrays.
+// No globals and no allocation, hence safe to call from any thread.
+// Color is not part of the mesh; pass it as a per-draw constant instead.
+
+#pragma once
 
 // Header files
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <stdlib.h>
 
-float *sphereVertices, *sphereColor, *sphereNormals, *sphereTexture;
+// Limits of trig tables (filled once per call, on stack)
+#define SPHERE_MAX_LATS		256
+#define SPHERE_MAX_LONGS	256
 
-int GenSphere(float radius, int lats, int longs) {
-	// Constant declaration
-	const float rad = M_PI / 180.0f;
-	const float latitudes = 180.0f / (float)lats;
-	const float longitudes = 360.0f / (float)longs;
-	const float uDiff = 1.0 / (float)lats;
-	const float vDiff = 1.0 / (float)(longs - 1);
-	const int points = lats * longs * 6;
-	int ptCntr = 0;
-	
-	// Code
-	// Allocating memory for arrays
-	sphereVertices = (float *)malloc(points * 3 * sizeof(float));
-	sphereNormals = (float *)malloc(points * 3 * sizeof(float));
-	sphereTexture = (float *)malloc(points * 2 * sizeof(float));
-	// Setting of values
-	for(float i = 0.0f, u = 0.0f; i < 360.0f; i += longitudes, u += uDiff) {
-		float iNext = i + longitudes;
-		float uNext = u + uDiff;
-		for(float j = 0.0f, v = 0.0f; j < 180.0f; j += latitudes, v += vDiff) {
-			float jNext = j + latitudes;
-			float vNext = v + vDiff;
-			float x[4], y[4], z[4];
-			float Tex_U[4], Tex_V[4];
-			
-			// Calculating points
-			x[0] = cos(i*rad) * sin(j*rad);
-			y[0] = cos(j*rad);
-			z[0] = sin(i*rad) * sin(j*rad);
-			Tex_U[0] = u;
-			Tex_V[0] = v;
-			
-			x[1] = cos(i*rad) * sin(jNext*rad);
-			y[1] = cos(jNext*rad);
-			z[1] = sin(i*rad) * sin(jNext*rad);
-			Tex_U[1] = u;
-			Tex_V[1] = vNext;
-			
-			x[2] = cos(iNext*rad) * sin(jNext*rad);
-			y[2] = cos(jNext*rad);
-			z[2] = sin(iNext*rad) * sin(jNext*rad);
-			Tex_U[2] = uNext;
-			Tex_V[2] = vNext;
-			
-			x[3] = cos(iNext*rad) * sin(j*rad);
-			y[3] = cos(j*rad);
-			z[3] = sin(iNext*rad) * sin(j*rad);
-			Tex_U[3] = uNext;
-			Tex_V[3] = v;
-			
-			// Triangle 1 (0, 1, 2)
-			sphereVertices[(ptCntr*3)+0] = radius * x[0];
-			sphereVertices[(ptCntr*3)+1] = radius * y[0];
-			sphereVertices[(ptCntr*3)+2] = radius * z[0];
-			sphereNormals[(ptCntr*3)+0] = x[0];
-			sphereNormals[(ptCntr*3)+1] = y[0];
-			sphereNormals[(ptCntr*3)+2] = z[0];
-			sphereTexture[(ptCntr*2)+0] = Tex_U[0];
-			sphereTexture[(ptCntr*2)+1] = Tex_V[0];
-			ptCntr++;
-			
-			sphereVertices[(ptCntr*3)+0] = radius * x[1];
-			sphereVertices[(ptCntr*3)+1] = radius * y[1];
-			sphereVertices[(ptCntr*3)+2] = radius * z[1];
-			sphereNormals[(ptCntr*3)+0] = x[1];
-			sphereNormals[(ptCntr*3)+1] = y[1];
-			sphereNormals[(ptCntr*3)+2] = z[1];
-			sphereTexture[(ptCntr*2)+0] = Tex_U[1];
-			sphereTexture[(ptCntr*2)+1] = Tex_V[1];
-			ptCntr++;
-			
-			sphereVertices[(ptCntr*3)+0] = radius * x[2];
-			sphereVertices[(ptCntr*3)+1] = radius * y[2];
-			sphereVertices[(ptCntr*3)+2] = radius * z[2];
-			sphereNormals[(ptCntr*3)+0] = x[2];
-			sphereNormals[(ptCntr*3)+1] = y[2];
-			sphereNormals[(ptCntr*3)+2] = z[2];
-			sphereTexture[(ptCntr*2)+0] = Tex_U[2];
-			sphereTexture[(ptCntr*2)+1] = Tex_V[2];
-			ptCntr++;
-			
-			// Triangle 2 (2, 3, 0)
-			sphereVertices[(ptCntr*3)+0] = radius * x[2];
-			sphereVertices[(ptCntr*3)+1] = radius * y[2];
-			sphereVertices[(ptCntr*3)+2] = radius * z[2];
-			sphereNormals[(ptCntr*3)+0] = x[2];
-			sphereNormals[(ptCntr*3)+1] = y[2];
-			sphereNormals[(ptCntr*3)+2] = z[2];
-			sphereTexture[(ptCntr*2)+0] = Tex_U[2];
-			sphereTexture[(ptCntr*2)+1] = Tex_V[2];
-			ptCntr++;
-			
-			sphereVertices[(ptCntr*3)+0] = radius * x[3];
-			sphereVertices[(ptCntr*3)+1] = radius * y[3];
-			sphereVertices[(ptCntr*3)+2] = radius * z[3];
-			sphereNormals[(ptCntr*3)+0] = x[3];
-			sphereNormals[(ptCntr*3)+1] = y[3];
-			sphereNormals[(ptCntr*3)+2] = z[3];
-			sphereTexture[(ptCntr*2)+0] = Tex_U[3];
-			sphereTexture[(ptCntr*2)+1] = Tex_V[3];
-			ptCntr++;
-			
-			sphereVertices[(ptCntr*3)+0] = radius * x[0];
-			sphereVertices[(ptCntr*3)+1] = radius * y[0];
-			sphereVertices[(ptCntr*3)+2] = radius * z[0];
-			sphereNormals[(ptCntr*3)+0] = x[0];
-			sphereNormals[(ptCntr*3)+1] = y[0];
-			sphereNormals[(ptCntr*3)+2] = z[0];
-			sphereTexture[(ptCntr*2)+0] = Tex_U[0];
-			sphereTexture[(ptCntr*2)+1] = Tex_V[0];
-			ptCntr++;
-		}
-	}
-	return ptCntr;
-}
+// Compile time counts, for arrays sized from constant lats / longs (no range check, see functions below)
+#define SPHERE_VERTEX_COUNT(lats, longs)	(((lats) + 1) * ((longs) + 1))
+#define SPHERE_INDEX_COUNT(lats, longs)		(((lats) - 1) * (longs) * 6)
 
-float *setSphereColor(int size, float red, float green, float blue) {
+// Number of shared vertices; one extra column for texture seam and one extra row for south pole
+int GetSphereVertexCount(int lats, int longs) {
 	// Code
-	sphereColor = (float *)malloc(size * 3 * sizeof(float));
-	for(int i = 0; i < size; i++) {
-		sphereColor[(i*3)+0] = red;
-		sphereColor[(i*3)+1] = green;
-		sphereColor[(i*3)+2] = blue;
-	}
-	return sphereColor;
+	if(lats < 2 || longs < 3 || lats > SPHERE_MAX_LATS || longs > SPHERE_MAX_LONGS)
+		return 0;
+	return SPHERE_VERTEX_COUNT(lats, longs);
 }
 
-float *getSphereVertices() {
-	return sphereVertices;
+// Number of indices; degenerate triangles at both poles are skipped
+int GetSphereIndexCount(int lats, int longs) {
+	// Code
+	if(GetSphereVertexCount(lats, longs) == 0)
+		return 0;
+	return SPHERE_INDEX_COUNT(lats, longs);
 }
 
-float *getSphereNormals() {
-	return sphereNormals;
-}
+// Fills arrays of sphere. Sizes (in elements) expected from caller :
+//	vertices, normals	- GetSphereVertexCount() * 3
+//	texcoords		- GetSphereVertexCount() * 2
+//	indices			- GetSphereIndexCount()
+// normals and texcoords can be NULL if not needed.
+// Returns number of indices written (0 on invalid arguments).
+int GenSphere(float radius, int lats, int longs, float *vertices, float *normals, float *texcoords, unsigned short *indices) {
+	// Variable declaration
+	float latSin[SPHERE_MAX_LATS + 1], latCos[SPHERE_MAX_LATS + 1];
+	float longSin[SPHERE_MAX_LONGS + 1], longCos[SPHERE_MAX_LONGS + 1];
+	const int columns = longs + 1;
+	int numVertices = GetSphereVertexCount(lats, longs);
+	int ptCntr = 0;
+	int idxCntr = 0;
 
-float *getSphereTexCoords() {
-	return sphereTexture;
-}
+	// Code
+	if(numVertices == 0 || numVertices > 65536 || vertices == NULL || indices == NULL)
+		return 0;
 
-void deleteSphere() {
-	if(sphereVertices) {
-		free(sphereVertices);
-		sphereVertices = NULL;
+	// Trig tables : once per ring and once per column
+	for(int j = 0; j <= lats; j++) {
+		float angle = (float)M_PI * (float)j / (float)lats;
+		latSin[j] = sinf(angle);
+		latCos[j] = cosf(angle);
 	}
-	if(sphereColor) {
-		free(sphereColor);
-		sphereColor = NULL;
+	latSin[0] = latSin[lats] = 0.0f;	// Exact poles
+	latCos[0] = 1.0f;
+	latCos[lats] = -1.0f;
+	for(int i = 0; i <= longs; i++) {
+		float angle = 2.0f * (float)M_PI * (float)(i % longs) / (float)longs;
+		longSin[i] = sinf(angle);
+		longCos[i] = cosf(angle);
 	}
-	if(sphereNormals) {
-		free(sphereNormals);
-		sphereNormals = NULL;
+
+	// Setting of vertices (row = latitude, column = longitude)
+	for(int j = 0; j <= lats; j++) {
+		for(int i = 0; i < columns; i++) {
+			float x = longCos[i] * latSin[j];
+			float y = latCos[j];
+			float z = longSin[i] * latSin[j];
+
+			vertices[(ptCntr*3)+0] = radius * x;
+			vertices[(ptCntr*3)+1] = radius * y;
+			vertices[(ptCntr*3)+2] = radius * z;
+			if(normals) {
+				normals[(ptCntr*3)+0] = x;
+				normals[(ptCntr*3)+1] = y;
+				normals[(ptCntr*3)+2] = z;
+			}
+			if(texcoords) {
+				texcoords[(ptCntr*2)+0] = (float)i / (float)longs;
+				texcoords[(ptCntr*2)+1] = (float)j / (float)lats;
+			}
+			ptCntr++;
+		}
 	}
-	if(sphereTexture) {
-		free(sphereTexture);
-		sphereTexture = NULL;
+
+	// Setting of indices (same winding as earlier unindexed sphere)
+	for(int i = 0; i < longs; i++) {
+		for(int j = 0; j < lats; j++) {
+			unsigned short p0 = (unsigned short)((j * columns) + i);		// (i, j)
+			unsigned short p1 = (unsigned short)(p0 + columns);		// (i, jNext)
+			unsigned short p2 = (unsigned short)(p1 + 1);			// (iNext, jNext)
+			unsigned short p3 = (unsigned short)(p0 + 1);			// (iNext, j)
+
+			// Triangle 1 (0, 1, 2) - degenerate at south pole
+			if(j != lats - 1) {
+				indices[idxCntr++] = p0;
+				indices[idxCntr++] = p1;
+				indices[idxCntr++] = p2;
+			}
+			// Triangle 2 (2, 3, 0) - degenerate at north pole
+			if(j != 0) {
+				indices[idxCntr++] = p2;
+				indices[idxCntr++] = p3;
+				indices[idxCntr++] = p0;
+			}
+		}
 	}
+	return idxCntr;
 }
@@ -107,10 +107,17 @@ int main() {
 	// Build OpenCL program
 	ret_ocl = clBuildProgram(oclProgram, 0, NULL, NULL, NULL, NULL);
 	if(ret_ocl != CL_SUCCESS) {
-		size_t len;
-		char buffer[1024];
-		clGetProgramBuildInfo(oclProgram, oclDeviceId, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, &len);
-		ocl_exit_error(strcat("clBuildProgram() failed : ", buffer), ret_ocl);
+		size_t len = 0;
+		char *buffer = NULL;
+		clGetProgramBuildInfo(oclProgram, oclDeviceId, CL_PROGRAM_BUILD_LOG, 0, NULL, &len);	// Size of log first
+		buffer = (char *)malloc(len + 1);
+		if(buffer != NULL) {
+			clGetProgramBuildInfo(oclProgram, oclDeviceId, CL_PROGRAM_BUILD_LOG, len, buffer, NULL);
+			buffer[len] = '\0';
+			printf("%s\n", buffer);
+			free(buffer);
+		}
+		ocl_exit_error("clBuildProgram() failed, build log is on console", ret_ocl);
 	}
 	
 	oclKernel = clCreateKernel(oclProgram, "vecAdd", &ret_ocl);
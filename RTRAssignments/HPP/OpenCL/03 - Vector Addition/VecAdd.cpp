@@ -1,6 +1,19 @@
 // Adding floats in OpenCL
 // By : Darshan Vikam
 // Date : 27 July 2021
+//
+// Same addition runs in 3 modes, each checked against vecAddHost() and timed kernel only and end to end
+// (host arrays in, host array out) :
+//	whole		- whole arrays written, one kernel, whole array read on one queue
+//	streamed	- arrays split in CHUNK_ELEMENTS chunks, chunk c goes to stream c % NUM_STREAMS; every stream is an
+//			  in-order queue with its own chunk buffers, so writes of chunk c + 1, kernel of chunk c and read
+//			  of chunk c - 1 can run at once on different queues while each queue keeps its own buffers safe
+//	zero copy	- buffers made over host arrays with CL_MEM_USE_HOST_PTR, result is mapped instead of read;
+//			  only run on devices sharing memory with host (CL_DEVICE_HOST_UNIFIED_MEMORY)
+// Every mode runs WARMUP_RUNS + WHOLE_RUNS times; its times are medians from event profiling (see ocl_profiler.h).
+// Every write, kernel, read, map and end to end run goes to Profile.csv with min / median / p95 of
+// queued->submit, submit->start and start->end.
+// Usage : VecAdd [gpu | cpu | any]		(default - any; "cpu" runs on e.g. PoCL)
 //=============================================================================
 
 // Header Files
@@ -8,10 +21,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#ifdef _WIN32
+	#include <malloc.h>	// _aligned_malloc()
+#endif
 #include <CL/opencl.h>	// OpenCL specific header file
 #include "../Include/helper_timer.h"
 #include "../Include/ocl_kernel_loader.h"
 #include "../Include/ocl_exit_error.h"
+#include "../Include/ocl_device_selector.h"
+#include "../Include/ocl_profiler.h"
+//-----------------------------------------------------------------------------
+
+#define CHUNK_ELEMENTS	(4 * 1024 * 1024)	// 16 MB per array per chunk, multiple of local work size
+#define NUM_STREAMS	3			// Triple buffering : write, kernel and read of 3 chunks in flight
+#define HOST_ALIGNMENT	4096			// Page aligned host arrays, so CL_MEM_USE_HOST_PTR can avoid a copy
+#define WARMUP_RUNS	1			// Not recorded
+#define WHOLE_RUNS	5
 //-----------------------------------------------------------------------------
 
 // Global variable declaration (for OpenCL)
@@ -22,6 +47,7 @@ cl_context		oclContext;		// Compute Context
 cl_command_queue	oclCommandQueue;	// Compute Command Queue
 cl_program		oclProgram;		// Compute Program
 cl_kernel		oclKernel;		// Compute Kernel
+cl_command_queue	oclStreamQueue[NUM_STREAMS];	// In-order queues of streamed mode, with profiling
 
 char *oclSrcCode = NULL;
 size_t kernelCodeLength;
@@ -39,30 +65,50 @@ cl_mem deviceInput1 = NULL;
 cl_mem deviceInput2 = NULL;
 cl_mem deviceOutput = NULL;
 
+cl_mem streamInput1[NUM_STREAMS];	// Chunk buffers, one set per stream
+cl_mem streamInput2[NUM_STREAMS];
+cl_mem streamOutput[NUM_STREAMS];
+
+cl_mem zeroCopyInput1 = NULL;		// Buffers over host arrays (CL_MEM_USE_HOST_PTR)
+cl_mem zeroCopyInput2 = NULL;
+cl_mem zeroCopyOutput = NULL;
+
 float timeOnCPU, timeOnGPU;
+float timeOnGPUTotal;			// Whole mode, writes + kernel + read
+
+OCLProfiler oclProfiler;		// Event timings of every command
 //-----------------------------------------------------------------------------
 
 // Entry point function - main()
-int main() {
+int main(int argc, char *argv[]) {
 	// Function declaration
 	void fillFloatArrayWithRandomNumbers(float *, int);
 	size_t roundGlobalSizeToNearestMultipleOfLocalSize(int, unsigned int);
 	void vecAddHost(const float *, const float *, float *, int);
+	void *alignedHostAlloc(size_t);
+	void alignedHostFree(void *);
+	void setVecAddKernelArgs(cl_mem, cl_mem, cl_mem, int);
+	float runStreamed(float *);
+	float runZeroCopy(float *);
+	bool compareWithGold(int *);
 	void cleanup();
 /*	char* loadOCLProgram(const char *, const char *, size_t *);
 	void exit_error(char *);
 	void ocl_exit_error(char *, cl_int);
 */
+	// Variable declaration
+	const char *devicePreference = (argc > 1) ? argv[1] : "any";
+
 	// Code
-	hostInput1 = (float *)malloc(iNumberOfArrayElements * sizeof(float));
+	hostInput1 = (float *)alignedHostAlloc(iNumberOfArrayElements * sizeof(float));
 	if(hostInput1 == NULL)
 		exit_error("CPU memory fatal error: Cannot allocate memory for host input array 1.");
 	
-	hostInput2 = (float *)malloc(iNumberOfArrayElements * sizeof(float));
+	hostInput2 = (float *)alignedHostAlloc(iNumberOfArrayElements * sizeof(float));
 	if(hostInput2 == NULL)
 		exit_error("CPU memory fatal error: Cannot allocate memory for host input array 2.");
 	
-	hostOutput = (float *)malloc(iNumberOfArrayElements * sizeof(float));
+	hostOutput = (float *)alignedHostAlloc(iNumberOfArrayElements * sizeof(float));
 	if(hostOutput == NULL)
 		exit_error("CPU memory fatal error: Cannot allocate memory for host output array.");
 	
@@ -74,29 +120,29 @@ int main() {
 	fillFloatArrayWithRandomNumbers(hostInput1, iNumberOfArrayElements);
 	fillFloatArrayWithRandomNumbers(hostInput2, iNumberOfArrayElements);
 	
-	// Get OpenCL supporting platform's id
-	ret_ocl = clGetPlatformIDs(1, &oclPlatformId, NULL);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clGetPlatformIDs() failed", ret_ocl);
-	
-	// Get OpenCL supporting GPU device's id
-	ret_ocl = clGetDeviceIDs(oclPlatformId, CL_DEVICE_TYPE_GPU, 1, &oclDeviceId, NULL);
+	// Get OpenCL device (GPU, else CPU of any platform) and its platform
+	ret_ocl = selectOCLDevice(devicePreference, &oclPlatformId, &oclDeviceId);
 	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clGetDeviceIDs() failed", ret_ocl);
-	
-	char gpu_name[256];
-	clGetDeviceInfo(oclDeviceId, CL_DEVICE_NAME, sizeof(gpu_name), &gpu_name, NULL);
-	printf("%s \n", gpu_name);
+		ocl_exit_error("selectOCLDevice() failed", ret_ocl);
+	printOCLDevice(stdout, oclPlatformId, oclDeviceId);
 	
 	// Create OpenCL compute context
 	oclContext = clCreateContext(NULL, 1, &oclDeviceId, NULL, NULL, &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
 		ocl_exit_error("clCreateContext() failed", ret_ocl);
 	
-	// Create command queue
-	oclCommandQueue = clCreateCommandQueue(oclContext, oclDeviceId, 0, &ret_ocl);
+	// Create command queue, events of its commands carry device timestamps
+	oclCommandQueue = clCreateCommandQueue(oclContext, oclDeviceId, CL_QUEUE_PROFILING_ENABLE, &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
 		ocl_exit_error("clCreateCommandQueue() failed", ret_ocl);
+	oclProfilerInit(&oclProfiler, WARMUP_RUNS);
+	
+	// Create command queues of streamed mode, profiling gives kernel only time of every chunk
+	for(int s = 0; s < NUM_STREAMS; s++) {
+		oclStreamQueue[s] = clCreateCommandQueue(oclContext, oclDeviceId, CL_QUEUE_PROFILING_ENABLE, &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clCreateCommandQueue() for stream failed", ret_ocl);
+	}
 	
 	// Create OpenCl program from '.cl' file
 /*	const char *szOCLKernelPath = 
@@ -108,18 +154,21 @@ int main() {
 	oclProgram = clCreateProgramWithSource(oclContext, 1, &szOCLKernelPath, NULL, &ret_ocl);
 */
 	oclSrcCode = loadOCLProgram("VecAdd.cl", "", &kernelCodeLength);
-	oclProgram = clCreateProgramWithSource(oclContext, 1, (const char **)&oclSrcCode, NULL, &ret_ocl);
+	if(oclSrcCode == NULL)
+		exit_error("Unable to load 'VecAdd.cl'.");
+	
+	// Build OpenCL program (from binary cache when same source and driver were built before)
+	OCLBuildInfo buildInfo;
+	StopWatchInterface *buildTimer = NULL;
+	sdkCreateTimer(&buildTimer);
+	sdkStartTimer(&buildTimer);
+	oclProgram = buildOCLProgramCached(oclContext, oclDeviceId, oclSrcCode, NULL, &buildInfo, &ret_ocl);
+	sdkStopTimer(&buildTimer);
+	float timeToBuild = sdkGetTimerValue(&buildTimer);
+	sdkDeleteTimer(&buildTimer);
 	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clCreateProgramWithSource() failed", ret_ocl);
-	
-	// Build OpenCL program
-	ret_ocl = clBuildProgram(oclProgram, 0, NULL, NULL, NULL, NULL);
-	if(ret_ocl != CL_SUCCESS) {
-		size_t len;
-		char buffer[1024];
-		clGetProgramBuildInfo(oclProgram, oclDeviceId, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, &len);
-		ocl_exit_error(strcat("clBuildProgram() failed : ", buffer), ret_ocl);
-	}
+		ocl_exit_error("buildOCLProgramCached() failed, build log is on console", ret_ocl);
+	printf("Program build : cache %s%s, %.3f ms \n", buildInfo.hit ? "hit" : "miss", buildInfo.stored ? " (stored)" : "", timeToBuild);
 	
 	oclKernel = clCreateKernel(oclProgram, "vecAdd", &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
@@ -140,86 +189,110 @@ int main() {
 		ocl_exit_error("clCreateBuffer() for output array failed", ret_ocl);
 	
 	// Set OpenCL kernel arguments
-	ret_ocl = clSetKernelArg(oclKernel, 0, sizeof(cl_mem), (void *)&deviceInput1);		// 'deviceInput1' maps to 'in1' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 1st argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 1, sizeof(cl_mem), (void *)&deviceInput2);		// 'deviceInput2' maps to 'in2' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 2nd argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 2, sizeof(cl_mem), (void *)&deviceOutput);		// 'deviceOutput' maps to 'out' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 3rd argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 3, sizeof(cl_int), (void *)&iNumberOfArrayElements);		// 'iNumberOfArrayElements' maps to 'len' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
-	
-	// Copy 'input' device buffer to device memory
-	ret_ocl = clEnqueueWriteBuffer(oclCommandQueue, deviceInput1, CL_FALSE, 0, size, hostInput1, 0, NULL, NULL);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueWriteBuffer() for 1st argument failed", ret_ocl);
-	
-	ret_ocl = clEnqueueWriteBuffer(oclCommandQueue, deviceInput2, CL_FALSE, 0, size, hostInput2, 0, NULL, NULL);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueWriteBuffer() for 2nd argument failed", ret_ocl);
-	
-	// Run the OpenCL kernel
+	setVecAddKernelArgs(deviceInput1, deviceInput2, deviceOutput, iNumberOfArrayElements);
+	
+	// Whole mode; every command gets an event, so writes, kernel and read are timed on device separately
+	cl_event events[4];		// Write 1, write 2, kernel, read
+	int entryWrite1 = oclProfilerAdd(&oclProfiler, "whole write 1", OCL_PROFILE_WRITE, (double)size, 0.0);
+	int entryWrite2 = oclProfilerAdd(&oclProfiler, "whole write 2", OCL_PROFILE_WRITE, (double)size, 0.0);
+	int entryKernel = oclProfilerAdd(&oclProfiler, "whole kernel", OCL_PROFILE_KERNEL, 3.0 * size, (double)iNumberOfArrayElements);
+	int entryRead = oclProfilerAdd(&oclProfiler, "whole read", OCL_PROFILE_READ, (double)size, 0.0);
+	int entryTotal = oclProfilerAdd(&oclProfiler, "whole end to end", OCL_PROFILE_SPAN, 3.0 * size, (double)iNumberOfArrayElements);
 	globalWorkSize = roundGlobalSizeToNearestMultipleOfLocalSize(localWorkSize, iNumberOfArrayElements);
-	StopWatchInterface *timer = NULL;	// For time counter
-	sdkCreateTimer(&timer);
-	sdkStartTimer(&timer);			// Start timer
-	ret_ocl = clEnqueueNDRangeKernel(oclCommandQueue, oclKernel, 1, NULL, &globalWorkSize, &localWorkSize, 0, NULL, NULL);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueNDRangeKernel() failed", ret_ocl);
-	
-	// Finish OpenCL command queue
-	clFinish(oclCommandQueue);
-	
-	sdkStopTimer(&timer);			// Stop timer
-	timeOnGPU = sdkGetTimerValue(&timer);
-	sdkDeleteTimer(&timer);
-	
-	// Read back result from device buffer to cpu buffer
-	ret_ocl = clEnqueueReadBuffer(oclCommandQueue, deviceOutput, CL_TRUE, 0, size, hostOutput, 0, NULL, NULL);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueReadBuffer() failed", ret_ocl);
+	for(int run = 0; run < WARMUP_RUNS + WHOLE_RUNS; run++) {
+		// Copy 'input' device buffer to device memory
+		ret_ocl = clEnqueueWriteBuffer(oclCommandQueue, deviceInput1, CL_FALSE, 0, size, hostInput1, 0, NULL, &events[0]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueWriteBuffer() for 1st argument failed", ret_ocl);
+		
+		ret_ocl = clEnqueueWriteBuffer(oclCommandQueue, deviceInput2, CL_FALSE, 0, size, hostInput2, 0, NULL, &events[1]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueWriteBuffer() for 2nd argument failed", ret_ocl);
+		
+		// Run the OpenCL kernel
+		ret_ocl = clEnqueueNDRangeKernel(oclCommandQueue, oclKernel, 1, NULL, &globalWorkSize, &localWorkSize, 0, NULL, &events[2]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueNDRangeKernel() failed", ret_ocl);
+		
+		// Read back result from device buffer to cpu buffer
+		ret_ocl = clEnqueueReadBuffer(oclCommandQueue, deviceOutput, CL_FALSE, 0, size, hostOutput, 0, NULL, &events[3]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueReadBuffer() failed", ret_ocl);
+		
+		ret_ocl = oclProfilerRecordSpan(&oclProfiler, entryTotal, run, events[0], events[3]);	// Waits for read
+		ret_ocl |= oclProfilerRecord(&oclProfiler, entryWrite1, run, events[0]);
+		ret_ocl |= oclProfilerRecord(&oclProfiler, entryWrite2, run, events[1]);
+		ret_ocl |= oclProfilerRecord(&oclProfiler, entryKernel, run, events[2]);
+		ret_ocl |= oclProfilerRecord(&oclProfiler, entryRead, run, events[3]);
+		for(int e = 0; e < 4; e++)
+			clReleaseEvent(events[e]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("oclProfilerRecord() failed", ret_ocl);
+	}
+	timeOnGPU = (float)oclProfilerMedian(&oclProfiler, entryKernel);
+	timeOnGPUTotal = (float)oclProfilerMedian(&oclProfiler, entryTotal);
 	
 	vecAddHost(hostInput1, hostInput2, gold, iNumberOfArrayElements);
 	
 	// Compare results for golden-host
 	const float epsilon = 0.000001f;
-	bool bAccuracy = true;
 	int breakValue = 0;
-	for(int i = 0; i < iNumberOfArrayElements; i++) {
-		float val1 = gold[i];
-		float val2 = hostOutput[i];
-		if(fabs(val1 - val2) > epsilon) {
-			bAccuracy = false;
-			breakValue = i;
-			break;
-		}
-	}
+	bool bAccuracy = compareWithGold(&breakValue);
 	if(bAccuracy == false)
 		printf("Break Value = %d\n", breakValue);
 	
+	// Streamed mode
+	float timeStreamedKernel, timeStreamedTotal;
+	int streamedBreakValue = 0;
+	memset(hostOutput, 0, size);
+	timeStreamedTotal = runStreamed(&timeStreamedKernel);
+	bool bStreamedAccuracy = compareWithGold(&streamedBreakValue);
+	
+	// Zero copy mode
+	cl_bool bHostUnifiedMemory = CL_FALSE;
+	float timeZeroCopyKernel = 0.0f, timeZeroCopyTotal = 0.0f;
+	int zeroCopyBreakValue = 0;
+	bool bZeroCopyAccuracy = false;
+	clGetDeviceInfo(oclDeviceId, CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(bHostUnifiedMemory), &bHostUnifiedMemory, NULL);
+	if(bHostUnifiedMemory) {
+		memset(hostOutput, 0, size);
+		timeZeroCopyTotal = runZeroCopy(&timeZeroCopyKernel);
+		bZeroCopyAccuracy = compareWithGold(&zeroCopyBreakValue);
+	}
+	
 	// print results into a file
 	FILE *fp_op = fopen("Output.txt", "w");
+	printOCLDevice(fp_op, oclPlatformId, oclDeviceId);
 	fprintf(fp_op, "Size of Array1 = %d \n", iNumberOfArrayElements);
 	fprintf(fp_op, "Size of Array2 = %d \n", iNumberOfArrayElements);
 	fprintf(fp_op, "Sum of each element from above 2 arrays creates 3rd array \n");
+	fprintf(fp_op, "Program build : cache %s%s, %.3f ms \n", buildInfo.hit ? "hit" : "miss", buildInfo.stored ? " (stored)" : "", timeToBuild);
 	fprintf(fp_op, "Global work size = %u \n", (unsigned int)globalWorkSize);
 	fprintf(fp_op, "Local work size = %u \n", (unsigned int)localWorkSize);
 	fprintf(fp_op, "Time taken on CPU = %0.6f (ms) \n", timeOnCPU);
 	fprintf(fp_op, "Time taken on GPU = %0.6f (ms) \n", timeOnGPU);
 	if(bAccuracy)
-		fprintf(fp_op, "Comparision of output arrays on CPU and GPU are accurate within the limit(%f)", epsilon);
+		fprintf(fp_op, "Comparision of output arrays on CPU and GPU are accurate within the limit(%f) \n", epsilon);
+	else
+		fprintf(fp_op, "Not all comparision of output arrays on CPU and GPU are accurate within the limit(%f) \n", epsilon);
+	
+	// Kernel : kernel(s) only; End to end : host input arrays to host output array; Bandwidth : 3 arrays over end to end time
+	double totalMB = (3.0 * size) / (1024.0 * 1024.0);
+	fprintf(fp_op, "\nChunk size = %d elements, streams = %d \n", CHUNK_ELEMENTS, NUM_STREAMS);
+	fprintf(fp_op, "%-10s %14s %18s %16s  %s \n", "Mode", "Kernel (ms)", "End to end (ms)", "Bandwidth (GB/s)", "Result");
+	fprintf(fp_op, "%-10s %14.3f %18.3f %16.2f  %s \n", "whole", timeOnGPU, timeOnGPUTotal, totalMB / (1.024 * timeOnGPUTotal), bAccuracy ? "PASS" : "FAIL");
+	fprintf(fp_op, "%-10s %14.3f %18.3f %16.2f  %s \n", "streamed", timeStreamedKernel, timeStreamedTotal, totalMB / (1.024 * timeStreamedTotal), bStreamedAccuracy ? "PASS" : "FAIL");
+	if(bHostUnifiedMemory)
+		fprintf(fp_op, "%-10s %14.3f %18.3f %16.2f  %s \n", "zero copy", timeZeroCopyKernel, timeZeroCopyTotal, totalMB / (1.024 * timeZeroCopyTotal), bZeroCopyAccuracy ? "PASS" : "FAIL");
 	else
-		fprintf(fp_op, "Not all comparision of output arrays on CPU and GPU are accurate within the limit(%f)", epsilon);
+		fprintf(fp_op, "%-10s %14s %18s %16s  %s \n", "zero copy", "-", "-", "-", "skipped (device has its own memory)");
+	fprintf(fp_op, "Times are medians of %d runs from event profiling; streamed kernel time is sum over chunks, it overlaps transfers \n", WHOLE_RUNS);
 	fclose(fp_op);
 	fp_op = NULL;
 	
+	if(oclProfilerWriteCSV(&oclProfiler, "Profile.csv", "VecAdd", oclDeviceId) == 0)
+		printf("Unable to create 'Profile.csv'. \n");
+	
 	// total clean up before exitting
 	cleanup();
 	
@@ -245,6 +318,214 @@ size_t roundGlobalSizeToNearestMultipleOfLocalSize(int local_size, unsigned int
 }
 //-----------------------------------------------------------------------------
 
+void *alignedHostAlloc(size_t bytes) {
+	// Code
+#ifdef _WIN32
+	return _aligned_malloc(bytes, HOST_ALIGNMENT);
+#else
+	void *ptr = NULL;
+	if(posix_memalign(&ptr, HOST_ALIGNMENT, bytes) != 0)
+		return NULL;
+	return ptr;
+#endif
+}
+//-----------------------------------------------------------------------------
+
+void alignedHostFree(void *ptr) {
+	// Code
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+//-----------------------------------------------------------------------------
+
+void setVecAddKernelArgs(cl_mem in1, cl_mem in2, cl_mem out, int len) {
+	// Code
+	ret_ocl = clSetKernelArg(oclKernel, 0, sizeof(cl_mem), (void *)&in1);		// 'in1' maps to 'in1' in kernel
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clSetKernelArg() for 1st argument failed", ret_ocl);
+	
+	ret_ocl = clSetKernelArg(oclKernel, 1, sizeof(cl_mem), (void *)&in2);		// 'in2' maps to 'in2' in kernel
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clSetKernelArg() for 2nd argument failed", ret_ocl);
+	
+	ret_ocl = clSetKernelArg(oclKernel, 2, sizeof(cl_mem), (void *)&out);		// 'out' maps to 'out' in kernel
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clSetKernelArg() for 3rd argument failed", ret_ocl);
+	
+	ret_ocl = clSetKernelArg(oclKernel, 3, sizeof(cl_int), (void *)&len);		// 'len' maps to 'len' in kernel
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
+}
+//-----------------------------------------------------------------------------
+
+// Chunk c is written, added and read back on stream c % NUM_STREAMS. A stream reuses its buffers only after
+// its in-order queue has finished previous chunk, so no events are needed between streams.
+// Runs WARMUP_RUNS + WHOLE_RUNS times; returns median end to end time in ms (first write started to last read
+// finished, on device clock), median kernel only time (sum over chunks of a run) in *kernelTime.
+float runStreamed(float *kernelTime) {
+	// Variable declaration
+	int numChunks = (iNumberOfArrayElements + CHUNK_ELEMENTS - 1) / CHUNK_ELEMENTS;
+	int numLastReads = (numChunks < NUM_STREAMS) ? numChunks : NUM_STREAMS;
+	size_t size = iNumberOfArrayElements * sizeof(cl_float);
+	size_t chunkSize = CHUNK_ELEMENTS * sizeof(cl_float);
+	cl_event *kernelEvents = NULL;
+	cl_event firstWrite = NULL;
+	cl_event lastReads[NUM_STREAMS];	// Read of last chunk of every stream
+	cl_ulong queued, submit, start, end;
+	double queuedToSubmit, submitToStart, startToEnd;
+	int entryKernel = oclProfilerAdd(&oclProfiler, "streamed kernels (sum of chunks)", OCL_PROFILE_KERNEL, 3.0 * size, (double)iNumberOfArrayElements);
+	int entryTotal = oclProfilerAdd(&oclProfiler, "streamed end to end", OCL_PROFILE_SPAN, 3.0 * size, (double)iNumberOfArrayElements);
+	
+	// Code
+	for(int s = 0; s < NUM_STREAMS; s++) {
+		streamInput1[s] = clCreateBuffer(oclContext, CL_MEM_READ_ONLY, chunkSize, NULL, &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clCreateBuffer() for 1st chunk array failed", ret_ocl);
+		
+		streamInput2[s] = clCreateBuffer(oclContext, CL_MEM_READ_ONLY, chunkSize, NULL, &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clCreateBuffer() for 2nd chunk array failed", ret_ocl);
+		
+		streamOutput[s] = clCreateBuffer(oclContext, CL_MEM_WRITE_ONLY, chunkSize, NULL, &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clCreateBuffer() for output chunk array failed", ret_ocl);
+	}
+	
+	kernelEvents = (cl_event *)malloc(numChunks * sizeof(cl_event));
+	if(kernelEvents == NULL)
+		exit_error("CPU memory fatal error: Cannot allocate memory for kernel events.");
+	
+	for(int run = 0; run < WARMUP_RUNS + WHOLE_RUNS; run++) {
+		for(int c = 0; c < numChunks; c++) {
+			int s = c % NUM_STREAMS;
+			size_t offset = (size_t)c * CHUNK_ELEMENTS;
+			int len = (iNumberOfArrayElements - offset < CHUNK_ELEMENTS) ? (int)(iNumberOfArrayElements - offset) : CHUNK_ELEMENTS;
+			size_t bytes = len * sizeof(cl_float);
+			size_t chunkGlobalWorkSize = roundGlobalSizeToNearestMultipleOfLocalSize(localWorkSize, len);
+			
+			ret_ocl = clEnqueueWriteBuffer(oclStreamQueue[s], streamInput1[s], CL_FALSE, 0, bytes, hostInput1 + offset, 0, NULL, (c == 0) ? &firstWrite : NULL);
+			if(ret_ocl != CL_SUCCESS)
+				ocl_exit_error("clEnqueueWriteBuffer() for 1st chunk failed", ret_ocl);
+			
+			ret_ocl = clEnqueueWriteBuffer(oclStreamQueue[s], streamInput2[s], CL_FALSE, 0, bytes, hostInput2 + offset, 0, NULL, NULL);
+			if(ret_ocl != CL_SUCCESS)
+				ocl_exit_error("clEnqueueWriteBuffer() for 2nd chunk failed", ret_ocl);
+			
+			setVecAddKernelArgs(streamInput1[s], streamInput2[s], streamOutput[s], len);	// Arguments are captured at enqueue
+			ret_ocl = clEnqueueNDRangeKernel(oclStreamQueue[s], oclKernel, 1, NULL, &chunkGlobalWorkSize, &localWorkSize, 0, NULL, &kernelEvents[c]);
+			if(ret_ocl != CL_SUCCESS)
+				ocl_exit_error("clEnqueueNDRangeKernel() for chunk failed", ret_ocl);
+			
+			ret_ocl = clEnqueueReadBuffer(oclStreamQueue[s], streamOutput[s], CL_FALSE, 0, bytes, hostOutput + offset, 0, NULL,
+				(c + NUM_STREAMS >= numChunks) ? &lastReads[s] : NULL);
+			if(ret_ocl != CL_SUCCESS)
+				ocl_exit_error("clEnqueueReadBuffer() for chunk failed", ret_ocl);
+			
+			clFlush(oclStreamQueue[s]);	// Submit now, so this stream runs while next ones are enqueued
+		}
+		
+		ret_ocl = oclProfilerRecordSpanEvents(&oclProfiler, entryTotal, run, firstWrite, numLastReads, lastReads);	// Waits for all streams
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("oclProfilerRecordSpanEvents() for streamed run failed", ret_ocl);
+		
+		queuedToSubmit = submitToStart = startToEnd = 0.0;
+		for(int c = 0; c < numChunks; c++) {
+			ret_ocl = clGetEventProfilingInfo(kernelEvents[c], CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &queued, NULL);
+			ret_ocl |= clGetEventProfilingInfo(kernelEvents[c], CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &submit, NULL);
+			ret_ocl |= clGetEventProfilingInfo(kernelEvents[c], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+			ret_ocl |= clGetEventProfilingInfo(kernelEvents[c], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+			if(ret_ocl != CL_SUCCESS)
+				ocl_exit_error("clGetEventProfilingInfo() for chunk kernel failed", ret_ocl);
+			queuedToSubmit += (double)(submit - queued) / 1000000.0;
+			submitToStart += (double)(start - submit) / 1000000.0;
+			startToEnd += (double)(end - start) / 1000000.0;
+			clReleaseEvent(kernelEvents[c]);
+		}
+		oclProfilerRecordTimes(&oclProfiler, entryKernel, run, queuedToSubmit, submitToStart, startToEnd);
+		
+		clReleaseEvent(firstWrite);
+		for(int i = 0; i < numLastReads; i++)
+			clReleaseEvent(lastReads[i]);
+	}
+	free(kernelEvents);
+	
+	*kernelTime = (float)oclProfilerMedian(&oclProfiler, entryKernel);
+	return (float)oclProfilerMedian(&oclProfiler, entryTotal);
+}
+//-----------------------------------------------------------------------------
+
+// Buffers use host arrays as their storage; result is made visible to host by mapping, not by a read.
+// Runs WARMUP_RUNS + WHOLE_RUNS times; returns median end to end time in ms (kernel started to unmap finished),
+// median kernel only time in *kernelTime.
+float runZeroCopy(float *kernelTime) {
+	// Variable declaration
+	size_t size = iNumberOfArrayElements * sizeof(cl_float);
+	cl_event events[3];		// Kernel, map, unmap
+	void *mapped = NULL;
+	int entryKernel = oclProfilerAdd(&oclProfiler, "zero copy kernel", OCL_PROFILE_KERNEL, 3.0 * size, (double)iNumberOfArrayElements);
+	int entryMap = oclProfilerAdd(&oclProfiler, "zero copy map", OCL_PROFILE_MAP, (double)size, 0.0);
+	int entryTotal = oclProfilerAdd(&oclProfiler, "zero copy end to end", OCL_PROFILE_SPAN, 3.0 * size, (double)iNumberOfArrayElements);
+	
+	// Code
+	zeroCopyInput1 = clCreateBuffer(oclContext, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR, size, hostInput1, &ret_ocl);
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clCreateBuffer() for 1st zero copy array failed", ret_ocl);
+	
+	zeroCopyInput2 = clCreateBuffer(oclContext, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR, size, hostInput2, &ret_ocl);
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clCreateBuffer() for 2nd zero copy array failed", ret_ocl);
+	
+	zeroCopyOutput = clCreateBuffer(oclContext, CL_MEM_WRITE_ONLY | CL_MEM_USE_HOST_PTR, size, hostOutput, &ret_ocl);
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clCreateBuffer() for zero copy output array failed", ret_ocl);
+	
+	setVecAddKernelArgs(zeroCopyInput1, zeroCopyInput2, zeroCopyOutput, iNumberOfArrayElements);
+	
+	for(int run = 0; run < WARMUP_RUNS + WHOLE_RUNS; run++) {
+		ret_ocl = clEnqueueNDRangeKernel(oclCommandQueue, oclKernel, 1, NULL, &globalWorkSize, &localWorkSize, 0, NULL, &events[0]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueNDRangeKernel() for zero copy failed", ret_ocl);
+		
+		// Mapping returns hostOutput itself, after device writes are visible there
+		mapped = clEnqueueMapBuffer(oclCommandQueue, zeroCopyOutput, CL_TRUE, CL_MAP_READ, 0, size, 0, NULL, &events[1], &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueMapBuffer() for zero copy output failed", ret_ocl);
+		
+		ret_ocl = clEnqueueUnmapMemObject(oclCommandQueue, zeroCopyOutput, mapped, 0, NULL, &events[2]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueUnmapMemObject() for zero copy output failed", ret_ocl);
+		
+		ret_ocl = oclProfilerRecordSpan(&oclProfiler, entryTotal, run, events[0], events[2]);	// Waits for unmap
+		ret_ocl |= oclProfilerRecord(&oclProfiler, entryKernel, run, events[0]);
+		ret_ocl |= oclProfilerRecord(&oclProfiler, entryMap, run, events[1]);
+		for(int e = 0; e < 3; e++)
+			clReleaseEvent(events[e]);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("oclProfilerRecord() for zero copy failed", ret_ocl);
+	}
+	
+	*kernelTime = (float)oclProfilerMedian(&oclProfiler, entryKernel);
+	return (float)oclProfilerMedian(&oclProfiler, entryTotal);
+}
+//-----------------------------------------------------------------------------
+
+// Returns true if hostOutput matches gold, else false with first mismatching index in *breakValue
+bool compareWithGold(int *breakValue) {
+	// Code
+	const float epsilon = 0.000001f;
+	for(int i = 0; i < iNumberOfArrayElements; i++) {
+		if(fabs(gold[i] - hostOutput[i]) > epsilon) {
+			*breakValue = i;
+			return false;
+		}
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
+
 void vecAddHost(const float* pFloatArray1, const float* pFloatArray2, float* pFloatResult, int iNumElements) {
 	// Code
 	StopWatchInterface *timer = NULL;
@@ -283,6 +564,13 @@ void cleanup() {
 		oclCommandQueue = NULL;
 	}
 	
+	for(int s = 0; s < NUM_STREAMS; s++) {
+		if(oclStreamQueue[s]) {
+			clReleaseCommandQueue(oclStreamQueue[s]);
+			oclStreamQueue[s] = NULL;
+		}
+	}
+	
 	if(oclContext) {
 		clReleaseContext(oclContext);
 		oclContext = NULL;
@@ -304,19 +592,49 @@ void cleanup() {
 		deviceOutput = NULL;
 	}
 	
+	for(int s = 0; s < NUM_STREAMS; s++) {
+		if(streamInput1[s]) {
+			clReleaseMemObject(streamInput1[s]);
+			streamInput1[s] = NULL;
+		}
+		if(streamInput2[s]) {
+			clReleaseMemObject(streamInput2[s]);
+			streamInput2[s] = NULL;
+		}
+		if(streamOutput[s]) {
+			clReleaseMemObject(streamOutput[s]);
+			streamOutput[s] = NULL;
+		}
+	}
+	
+	if(zeroCopyInput1) {
+		clReleaseMemObject(zeroCopyInput1);
+		zeroCopyInput1 = NULL;
+	}
+	
+	if(zeroCopyInput2) {
+		clReleaseMemObject(zeroCopyInput2);
+		zeroCopyInput2 = NULL;
+	}
+	
+	if(zeroCopyOutput) {
+		clReleaseMemObject(zeroCopyOutput);
+		zeroCopyOutput = NULL;
+	}
+	
 	// Free host-memory
 	if(hostInput1) {
-		free(hostInput1);
+		alignedHostFree(hostInput1);
 		hostInput1 = NULL;
 	}
 	
 	if(hostInput2) {
-		free(hostInput2);
+		alignedHostFree(hostInput2);
 		hostInput2 = NULL;
 	}
 	
 	if(hostOutput) {
-		free(hostOutput);
+		alignedHostFree(hostOutput);
 		hostOutput = NULL;
 	}
 	
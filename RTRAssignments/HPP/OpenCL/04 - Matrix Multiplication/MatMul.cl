@@ -1,14 +1,112 @@
-// OpenCL kernel
-__kernel void matrixMultiply(__global int *A, __global int *B, __global int *C, int numARows, int numACols, int numBRows, int numBCols, int numCRows, int numCCols) {
+// OpenCL kernels : C (M x N) = A (M x K) * B (K x N), all row major floats
+// Every kernel runs on a 2D NDRange, dimension 0 along columns of C (neighbouring work items read
+// neighbouring elements of B and write neighbouring elements of C) and dimension 1 along rows.
+// Global size is rounded up to a multiple of work group size, so every kernel checks M, N and K.
+
+// Tile sizes, host passes same values with -D
+#ifndef TILE
+	#define TILE		16		// matMulTiled : work group is TILE x TILE
+#endif
+#ifndef RB_TILE
+	#define RB_TILE		32		// matMulRegister : C tile of a work group is RB_TILE x RB_TILE
+#endif
+#ifndef RB_WPT
+	#define RB_WPT		4		// matMulRegister : every work item computes RB_WPT x RB_WPT elements
+#endif
+#define RB_LOCAL	(RB_TILE / RB_WPT)	// matMulRegister : work group is RB_LOCAL x RB_LOCAL
+
+// One element of C per work item, straight from global memory
+__kernel void matMulNaive(__global const float *A, __global const float *B, __global float *C, int M, int N, int K) {
 	// Variable declaration
-	int row = get_global_id(0);
-	int col = get_global_id(1);
-	
+	int col = get_global_id(0);
+	int row = get_global_id(1);
+	float sum = 0.0f;
+
 	// Code
-	if((row < numARows) && (col < numBCols)) {
-		int CValue = 0;
-		for(int k = 0; k < numACols; k++)
-			CValue += A[row * numACols + k] * B[k * numBCols + col];
-		C[row * numCCols + col] = CValue;
+	if((row < M) && (col < N)) {
+		for(int k = 0; k < K; k++)
+			sum += A[row * K + k] * B[k * N + col];
+		C[row * N + col] = sum;
+	}
+}
+
+// One element of C per work item; A and B pass through local memory in TILE x TILE tiles, so every
+// element read from global memory is used TILE times. Outside of matrices tiles are padded with 0.
+__kernel __attribute__((reqd_work_group_size(TILE, TILE, 1)))
+void matMulTiled(__global const float *A, __global const float *B, __global float *C, int M, int N, int K) {
+	// Variable declaration
+	__local float tileA[TILE][TILE];
+	__local float tileB[TILE][TILE];
+	int tx = get_local_id(0);
+	int ty = get_local_id(1);
+	int col = get_group_id(0) * TILE + tx;
+	int row = get_group_id(1) * TILE + ty;
+	float sum = 0.0f;
+
+	// Code
+	for(int t = 0; t < K; t += TILE) {
+		tileA[ty][tx] = ((row < M) && (t + tx < K)) ? A[row * K + t + tx] : 0.0f;
+		tileB[ty][tx] = ((t + ty < K) && (col < N)) ? B[(t + ty) * N + col] : 0.0f;
+		barrier(CLK_LOCAL_MEM_FENCE);
+
+		for(int k = 0; k < TILE; k++)
+			sum += tileA[ty][k] * tileB[k][tx];
+		barrier(CLK_LOCAL_MEM_FENCE);
+	}
+
+	if((row < M) && (col < N))
+		C[row * N + col] = sum;
+}
+
+// RB_WPT x RB_WPT elements of C per work item, accumulated in registers. Work item (tx, ty) of a group
+// computes rows ty + i * RB_LOCAL and columns tx + j * RB_LOCAL of group's tile, so loads and stores
+// of a work group stay contiguous. Every value taken from local memory is used RB_WPT times.
+__kernel __attribute__((reqd_work_group_size(RB_LOCAL, RB_LOCAL, 1)))
+void matMulRegister(__global const float *A, __global const float *B, __global float *C, int M, int N, int K) {
+	// Variable declaration
+	__local float tileA[RB_TILE][RB_TILE];
+	__local float tileB[RB_TILE][RB_TILE];
+	float acc[RB_WPT][RB_WPT];
+	float a[RB_WPT], b[RB_WPT];
+	int tx = get_local_id(0);
+	int ty = get_local_id(1);
+	int colBase = get_group_id(0) * RB_TILE;
+	int rowBase = get_group_id(1) * RB_TILE;
+
+	// Code
+	for(int i = 0; i < RB_WPT; i++)
+		for(int j = 0; j < RB_WPT; j++)
+			acc[i][j] = 0.0f;
+
+	for(int t = 0; t < K; t += RB_TILE) {
+		for(int i = 0; i < RB_WPT; i++) {	// Each work item loads RB_WPT x RB_WPT elements of each tile
+			for(int j = 0; j < RB_WPT; j++) {
+				int r = ty + i * RB_LOCAL;
+				int c = tx + j * RB_LOCAL;
+				tileA[r][c] = ((rowBase + r < M) && (t + c < K)) ? A[(rowBase + r) * K + t + c] : 0.0f;
+				tileB[r][c] = ((t + r < K) && (colBase + c < N)) ? B[(t + r) * N + colBase + c] : 0.0f;
+			}
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+
+		for(int k = 0; k < RB_TILE; k++) {
+			for(int i = 0; i < RB_WPT; i++)
+				a[i] = tileA[ty + i * RB_LOCAL][k];
+			for(int j = 0; j < RB_WPT; j++)
+				b[j] = tileB[k][tx + j * RB_LOCAL];
+			for(int i = 0; i < RB_WPT; i++)
+				for(int j = 0; j < RB_WPT; j++)
+					acc[i][j] += a[i] * b[j];
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+	}
+
+	for(int i = 0; i < RB_WPT; i++) {
+		for(int j = 0; j < RB_WPT; j++) {
+			int row = rowBase + ty + i * RB_LOCAL;
+			int col = colBase + tx + j * RB_LOCAL;
+			if((row < M) && (col < N))
+				C[row * N + col] = acc[i][j];
+		}
 	}
 }
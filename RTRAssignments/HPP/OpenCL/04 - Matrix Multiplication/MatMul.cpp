@@ -1,6 +1,18 @@
 // Multiplying matrices of floats in OpenCL
 // By : Darshan Vikam
 // Date : 28 July 2021
+//
+// Square matrices of every size in 'sizes' (up to 'maxSize') are multiplied by naive, local memory tiled
+// and register blocked kernels (see MatMul.cl) on a 2D NDRange. GFLOPS and max error against matMulHost()
+// of every run are written to Output.txt. Sizes which are not multiples of tiles check edge handling.
+// matMulHost() is blocked, packed and multithreaded (see host_gemm.h), so its GFLOPS, also reported
+// with fraction of measured micro kernel peak, are a fair CPU side of comparison.
+// Device times come from event profiling (see ocl_profiler.h) : every write, kernel and read runs
+// WARMUP_RUNS + repeats times and median kernel time goes to Output.txt; min / median / p95 of
+// every command with its queued, submit and start stamps go to Profile.csv.
+// Usage : MatMul [gpu | cpu | any] [maxSize]		(default - any, 4096; "cpu" runs on e.g. PoCL)
+// Build : runOpenCL.bat (cl.exe /O2 /arch:AVX2), or g++ -O2 -mavx2 -mfma -pthread -o MatMul MatMul.cpp -lOpenCL
+// Without AVX2 / FMA flags host_gemm.h falls back to its scalar kernel and host GFLOPS mean little.
 //=============================================================================
 
 // Header Files
@@ -12,8 +24,19 @@
 #include "../Include/helper_timer.h"
 #include "../Include/ocl_kernel_loader.h"
 #include "../Include/ocl_exit_error.h"
+#include "../Include/ocl_device_selector.h"
+#include "../Include/host_gemm.h"
+#include "../Include/ocl_profiler.h"
 //-----------------------------------------------------------------------------
 
+// Tile sizes, passed to MatMul.cl with -D
+#define TILE		16		// matMulTiled : 16 x 16 work group
+#define RB_TILE		32		// matMulRegister : 32 x 32 tile of C per work group ...
+#define RB_WPT		4		// ... 4 x 4 elements of C per work item, so 8 x 8 work group
+#define RB_LOCAL	(RB_TILE / RB_WPT)
+
+#define WARMUP_RUNS	1		// Not recorded (kernel compilation of some drivers happens there)
+
 // Global variable declaration (for OpenCL)
 cl_int			ret_ocl;
 cl_platform_id		oclPlatformId;
@@ -21,14 +44,13 @@ cl_device_id		oclDeviceId;		// Compute Device ID
 cl_context		oclContext;		// Compute Context
 cl_command_queue	oclCommandQueue;	// Compute Command Queue
 cl_program		oclProgram;		// Compute Program
-cl_kernel		oclKernel;		// Compute Kernel
+cl_kernel		oclKernelNaive;		// Compute Kernels
+cl_kernel		oclKernelTiled;
+cl_kernel		oclKernelRegister;
 
 char *oclSrcCode = NULL;
 size_t kernelCodeLength;
 
-size_t localWorkSize = 256;
-size_t globalWorkSize;
-
 float *hostA = NULL;
 float *hostB = NULL;
 float *hostC = NULL;
@@ -39,227 +61,212 @@ cl_mem deviceB = NULL;
 cl_mem deviceC = NULL;
 
 float timeOnCPU, timeOnGPU;
+
+OCLProfiler oclProfiler;		// Event timings of every command
+
+// Kernels of the sweep; 'tile' - columns and rows of C covered by one work group
+typedef struct {
+	const char *name;
+	cl_kernel *kernel;
+	size_t local;
+	int tile;
+} MatMulKernel;
 //-----------------------------------------------------------------------------
 
 // Entry point function - main()
-int main() {
+int main(int argc, char *argv[]) {
 	// Function declaration
 	void fillFloatArrayWithRandomNumbers(float *, int);
-	size_t roundGlobalSizeToNearestMultipleOfLocalSize(int, unsigned int);
+	float runMatMulKernel(cl_kernel, size_t, int, int, int, int, int, int);
+	void profiledTransfer(bool, cl_mem, size_t, float *, int, int);
 	void matMulHost(float *, float *, float *, int, int, int);
 	void cleanup();
 
 	// Variable declaration
-	int numARows, numACols;
-	int numBRows, numBCols;
-	int numCRows, numCCols;
-	int numCHostRows, numCHostCols;
+	const int sizes[] = { 64, 100, 128, 250, 256, 500, 512, 1000, 1024, 2000, 2048, 4096 };
+	const char *devicePreference = (argc > 1) ? argv[1] : "any";
+	int maxSize = (argc > 2) ? atoi(argv[2]) : 4096;
+	MatMulKernel kernels[3] = {
+		{ "naive", &oclKernelNaive, TILE, TILE },
+		{ "tiled", &oclKernelTiled, TILE, TILE },
+		{ "register", &oclKernelRegister, RB_LOCAL, RB_TILE }
+	};
+	char buildOptions[128];
+	char entryName[64];
+	OCLBuildInfo buildInfo;
+	float timeToBuild;
+	size_t maxWorkGroupSize = 0;
 
 	// Code
-	numARows = 4;
-	numACols = 4;
-	numBRows = 4;
-	numBCols = 4;
-	numCRows = numARows;
-	numCCols = numBCols;
-	numCHostRows = numARows;
-	numCHostCols = numBCols;
-	
-	int sizeA = numARows * numACols * sizeof(float);
-	int sizeB = numBRows * numBCols * sizeof(float);
-	int sizeC = numCRows * numCCols * sizeof(float);
-	int sizeCHost = numCHostRows * numCHostCols * sizeof(float);
-	
-	hostA = (float *)malloc(sizeA);
+	if(maxSize < sizes[0])
+		maxSize = sizes[0];
+
+	size_t maxElements = (size_t)maxSize * maxSize;
+	hostA = (float *)malloc(maxElements * sizeof(float));
 	if(hostA == NULL)
 		exit_error("CPU memory fatal error: Cannot allocate memory for host input matrix A.");
-	
-	hostB = (float *)malloc(sizeB);
+
+	hostB = (float *)malloc(maxElements * sizeof(float));
 	if(hostB == NULL)
 		exit_error("CPU memory fatal error: Cannot allocate memory for host input matrix B.");
-	
-	hostC = (float *)malloc(sizeC);
+
+	hostC = (float *)malloc(maxElements * sizeof(float));
 	if(hostC == NULL)
 		exit_error("CPU memory fatal error: Cannot allocate memory for host output matrix C.");
-	
-	CHost = (float *)malloc(sizeCHost);
+
+	CHost = (float *)malloc(maxElements * sizeof(float));
 	if(CHost == NULL)
-		exit_error("CPU memory fatal error: Cannot allocate memory for OpenCL output matrix CHost.");
-	
-	// Filling above host input arraay with hard coded values (arbitary values)
-	fillFloatArrayWithRandomNumbers(hostA, numARows * numACols);
-	fillFloatArrayWithRandomNumbers(hostB, numBRows * numBCols);
-	
-	// Get OpenCL supporting platform's id
-	ret_ocl = clGetPlatformIDs(1, &oclPlatformId, NULL);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clGetPlatformIDs() failed", ret_ocl);
-	
-	// Get OpenCL supporting GPU device's id
-	ret_ocl = clGetDeviceIDs(oclPlatformId, CL_DEVICE_TYPE_GPU, 1, &oclDeviceId, NULL);
+		exit_error("CPU memory fatal error: Cannot allocate memory for host output matrix CHost.");
+
+	// Filling above host input arrays with random values; every size uses beginning of them
+	fillFloatArrayWithRandomNumbers(hostA, (int)maxElements);
+	fillFloatArrayWithRandomNumbers(hostB, (int)maxElements);
+
+	// Get OpenCL supporting device's id (GPU if there is one, else CPU)
+	ret_ocl = selectOCLDevice(devicePreference, &oclPlatformId, &oclDeviceId);
 	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clGetDeviceIDs() failed", ret_ocl);
-	
-	char gpu_name[256];
-	clGetDeviceInfo(oclDeviceId, CL_DEVICE_NAME, sizeof(gpu_name), &gpu_name, NULL);
-	printf("%s \n", gpu_name);
-	
+		ocl_exit_error("selectOCLDevice() failed", ret_ocl);
+	printOCLDevice(stdout, oclPlatformId, oclDeviceId);
+	clGetDeviceInfo(oclDeviceId, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(maxWorkGroupSize), &maxWorkGroupSize, NULL);
+
 	// Create OpenCL compute context
 	oclContext = clCreateContext(NULL, 1, &oclDeviceId, NULL, NULL, &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
 		ocl_exit_error("clCreateContext() failed", ret_ocl);
-	
-	// Create command queue
-	oclCommandQueue = clCreateCommandQueue(oclContext, oclDeviceId, 0, &ret_ocl);
+
+	// Create command queue, events of its commands carry device timestamps
+	oclCommandQueue = clCreateCommandQueue(oclContext, oclDeviceId, CL_QUEUE_PROFILING_ENABLE, &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
 		ocl_exit_error("clCreateCommandQueue() failed", ret_ocl);
-	
+	oclProfilerInit(&oclProfiler, WARMUP_RUNS);
+
 	// Create OpenCl program from '.cl' file
 	oclSrcCode = loadOCLProgram("MatMul.cl", "", &kernelCodeLength);
-	oclProgram = clCreateProgramWithSource(oclContext, 1, (const char **)&oclSrcCode, NULL, &ret_ocl);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clCreateProgramWithSource() failed", ret_ocl);
-	
-	// Build OpenCL program
-	ret_ocl = clBuildProgram(oclProgram, 0, NULL, NULL, NULL, NULL);
-	if(ret_ocl != CL_SUCCESS) {
-		size_t len;
-		clGetProgramBuildInfo(oclProgram, oclDeviceId, CL_PROGRAM_BUILD_LOG, 0, NULL, &len);
-		char *buffer = NULL;
-		buffer = (char *)malloc(len);
-		if(buffer == NULL)
-			exit(1);
-		clGetProgramBuildInfo(oclProgram, oclDeviceId, CL_PROGRAM_BUILD_LOG, sizeof(buffer), buffer, NULL);
-		printf(buffer);
-		ocl_exit_error("clBuildProgram() failed : ", ret_ocl);
-	}
-	
-	oclKernel = clCreateKernel(oclProgram, "matrixMultiply", &ret_ocl);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clCreateKernel() failed", ret_ocl);
-	
-	// Create buffer for arrays
-	int size = numCRows * numCCols * sizeof(cl_float);
-	deviceA = clCreateBuffer(oclContext, CL_MEM_READ_ONLY, size, NULL, &ret_ocl);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clCreateBuffer() for 1st array failed", ret_ocl);
-	
-	deviceB = clCreateBuffer(oclContext, CL_MEM_READ_ONLY, size, NULL, &ret_ocl);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clCreateBuffer() for 2nd array failed", ret_ocl);
-	
-	deviceC = clCreateBuffer(oclContext, CL_MEM_WRITE_ONLY, size, NULL, &ret_ocl);
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clCreateBuffer() for output array failed", ret_ocl);
-	
-	// Set OpenCL kernel arguments
-	ret_ocl = clSetKernelArg(oclKernel, 0, sizeof(cl_mem), (void *)&deviceA);		// 'deviceA' maps to 'A' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 1st argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 1, sizeof(cl_mem), (void *)&deviceB);		// 'deviceB' maps to 'B' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 2nd argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 2, sizeof(cl_mem), (void *)&deviceC);		// 'deviceC' maps to 'C' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 3rd argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 3, sizeof(cl_int), (void *)&numARows);		// 'numARows' maps to 'numARows' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 4, sizeof(cl_int), (void *)&numACols);		// 'numACols' maps to 'numACols' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 5, sizeof(cl_int), (void *)&numBRows);		// 'numBRows' maps to 'numBRows' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 6, sizeof(cl_int), (void *)&numBCols);		// 'numBCols' maps to 'numBCols' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 7, sizeof(cl_int), (void *)&numCRows);		// 'numCRows' maps to 'numCRows' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
-	
-	ret_ocl = clSetKernelArg(oclKernel, 8, sizeof(cl_int), (void *)&numCCols);		// 'numCCols' maps to 'numCCols' in kernel
-	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clSetKernelArg() for 4th argument failed", ret_ocl);
-	
-	// Copy 'input' device buffer to device memory
-	ret_ocl = clEnqueueWriteBuffer(oclCommandQueue, deviceA, CL_FALSE, 0, size, hostA, 0, NULL, NULL);
+	if(oclSrcCode == NULL)
+		exit_error("Unable to load 'MatMul.cl'.");
+
+	// Build OpenCL program (from binary cache when same source, options and driver were built before)
+	sprintf(buildOptions, "-D TILE=%d -D RB_TILE=%d -D RB_WPT=%d", TILE, RB_TILE, RB_WPT);
+	StopWatchInterface *buildTimer = NULL;
+	sdkCreateTimer(&buildTimer);
+	sdkStartTimer(&buildTimer);
+	oclProgram = buildOCLProgramCached(oclContext, oclDeviceId, oclSrcCode, buildOptions, &buildInfo, &ret_ocl);
+	sdkStopTimer(&buildTimer);
+	timeToBuild = sdkGetTimerValue(&buildTimer);
+	sdkDeleteTimer(&buildTimer);
 	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueWriteBuffer() for 1st argument failed", ret_ocl);
-	
-	ret_ocl = clEnqueueWriteBuffer(oclCommandQueue, deviceB, CL_FALSE, 0, size, hostB, 0, NULL, NULL);
+		ocl_exit_error("buildOCLProgramCached() failed, build log is on console", ret_ocl);
+	printf("Program build : cache %s%s, %.3f ms \n", buildInfo.hit ? "hit" : "miss", buildInfo.stored ? " (stored)" : "", timeToBuild);
+
+	oclKernelNaive = clCreateKernel(oclProgram, "matMulNaive", &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueWriteBuffer() for 2nd argument failed", ret_ocl);
-	
-	// Run the OpenCL kernel
-	globalWorkSize = roundGlobalSizeToNearestMultipleOfLocalSize(localWorkSize, (numCRows * numCCols));
-	
-	// Timer
-	StopWatchInterface *timer = NULL;	// For time counter
-	sdkCreateTimer(&timer);
-	sdkStartTimer(&timer);			// Start timer
-	ret_ocl = clEnqueueNDRangeKernel(oclCommandQueue, oclKernel, 1, NULL, &globalWorkSize, &localWorkSize, 0, NULL, NULL);
+		ocl_exit_error("clCreateKernel() for matMulNaive failed", ret_ocl);
+
+	oclKernelTiled = clCreateKernel(oclProgram, "matMulTiled", &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueNDRangeKernel() failed", ret_ocl);
-	
-	// Finish OpenCL command queue
-	clFinish(oclCommandQueue);
-	
-	sdkStopTimer(&timer);			// Stop timer
-	timeOnGPU = sdkGetTimerValue(&timer);
-	sdkDeleteTimer(&timer);
-	
-	// Read back result from device buffer to cpu buffer
-	ret_ocl = clEnqueueReadBuffer(oclCommandQueue, deviceC, CL_TRUE, 0, size, hostC, 0, NULL, NULL);
+		ocl_exit_error("clCreateKernel() for matMulTiled failed", ret_ocl);
+
+	oclKernelRegister = clCreateKernel(oclProgram, "matMulRegister", &ret_ocl);
 	if(ret_ocl != CL_SUCCESS)
-		ocl_exit_error("clEnqueueReadBuffer() failed", ret_ocl);
-	
-	matMulHost(hostA, hostB, CHost, numACols, numCHostRows, numCHostCols);
-	
-	// Compare results for golden-host
-	const float epsilon = 0.000001f;
+		ocl_exit_error("clCreateKernel() for matMulRegister failed", ret_ocl);
+
+	// print results into a file
+	FILE *fp_op = fopen("Output.txt", "w");
+	if(fp_op == NULL)
+		exit_error("Unable to create 'Output.txt'.");
+	fprintf(fp_op, "Device : ");
+	printOCLDevice(fp_op, oclPlatformId, oclDeviceId);
+	fprintf(fp_op, "Program build : cache %s%s, %.3f ms \n", buildInfo.hit ? "hit" : "miss", buildInfo.stored ? " (stored)" : "", timeToBuild);
+	fprintf(fp_op, "C (N x N) = A (N x N) * B (N x N), random floats in [0, 1] \n");
+	fprintf(fp_op, "Work group : naive %d x %d, tiled %d x %d, register %d x %d (%d x %d elements per work item) \n",
+		TILE, TILE, TILE, TILE, RB_LOCAL, RB_LOCAL, RB_WPT, RB_WPT);
+	double hostPeak = hostGemmPeakGflops();
+	fprintf(fp_op, "Host : %s micro kernel, %d threads, measured peak %.2f GFLOPS \n", HOST_GEMM_KERNEL_NAME, hostGemmThreads(), hostPeak);
+	fprintf(fp_op, "Max error is largest |C - matMulHost()|, limit is N * 1e-5 \n");
+	fprintf(fp_op, "Device time is median kernel time from event profiling, see Profile.csv for transfers and spread \n\n");
+	fprintf(fp_op, "%6s %-9s %12s %10s %12s %s \n", "N", "Kernel", "Time (ms)", "GFLOPS", "Max error", "Result");
+
 	bool bAccuracy = true;
-	int breakValue = 0;
-	for(int i = 0; i < numARows * numACols; i++) {
-		float val1 = CHost[i];
-		float val2 = hostC[i];
-		if(fabs(val1 - val2) > epsilon) {
-			bAccuracy = false;
-			breakValue = i;
-			break;
+	for(unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && sizes[s] <= maxSize; s++) {
+		int n = sizes[s];
+		size_t size = (size_t)n * n * sizeof(cl_float);
+		int repeats = (n <= 512) ? 5 : ((n <= 1024) ? 3 : 1);
+
+		// Create buffer for matrices
+		deviceA = clCreateBuffer(oclContext, CL_MEM_READ_ONLY, size, NULL, &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clCreateBuffer() for matrix A failed", ret_ocl);
+
+		deviceB = clCreateBuffer(oclContext, CL_MEM_READ_ONLY, size, NULL, &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clCreateBuffer() for matrix B failed", ret_ocl);
+
+		deviceC = clCreateBuffer(oclContext, CL_MEM_WRITE_ONLY, size, NULL, &ret_ocl);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clCreateBuffer() for matrix C failed", ret_ocl);
+
+		// Copy input matrices to device memory
+		sprintf(entryName, "write A N=%d", n);
+		profiledTransfer(true, deviceA, size, hostA, repeats, oclProfilerAdd(&oclProfiler, entryName, OCL_PROFILE_WRITE, (double)size, 0.0));
+		sprintf(entryName, "write B N=%d", n);
+		profiledTransfer(true, deviceB, size, hostB, repeats, oclProfilerAdd(&oclProfiler, entryName, OCL_PROFILE_WRITE, (double)size, 0.0));
+
+		// Reference on host
+		matMulHost(hostA, hostB, CHost, n, n, n);
+		double hostGflops = (2.0 * n * n * n) / (timeOnCPU * 1.0e6);
+		fprintf(fp_op, "%6d %-9s %12.3f %10.2f %12s %.0f%% of peak \n", n, "host", timeOnCPU, hostGflops, "-", (hostGflops * 100.0) / hostPeak);
+		printf("N = %4d %-9s : %10.3f ms, %8.2f GFLOPS \n", n, "host", timeOnCPU, hostGflops);
+
+		for(int k = 0; k < 3; k++) {
+			if(kernels[k].local * kernels[k].local > maxWorkGroupSize) {
+				fprintf(fp_op, "%6d %-9s skipped, needs work group of %u \n", n, kernels[k].name, (unsigned int)(kernels[k].local * kernels[k].local));
+				continue;
+			}
+			memset(hostC, 0, size);
+			sprintf(entryName, "%s N=%d", kernels[k].name, n);
+			timeOnGPU = runMatMulKernel(*kernels[k].kernel, kernels[k].local, kernels[k].tile, n, n, n, repeats,
+				oclProfilerAdd(&oclProfiler, entryName, OCL_PROFILE_KERNEL, 0.0, 2.0 * n * n * n));
+
+			// Read back result from device buffer to cpu buffer
+			sprintf(entryName, "read C %s N=%d", kernels[k].name, n);
+			profiledTransfer(false, deviceC, size, hostC, repeats, oclProfilerAdd(&oclProfiler, entryName, OCL_PROFILE_READ, (double)size, 0.0));
+
+			// Compare results for golden-host
+			float maxError = 0.0f;
+			for(size_t i = 0; i < (size_t)n * n; i++) {
+				float error = fabsf(CHost[i] - hostC[i]);
+				if(!(error <= maxError))		// NaN counts as error too
+					maxError = error;
+			}
+			bool bPassed = (maxError <= n * 1e-5f);
+			bAccuracy = bAccuracy && bPassed;
+
+			double gflops = (2.0 * n * n * n) / (timeOnGPU * 1.0e6);
+			fprintf(fp_op, "%6d %-9s %12.3f %10.2f %12.3e %s \n", n, kernels[k].name, timeOnGPU, gflops, maxError, bPassed ? "PASS" : "FAIL");
+			printf("N = %4d %-9s : %10.3f ms, %8.2f GFLOPS, max error %.3e %s \n", n, kernels[k].name, timeOnGPU, gflops, maxError, bPassed ? "" : "(FAIL)");
 		}
+		fflush(fp_op);
+
+		clReleaseMemObject(deviceA);
+		clReleaseMemObject(deviceB);
+		clReleaseMemObject(deviceC);
+		deviceA = deviceB = deviceC = NULL;
 	}
-	if(bAccuracy == false)
-		printf("Break Value = %d\n", breakValue);
-	
-	// print results into a file
-	FILE *fp_op = fopen("Output.txt", "w");
-	fprintf(fp_op, "1st matrix is from 0th element %.6f to %dth element %.6f\n", hostA[0], (numARows * numACols) - 1, hostA[(numARows * numACols) - 1]);
-	fprintf(fp_op, "2nd matrix is from 0th element %.6f to %dth element %.6f\n", hostB[0], (numBRows * numBCols) - 1, hostB[(numBRows * numBCols) - 1]);
-	fprintf(fp_op, "Multiplication of above 2 matrices creates 3rd matrix as :\n");
-	fprintf(fp_op, "3rd matrix is from 0th element %.6f to %dth element %.6f\n", hostC[0], (numCRows * numCCols) - 1, hostC[(numCRows * numCCols) - 1]);
-	fprintf(fp_op, "Global work size = %u \n", (unsigned int)globalWorkSize);
-	fprintf(fp_op, "Local work size = %u \n", (unsigned int)localWorkSize);
-	fprintf(fp_op, "Time taken on CPU = %0.6f (ms) \n", timeOnCPU);
-	fprintf(fp_op, "Time taken on GPU = %0.6f (ms) \n", timeOnGPU);
+
 	if(bAccuracy)
-		fprintf(fp_op, "Comparision of output arrays on CPU and GPU are accurate within the limit(%f)", epsilon);
+		fprintf(fp_op, "\nComparision of output matrices on CPU and OpenCL device are accurate within the limit");
 	else
-		fprintf(fp_op, "Not all comparision of output arrays on CPU and GPU are accurate within the limit(%f)", epsilon);
+		fprintf(fp_op, "\nNot all comparision of output matrices on CPU and OpenCL device are accurate within the limit");
 	fclose(fp_op);
 	fp_op = NULL;
-	
+
+	if(oclProfilerWriteCSV(&oclProfiler, "Profile.csv", "MatMul", oclDeviceId) == 0)
+		printf("Unable to create 'Profile.csv'. \n");
+
 	// total clean up before exitting
 	cleanup();
-	
-	return 0;
+
+	return (bAccuracy ? 0 : 1);
 }
 //-----------------------------------------------------------------------------
 
@@ -271,13 +278,65 @@ void fillFloatArrayWithRandomNumbers(float *pFloatArray, int iSize) {
 }
 //-----------------------------------------------------------------------------
 
-size_t roundGlobalSizeToNearestMultipleOfLocalSize(int local_size, unsigned int global_size) {
+// Runs 'kernel' on deviceA, deviceB -> deviceC; 'local' x 'local' work groups, each covering 'tile' x 'tile' of C.
+// WARMUP_RUNS + 'repeats' runs are recorded into profiler 'entry'; returns median kernel time in ms.
+float runMatMulKernel(cl_kernel kernel, size_t local, int tile, int M, int N, int K, int repeats, int entry) {
+	// Variable declaration
+	size_t localWorkSize[2] = { local, local };
+	size_t globalWorkSize[2];
+	cl_event event = NULL;
+
 	// Code
-	unsigned int r = global_size % local_size;
-	if(r == 0)
-		return global_size;
-	else
-		return (global_size + local_size - r);
+	globalWorkSize[0] = (size_t)((N + tile - 1) / tile) * local;	// Dimension 0 - columns of C
+	globalWorkSize[1] = (size_t)((M + tile - 1) / tile) * local;	// Dimension 1 - rows of C
+
+	// Set OpenCL kernel arguments
+	ret_ocl = clSetKernelArg(kernel, 0, sizeof(cl_mem), (void *)&deviceA);		// 'deviceA' maps to 'A' in kernel
+	ret_ocl |= clSetKernelArg(kernel, 1, sizeof(cl_mem), (void *)&deviceB);		// 'deviceB' maps to 'B' in kernel
+	ret_ocl |= clSetKernelArg(kernel, 2, sizeof(cl_mem), (void *)&deviceC);		// 'deviceC' maps to 'C' in kernel
+	ret_ocl |= clSetKernelArg(kernel, 3, sizeof(cl_int), (void *)&M);
+	ret_ocl |= clSetKernelArg(kernel, 4, sizeof(cl_int), (void *)&N);
+	ret_ocl |= clSetKernelArg(kernel, 5, sizeof(cl_int), (void *)&K);
+	if(ret_ocl != CL_SUCCESS)
+		ocl_exit_error("clSetKernelArg() failed", ret_ocl);
+
+	for(int run = 0; run < WARMUP_RUNS + repeats; run++) {
+		ret_ocl = clEnqueueNDRangeKernel(oclCommandQueue, kernel, 2, NULL, globalWorkSize, localWorkSize, 0, NULL, &event);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("clEnqueueNDRangeKernel() failed", ret_ocl);
+
+		ret_ocl = oclProfilerRecord(&oclProfiler, entry, run, event);	// Waits for kernel
+		clReleaseEvent(event);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("oclProfilerRecord() for kernel failed", ret_ocl);
+	}
+	return (float)oclProfilerMedian(&oclProfiler, entry);
+}
+//-----------------------------------------------------------------------------
+
+// Writes 'host' to (or reads it from) 'buffer' WARMUP_RUNS + 'repeats' times, recorded into profiler 'entry'
+void profiledTransfer(bool write, cl_mem buffer, size_t size, float *host, int repeats, int entry) {
+	// Variable declaration
+	cl_event event = NULL;
+
+	// Code
+	for(int run = 0; run < WARMUP_RUNS + repeats; run++) {
+		if(write) {
+			ret_ocl = clEnqueueWriteBuffer(oclCommandQueue, buffer, CL_FALSE, 0, size, host, 0, NULL, &event);
+			if(ret_ocl != CL_SUCCESS)
+				ocl_exit_error("clEnqueueWriteBuffer() failed", ret_ocl);
+		}
+		else {
+			ret_ocl = clEnqueueReadBuffer(oclCommandQueue, buffer, CL_FALSE, 0, size, host, 0, NULL, &event);
+			if(ret_ocl != CL_SUCCESS)
+				ocl_exit_error("clEnqueueReadBuffer() failed", ret_ocl);
+		}
+
+		ret_ocl = oclProfilerRecord(&oclProfiler, entry, run, event);	// Waits for transfer
+		clReleaseEvent(event);
+		if(ret_ocl != CL_SUCCESS)
+			ocl_exit_error("oclProfilerRecord() for transfer failed", ret_ocl);
+	}
 }
 //-----------------------------------------------------------------------------
 
@@ -286,19 +345,9 @@ void matMulHost(float* A, float* B, float* C, int iACols, int iCRows, int iCCols
 	StopWatchInterface *timer = NULL;
 	sdkCreateTimer(&timer);
 	sdkStartTimer(&timer);
-	
-	for(int i = 0; i < iCRows; i++) {
-		for(int j = 0; j < iCCols; j++) {
-			float sum = 0.0f;
-			for(int k = 0; k < iACols; k++) {
-				float a = A[i * iACols + k];
-				float b = B[k * iCCols + j];
-				sum += a * b;
-			}
-			C[i * iCCols + j] = sum;
-		}
-	}
-	
+
+	hostGemm(A, B, C, iCRows, iCCols, iACols);	// Packed panels, SIMD micro kernel, all CPU threads
+
 	sdkStopTimer(&timer);
 	timeOnCPU = sdkGetTimerValue(&timer);
 	sdkDeleteTimer(&timer);
@@ -312,59 +361,69 @@ void cleanup() {
 		free((void *)oclSrcCode);
 		oclSrcCode = NULL;
 	}
-	
-	if(oclKernel) {
-		clReleaseKernel(oclKernel);
-		oclKernel = NULL;
+
+	if(oclKernelNaive) {
+		clReleaseKernel(oclKernelNaive);
+		oclKernelNaive = NULL;
+	}
+
+	if(oclKernelTiled) {
+		clReleaseKernel(oclKernelTiled);
+		oclKernelTiled = NULL;
 	}
-	
+
+	if(oclKernelRegister) {
+		clReleaseKernel(oclKernelRegister);
+		oclKernelRegister = NULL;
+	}
+
 	if(oclProgram) {
 		clReleaseProgram(oclProgram);
 		oclProgram = NULL;
 	}
-	
+
 	if(oclCommandQueue) {
 		clReleaseCommandQueue(oclCommandQueue);
 		oclCommandQueue = NULL;
 	}
-	
+
 	if(oclContext) {
 		clReleaseContext(oclContext);
 		oclContext = NULL;
 	}
-	
+
 	// Free device memory
 	if(deviceA) {
 		clReleaseMemObject(deviceA);
 		deviceA = NULL;
 	}
-	
+
 	if(deviceB) {
 		clReleaseMemObject(deviceB);
 		deviceB = NULL;
 	}
-	
+
 	if(deviceC) {
 		clReleaseMemObject(deviceC);
 		deviceC = NULL;
 	}
-	
+
 	// Free host-memory
 	if(hostA) {
 		free(hostA);
 		hostA = NULL;
 	}
-	
+
 	if(hostB) {
 		free(hostB);
 		hostB = NULL;
 	}
-	
+
 	if(hostC) {
 		free(hostC);
 		hostC = NULL;
 	}
-	
+
 	if(CHost) {
 		free(CHost);
 		CHost = NULL;
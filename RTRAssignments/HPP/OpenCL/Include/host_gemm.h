@@ -0,0 +1,242 @@
+// Header file for blocked, multithreaded CPU matrix multiplication (host reference of OpenCL samples)
+// By : Darshan Vikam
+//
+// C (M x N) = A (M x K) * B (K x N), row major floats, computed as in BLIS / GotoBLAS :
+//	- K is cut in HOST_GEMM_KC deep panels and N in HOST_GEMM_NC wide panels; a panel of B is packed
+//	  into HOST_GEMM_NR wide slivers (KC x NR, stays in L1 while a sliver of A streams past it)
+//	- M is cut in HOST_GEMM_MC high blocks; a block of A is packed into HOST_GEMM_MR high slivers
+//	  (whole block, MC x KC, stays in L2)
+//	- micro kernel multiplies a sliver of A by a sliver of B into MR x NR elements of C held in registers
+// Rows of C are shared among threads, each with its own packing buffers, so threads never wait for each other.
+// Micro kernel is chosen at compile time :
+//	AVX2 + FMA	- 6 x 16 tile in 12 ymm registers (-mavx2 -mfma, or /arch:AVX2)
+//	other		- same tile in scalar code (compiler may still vectorize it)
+//=============================================================================
+
+// Header Files
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+	#define HOST_GEMM_AVX2
+	#include <immintrin.h>
+	#define HOST_GEMM_KERNEL_NAME	"AVX2/FMA"
+#else
+	#define HOST_GEMM_KERNEL_NAME	"Scalar"
+#endif
+
+#define HOST_GEMM_MR	6		// Micro tile of C
+#define HOST_GEMM_NR	16
+#ifndef HOST_GEMM_KC
+	#define HOST_GEMM_KC	384		// Depth of packed panels, KC x NR sliver of B = 24 KB (L1)
+#endif
+#ifndef HOST_GEMM_MC
+	#define HOST_GEMM_MC	72		// Packed block of A, MC x KC = 108 KB (L2), multiple of MR
+#endif
+#ifndef HOST_GEMM_NC
+	#define HOST_GEMM_NC	2048		// Packed panel of B, KC x NC = 3 MB (L3), multiple of NR
+#endif
+//=============================================================================
+
+// Micro kernel : c (MR x NR, row stride ldc) = (accumulate ? c : 0) + a sliver (kc x MR) * b sliver (kc x NR)
+static inline void hostGemmKernel(int kc, const float *a, const float *b, float *c, int ldc, bool accumulate) {
+#if defined(HOST_GEMM_AVX2)
+	// Variable declaration
+	__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+	__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+	__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+	__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+	__m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+	__m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+	__m256 b0, b1, ai;
+
+	// Code
+	for(int p = 0; p < kc; p++) {
+		b0 = _mm256_loadu_ps(b);
+		b1 = _mm256_loadu_ps(b + 8);
+		ai = _mm256_broadcast_ss(a + 0); c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+		ai = _mm256_broadcast_ss(a + 1); c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+		ai = _mm256_broadcast_ss(a + 2); c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+		ai = _mm256_broadcast_ss(a + 3); c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+		ai = _mm256_broadcast_ss(a + 4); c40 = _mm256_fmadd_ps(ai, b0, c40); c41 = _mm256_fmadd_ps(ai, b1, c41);
+		ai = _mm256_broadcast_ss(a + 5); c50 = _mm256_fmadd_ps(ai, b0, c50); c51 = _mm256_fmadd_ps(ai, b1, c51);
+		a += HOST_GEMM_MR;
+		b += HOST_GEMM_NR;
+	}
+
+	#define HOST_GEMM_STORE(row, lo, hi)											\
+		if(accumulate) {												\
+			lo = _mm256_add_ps(lo, _mm256_loadu_ps(c + (row) * ldc));						\
+			hi = _mm256_add_ps(hi, _mm256_loadu_ps(c + (row) * ldc + 8));					\
+		}														\
+		_mm256_storeu_ps(c + (row) * ldc, lo);										\
+		_mm256_storeu_ps(c + (row) * ldc + 8, hi);
+	HOST_GEMM_STORE(0, c00, c01);
+	HOST_GEMM_STORE(1, c10, c11);
+	HOST_GEMM_STORE(2, c20, c21);
+	HOST_GEMM_STORE(3, c30, c31);
+	HOST_GEMM_STORE(4, c40, c41);
+	HOST_GEMM_STORE(5, c50, c51);
+	#undef HOST_GEMM_STORE
+#else
+	// Variable declaration
+	float acc[HOST_GEMM_MR][HOST_GEMM_NR] = { { 0.0f } };
+
+	// Code
+	for(int p = 0; p < kc; p++) {
+		for(int i = 0; i < HOST_GEMM_MR; i++)
+			for(int j = 0; j < HOST_GEMM_NR; j++)
+				acc[i][j] += a[i] * b[j];
+		a += HOST_GEMM_MR;
+		b += HOST_GEMM_NR;
+	}
+	for(int i = 0; i < HOST_GEMM_MR; i++)
+		for(int j = 0; j < HOST_GEMM_NR; j++)
+			c[i * ldc + j] = (accumulate ? c[i * ldc + j] : 0.0f) + acc[i][j];
+#endif
+}
+
+// Packs mc x kc block of A (at A[i0][p0]) into MR high slivers, column by column; rows past mc are 0
+static void hostGemmPackA(const float *A, int lda, int i0, int p0, int mc, int kc, float *packed) {
+	// Code
+	for(int ir = 0; ir < mc; ir += HOST_GEMM_MR) {
+		for(int p = 0; p < kc; p++) {
+			for(int i = 0; i < HOST_GEMM_MR; i++)
+				*packed++ = (ir + i < mc) ? A[(size_t)(i0 + ir + i) * lda + p0 + p] : 0.0f;
+		}
+	}
+}
+
+// Packs kc x nc panel of B (at B[p0][j0]) into NR wide slivers, row by row; columns past nc are 0
+static void hostGemmPackB(const float *B, int ldb, int p0, int j0, int kc, int nc, float *packed) {
+	// Code
+	for(int jr = 0; jr < nc; jr += HOST_GEMM_NR) {
+		for(int p = 0; p < kc; p++) {
+			const float *row = B + (size_t)(p0 + p) * ldb + j0 + jr;
+			if(jr + HOST_GEMM_NR <= nc)
+				memcpy(packed, row, HOST_GEMM_NR * sizeof(float));
+			else {
+				for(int j = 0; j < HOST_GEMM_NR; j++)
+					packed[j] = (jr + j < nc) ? row[j] : 0.0f;
+			}
+			packed += HOST_GEMM_NR;
+		}
+	}
+}
+
+// Rows m0 .. m1 - 1 of C, on calling thread
+static void hostGemmRows(const float *A, const float *B, float *C, int m0, int m1, int N, int K) {
+	// Variable declaration
+	std::vector<float> packedA((size_t)HOST_GEMM_MC * HOST_GEMM_KC);
+	std::vector<float> packedB((size_t)HOST_GEMM_KC * (HOST_GEMM_NC + HOST_GEMM_NR));
+	float edge[HOST_GEMM_MR * HOST_GEMM_NR];
+
+	// Code
+	if(K == 0) {		// Empty product, loops below would leave C untouched
+		for(int i = m0; i < m1; i++)
+			memset(C + (size_t)i * N, 0, N * sizeof(float));
+		return;
+	}
+
+	for(int jc = 0; jc < N; jc += HOST_GEMM_NC) {
+		int nc = (N - jc < HOST_GEMM_NC) ? N - jc : HOST_GEMM_NC;
+		for(int pc = 0; pc < K; pc += HOST_GEMM_KC) {
+			int kc = (K - pc < HOST_GEMM_KC) ? K - pc : HOST_GEMM_KC;
+			bool accumulate = (pc > 0);	// First panel overwrites C
+			hostGemmPackB(B, N, pc, jc, kc, nc, packedB.data());
+
+			for(int ic = m0; ic < m1; ic += HOST_GEMM_MC) {
+				int mc = (m1 - ic < HOST_GEMM_MC) ? m1 - ic : HOST_GEMM_MC;
+				hostGemmPackA(A, K, ic, pc, mc, kc, packedA.data());
+
+				for(int jr = 0; jr < nc; jr += HOST_GEMM_NR) {
+					int nr = (nc - jr < HOST_GEMM_NR) ? nc - jr : HOST_GEMM_NR;
+					const float *b = packedB.data() + (size_t)jr * kc;
+					for(int ir = 0; ir < mc; ir += HOST_GEMM_MR) {
+						int mr = (mc - ir < HOST_GEMM_MR) ? mc - ir : HOST_GEMM_MR;
+						const float *a = packedA.data() + (size_t)ir * kc;
+						float *c = C + (size_t)(ic + ir) * N + jc + jr;
+						if(mr == HOST_GEMM_MR && nr == HOST_GEMM_NR)
+							hostGemmKernel(kc, a, b, c, N, accumulate);
+						else {		// Edge tile : full tile into 'edge', only valid part to C
+							hostGemmKernel(kc, a, b, edge, HOST_GEMM_NR, false);
+							for(int i = 0; i < mr; i++)
+								for(int j = 0; j < nr; j++)
+									c[(size_t)i * N + j] = (accumulate ? c[(size_t)i * N + j] : 0.0f) + edge[i * HOST_GEMM_NR + j];
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// Number of threads hostGemm() uses
+static inline int hostGemmThreads(void) {
+	// Variable declaration
+	unsigned int numThreads = std::thread::hardware_concurrency();
+
+	// Code
+	return (numThreads > 0) ? (int)numThreads : 1;
+}
+
+// C (M x N) = A (M x K) * B (K x N); rows of C are split among threads in multiples of MR
+void hostGemm(const float *A, const float *B, float *C, int M, int N, int K) {
+	// Variable declaration
+	int numThreads = hostGemmThreads();
+	int rowsPerThread;
+	std::vector<std::thread> threads;
+
+	// Code
+	if((long long)M * N * K < 64 * 64 * 64)		// Threads cost more than they save
+		numThreads = 1;
+	rowsPerThread = (M + numThreads - 1) / numThreads;
+	rowsPerThread = ((rowsPerThread + HOST_GEMM_MR - 1) / HOST_GEMM_MR) * HOST_GEMM_MR;
+
+	for(int m0 = rowsPerThread; m0 < M; m0 += rowsPerThread)		// Calling thread takes first slice
+		threads.push_back(std::thread(hostGemmRows, A, B, C, m0, (m0 + rowsPerThread < M) ? m0 + rowsPerThread : M, N, K));
+	hostGemmRows(A, B, C, 0, (rowsPerThread < M) ? rowsPerThread : M, N, K);
+	for(size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+}
+
+// Internal : one thread of hostGemmPeakGflops()
+static void hostGemmPeakThread(double *gflops) {
+	// Variable declaration
+	std::vector<float> a((size_t)HOST_GEMM_MR * HOST_GEMM_KC, 0.5f);
+	std::vector<float> b((size_t)HOST_GEMM_KC * HOST_GEMM_NR, 0.25f);
+	float c[HOST_GEMM_MR * HOST_GEMM_NR];
+	const int iterations = 65536;		// Tens of milliseconds, so all threads overlap
+	double seconds;
+
+	// Code
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int i = 0; i < iterations; i++)
+		hostGemmKernel(HOST_GEMM_KC, a.data(), b.data(), c, HOST_GEMM_NR, i > 0);
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	*gflops = (2.0 * HOST_GEMM_MR * HOST_GEMM_NR * HOST_GEMM_KC * iterations) / (seconds * 1.0e9);
+	if(c[0] < 0.0f)		// Never true; keeps compiler from dropping the loop
+		*gflops = 0.0;
+}
+
+// Micro kernel throughput of all threads together on data in L1, in GFLOPS : practical peak for hostGemm()
+double hostGemmPeakGflops(void) {
+	// Variable declaration
+	int numThreads = hostGemmThreads();
+	std::vector<std::thread> threads;
+	std::vector<double> gflops(numThreads, 0.0);
+	double total = 0.0;
+
+	// Code
+	for(int t = 0; t < numThreads; t++)
+		threads.push_back(std::thread(hostGemmPeakThread, &gflops[t]));
+	for(int t = 0; t < numThreads; t++) {
+		threads[t].join();
+		total += gflops[t];
+	}
+	return total;
+}
+//=============================================================================
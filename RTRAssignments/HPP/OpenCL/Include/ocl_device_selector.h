@@ -0,0 +1,64 @@
+// Header file for OpenCL device selection
+// By : Darshan Vikam
+//
+// Looks through every platform, so a machine without GPU can run samples on a CPU device (e.g. PoCL).
+// Preference (usually 1st command line argument) :
+//	"gpu"	- GPU devices only
+//	"cpu"	- CPU devices only
+//	other	- first GPU, else first CPU, else any other device
+//=============================================================================
+
+// Header Files
+#include <stdio.h>
+#include <string.h>
+#include <CL/opencl.h>
+//=============================================================================
+
+// Returns CL_SUCCESS and selected device (with its platform), or CL_DEVICE_NOT_FOUND
+cl_int selectOCLDevice(const char *preference, cl_platform_id *platformId, cl_device_id *deviceId) {
+	// Variable declaration
+	cl_platform_id platforms[16];
+	cl_uint numPlatforms = 0;
+	cl_device_type types[3] = { CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_CPU, CL_DEVICE_TYPE_ALL };
+	int numTypes = 3;
+	cl_int ret;
+
+	// Code
+	ret = clGetPlatformIDs(16, platforms, &numPlatforms);
+	if(ret != CL_SUCCESS)
+		return ret;
+	if(numPlatforms > 16)
+		numPlatforms = 16;
+
+	if(preference != NULL && strcmp(preference, "gpu") == 0)
+		numTypes = 1;
+	else if(preference != NULL && strcmp(preference, "cpu") == 0) {
+		types[0] = CL_DEVICE_TYPE_CPU;
+		numTypes = 1;
+	}
+
+	for(int t = 0; t < numTypes; t++) {		// Every platform is asked for a type before next type is tried
+		for(cl_uint p = 0; p < numPlatforms; p++) {
+			if(clGetDeviceIDs(platforms[p], types[t], 1, deviceId, NULL) == CL_SUCCESS) {
+				*platformId = platforms[p];
+				return CL_SUCCESS;
+			}
+		}
+	}
+	return CL_DEVICE_NOT_FOUND;
+}
+
+// Prints "<device name> (<platform name>, <device type>)"
+void printOCLDevice(FILE *fp, cl_platform_id platformId, cl_device_id deviceId) {
+	// Variable declaration
+	char deviceName[256] = "";
+	char platformName[256] = "";
+	cl_device_type type = 0;
+
+	// Code
+	clGetDeviceInfo(deviceId, CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+	clGetDeviceInfo(deviceId, CL_DEVICE_TYPE, sizeof(type), &type, NULL);
+	clGetPlatformInfo(platformId, CL_PLATFORM_NAME, sizeof(platformName), platformName, NULL);
+	fprintf(fp, "%s (%s, %s) \n", deviceName, platformName, (type & CL_DEVICE_TYPE_GPU) ? "GPU" : ((type & CL_DEVICE_TYPE_CPU) ? "CPU" : "other"));
+}
+//=============================================================================
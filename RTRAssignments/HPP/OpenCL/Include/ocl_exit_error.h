@@ -5,7 +5,7 @@
 // Header Files
 #include <stdio.h>
 #include <stdlib.h>
-#include <Cl/opencl.h>
+#include <CL/opencl.h>
 //=============================================================================
 
 void exit_error(char *err_msg) {
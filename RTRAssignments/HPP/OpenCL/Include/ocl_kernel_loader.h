@@ -1,5 +1,45 @@
 // Header file for OpenCL
 // By : Darshan Vikam
+//
+// loadOCLProgram() reads kernel source; buildOCLProgramCached() builds it through a binary cache :
+// key is 64 bit FNV-1a hash of source (with preamble), build options and device / driver identity,
+// a hit creates program from OCLCache/<key>.bin with clCreateProgramWithBinary(), a miss builds from
+// source and stores CL_PROGRAM_BINARIES (written to a temporary file and renamed, so a file is either
+// complete or absent). Files with bad header, size or checksum, or refused by driver, are deleted.
+//=============================================================================
+
+// Header Files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#ifdef _WIN32
+	#include <direct.h>	// _mkdir()
+#else
+	#include <sys/stat.h>	// mkdir()
+#endif
+#include <CL/opencl.h>
+//=============================================================================
+
+#define OCL_CACHE_DIR		"OCLCache"
+#define OCL_CACHE_MAGIC		0x4C435644	// "DVCL"
+#define OCL_CACHE_VERSION	1
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint64_t length;		// Bytes of binary after header
+	uint64_t checksum;		// FNV-1a of binary
+} OCLCacheFileHeader;
+
+typedef struct {
+	bool hit;			// Program came from cache file
+	bool stored;			// Miss whose binary was written to cache
+	uint64_t key;
+} OCLBuildInfo;
+//=============================================================================
 
 // Function to load OpenCL Kernel program as an array of strings.
 char *loadOCLProgram(const char *filename, const char *preamble, size_t *finalLength) {
@@ -33,3 +73,191 @@ char *loadOCLProgram(const char *filename, const char *preamble, size_t *finalLe
 
 	return srcString;
 }
+//-----------------------------------------------------------------------------
+
+uint64_t oclCacheHash(uint64_t hash, const void *data, size_t size) {
+	// Variable declaration
+	const unsigned char *bytes = (const unsigned char *)data;
+
+	// Code
+	for(size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;		// FNV-1a 64 bit prime
+	}
+	return hash;
+}
+
+uint64_t oclCacheHashString(uint64_t hash, const char *string) {
+	// Code
+	if(string == NULL)
+		string = "";
+	return oclCacheHash(hash, string, strlen(string) + 1);	// Terminator too, so "ab"+"c" differs from "a"+"bc"
+}
+
+uint64_t oclCacheHashDeviceInfo(uint64_t hash, cl_device_id deviceId, cl_device_info param) {
+	// Variable declaration
+	char info[256] = "";
+
+	// Code
+	clGetDeviceInfo(deviceId, param, sizeof(info) - 1, info, NULL);
+	return oclCacheHashString(hash, info);
+}
+//-----------------------------------------------------------------------------
+
+// Prints build log of 'program' for 'deviceId', whatever its length
+void printOCLBuildLog(FILE *fp, cl_program program, cl_device_id deviceId) {
+	// Variable declaration
+	size_t len = 0;
+	char *buffer = NULL;
+
+	// Code
+	if(clGetProgramBuildInfo(program, deviceId, CL_PROGRAM_BUILD_LOG, 0, NULL, &len) != CL_SUCCESS || len == 0)
+		return;
+	buffer = (char *)malloc(len + 1);
+	if(buffer == NULL)
+		return;
+	if(clGetProgramBuildInfo(program, deviceId, CL_PROGRAM_BUILD_LOG, len, buffer, NULL) == CL_SUCCESS) {
+		buffer[len] = '\0';
+		fprintf(fp, "%s\n", buffer);
+	}
+	free(buffer);
+}
+//-----------------------------------------------------------------------------
+
+// Internal : program from cache file, NULL if there is no usable file (an unusable one is deleted)
+cl_program oclCacheLoad(cl_context context, cl_device_id deviceId, const char *options, uint64_t key, const char *path) {
+	// Variable declaration
+	FILE *fp = NULL;
+	OCLCacheFileHeader header;
+	unsigned char *binary = NULL;
+	cl_program program = NULL;
+	cl_int ret, binaryStatus;
+	bool corrupt = true;
+
+	// Code
+	fp = fopen(path, "rb");
+	if(fp == NULL)
+		return NULL;
+	if(fread(&header, sizeof(header), 1, fp) == 1 && header.magic == OCL_CACHE_MAGIC && header.version == OCL_CACHE_VERSION &&
+		header.key == key && header.length > 0 && (binary = (unsigned char *)malloc((size_t)header.length)) != NULL) {
+		if(fread(binary, 1, (size_t)header.length, fp) == (size_t)header.length && fgetc(fp) == EOF &&
+			oclCacheHash(0xcbf29ce484222325ull, binary, (size_t)header.length) == header.checksum)
+			corrupt = false;
+	}
+	fclose(fp);
+
+	if(corrupt == false) {
+		size_t length = (size_t)header.length;
+		program = clCreateProgramWithBinary(context, 1, &deviceId, &length, (const unsigned char **)&binary, &binaryStatus, &ret);
+		if(ret == CL_SUCCESS && binaryStatus == CL_SUCCESS)
+			ret = clBuildProgram(program, 1, &deviceId, options, NULL, NULL);	// Still needed, but only links
+		else if(ret == CL_SUCCESS)
+			ret = binaryStatus;
+		if(ret != CL_SUCCESS && program) {	// Driver changed without changing its version strings, or refused binary
+			clReleaseProgram(program);
+			program = NULL;
+		}
+	}
+	free(binary);
+
+	if(program == NULL)
+		remove(path);
+	return program;
+}
+
+// Internal : stores binary of a built program; returns false if driver gives no binary or file cannot be written
+bool oclCacheStore(cl_program program, uint64_t key, const char *path) {
+	// Variable declaration
+	OCLCacheFileHeader header;
+	size_t length = 0;
+	unsigned char *binary = NULL;
+	char tempPath[300];
+	FILE *fp = NULL;
+	bool written = false;
+
+	// Code
+	if(clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(length), &length, NULL) != CL_SUCCESS || length == 0)
+		return false;
+	binary = (unsigned char *)malloc(length);
+	if(binary == NULL)
+		return false;
+	if(clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binary), &binary, NULL) != CL_SUCCESS) {	// Array of 1 pointer
+		free(binary);
+		return false;
+	}
+
+	header.magic = OCL_CACHE_MAGIC;
+	header.version = OCL_CACHE_VERSION;
+	header.key = key;
+	header.length = length;
+	header.checksum = oclCacheHash(0xcbf29ce484222325ull, binary, length);
+
+	sprintf(tempPath, "%s.tmp", path);
+	fp = fopen(tempPath, "wb");
+	if(fp != NULL) {
+		written = (fwrite(&header, sizeof(header), 1, fp) == 1) && (fwrite(binary, 1, length, fp) == length);
+		written = (fclose(fp) == 0) && written;
+	}
+	free(binary);
+
+	if(written && rename(tempPath, path) != 0) {
+		remove(path);			// Windows rename() does not replace an existing file
+		written = (rename(tempPath, path) == 0);
+	}
+	if(written == false)
+		remove(tempPath);
+	return written;
+}
+
+// Builds 'source' (as returned by loadOCLProgram()) for 'deviceId' through cache; 'info' tells hit or miss.
+// Returns NULL with error in *ret if program cannot be built; build log is printed to stdout then.
+cl_program buildOCLProgramCached(cl_context context, cl_device_id deviceId, const char *source, const char *options, OCLBuildInfo *info, cl_int *ret) {
+	// Variable declaration
+	uint64_t key = 0xcbf29ce484222325ull;		// FNV-1a 64 bit offset basis
+	char path[256];
+	cl_program program = NULL;
+	bool cacheDir;
+
+	// Code
+	if(options == NULL)
+		options = "";
+	key = oclCacheHashString(key, source);
+	key = oclCacheHashString(key, options);
+	key = oclCacheHashDeviceInfo(key, deviceId, CL_DEVICE_NAME);
+	key = oclCacheHashDeviceInfo(key, deviceId, CL_DEVICE_VENDOR);
+	key = oclCacheHashDeviceInfo(key, deviceId, CL_DEVICE_VERSION);
+	key = oclCacheHashDeviceInfo(key, deviceId, CL_DRIVER_VERSION);
+	info->hit = false;
+	info->stored = false;
+	info->key = key;
+
+#ifdef _WIN32
+	cacheDir = (_mkdir(OCL_CACHE_DIR) == 0 || errno == EEXIST);
+#else
+	cacheDir = (mkdir(OCL_CACHE_DIR, 0755) == 0 || errno == EEXIST);
+#endif
+	sprintf(path, "%s/%016llx.bin", OCL_CACHE_DIR, (unsigned long long)key);
+
+	if(cacheDir) {
+		program = oclCacheLoad(context, deviceId, options, key, path);
+		if(program) {
+			info->hit = true;
+			*ret = CL_SUCCESS;
+			return program;
+		}
+	}
+
+	program = clCreateProgramWithSource(context, 1, &source, NULL, ret);
+	if(*ret != CL_SUCCESS)
+		return NULL;
+	*ret = clBuildProgram(program, 1, &deviceId, options, NULL, NULL);
+	if(*ret != CL_SUCCESS) {
+		printOCLBuildLog(stdout, program, deviceId);
+		clReleaseProgram(program);
+		return NULL;
+	}
+	if(cacheDir)
+		info->stored = oclCacheStore(program, key, path);
+	return program;
+}
+//=============================================================================
@@ -0,0 +1,225 @@
+// Header file for OpenCL event profiling
+// By : Darshan Vikam
+//
+// Device side timing of writes, kernels and reads from their events, instead of a host timer around clFinish().
+// Queue must be created with CL_QUEUE_PROFILING_ENABLE and every timed command given an event. Usage :
+//	int e = oclProfilerAdd(&profiler, "tiled N=1024", OCL_PROFILE_KERNEL, 0.0, flops);
+//	for(int run = 0; run < warmupRuns + runs; run++) {
+//		clEnqueueNDRangeKernel(..., &event);
+//		oclProfilerRecord(&profiler, e, run, event);	// Warm up runs are dropped
+//		clReleaseEvent(event);
+//	}
+//	oclProfilerWriteCSV(&profiler, "Profile.csv", "MatMul", deviceId);
+// Every entry gets min / median / p95 of queued->submit, submit->start and start->end (ms), and bandwidth or
+// FLOP rate at median start->end. CSV has a header line and one row per entry.
+//=============================================================================
+
+// Header Files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CL/opencl.h>
+//=============================================================================
+
+#define OCL_PROFILE_MAX_ENTRIES	128
+#define OCL_PROFILE_MAX_RUNS	64
+
+typedef enum {
+	OCL_PROFILE_WRITE,
+	OCL_PROFILE_KERNEL,
+	OCL_PROFILE_READ,
+	OCL_PROFILE_MAP,
+	OCL_PROFILE_SPAN		// First command queued to last command finished, e.g. writes + kernel + read
+} OCLProfileKind;
+
+typedef struct {
+	char name[64];
+	OCLProfileKind kind;
+	double bytes;			// Moved per run, 0 if not relevant
+	double flops;			// Floating point operations per run, 0 if not relevant
+	int numRuns;
+	double queuedToSubmit[OCL_PROFILE_MAX_RUNS];	// ms
+	double submitToStart[OCL_PROFILE_MAX_RUNS];
+	double startToEnd[OCL_PROFILE_MAX_RUNS];
+} OCLProfileEntry;
+
+typedef struct {
+	int warmupRuns;			// Runs below this index are not recorded
+	int numEntries;
+	OCLProfileEntry entry[OCL_PROFILE_MAX_ENTRIES];
+} OCLProfiler;
+
+typedef struct {
+	double min, median, p95;
+} OCLProfileStats;
+//=============================================================================
+
+void oclProfilerInit(OCLProfiler *profiler, int warmupRuns) {
+	// Code
+	profiler->warmupRuns = warmupRuns;
+	profiler->numEntries = 0;
+}
+
+// Returns index of new entry, or -1 if profiler is full (recording into -1 does nothing)
+int oclProfilerAdd(OCLProfiler *profiler, const char *name, OCLProfileKind kind, double bytes, double flops) {
+	// Variable declaration
+	OCLProfileEntry *entry;
+
+	// Code
+	if(profiler->numEntries >= OCL_PROFILE_MAX_ENTRIES)
+		return -1;
+	entry = &profiler->entry[profiler->numEntries];
+	strncpy(entry->name, name, sizeof(entry->name) - 1);
+	entry->name[sizeof(entry->name) - 1] = '\0';
+	entry->kind = kind;
+	entry->bytes = bytes;
+	entry->flops = flops;
+	entry->numRuns = 0;
+	return profiler->numEntries++;
+}
+
+// Records one run given as durations in ms (e.g. sums over chunks of a run)
+void oclProfilerRecordTimes(OCLProfiler *profiler, int index, int run, double queuedToSubmit, double submitToStart, double startToEnd) {
+	// Variable declaration
+	OCLProfileEntry *entry;
+
+	// Code
+	if(index < 0 || index >= profiler->numEntries || run < profiler->warmupRuns)
+		return;
+	entry = &profiler->entry[index];
+	if(entry->numRuns >= OCL_PROFILE_MAX_RUNS)
+		return;
+	entry->queuedToSubmit[entry->numRuns] = queuedToSubmit;
+	entry->submitToStart[entry->numRuns] = submitToStart;
+	entry->startToEnd[entry->numRuns] = startToEnd;
+	entry->numRuns++;
+}
+
+// Records timestamps from 'first' (queued, submit, start) to latest end of 'numLast' events in 'last', which may
+// be on different queues of same device; waits for all of them. Events stay owned by caller.
+cl_int oclProfilerRecordSpanEvents(OCLProfiler *profiler, int index, int run, cl_event first, int numLast, const cl_event *last) {
+	// Variable declaration
+	cl_ulong queued = 0, submit = 0, start = 0, end = 0, lastEnd = 0;
+	cl_int ret;
+
+	// Code
+	ret = clWaitForEvents(numLast, last);
+	if(ret != CL_SUCCESS)
+		return ret;
+	if(index < 0 || index >= profiler->numEntries || run < profiler->warmupRuns)
+		return CL_SUCCESS;
+
+	ret = clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &queued, NULL);
+	ret |= clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &submit, NULL);
+	ret |= clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+	for(int i = 0; i < numLast; i++) {
+		ret |= clGetEventProfilingInfo(last[i], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+		if(end > lastEnd)
+			lastEnd = end;
+	}
+	if(ret != CL_SUCCESS)		// Queue without CL_QUEUE_PROFILING_ENABLE
+		return ret;
+
+	oclProfilerRecordTimes(profiler, index, run, (double)(submit - queued) / 1000000.0, (double)(start - submit) / 1000000.0,
+		(double)(lastEnd - start) / 1000000.0);
+	return CL_SUCCESS;
+}
+
+// Records timestamps from 'first' (queued, submit, start) and 'last' (end); waits for 'last' to finish.
+cl_int oclProfilerRecordSpan(OCLProfiler *profiler, int index, int run, cl_event first, cl_event last) {
+	// Code
+	return oclProfilerRecordSpanEvents(profiler, index, run, first, 1, &last);
+}
+
+// Records timestamps of one command
+cl_int oclProfilerRecord(OCLProfiler *profiler, int index, int run, cl_event event) {
+	// Code
+	return oclProfilerRecordSpan(profiler, index, run, event, event);
+}
+//=============================================================================
+
+int oclProfileCompare(const void *a, const void *b) {
+	// Code
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+// Min, median and p95 (nearest rank) of 'count' values
+OCLProfileStats oclProfileStats(const double *values, int count) {
+	// Variable declaration
+	double sorted[OCL_PROFILE_MAX_RUNS];
+	OCLProfileStats stats = { 0.0, 0.0, 0.0 };
+	int rank;
+
+	// Code
+	if(count <= 0)
+		return stats;
+	memcpy(sorted, values, count * sizeof(double));
+	qsort(sorted, count, sizeof(double), oclProfileCompare);
+
+	rank = (95 * count + 99) / 100;		// ceil(0.95 * count)
+	stats.min = sorted[0];
+	stats.median = (count % 2) ? sorted[count / 2] : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+	stats.p95 = sorted[rank - 1];
+	return stats;
+}
+
+// Median start->end of an entry in ms, 0 if nothing recorded
+double oclProfilerMedian(const OCLProfiler *profiler, int index) {
+	// Code
+	if(index < 0 || index >= profiler->numEntries)
+		return 0.0;
+	return oclProfileStats(profiler->entry[index].startToEnd, profiler->entry[index].numRuns).median;
+}
+//=============================================================================
+
+const char *oclProfileKindName(OCLProfileKind kind) {
+	// Code
+	switch(kind) {
+		case OCL_PROFILE_WRITE:		return "write";
+		case OCL_PROFILE_KERNEL:	return "kernel";
+		case OCL_PROFILE_READ:		return "read";
+		case OCL_PROFILE_MAP:		return "map";
+		default:			return "span";
+	}
+}
+
+// Writes header and one row per entry to 'path'. Returns 0 on failure.
+int oclProfilerWriteCSV(const OCLProfiler *profiler, const char *path, const char *sample, cl_device_id deviceId) {
+	// Variable declaration
+	char deviceName[256] = "";
+	FILE *fp = NULL;
+	OCLProfileStats q, s, e;
+
+	// Code
+	fp = fopen(path, "w");
+	if(fp == NULL)
+		return 0;
+	clGetDeviceInfo(deviceId, CL_DEVICE_NAME, sizeof(deviceName), deviceName, NULL);
+	for(char *c = deviceName; *c; c++)		// Keep CSV columns intact
+		if(*c == ',' || *c == '"')
+			*c = ' ';
+
+	fprintf(fp, "sample,device,name,kind,runs,"
+		"queued_submit_min_ms,queued_submit_median_ms,queued_submit_p95_ms,"
+		"submit_start_min_ms,submit_start_median_ms,submit_start_p95_ms,"
+		"start_end_min_ms,start_end_median_ms,start_end_p95_ms,"
+		"bytes,flops,gb_per_s,gflops\n");
+
+	for(int i = 0; i < profiler->numEntries; i++) {
+		const OCLProfileEntry *entry = &profiler->entry[i];
+		q = oclProfileStats(entry->queuedToSubmit, entry->numRuns);
+		s = oclProfileStats(entry->submitToStart, entry->numRuns);
+		e = oclProfileStats(entry->startToEnd, entry->numRuns);
+		fprintf(fp, "%s,%s,%s,%s,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.0f,%.0f,%.3f,%.3f\n",
+			sample, deviceName, entry->name, oclProfileKindName(entry->kind), entry->numRuns,
+			q.min, q.median, q.p95, s.min, s.median, s.p95, e.min, e.median, e.p95,
+			entry->bytes, entry->flops,
+			(e.median > 0.0) ? entry->bytes / (e.median * 1.0e6) : 0.0,	// bytes / ms / 1e6 = GB/s
+			(e.median > 0.0) ? entry->flops / (e.median * 1.0e6) : 0.0);
+	}
+	fclose(fp);
+	return 1;
+}
+//=============================================================================
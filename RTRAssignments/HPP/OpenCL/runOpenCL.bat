@@ -12,7 +12,7 @@ IF EXIST *.txt  ( del *.txt )
 @echo on
 
 :: Compile the OpenCL application
-cl.exe /c /EHsc %2.%3
+cl.exe /c /EHsc /O2 /arch:AVX2 %2.%3
 	@echo off
 	if NOT %errorlevel% == 0 ( goto :end )
 	@echo on
@@ -12,6 +12,7 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
+#include "../../ProgramablePipeline/Include/FrameScheduler.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -32,6 +33,8 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 GLfloat gGLfAngle = 0.0f;
+GLfloat gGLfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 
 
 // Entry point function
@@ -42,7 +45,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -157,8 +160,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -266,6 +272,8 @@ void Initialize(void) {
 	// Code
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
+
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
 	
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	Resize(giWindowWidth, giWindowHeight);
@@ -284,6 +292,9 @@ void Resize(int width, int height) {
 }
 
 void display(void) {
+	// Variable declaration
+	GLfloat angle = frameSchedulerLerpAngle(gGLfPrevAngle, gGLfAngle, gScheduler.alpha);
+
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT);
 
@@ -291,7 +302,7 @@ void display(void) {
 	glLoadIdentity();
 
 	glTranslatef(0.0f, 0.0f, -3.0f);
-	glRotatef(gGLfAngle, 0.0f, 1.0f, 0.0f);
+	glRotatef(angle, 0.0f, 1.0f, 0.0f);
 
 	glBegin(GL_TRIANGLES);
 	glColor3f(1.0f, 0.0f, 0.0f);
@@ -305,11 +316,12 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
-	gGLfAngle += 1.0f;
+	gGLfPrevAngle = gGLfAngle;
+	gGLfAngle += 60.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
+		gGLfAngle -= 360.0f;
 }
 
 void Uninitialize() {
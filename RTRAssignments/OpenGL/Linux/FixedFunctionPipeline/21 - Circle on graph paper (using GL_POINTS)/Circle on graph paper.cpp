@@ -13,6 +13,7 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
+#include "../Include/PrimitiveCache.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -33,6 +34,9 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 
+PrimitiveLists gPrimitives;	// Unit circle, compiled once
+GLuint gCircle;
+
 // Entry point function
 int main() {
 	// Function declaration
@@ -226,6 +230,8 @@ void Initialize(void) {
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
 	
+	gCircle = primitiveListCircle(&gPrimitives, 360000, 0.0f, GL_POINTS);	// One point every 0.001 degree
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	Resize(giWindowWidth, giWindowHeight);
 }
@@ -244,7 +250,7 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
-	float i, radius, pi;
+	float i;
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -285,14 +291,9 @@ void display(void) {
 		glVertex3f(0.0f, 2.0f, 0.0f);
 	glEnd();
 
-	radius = 1.0f;
-	pi = (22.0/7.0)/180.0;
 	glPointSize(1);
-	glBegin(GL_POINTS);			// hollow circle - using points
-	glColor3f(1.0f, 1.0f, 0.0f);
-		for(i=0.0f; i<360.0f; i+=0.001f)
-			glVertex3f((GLfloat)(radius*cos(i*pi)), (GLfloat)(radius*sin(i*pi)), 0.0f);
-	glEnd();
+	glColor3f(1.0f, 1.0f, 0.0f);		// hollow circle - using points
+	primitiveListDraw(gCircle, 0.0f, 0.0f, 1.0f);
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
@@ -306,6 +307,8 @@ void Uninitialize() {
 	GLXContext currentGLXContext;
 	
 	// Code
+	primitiveListsDelete(&gPrimitives);
+
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
 		glXMakeCurrent(gpDisplay, 0, 0);
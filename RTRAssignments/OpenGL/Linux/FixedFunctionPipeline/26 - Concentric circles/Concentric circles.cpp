@@ -13,6 +13,7 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
+#include "../Include/PrimitiveCache.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -33,6 +34,9 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 
+PrimitiveLists gPrimitives;	// Unit circle, compiled once and scaled for every ring
+GLuint gCircle;
+
 // Entry point function
 int main() {
 	// Function declaration
@@ -226,6 +230,8 @@ void Initialize(void) {
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
 	
+	gCircle = primitiveListCircle(&gPrimitives, 36000, 0.0f, GL_LINES);	// One vertex every 0.01 degree
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	Resize(giWindowWidth, giWindowHeight);
 }
@@ -244,7 +250,7 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
-	float i, radius, pi;
+	float radius;
 	int color;
 
 	// Code
@@ -254,9 +260,7 @@ void display(void) {
 	glLoadIdentity();
 	glTranslatef(0.0f, 0.0f, -3.0f);
 
-	pi = (22.0/7.0)/180.0;
 	glPointSize(1);
-	glBegin(GL_LINES);			// hollow triangle - using lines
 	for(radius = 1.0f, color = 1; radius > 0.0f; radius -= 0.1f, color++) {
 		switch(color) {
 			case 1 :
@@ -290,10 +294,8 @@ void display(void) {
 				glColor3f(0.0f, 0.5f, 1.0f);
 				break;
 		}
-		for(i=0.0f; i<360.0f; i+=0.01f)
-			glVertex3f((GLfloat)(radius*cos(i*pi)), (GLfloat)(radius*sin(i*pi)), 0.0f);
+		primitiveListDraw(gCircle, 0.0f, 0.0f, radius);	// hollow circle - using lines
 	}
-	glEnd();
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
@@ -307,6 +309,8 @@ void Uninitialize() {
 	GLXContext currentGLXContext;
 	
 	// Code
+	primitiveListsDelete(&gPrimitives);
+
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
 		glXMakeCurrent(gpDisplay, 0, 0);
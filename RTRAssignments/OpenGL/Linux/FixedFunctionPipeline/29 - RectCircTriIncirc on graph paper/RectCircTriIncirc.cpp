@@ -13,6 +13,7 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
+#include "../Include/PrimitiveCache.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -33,6 +34,10 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 
+PrimitiveLists gPrimitives;	// Unit circle and triangle, compiled once
+GLuint gCircle, gTriangle;
+GLfloat gInCircleCenter[2], gInCircleRadius;	// For triangle inscribed in unit circle
+
 // Entry point function
 int main() {
 	// Function declaration
@@ -222,10 +227,20 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	
+	// Variable declaration
+	const GLfloat rad = M_PI / 180.0f;
+	const GLfloat apex[] = { 0.0f, 1.0f };
+	const GLfloat left[] = { (GLfloat)cos(210.0f * rad), (GLfloat)sin(210.0f * rad) };
+	const GLfloat right[] = { (GLfloat)cos(330.0f * rad), (GLfloat)sin(330.0f * rad) };
+
 	// Code
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
 	
+	gCircle = primitiveListCircle(&gPrimitives, 360000, 0.0f, GL_POINTS);	// One point every 0.001 degree
+	gTriangle = primitiveListCircle(&gPrimitives, 3, 90.0f, GL_LINE_LOOP);	// Apex on top
+	triangleIncircle(apex, left, right, gInCircleCenter, &gInCircleRadius);
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	Resize(giWindowWidth, giWindowHeight);
 }
@@ -244,8 +259,7 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
-	float i, radius = 1.5f, inRadius;
-	const float rad = (22.0/7.0)/180.0;
+	float i, radius = 1.5f;
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -299,29 +313,10 @@ void display(void) {
 	glEnd();
 
 	glPointSize(1);
-	glBegin(GL_POINTS);			// Circle
 	glColor3f(1.0f, 1.0f, 0.0f);
-	for(i=0.0f; i<360.0f; i+=0.001f)
-	glVertex3f((GLfloat)(radius*cos(i*rad)), (GLfloat)(radius*sin(i*rad)), 0.0f);
-	glEnd();
-
-	glBegin(GL_LINES);			// Inner triangle
-	glColor3f(1.0f, 1.0f, 0.0f);
-	glVertex3f(0.0f, radius, 0.0f);
-	glVertex3f((GLfloat)(radius*cos(210*rad)), (GLfloat)(radius*sin(210*rad)), 0.0f);
-	glVertex3f((GLfloat)(radius*cos(210*rad)), (GLfloat)(radius*sin(210*rad)), 0.0f);
-	glVertex3f((GLfloat)(radius*cos(330*rad)), (GLfloat)(radius*sin(330*rad)), 0.0f);
-	glVertex3f((GLfloat)(radius*cos(330*rad)), (GLfloat)(radius*sin(330*rad)), 0.0f);
-	glVertex3f(0.0f, radius, 0.0f);
-	glEnd();
-
-	glPointSize(1);
-	inRadius = radius / 2.0f;
-	glBegin(GL_POINTS);			// InCircle
-	glColor3f(1.0f, 1.0f, 0.0f);
-	for(i=0.0f; i<360.0f; i+=0.001f)
-		glVertex3f((GLfloat)(inRadius*cos(i*rad)), (GLfloat)(inRadius*sin(i*rad)), 0.0f);
-	glEnd();
+	primitiveListDraw(gCircle, 0.0f, 0.0f, radius);		// Circle
+	primitiveListDraw(gTriangle, 0.0f, 0.0f, radius);	// Inner triangle
+	primitiveListDraw(gCircle, radius * gInCircleCenter[0], radius * gInCircleCenter[1], radius * gInCircleRadius);	// InCircle
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
@@ -335,6 +330,8 @@ void Uninitialize() {
 	GLXContext currentGLXContext;
 	
 	// Code
+	primitiveListsDelete(&gPrimitives);
+
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
 		glXMakeCurrent(gpDisplay, 0, 0);
@@ -13,6 +13,7 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
+#include "../../ProgramablePipeline/Include/FrameScheduler.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -33,6 +34,8 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 GLfloat gGLfAngle = 0.0f;
+GLfloat gGLfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 GLfloat identityMatrix[16];
 GLfloat translationMatrix[16];
 GLfloat scaleMatrix[16];
@@ -46,7 +49,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -121,8 +124,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -235,6 +241,8 @@ void Initialize(void) {
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	my_glIdentity(identityMatrix);
 	my_glTranslate(translationMatrix, 0.0f, 0.0f, -5.0f);
 	my_glScale(scaleMatrix, 0.75f, 0.75f, 0.75f);
@@ -265,6 +273,9 @@ void display(void) {
 	// Function declaration
 	void my_glRotation(GLfloat, float, float ,float);
 	
+	// Variable declaration
+	GLfloat angle = frameSchedulerLerpAngle(gGLfPrevAngle, gGLfAngle, gScheduler.alpha);
+
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -279,9 +290,9 @@ void display(void) {
 
 	glMultMatrixf(translationMatrix);
 	glMultMatrixf(scaleMatrix);
-	my_glRotation(gGLfAngle, 1.0f, 0.0f, 0.0f);
-	my_glRotation(gGLfAngle, 0.0f, 1.0f, 0.0f);
-	my_glRotation(gGLfAngle, 0.0f, 0.0f, 1.0f);
+	my_glRotation(angle, 1.0f, 0.0f, 0.0f);
+	my_glRotation(angle, 0.0f, 1.0f, 0.0f);
+	my_glRotation(angle, 0.0f, 0.0f, 1.0f);
 
 	glBegin(GL_QUADS);
 	glColor3f(1.0f, 0.0f, 0.0f);		// Front face
@@ -324,11 +335,12 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
-	gGLfAngle += 0.5f;
+	gGLfPrevAngle = gGLfAngle;
+	gGLfAngle += 30.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
+		gGLfAngle -= 360.0f;
 }
 
 void Uninitialize() {
@@ -12,6 +12,7 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
+#include "../../ProgramablePipeline/Include/FrameScheduler.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -32,6 +33,7 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 GLfloat gGLfAngle = 0.0f;
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 bool gbLight = false;
 
 GLfloat lightAmbientZero[] = {0.0f, 0.0f, 0.0f, 1.0f};
@@ -57,6 +59,7 @@ GLfloat materialShininess = 128.0f;
 float lightAngle0 = 0.0f;
 float lightAngle1 = 0.0f;
 float lightAngle2 = 0.0f;
+float prevLightAngle0 = 0.0f, prevLightAngle1 = 0.0f, prevLightAngle2 = 0.0f;	// At previous update, display() interpolates from them
 
 GLUquadric* quadric = NULL;
 
@@ -68,7 +71,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -154,8 +157,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -265,6 +271,8 @@ void Initialize(void) {
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	glShadeModel(GL_SMOOTH);
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
@@ -310,6 +318,11 @@ void Resize(int width, int height) {
 }
 
 void display(void) {
+	// Variable declaration
+	GLfloat angle0 = frameSchedulerLerpAngle(prevLightAngle0, lightAngle0, gScheduler.alpha);
+	GLfloat angle1 = frameSchedulerLerpAngle(prevLightAngle1, lightAngle1, gScheduler.alpha);
+	GLfloat angle2 = frameSchedulerLerpAngle(prevLightAngle2, lightAngle2, gScheduler.alpha);
+
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -319,18 +332,18 @@ void display(void) {
 	glPushMatrix();
 		glTranslatef(0.0f, 0.0f, -1.0f);	// gluLookAt(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
 		glPushMatrix();
-			glRotatef(lightAngle0, 1.0f, 0.0f, 0.0f);
-			lightPositionZero[1] = lightAngle0;
+			glRotatef(angle0, 1.0f, 0.0f, 0.0f);
+			lightPositionZero[1] = angle0;
 			glLightfv(GL_LIGHT0, GL_POSITION, lightPositionZero);
 		glPopMatrix();
 		glPushMatrix();
-			glRotatef(lightAngle1, 0.0f, 1.0f, 0.0f);
-			lightPositionOne[0] = lightAngle1;
+			glRotatef(angle1, 0.0f, 1.0f, 0.0f);
+			lightPositionOne[0] = angle1;
 			glLightfv(GL_LIGHT1, GL_POSITION, lightPositionOne);
 		glPopMatrix();
 		glPushMatrix();
-			glRotatef(lightAngle2, 0.0f, 0.0f, 1.0f);
-			lightPositionTwo[1] = lightAngle2;
+			glRotatef(angle2, 0.0f, 0.0f, 1.0f);
+			lightPositionTwo[1] = angle2;
 			glLightfv(GL_LIGHT2, GL_POSITION, lightPositionTwo);
 		glPopMatrix();
 		glTranslatef(0.0f, 0.0f, -1.0f);
@@ -345,21 +358,24 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
-	gGLfAngle += 0.5f;
+	gGLfAngle += 30.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
-
-	lightAngle0 += 0.25f;
-	if(lightAngle0 > 360.0f)
-		lightAngle0 = 0.0f;
-	lightAngle1 += 0.5f;
-	if(lightAngle1 > 360.0f)
-		lightAngle1 = 0.0f;
-	lightAngle2 += 0.75f;
-	if(lightAngle2 > 360.0f)
-		lightAngle2 = 0.0f;
+		gGLfAngle -= 360.0f;
+
+	prevLightAngle0 = lightAngle0;
+	lightAngle0 += 15.0f * delta;
+	if(lightAngle0 >= 360.0f)
+		lightAngle0 -= 360.0f;
+	prevLightAngle1 = lightAngle1;
+	lightAngle1 += 30.0f * delta;
+	if(lightAngle1 >= 360.0f)
+		lightAngle1 -= 360.0f;
+	prevLightAngle2 = lightAngle2;
+	lightAngle2 += 45.0f * delta;
+	if(lightAngle2 >= 360.0f)
+		lightAngle2 -= 360.0f;
 }
 
 void Uninitialize() {
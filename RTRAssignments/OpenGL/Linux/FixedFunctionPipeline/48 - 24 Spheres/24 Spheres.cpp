@@ -12,6 +12,7 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
+#include "../../ProgramablePipeline/Include/FrameScheduler.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -32,10 +33,12 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 GLfloat gGLfAngle = 0.0f;
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 
 float XAxisRotation = 0.0f;
 float YAxisRotation = 0.0f;
 float ZAxisRotation = 0.0f;
+float prevXAxisRotation = 0.0f, prevYAxisRotation = 0.0f, prevZAxisRotation = 0.0f;	// At previous update, display() interpolates from them
 int KeyPressCode = 0;
 
 bool gbLight = false;
@@ -56,7 +59,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -154,8 +157,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -265,6 +271,8 @@ void Initialize(void) {
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	glShadeModel(GL_SMOOTH);
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
@@ -306,6 +314,11 @@ void display(void) {
 	// Function declaration
 	void Spheres_24();
 
+	// Variable declaration
+	GLfloat xAngle = prevXAxisRotation + ((XAxisRotation - prevXAxisRotation) * gScheduler.alpha);	// Not wrapped, light position follows angle
+	GLfloat yAngle = prevYAxisRotation + ((YAxisRotation - prevYAxisRotation) * gScheduler.alpha);
+	GLfloat zAngle = prevZAxisRotation + ((ZAxisRotation - prevZAxisRotation) * gScheduler.alpha);
+
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -314,20 +327,20 @@ void display(void) {
 
 	glPushMatrix();
 	if(KeyPressCode == 1) {
-		glRotatef(XAxisRotation, 1.0f, 0.0f, 0.0f);
+		glRotatef(xAngle, 1.0f, 0.0f, 0.0f);
 		lightPosition[0] = 0.0f;
-		lightPosition[1] = XAxisRotation;
+		lightPosition[1] = xAngle;
 		lightPosition[2] = 0.0f;
 	}
 	else if(KeyPressCode == 2) {
-		glRotatef(YAxisRotation, 0.0f, 1.0f, 0.0f);
+		glRotatef(yAngle, 0.0f, 1.0f, 0.0f);
 		lightPosition[0] = 0.0f;
 		lightPosition[1] = 0.0f;
-		lightPosition[2] = YAxisRotation;
+		lightPosition[2] = yAngle;
 	}
 	else if(KeyPressCode == 3) {
-		glRotatef(ZAxisRotation, 0.0f, 0.0f, 1.0f);
-		lightPosition[0] = ZAxisRotation;
+		glRotatef(zAngle, 0.0f, 0.0f, 1.0f);
+		lightPosition[0] = zAngle;
 		lightPosition[1] = 0.0f;
 		lightPosition[2] = 0.0f;
 	}
@@ -475,15 +488,18 @@ void Spheres_24(void) {
 	}
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
-	gGLfAngle += 0.5f;
+	gGLfAngle += 30.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
-
-	XAxisRotation += 0.5f;
-	YAxisRotation += 0.5f;
-	ZAxisRotation += 0.5f;
+		gGLfAngle -= 360.0f;
+
+	prevXAxisRotation = XAxisRotation;
+	prevYAxisRotation = YAxisRotation;
+	prevZAxisRotation = ZAxisRotation;
+	XAxisRotation += 30.0f * delta;
+	YAxisRotation += 30.0f * delta;
+	ZAxisRotation += 30.0f * delta;
 /*	if(XAxisRotation >= 360.0f)
 		XAxisRotation = 0.0f;
 	if(YAxisRotation >= 360.0f)
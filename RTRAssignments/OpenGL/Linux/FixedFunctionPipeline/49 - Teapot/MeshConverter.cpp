@@ -0,0 +1,145 @@
+// Offline converter : Teapot_model.h -> Teapot.mesh
+// Welds every unique (vertex, normal, texture) index triple of the model into one vertex
+// and writes single indexed, interleaved stream (see MeshFile.h for file layout).
+// Triangles are reordered for post-transform cache and overdraw, vertices for fetch locality.
+// Date : 17 October 2026
+// By : Darshan Vikam
+//
+// Build & run (only when Teapot_model.h changes) :
+//	g++ -O2 -o MeshConverter MeshConverter.cpp && ./MeshConverter [output file]
+
+// General Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+// OpenGL specific header files
+#include <GL/gl.h>		// for GLfloat used by model
+
+// Local header files
+#include "MeshFile.h"
+#include "../../ProgramablePipeline/Include/MeshOptimizer.h"
+#include "Teapot_model.h"
+
+// Vertex written to file; same order as GL_T2F_N3F_V3F so glInterleavedArrays() can be used directly
+typedef struct {
+	GLfloat texcoord[2];
+	GLfloat normal[3];
+	GLfloat position[3];
+} TeapotVertex;
+
+// Entry point function
+int main(int argc, char *argv[]) {
+	// Variable declaration
+	const char *outputFile = (argc > 1) ? argv[1] : "Teapot.mesh";
+	const unsigned int numFaces = sizeof(face_indicies) / sizeof(face_indicies[0]);
+	const unsigned int numCorners = numFaces * 3;
+	unsigned int tableSize = 1;
+	unsigned int *table = NULL;		// Open addressing hash : slot -> welded vertex index + 1 (0 = empty)
+	unsigned int *triples = NULL;		// Welded vertex -> packed (v, n, t)
+	TeapotVertex *weldedVertices = NULL;
+	unsigned int *indices32 = NULL;
+	unsigned int numVertices = 0;
+	MeshFileHeader layout;
+	size_t sourceBytes, meshBytes;
+	float acmrBefore, acmrAfter, overdrawBefore, overdrawAfter;
+
+	// Code
+	while(tableSize < numCorners * 2)
+		tableSize <<= 1;
+
+	table = (unsigned int *)calloc(tableSize, sizeof(unsigned int));
+	triples = (unsigned int *)malloc(numCorners * 3 * sizeof(unsigned int));
+	weldedVertices = (TeapotVertex *)malloc(numCorners * sizeof(TeapotVertex));
+	indices32 = (unsigned int *)malloc(numCorners * sizeof(unsigned int));
+	if(table == NULL || triples == NULL || weldedVertices == NULL || indices32 == NULL) {
+		printf("\n ERROR : Unable to allocate memory for welding.\n");
+		free(table); free(triples); free(weldedVertices); free(indices32);
+		return 1;
+	}
+
+	// Welding
+	for(unsigned int i = 0; i < numFaces; i++) {
+		for(unsigned int j = 0; j < 3; j++) {
+			unsigned int vi = (unsigned short)face_indicies[i][j];
+			unsigned int ni = (unsigned short)face_indicies[i][j+3];
+			unsigned int ti = (unsigned short)face_indicies[i][j+6];
+			unsigned int slot = ((vi * 73856093u) ^ (ni * 19349663u) ^ (ti * 83492791u)) & (tableSize - 1);
+
+			for(;;) {
+				unsigned int entry = table[slot];
+				if(entry == 0) {
+					// New unique corner
+					TeapotVertex *v = &weldedVertices[numVertices];
+					v->texcoord[0] = textures[ti][0];
+					v->texcoord[1] = textures[ti][1];
+					memcpy(v->normal, normals[ni], sizeof(v->normal));
+					memcpy(v->position, vertices[vi], sizeof(v->position));
+					triples[(numVertices*3)+0] = vi;
+					triples[(numVertices*3)+1] = ni;
+					triples[(numVertices*3)+2] = ti;
+					table[slot] = ++numVertices;
+					indices32[(i*3)+j] = numVertices - 1;
+					break;
+				}
+				entry--;
+				if(triples[(entry*3)+0] == vi && triples[(entry*3)+1] == ni && triples[(entry*3)+2] == ti) {
+					indices32[(i*3)+j] = entry;
+					break;
+				}
+				slot = (slot + 1) & (tableSize - 1);
+			}
+		}
+	}
+
+	// Optimization (welded order is order of source faces)
+	acmrBefore = analyzeVertexCache(indices32, sizeof(unsigned int), numCorners, 0, numVertices, MESH_ANALYZE_CACHE_SIZE);
+	overdrawBefore = analyzeOverdraw(indices32, sizeof(unsigned int), numCorners, weldedVertices, sizeof(TeapotVertex), offsetof(TeapotVertex, position), 0, numVertices);
+	if(optimizeVertexCache(indices32, sizeof(unsigned int), numCorners, 0, numVertices) == false ||
+		optimizeOverdraw(indices32, sizeof(unsigned int), numCorners, 0, numVertices, weldedVertices, sizeof(TeapotVertex), offsetof(TeapotVertex, position)) == false ||
+		optimizeVertexFetch(weldedVertices, sizeof(TeapotVertex), indices32, sizeof(unsigned int), numCorners, 0, numVertices) == false) {
+		printf("\n ERROR : Unable to allocate memory for optimization.\n");
+		free(table); free(triples); free(weldedVertices); free(indices32);
+		return 1;
+	}
+	acmrAfter = analyzeVertexCache(indices32, sizeof(unsigned int), numCorners, 0, numVertices, MESH_ANALYZE_CACHE_SIZE);
+	overdrawAfter = analyzeOverdraw(indices32, sizeof(unsigned int), numCorners, weldedVertices, sizeof(TeapotVertex), offsetof(TeapotVertex, position), 0, numVertices);
+
+	// Narrowest index type that fits
+	memset(&layout, 0, sizeof(MeshFileHeader));
+	layout.vertexCount = numVertices;
+	layout.vertexStride = sizeof(TeapotVertex);
+	layout.texcoordOffset = offsetof(TeapotVertex, texcoord);
+	layout.normalOffset = offsetof(TeapotVertex, normal);
+	layout.positionOffset = offsetof(TeapotVertex, position);
+	layout.indexCount = numCorners;
+	layout.indexSize = (numVertices <= 65536) ? 2 : 4;
+	if(layout.indexSize == 2) {
+		unsigned short *indices16 = (unsigned short *)indices32;	// In place narrowing, front to back is safe
+		for(unsigned int i = 0; i < numCorners; i++)
+			indices16[i] = (unsigned short)indices32[i];
+	}
+
+	if(WriteMeshFile(outputFile, &layout, weldedVertices, indices32) == false) {
+		free(table); free(triples); free(weldedVertices); free(indices32);
+		return 1;
+	}
+
+	// Report
+	sourceBytes = sizeof(face_indicies) + sizeof(vertices) + sizeof(normals) + sizeof(textures);
+	meshBytes = sizeof(MeshFileHeader) + ((size_t)numVertices * layout.vertexStride) + ((size_t)numCorners * layout.indexSize);
+	printf("\n Faces            : %u", numFaces);
+	printf("\n Source tables    : %u positions, %u normals, %u texcoords (%zu bytes)", (unsigned int)(sizeof(vertices)/sizeof(vertices[0])), (unsigned int)(sizeof(normals)/sizeof(normals[0])), (unsigned int)(sizeof(textures)/sizeof(textures[0])), sourceBytes);
+	printf("\n Welded vertices  : %u (from %u corners, %.2f corners per vertex)", numVertices, numCorners, (float)numCorners / (float)numVertices);
+	printf("\n Indices          : %u x %u bytes", numCorners, layout.indexSize);
+	printf("\n ACMR (FIFO %d)   : %.3f -> %.3f", MESH_ANALYZE_CACHE_SIZE, acmrBefore, acmrAfter);
+	printf("\n Overdraw         : %.3f -> %.3f", overdrawBefore, overdrawAfter);
+	printf("\n Written          : %s (%zu bytes)\n", outputFile, meshBytes);
+
+	free(table);
+	free(triples);
+	free(weldedVertices);
+	free(indices32);
+	return 0;
+}
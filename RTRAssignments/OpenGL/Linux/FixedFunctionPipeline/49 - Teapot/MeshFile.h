@@ -0,0 +1,165 @@
+// Header file for compact binary mesh file (.mesh) and its memory mapped loader
+// By : Darshan Vikam
+//
+// File layout (little endian) :
+//	MeshFileHeader		- 64 bytes
+//	vertex data		- vertexCount * vertexStride bytes, at header.vertexDataOffset
+//	index data		- indexCount * indexSize bytes, at header.indexDataOffset
+// Both data blocks are ready to be given to glBufferData() as they are. Loader checks that attributes lie inside
+// vertexStride and that every index is below vertexCount, so GL never reads past vertex buffer.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+//=============================================================================
+
+#define MESH_FILE_MAGIC		"DVMS"
+#define MESH_FILE_VERSION	1
+#define MESH_FILE_ALIGNMENT	16
+
+typedef struct {
+	char magic[4];			// MESH_FILE_MAGIC
+	unsigned int version;		// MESH_FILE_VERSION
+	unsigned int fileSize;		// Total size, for truncation check
+	unsigned int vertexCount;
+	unsigned int vertexStride;	// bytes per vertex
+	unsigned int positionOffset;	// byte offset of 3 floats in vertex
+	unsigned int normalOffset;	// byte offset of 3 floats in vertex
+	unsigned int texcoordOffset;	// byte offset of 2 floats in vertex
+	unsigned int vertexDataOffset;	// from start of file
+	unsigned int indexCount;
+	unsigned int indexSize;		// 2 - unsigned short, 4 - unsigned int
+	unsigned int indexDataOffset;	// from start of file
+	unsigned int reserved[4];
+} MeshFileHeader;
+
+// Loaded (mapped) mesh; pointers point straight into mapping
+typedef struct {
+	const MeshFileHeader *header;
+	const void *vertices;
+	const void *indices;
+	void *mapping;
+	size_t mappingSize;
+} MeshFile;
+//=============================================================================
+
+// Attribute of 'size' bytes at 'offset' lies inside vertex
+bool MeshFileAttributeFits(const MeshFileHeader *header, unsigned int offset, unsigned int size) {
+	// Code
+	return (size_t)offset + size <= header->vertexStride;
+}
+
+// Every index refers to an existing vertex (GL would otherwise read past vertex buffer)
+bool MeshFileIndicesInRange(const MeshFileHeader *header, const void *indices) {
+	// Code
+	for(unsigned int i = 0; i < header->indexCount; i++) {
+		unsigned int index = (header->indexSize == 2) ? ((const unsigned short *)indices)[i] : ((const unsigned int *)indices)[i];
+		if(index >= header->vertexCount)
+			return false;
+	}
+	return true;
+}
+
+// Maps 'path' read only and validates header, vertex layout and indices. Returns true on success.
+bool LoadMeshFile(const char *path, MeshFile *mesh) {
+	// Variable declaration
+	int fd;
+	struct stat fileStat;
+	const MeshFileHeader *header;
+
+	// Code
+	memset(mesh, 0, sizeof(MeshFile));
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		printf("\n ERROR : Unable to open mesh file %s.", path);
+		return false;
+	}
+	if(fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(MeshFileHeader)) {
+		printf("\n ERROR : Mesh file %s is too small.", path);
+		close(fd);
+		return false;
+	}
+
+	mesh->mappingSize = (size_t)fileStat.st_size;
+	mesh->mapping = mmap(NULL, mesh->mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);		// Mapping stays valid after close
+	if(mesh->mapping == MAP_FAILED) {
+		printf("\n ERROR : Unable to map mesh file %s.", path);
+		mesh->mapping = NULL;
+		return false;
+	}
+	madvise(mesh->mapping, mesh->mappingSize, MADV_WILLNEED);	// Page in whole file at once
+
+	header = (const MeshFileHeader *)mesh->mapping;
+	if(memcmp(header->magic, MESH_FILE_MAGIC, 4) != 0 || header->version != MESH_FILE_VERSION || header->fileSize != mesh->mappingSize ||
+		(header->indexSize != 2 && header->indexSize != 4) ||
+		(size_t)header->vertexDataOffset + ((size_t)header->vertexCount * header->vertexStride) > mesh->mappingSize ||
+		(size_t)header->indexDataOffset + ((size_t)header->indexCount * header->indexSize) > mesh->mappingSize ||
+		header->vertexDataOffset % sizeof(float) != 0 || header->vertexStride % sizeof(float) != 0 || header->indexDataOffset % header->indexSize != 0 ||
+		!MeshFileAttributeFits(header, header->positionOffset, 3 * sizeof(float)) ||
+		!MeshFileAttributeFits(header, header->normalOffset, 3 * sizeof(float)) ||
+		!MeshFileAttributeFits(header, header->texcoordOffset, 2 * sizeof(float)) ||
+		!MeshFileIndicesInRange(header, (const char *)mesh->mapping + header->indexDataOffset)) {
+		printf("\n ERROR : Mesh file %s is invalid or of other version.", path);
+		munmap(mesh->mapping, mesh->mappingSize);
+		memset(mesh, 0, sizeof(MeshFile));
+		return false;
+	}
+
+	mesh->header = header;
+	mesh->vertices = (const char *)mesh->mapping + header->vertexDataOffset;
+	mesh->indices = (const char *)mesh->mapping + header->indexDataOffset;
+	return true;
+}
+
+void UnloadMeshFile(MeshFile *mesh) {
+	// Code
+	if(mesh->mapping)
+		munmap(mesh->mapping, mesh->mappingSize);
+	memset(mesh, 0, sizeof(MeshFile));
+}
+
+// Writes mesh file; used by offline converter. Returns true on success.
+bool WriteMeshFile(const char *path, const MeshFileHeader *layout, const void *vertices, const void *indices) {
+	// Variable declaration
+	MeshFileHeader header;
+	static const char padding[MESH_FILE_ALIGNMENT] = { 0 };
+	size_t vertexBytes, indexBytes;
+	FILE *fp = NULL;
+
+	// Code
+	header = *layout;
+	memcpy(header.magic, MESH_FILE_MAGIC, 4);
+	header.version = MESH_FILE_VERSION;
+	vertexBytes = (size_t)header.vertexCount * header.vertexStride;
+	indexBytes = (size_t)header.indexCount * header.indexSize;
+	header.vertexDataOffset = sizeof(MeshFileHeader);
+	header.indexDataOffset = (unsigned int)((header.vertexDataOffset + vertexBytes + MESH_FILE_ALIGNMENT - 1) & ~(size_t)(MESH_FILE_ALIGNMENT - 1));
+	header.fileSize = (unsigned int)(header.indexDataOffset + indexBytes);
+
+	fp = fopen(path, "wb");
+	if(fp == NULL) {
+		printf("\n ERROR : Unable to create mesh file %s.", path);
+		return false;
+	}
+	fwrite(&header, sizeof(MeshFileHeader), 1, fp);
+	fwrite(vertices, 1, vertexBytes, fp);
+	fwrite(padding, 1, header.indexDataOffset - (header.vertexDataOffset + vertexBytes), fp);
+	fwrite(indices, 1, indexBytes, fp);
+	if(ferror(fp)) {
+		printf("\n ERROR : Unable to write mesh file %s.", path);
+		fclose(fp);
+		return false;
+	}
+	fclose(fp);
+	return true;
+}
+//=============================================================================
@@ -7,12 +7,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <time.h>		// for CPU frame time
 
 // OpenGL specific header files
+#include <GL/glew.h>		// for buffer objects
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
-#include <SOIL/SOIL.h>		// for texture loading
+#include "../../ProgramablePipeline/Include/FrameScheduler.h"
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -21,7 +23,8 @@
 #include <X11/keysym.h>
 
 // Local header files
-#include "Teapot_model.h"
+#include "MeshFile.h"		// Teapot.mesh is generated from Teapot_model.h by MeshConverter.cpp
+#include "../../ProgramablePipeline/Include/TextureLoader.h"	// Decodes on worker threads, uploads through pixel buffers
 
 // Namespaces
 using namespace std;
@@ -37,7 +40,17 @@ int giWindowWidth = 800;
 int giWindowHeight = 600;
 
 GLfloat gGLfAngle = 0.0f;
+GLfloat gGLfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 GLuint marble_texture;
+TextureLoader gTextureLoader;	// Texture is a placeholder until decoded and uploaded
+MeshFile gTeapotMesh;
+GLuint gVBObj_Teapot[2];	// [0] - interleaved vertices, [1] - indices
+GLenum gTeapotIndexType;
+bool gbRetained = true;		// true - buffer objects with single glDrawElements(), false - glBegin()/glEnd()
+double gdFrameTimeSum = 0.0;	// CPU time of display() (excluding swap), averaged over FRAME_TIME_SAMPLES frames
+int giFrameTimeCount = 0;
+#define FRAME_TIME_SAMPLES 256
 bool gbRotation = false;
 bool gbTexture = false;
 bool gbLight = false;
@@ -59,7 +72,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -129,6 +142,16 @@ int main() {
 								gbTexture = true;
 							}
 							break;
+						case XK_r :
+						case XK_R :
+							if(gbRetained == true)
+								gbRetained = false;
+							else if(gVBObj_Teapot[0])
+								gbRetained = true;
+							printf("\n Rendering mode : %s", gbRetained ? "Retained (glDrawElements)" : "Immediate (glBegin/glEnd)");
+							gdFrameTimeSum = 0.0;
+							giFrameTimeCount = 0;
+							break;
 						default :
 							break;
 					}
@@ -163,8 +186,12 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
+		textureLoaderUpdate(&gTextureLoader);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -269,12 +296,51 @@ void ToggleFullscreen() {
 void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
-	GLuint LoadBitmapAsTexture(const char*);
+	void Uninitialize();
 	
 	// Code
+	if(LoadMeshFile("Teapot.mesh", &gTeapotMesh) == false) {
+		printf("\n Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
+
 	gGLXContext = glXCreateContext(gpDisplay, gpXVisualInfo, NULL, GL_TRUE);
 	glXMakeCurrent(gpDisplay, gWindow, gGLXContext);
 
+	GLenum glew_error = glewInit();
+	if(glew_error != GLEW_OK) {
+		printf("\n ERROR : glewInit() failed. Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
+
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
+	// Retained mode : mapped mesh goes to buffer objects as it is, once
+	if(GLEW_VERSION_1_5) {
+		const MeshFileHeader *header = gTeapotMesh.header;
+
+		glGenBuffers(2, gVBObj_Teapot);
+		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Teapot[0]);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)header->vertexCount * header->vertexStride, gTeapotMesh.vertices, GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj_Teapot[1]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)header->indexCount * header->indexSize, gTeapotMesh.indices, GL_STATIC_DRAW);
+		gTeapotIndexType = (header->indexSize == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+		// Array state is used only by glDrawElements(), hence set once and left bound
+		glVertexPointer(3, GL_FLOAT, header->vertexStride, (void *)(size_t)header->positionOffset);
+		glNormalPointer(GL_FLOAT, header->vertexStride, (void *)(size_t)header->normalOffset);
+		glTexCoordPointer(2, GL_FLOAT, header->vertexStride, (void *)(size_t)header->texcoordOffset);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+	else {
+		printf("\n OpenGL 1.5 is not available, using immediate mode only.");
+		gbRetained = false;
+	}
+
 	glShadeModel(GL_SMOOTH);
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
@@ -282,7 +348,8 @@ void Initialize(void) {
 	glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
 
 	// Loading texture
-	marble_texture = LoadBitmapAsTexture("Marble.bmp");
+	textureLoaderInitialize(&gTextureLoader);
+	textureLoaderRequest(&gTextureLoader, "Marble.bmp", &marble_texture);
 
 	// Actual initialization of lights
 	glLightfv(GL_LIGHT0, GL_AMBIENT, lightAmbient);
@@ -301,25 +368,6 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-GLuint LoadBitmapAsTexture(const char* path) {
-	// Variable declaration
-	int width, height;
-	unsigned char *imageData = NULL;
-	GLuint textureID;
-	
-	// Code
-	imageData = SOIL_load_image(path, &width, &height, NULL, SOIL_LOAD_RGB);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, imageData);
-	
-	SOIL_free_image_data(imageData);
-	return textureID;
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -334,46 +382,64 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
-	int i, j, vi, ni, ti;
+	GLfloat angle = frameSchedulerLerpAngle(gGLfPrevAngle, gGLfAngle, gScheduler.alpha);
+	const MeshFileHeader *header = gTeapotMesh.header;
+	const char *vertexData = (const char *)gTeapotMesh.vertices;
+	const char *vertex;
+	unsigned int i, index;
+	struct timespec frameStart, frameEnd;
 
 	// Code
+	clock_gettime(CLOCK_MONOTONIC, &frameStart);
+
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 
 	glTranslatef(0.0f, 0.0f, -1.0f);
-	if(gbRotation == true)
-		glRotatef(gGLfAngle, 0.0f, 1.0f, 0.0f);
-	else {
-		glRotatef(gGLfAngle, 0.0f, 1.0f, 0.0f);
-		gGLfAngle -= 0.5f;
-	}
+	glRotatef(angle, 0.0f, 1.0f, 0.0f);		// Update() holds angle while rotation is off
 
 	glBindTexture(GL_TEXTURE_2D, marble_texture);
 
-	glBegin(GL_TRIANGLES);
-	for(i = 0; i < sizeof(face_indicies)/sizeof(face_indicies[0]); i++) {
-		for(j = 0; j < 3; j++) {
-			vi = face_indicies[i][j];
-			ni = face_indicies[i][j+3];
-			ti = face_indicies[i][j+6];
-
-			glNormal3f(normals[ni][0], normals[ni][1], normals[ni][2]);
-			glTexCoord2f(textures[ti][0], textures[ti][1]);
-			glVertex3f(vertices[vi][0], vertices[vi][1], vertices[vi][2]);
+	if(gbRetained == true)
+		glDrawElements(GL_TRIANGLES, header->indexCount, gTeapotIndexType, (void *)0);
+	else {
+		glBegin(GL_TRIANGLES);
+		for(i = 0; i < header->indexCount; i++) {
+			if(header->indexSize == 2)
+				index = ((const unsigned short *)gTeapotMesh.indices)[i];
+			else
+				index = ((const unsigned int *)gTeapotMesh.indices)[i];
+			vertex = vertexData + (index * header->vertexStride);
+
+			glNormal3fv((const GLfloat *)(vertex + header->normalOffset));
+			glTexCoord2fv((const GLfloat *)(vertex + header->texcoordOffset));
+			glVertex3fv((const GLfloat *)(vertex + header->positionOffset));
 		}
+		glEnd();
+	}
+
+	// CPU cost of submitting frame; swap is excluded as it may wait for vsync
+	clock_gettime(CLOCK_MONOTONIC, &frameEnd);
+	gdFrameTimeSum += ((double)(frameEnd.tv_sec - frameStart.tv_sec) * 1000.0) + ((double)(frameEnd.tv_nsec - frameStart.tv_nsec) / 1000000.0);
+	if(++giFrameTimeCount == FRAME_TIME_SAMPLES) {
+		printf("\n %s : %.3f ms CPU per frame", gbRetained ? "Retained " : "Immediate", gdFrameTimeSum / FRAME_TIME_SAMPLES);
+		fflush(stdout);
+		gdFrameTimeSum = 0.0;
+		giFrameTimeCount = 0;
 	}
-	glEnd();
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
-	gGLfAngle += 0.5f;
+	gGLfPrevAngle = gGLfAngle;
+	if(gbRotation == true)
+		gGLfAngle += 30.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
+		gGLfAngle -= 360.0f;
 }
 
 void Uninitialize() {
@@ -381,16 +447,20 @@ void Uninitialize() {
 	GLXContext currentGLXContext;
 	
 	// Code
+	if(gVBObj_Teapot[0]) {
+		glDeleteBuffers(2, gVBObj_Teapot);
+		gVBObj_Teapot[0] = gVBObj_Teapot[1] = 0;
+	}
+
+	textureLoaderUninitialize(&gTextureLoader);	// Deletes marble_texture too
+
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
 		glXMakeCurrent(gpDisplay, 0, 0);
 	if(gGLXContext)
 		glXDestroyContext(gpDisplay, gGLXContext);
 
-	if(marble_texture) {
-		glDeleteTextures(1, &marble_texture);
-		marble_texture = 0;
-	}
+	UnloadMeshFile(&gTeapotMesh);
 
 	if(gWindow)
 		XDestroyWindow(gpDisplay, gWindow);
@@ -0,0 +1,117 @@
+// Header file for cache of unit size 2D primitives (circle, regular polygon) as display lists
+// By : Darshan Vikam
+//
+// Every primitive is compiled once, with radius 1 around origin, into a display list for its key
+// (segments, start angle, primitive mode); asking for same key again returns same list.
+// primitiveListDraw() places it with glTranslatef() and glScalef(radius, radius, 1), so circles of
+// any radius share one list and drawing needs no cos()/sin(). Lists carry no color, call glColor*() first.
+// Build lists in Initialize() (after context is current) and delete them in Uninitialize().
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <math.h>
+#include <GL/gl.h>
+
+#define PRIMITIVE_LIST_MAX_ENTRIES	16
+//=============================================================================
+
+typedef struct {
+	unsigned int segments;
+	GLfloat startAngle;		// Degrees, angle of first vertex
+	GLenum mode;			// GL_POINTS, GL_LINES, GL_LINE_LOOP, ...
+	GLuint list;
+} PrimitiveListEntry;
+
+typedef struct {
+	PrimitiveListEntry entry[PRIMITIVE_LIST_MAX_ENTRIES];
+	unsigned int numEntries;
+} PrimitiveLists;
+//=============================================================================
+
+// 'segments' vertices on unit circle drawn with 'mode', first one at 'startAngle' degrees.
+// Few segments give regular polygon (3 and 90 - triangle with apex on top). Returns list, 0 on failure.
+GLuint primitiveListCircle(PrimitiveLists *lists, unsigned int segments, GLfloat startAngle, GLenum mode) {
+	// Variable declaration
+	PrimitiveListEntry *entry;
+	GLfloat angle;
+	GLuint list;
+
+	// Code
+	for(unsigned int i = 0; i < lists->numEntries; i++) {
+		entry = &lists->entry[i];
+		if(entry->segments == segments && entry->startAngle == startAngle && entry->mode == mode)
+			return entry->list;
+	}
+	if(lists->numEntries == PRIMITIVE_LIST_MAX_ENTRIES) {
+		printf("\n ERROR : Primitive list cache is full (%d entries).", PRIMITIVE_LIST_MAX_ENTRIES);
+		return 0;
+	}
+	list = glGenLists(1);
+	if(list == 0) {
+		printf("\n ERROR : Unable to create display list for primitive.");
+		return 0;
+	}
+
+	glNewList(list, GL_COMPILE);
+	glBegin(mode);
+		for(unsigned int i = 0; i < segments; i++) {
+			angle = (startAngle + (360.0f * i) / segments) * (M_PI / 180.0f);
+			glVertex3f((GLfloat)cos(angle), (GLfloat)sin(angle), 0.0f);
+		}
+	glEnd();
+	glEndList();
+
+	entry = &lists->entry[lists->numEntries++];
+	entry->segments = segments;
+	entry->startAngle = startAngle;
+	entry->mode = mode;
+	entry->list = list;
+	return list;
+}
+
+// Draws cached primitive with given center and radius in current model-view matrix
+void primitiveListDraw(GLuint list, GLfloat x, GLfloat y, GLfloat radius) {
+	// Code
+	glPushMatrix();
+	glTranslatef(x, y, 0.0f);
+	glScalef(radius, radius, 1.0f);
+	glCallList(list);
+	glPopMatrix();
+}
+
+void primitiveListsDelete(PrimitiveLists *lists) {
+	// Code
+	for(unsigned int i = 0; i < lists->numEntries; i++) {
+		if(lists->entry[i].list)
+			glDeleteLists(lists->entry[i].list, 1);
+		lists->entry[i].list = 0;
+	}
+	lists->numEntries = 0;
+}
+//=============================================================================
+
+// Incircle of triangle abc : center and radius, to place a cached unit circle inside any triangle
+void triangleIncircle(const GLfloat a[2], const GLfloat b[2], const GLfloat c[2], GLfloat center[2], GLfloat *radius) {
+	// Variable declaration
+	GLfloat lenA, lenB, lenC, perimeter, area;
+
+	// Code
+	lenA = hypot(b[0] - c[0], b[1] - c[1]);		// Side opposite to a
+	lenB = hypot(a[0] - c[0], a[1] - c[1]);
+	lenC = hypot(a[0] - b[0], a[1] - b[1]);
+	perimeter = lenA + lenB + lenC;
+	area = fabs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1])) / 2.0f;
+	if(perimeter <= 0.0f) {
+		center[0] = a[0];
+		center[1] = a[1];
+		*radius = 0.0f;
+		return;
+	}
+	center[0] = (lenA * a[0] + lenB * b[0] + lenC * c[0]) / perimeter;
+	center[1] = (lenA * a[1] + lenB * b[1] + lenC * c[1]) / perimeter;
+	*radius = (2.0f * area) / perimeter;
+}
+//=============================================================================
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include "../Include/RenderOnDemand.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -38,6 +39,7 @@ int giWindowHeight = 600;
 GLuint gVertexShaderObject;
 GLuint gFragmentShaderObject;
 GLuint gShaderProgramObject;
+RenderOnDemand gRenderLoop;	// Draws only when a frame is due
 
 // Entry point function
 int main() {
@@ -58,17 +60,21 @@ int main() {
 	// Code
 	CreateWindow();
 	Initialize();
+	renderOnDemandInitialize(&gRenderLoop, gpDisplay);
 
 	// Message loop
 	XEvent event;
 	KeySym keysym;
 	while(bDone == false) {
+		renderOnDemandWait(&gRenderLoop);	// Sleeps until an event comes or a frame is due
 		while(XPending(gpDisplay)) {
 			XNextEvent(gpDisplay, &event);
 			switch(event.type) {
 				case MapNotify :
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case KeyPress :
+					renderOnDemandInvalidate(&gRenderLoop);
 					keysym = XkbKeycodeToKeysym(gpDisplay, event.xkey.keycode, 0, 0);
 					switch(keysym) {
 						case XK_Escape :
@@ -93,6 +99,7 @@ int main() {
 					}
 					break;
 				case ButtonPress :
+					renderOnDemandInvalidate(&gRenderLoop);
 					switch(event.xbutton.button) {
 						case 1 :
 							break;
@@ -110,8 +117,10 @@ int main() {
 					winWidth = event.xconfigure.width;
 					winHeight = event.xconfigure.height;
 					Resize(winWidth, winHeight);
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case Expose :
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case DestroyNotify :
 					break;
@@ -122,9 +131,12 @@ int main() {
 					break;
 			}
 		}
-		Update();
-		display();
+		if(renderOnDemandShouldDraw(&gRenderLoop) == true) {
+			Update();
+			display();
+		}
 	}
+	renderOnDemandUninitialize(&gRenderLoop);
 	Uninitialize();
 	return 0;
 }
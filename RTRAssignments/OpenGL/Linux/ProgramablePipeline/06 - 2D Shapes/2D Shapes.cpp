@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -268,7 +269,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -337,8 +338,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
-//	ShaderErrorCheck(gVSObj, "COMIPLE");		// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -352,8 +352,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"FRAGMENT");	// Error checking for shader
-//	ShaderErrorCheck(gFSObj, "COMPILE");		// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -362,8 +361,7 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_COLOR, "vColor");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
-//	ShaderErrorCheck(gSPObj, "LINK");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -434,54 +432,12 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -8,6 +8,8 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/FrameScheduler.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -47,6 +49,8 @@ int giWindowWidth = 800;
 int giWindowHeight = 600;
 
 GLfloat gGLfAngle = 0.0f;
+GLfloat gGLfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 
 GLuint gVSObj;		// Vertex Shader Object
 GLuint gFSObj;		// Fragment Shader Object
@@ -66,7 +70,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -141,8 +145,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -270,7 +277,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -305,6 +312,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -339,8 +348,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
-//	ShaderErrorCheck(gVSObj, "COMIPLE");		// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -354,8 +362,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"FRAGMENT");	// Error checking for shader
-//	ShaderErrorCheck(gFSObj, "COMPILE");		// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -364,8 +371,7 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_COLOR, "vColor");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
-//	ShaderErrorCheck(gSPObj, "LINK");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -436,54 +442,12 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -499,6 +463,7 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
+	GLfloat angle = frameSchedulerLerpAngle(gGLfPrevAngle, gGLfAngle, gScheduler.alpha);
 	mat4 ModelViewMatrix, ModelViewProjectionMatrix;
 	mat4 translationMatrix, rotationMatrix;
 
@@ -515,7 +480,7 @@ void display(void) {
 
 	translationMatrix = translate(-1.5f, 0.0f, -5.0f);
 	ModelViewMatrix = translationMatrix;
-	rotationMatrix = rotate(gGLfAngle, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(angle, 0.0f, 1.0f, 0.0f);
 	ModelViewMatrix *= rotationMatrix;
 
 	ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
@@ -533,7 +498,7 @@ void display(void) {
 
 	translationMatrix = translate(1.5f, 0.0f, -5.0f);
 	ModelViewMatrix = translationMatrix;
-	rotationMatrix = rotate(gGLfAngle, 1.0f, 0.0f, 0.0f);
+	rotationMatrix = rotate(angle, 1.0f, 0.0f, 0.0f);
 	ModelViewMatrix *= rotationMatrix;
 
 	ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
@@ -550,11 +515,12 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
-	gGLfAngle += 1.0f;
+	gGLfPrevAngle = gGLfAngle;
+	gGLfAngle += 60.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
+		gGLfAngle -= 360.0f;
 }
 
 void Uninitialize() {
@@ -8,6 +8,9 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/StreamBuffer.h"
+#include "../Include/PrimitiveCache.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -56,10 +59,10 @@ GLuint gFSObj;		// Fragment Shader Object
 GLuint gSPObj;		// Shader Program Object
 GLuint gVAObj_GraphPaper;	// Vertex Array Object - graph paper
 GLuint gVBObj_GraphPaper[2];	// Vertex Buffer Object - graph paper
-GLuint gVAObj_shapes[3];	// Vertex Array Object - [0]-triangle; [1]-rectangle; [2]-circle
-GLuint gVBObj_triangle[2];	// Vertex Buffer Object - for triangle
-GLuint gVBObj_rectangle[2];	// Vertex Buffer Object - for rectangle
-GLuint gVBObj_circle[2];	// Vertex Buffer Object - for circle
+GLuint gVAObj_shapes[2];	// Vertex Array Object - [0]-triangle; [1]-rectangle
+StreamBuffer gStreamBuffer;	// Vertices and colors of triangle and rectangle, written every frame
+PrimitiveCache gPrimitives;	// Unit circle, generated once
+int gCircle;			// Entry of circle in gPrimitives
 GLuint gMVPUniform;	// Model View Projection matrix Uniform
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
@@ -304,7 +307,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -375,8 +378,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
-//	ShaderErrorCheck(gVSObj, "COMIPLE");		// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -390,8 +392,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
-//	ShaderErrorCheck(gFSObj, "COMPILE");		// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -400,8 +401,7 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_COLOR, "vColor");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
-//	ShaderErrorCheck(gSPObj, "LINK");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -490,51 +490,24 @@ void Initialize(void) {
 	glBindVertexArray(0);			// unbind and save above steps into gVAObj_GraphPaper
 
 	// For Shapes
-	glGenVertexArrays(3, gVAObj_shapes);	// Generate 3 vertex arrays to draw triangle, rectangle and circle
-	glBindVertexArray(gVAObj_shapes[0]);	// For triangle
-		// vPosition VBObj of Triangle
-		glGenBuffers(2, gVBObj_triangle);
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_triangle[0]);
-		glBufferData(GL_ARRAY_BUFFER, 3 * 3 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_POS);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glGenVertexArrays(2, gVAObj_shapes);	// Generate 2 vertex arrays to draw triangle and rectangle
+	for(int i = 0; i < 2; i++) {
+		glBindVertexArray(gVAObj_shapes[i]);	// Data comes from gStreamBuffer, offsets are set while drawing
+			glEnableVertexAttribArray(DV_ATTRIB_POS);
+			glEnableVertexAttribArray(DV_ATTRIB_COLOR);
+		glBindVertexArray(0);
+	}
+	// Largest frame is rectangle : 4 vertices of position(3) and color(3)
+	if(streamBufferCreate(&gStreamBuffer, 4 * (3 + 3) * sizeof(GLfloat)) == false) {
+		printf("\n Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
 
-		// vColor VBObj of Triangle
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_triangle[1]);
-		glBufferData(GL_ARRAY_BUFFER, 3 * 3 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_COLOR);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	glBindVertexArray(gVAObj_shapes[1]);	// For rectangle
-		glGenBuffers(2, gVBObj_rectangle);
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_rectangle[0]);
-		glBufferData(GL_ARRAY_BUFFER, 4 * 3 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_POS);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_rectangle[1]);
-		glBufferData(GL_ARRAY_BUFFER, 4 * 3 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_COLOR);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	glBindVertexArray(gVAObj_shapes[2]);	// For circle
-		glGenBuffers(2, gVBObj_circle);
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_circle[0]);
-		glBufferData(GL_ARRAY_BUFFER, 3600 * 2 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_POS, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_POS);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_circle[1]);
-		glBufferData(GL_ARRAY_BUFFER, 3600 * 3 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_COLOR);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	// Circle is of unit radius, scaled to 'radius' while drawing
+	primitiveCacheInitialize(&gPrimitives, DV_ATTRIB_POS);
+	gCircle = primitiveCacheCircle(&gPrimitives, 3600);
+	primitiveCacheUpload(&gPrimitives);
 
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
@@ -546,54 +519,12 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -614,6 +545,7 @@ void display(void) {
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	streamBufferBeginFrame(&gStreamBuffer);
 
 	// Start of OpenGL shader program
 	glUseProgram(gSPObj);
@@ -644,21 +576,18 @@ void display(void) {
 			1.0f, 1.0f, 0.0f,
 			1.0f, 1.0f, 0.0f
 		};
-		glBindVertexArray(gVAObj_shapes[0]);
-			glBindBuffer(GL_ARRAY_BUFFER, gVBObj_triangle[0]);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(triangleVertex), triangleVertex, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-			glEnableVertexAttribArray(DV_ATTRIB_POS);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			glBindBuffer(GL_ARRAY_BUFFER, gVBObj_triangle[1]);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(triangleColors), triangleColors, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-			glEnableVertexAttribArray(DV_ATTRIB_COLOR);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			glDrawArrays(GL_LINE_LOOP, 0, 3);
-		glBindVertexArray(0);
+		GLintptr vertexOffset = streamBufferUpload(&gStreamBuffer, triangleVertex, sizeof(triangleVertex));
+		GLintptr colorOffset = streamBufferUpload(&gStreamBuffer, triangleColors, sizeof(triangleColors));
+		if(vertexOffset >= 0 && colorOffset >= 0) {
+			glBindVertexArray(gVAObj_shapes[0]);
+				glBindBuffer(GL_ARRAY_BUFFER, gStreamBuffer.buffer);
+				glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, (void *)vertexOffset);
+				glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, (void *)colorOffset);
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+				glDrawArrays(GL_LINE_LOOP, 0, 3);
+			glBindVertexArray(0);
+		}
 	}
 	else if(keyPressed == 2) {	// 2 ==> Rectangle
 		const GLfloat rectangleVertices[] = {
@@ -673,53 +602,31 @@ void display(void) {
 			 1.0f, 1.0f, 0.0f,
 			 1.0f, 1.0f, 0.0f
 		};
-		glBindVertexArray(gVAObj_shapes[1]);
-			glBindBuffer(GL_ARRAY_BUFFER, gVBObj_rectangle[1]);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-			glEnableVertexAttribArray(DV_ATTRIB_POS);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			glBindBuffer(GL_ARRAY_BUFFER, gVBObj_rectangle[0]);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleColor), rectangleColor, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-			glEnableVertexAttribArray(DV_ATTRIB_COLOR);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			glDrawArrays(GL_LINE_LOOP, 0, 4);
-		glBindVertexArray(0);
+		GLintptr vertexOffset = streamBufferUpload(&gStreamBuffer, rectangleVertices, sizeof(rectangleVertices));
+		GLintptr colorOffset = streamBufferUpload(&gStreamBuffer, rectangleColor, sizeof(rectangleColor));
+		if(vertexOffset >= 0 && colorOffset >= 0) {
+			glBindVertexArray(gVAObj_shapes[1]);
+				glBindBuffer(GL_ARRAY_BUFFER, gStreamBuffer.buffer);
+				glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, (void *)vertexOffset);
+				glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, (void *)colorOffset);
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+				glDrawArrays(GL_LINE_LOOP, 0, 4);
+			glBindVertexArray(0);
+		}
 	}
 	else if(keyPressed == 3) {		// 3 ==> Circle
-		GLfloat circleVertices[3600*2];
-		GLfloat circleColor[3600*3];
-		for(int i = 0; i < 3600*2; i += 2) {
-			circleVertices[i] = radius * cos(((GLfloat)i/20.0f)*(M_PI/180.0f));	// X = r * cos(theta)
-			circleVertices[i+1] = radius * sin(((GLfloat)i/20.0f)*(M_PI/180.0f));	// Y = r * sin(theta)
-		}
-		for(int i = 0; i < 3600*3; i += 3) {
-			circleColor[i] = 1.0f;
-			circleColor[i+1] = 1.0f;
-			circleColor[i+2] = 0.0f;
-		}
-		glBindVertexArray(gVAObj_shapes[2]);
-			glBindBuffer(GL_ARRAY_BUFFER, gVBObj_circle[0]);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(circleVertices), circleVertices, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(DV_ATTRIB_POS, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-			glEnableVertexAttribArray(DV_ATTRIB_POS);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-		
-			glBindBuffer(GL_ARRAY_BUFFER, gVBObj_circle[1]);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(circleColor), circleColor, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-			glEnableVertexAttribArray(DV_ATTRIB_COLOR);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		ModelViewMatrix = translationMatrix * scale(radius, radius, 1.0f);
+		ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
+		glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
 
-			glDrawArrays(GL_POINTS, 0, 3600);
-		glBindVertexArray(0);
+		glVertexAttrib3f(DV_ATTRIB_COLOR, 1.0f, 1.0f, 0.0f);	// Cached circle has no color array
+		primitiveCacheDraw(&gPrimitives, gCircle, GL_POINTS);
 	}
 
 	// End of OpenGL shading program
 	glUseProgram(0);
+	streamBufferEndFrame(&gStreamBuffer);
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
@@ -745,11 +652,11 @@ void Uninitialize() {
 		gVAObj_GraphPaper = 0;
 	}
 	if(gVAObj_shapes) {
-		glDeleteVertexArrays(3, gVAObj_shapes);
+		glDeleteVertexArrays(2, gVAObj_shapes);
 		gVAObj_shapes[0] = 0;
 		gVAObj_shapes[1] = 0;
-		gVAObj_shapes[2] = 0;
 	}
+	primitiveCacheDelete(&gPrimitives);
 
 	// Destroy Vertex Buffer Object
 	if(gVBObj_GraphPaper) {
@@ -757,21 +664,7 @@ void Uninitialize() {
 		gVBObj_GraphPaper[0] = 0;
 		gVBObj_GraphPaper[1] = 0;
 	}
-	if(gVBObj_triangle) {
-		glDeleteBuffers(2, gVBObj_triangle);
-		gVBObj_triangle[0] = 0;
-		gVBObj_triangle[1] = 0;
-	}
-	if(gVBObj_rectangle) {
-		glDeleteBuffers(2, gVBObj_rectangle);
-		gVBObj_rectangle[0] = 0;
-		gVBObj_rectangle[1] = 0;
-	}
-	if(gVBObj_circle) {
-		glDeleteBuffers(2, gVBObj_circle);
-		gVBObj_circle[0] = 0;
-		gVBObj_circle[1] = 0;
-	}
+	streamBufferDestroy(&gStreamBuffer);
 
 	// Detach shaders
 	glDetachShader(gSPObj, gVSObj);		// Detach vertex shader from final shader program
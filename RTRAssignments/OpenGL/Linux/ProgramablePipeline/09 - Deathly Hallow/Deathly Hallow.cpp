@@ -8,6 +8,9 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/PrimitiveCache.h"
+#include "../Include/RenderOnDemand.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -49,15 +52,18 @@ int giWindowHeight = 600;
 GLuint gVSObj;		// Vertex Shader Object
 GLuint gFSObj;		// Fragment Shader Object
 GLuint gSPObj;		// Shader Program Object
-GLuint gVAObj_CloakOfInvisibility;	// Vertex Array Object 
-GLuint gVBObj_CloakOfInvisibility_pos;	// Fragment Buffer Object for position
-GLuint gVAObj_ResurrectionStone;	// Vertex Array Object 
-GLuint gVBObj_ResurrectionStone_pos;	// Fragment Buffer Object for position
+PrimitiveCache gPrimitives;		// Unit triangle and circle, generated once
+int gCloakOfInvisibility;		// Entry of triangle in gPrimitives
+int gResurrectionStone;			// Entry of circle in gPrimitives
+GLfloat gTriangleRadius, gInCircleRadius;	// Scale of cached primitives
 GLuint gVAObj_ElderWand;		// Vertex Array Object
 GLuint gVBObj_ElderWand_pos;		// Fragment Buffer Object for position
 GLuint gMVPUniform;	// Matrix 
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
+RenderOnDemand gRenderLoop;	// Draws only when a frame is due
+GLfloat gTrans = 5.0f;		// Distance of symbols from centre, animated down to 0
+GLfloat gRot = 0.0f;		// Angle of symbols, animated up to 720
 
 // Entry point function
 int main() {
@@ -67,7 +73,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -78,17 +84,22 @@ int main() {
 	// Code
 	CreateWindow();
 	Initialize();
+	renderOnDemandInitialize(&gRenderLoop, gpDisplay);
+	renderOnDemandSetAnimation(&gRenderLoop, 60.0);	// Stopped in display() once animation is over
 
 	// Message loop
 	XEvent event;
 	KeySym keysym;
 	while(bDone == false) {
+		renderOnDemandWait(&gRenderLoop);	// Sleeps until an event comes or a frame is due
 		while(XPending(gpDisplay)) {
 			XNextEvent(gpDisplay, &event);
 			switch(event.type) {
 				case MapNotify :
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case KeyPress :
+					renderOnDemandInvalidate(&gRenderLoop);
 					keysym = XkbKeycodeToKeysym(gpDisplay, event.xkey.keycode, 0, 0);
 					switch(keysym) {
 						case XK_Escape :
@@ -113,6 +124,7 @@ int main() {
 					}
 					break;
 				case ButtonPress :
+					renderOnDemandInvalidate(&gRenderLoop);
 					switch(event.xbutton.button) {
 						case 1 :
 							break;
@@ -130,8 +142,10 @@ int main() {
 					winWidth = event.xconfigure.width;
 					winHeight = event.xconfigure.height;
 					Resize(winWidth, winHeight);
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case Expose :
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case DestroyNotify :
 					break;
@@ -142,9 +156,12 @@ int main() {
 					break;
 			}
 		}
-		Update();
-		display();
+		if(renderOnDemandShouldDraw(&gRenderLoop) == true) {
+			Update((GLfloat)renderOnDemandElapsed(&gRenderLoop));	// Extra frames for events do not speed animation up
+			display();
+		}
 	}
+	renderOnDemandUninitialize(&gRenderLoop);
 	Uninitialize();
 	return 0;
 }
@@ -271,7 +288,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -339,8 +356,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
-//	ShaderErrorCheck(gVSObj, "COMIPLE");		// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -353,8 +369,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
-//	ShaderErrorCheck(gFSObj, "COMPILE");		// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -363,56 +378,26 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_COLOR, "vColor");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
-//	ShaderErrorCheck(gSPObj, "LINK");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
 
 	// other variable initialization
-	const GLfloat radian = 22.0f / (7.0f * 180.0f);
 	const GLfloat TriangleSide = 1.5f;
-	const GLfloat Triangle_radius = (2.0f / sqrt(3.0f)) * TriangleSide;
-	const GLfloat inCircle_radius = TriangleSide / sqrt(3.0f);
-
-	const GLfloat CloakOfInvisibilityVertex[] = {
-		(GLfloat)(Triangle_radius * cos(90.0f * radian)), (GLfloat)(Triangle_radius * sin(90.0f * radian)), 0.0f,	// Apex
-		(GLfloat)(Triangle_radius * cos(210.0f * radian)), (GLfloat)(Triangle_radius * sin(210.0f * radian)), 0.0f,	// left bottom
-		(GLfloat)(Triangle_radius * cos(330.0f * radian)), (GLfloat)(Triangle_radius * sin(330.0f * radian)), 0.0f	// right bottom
-	};
-
-	GLfloat ResurrectionStoneVertex[3600*2];
-	for(int i = 0; i < 3600*2; i += 2) {
-		ResurrectionStoneVertex[i] = (GLfloat)(inCircle_radius * cos(i * radian / 20.0f));
-		ResurrectionStoneVertex[i+1] = (GLfloat)(inCircle_radius * sin(i * radian / 20.0f));
-	}
+	gTriangleRadius = (2.0f / sqrt(3.0f)) * TriangleSide;
+	gInCircleRadius = TriangleSide / sqrt(3.0f);
 
 	const GLfloat ElderWandVertex[] = {
-		0.0f, (GLfloat)(inCircle_radius * 2), 0.0f,
-		0.0f, (GLfloat)(-inCircle_radius), 0.0f
+		0.0f, (GLfloat)(gInCircleRadius * 2), 0.0f,
+		0.0f, (GLfloat)(-gInCircleRadius), 0.0f
 	};
 
-	// For Cloak of Invisibility
-	glGenVertexArrays(1, &gVAObj_CloakOfInvisibility);
-	glBindVertexArray(gVAObj_CloakOfInvisibility);
-		glGenBuffers(1, &gVBObj_CloakOfInvisibility_pos);
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_CloakOfInvisibility_pos);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(CloakOfInvisibilityVertex), CloakOfInvisibilityVertex, GL_STATIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_POS);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-
-	// For Resurrection Stone
-	glGenVertexArrays(1, &gVAObj_ResurrectionStone);
-	glBindVertexArray(gVAObj_ResurrectionStone);
-		glGenBuffers(1, &gVBObj_ResurrectionStone_pos);
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_ResurrectionStone_pos);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(ResurrectionStoneVertex), ResurrectionStoneVertex, GL_STATIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_POS, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_POS);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	// For Cloak of Invisibility and Resurrection Stone
+	primitiveCacheInitialize(&gPrimitives, DV_ATTRIB_POS);
+	gCloakOfInvisibility = primitiveCachePolygon(&gPrimitives, 3, 90.0f);	// Apex on top
+	gResurrectionStone = primitiveCacheCircle(&gPrimitives, 3600);
+	primitiveCacheUpload(&gPrimitives);
 
 	// For Elder Wand
 	glGenVertexArrays(1, &gVAObj_ElderWand);
@@ -435,54 +420,12 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -500,8 +443,6 @@ void display(void) {
 	// Variable declaration
 	mat4 ModelViewMatrix, ModelViewProjectionMatrix;
 	mat4 translationMatrix, rotationMatrix;
-	static GLfloat trans = 5.0f;
-	static GLfloat rot = 0.0f;
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -517,17 +458,16 @@ void display(void) {
 
 	translationMatrix = translate(0.0f, 0.0f, -5.0f);
 	ModelViewMatrix = translationMatrix;
-	translationMatrix = translate(-trans, -trans, 0.0f);
+	translationMatrix = translate(-gTrans, -gTrans, 0.0f);
 	ModelViewMatrix *= translationMatrix;
-	rotationMatrix = rotate(rot, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(gRot, 0.0f, 1.0f, 0.0f);
 	ModelViewMatrix *= rotationMatrix;
+	ModelViewMatrix *= scale(gTriangleRadius, gTriangleRadius, 1.0f);
 
 	ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
 	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
 
-	glBindVertexArray(gVAObj_CloakOfInvisibility);
-	glDrawArrays(GL_LINE_LOOP, 0, 3);
-	glBindVertexArray(0);
+	primitiveCacheDraw(&gPrimitives, gCloakOfInvisibility, GL_LINE_LOOP);
 
 	// For Resurrection Stone
 	ModelViewMatrix = mat4::identity();
@@ -537,17 +477,16 @@ void display(void) {
 
 	translationMatrix = translate(0.0f, 0.0f, -5.0f);
 	ModelViewMatrix = translationMatrix;
-	translationMatrix = translate(trans, -trans, 0.0f);
+	translationMatrix = translate(gTrans, -gTrans, 0.0f);
 	ModelViewMatrix *= translationMatrix;
-	rotationMatrix = rotate(rot, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(gRot, 0.0f, 1.0f, 0.0f);
 	ModelViewMatrix *= rotationMatrix;
+	ModelViewMatrix *= scale(gInCircleRadius, gInCircleRadius, 1.0f);
 
 	ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
 	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
 
-	glBindVertexArray(gVAObj_ResurrectionStone);
-	glDrawArrays(GL_POINTS, 0, 3600);
-	glBindVertexArray(0);
+	primitiveCacheDraw(&gPrimitives, gResurrectionStone, GL_POINTS);
 
 	// For Elder Wand
 	ModelViewMatrix = mat4::identity();
@@ -557,9 +496,9 @@ void display(void) {
 
 	translationMatrix = translate(0.0f, 0.0f, -5.0f);
 	ModelViewMatrix = translationMatrix;
-	translationMatrix = translate(0.0f, trans, 0.0f);
+	translationMatrix = translate(0.0f, gTrans, 0.0f);
 	ModelViewMatrix *= translationMatrix;
-	rotationMatrix = rotate(rot, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(gRot, 0.0f, 1.0f, 0.0f);
 	ModelViewMatrix *= rotationMatrix;
 
 	ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
@@ -572,16 +511,17 @@ void display(void) {
 	// End of OpenGL shading program
 	glUseProgram(0);
 
-	if(trans >= 0.0f)
-		trans -= 0.005f;
-	if(rot <= 720.0f)
-		rot += 0.5f;
-
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last frame
 	// Code
+	if(gTrans >= 0.0f)
+		gTrans -= 0.3f * delta;		// Units per second
+	if(gRot <= 720.0f)
+		gRot += 30.0f * delta;		// Degrees per second
+	if(gTrans < 0.0f && gRot > 720.0f)
+		renderOnDemandSetAnimation(&gRenderLoop, 0.0);	// Scene is static from now on
 }
 
 void Uninitialize() {
@@ -596,32 +536,17 @@ void Uninitialize() {
 	glUseProgram(0);
 
 	// Destroy Vertex Array Object
-	if(gVAObj_CloakOfInvisibility) {
-		glDeleteVertexArrays(1, &gVAObj_CloakOfInvisibility);
-		gVAObj_CloakOfInvisibility = 0;
-	}
-	if(gVAObj_ResurrectionStone) {
-		glDeleteVertexArrays(1, &gVAObj_ResurrectionStone);
-		gVAObj_ResurrectionStone = 0;
-	}
 	if(gVAObj_ElderWand) {
 		glDeleteVertexArrays(1, &gVAObj_ElderWand);
 		gVAObj_ElderWand = 0;
 	}
 
 	// Destroy Vertex Buffer Object
-	if(gVBObj_CloakOfInvisibility_pos) {
-		glDeleteBuffers(1, &gVBObj_CloakOfInvisibility_pos);
-		gVBObj_CloakOfInvisibility_pos = 0;
-	}
-	if(gVBObj_ResurrectionStone_pos) {
-		glDeleteBuffers(1, &gVBObj_ResurrectionStone_pos);
-		gVBObj_ResurrectionStone_pos = 0;
-	}
 	if(gVBObj_ElderWand_pos) {
 		glDeleteBuffers(1, &gVBObj_ElderWand_pos);
 		gVBObj_ElderWand_pos = 0;
 	}
+	primitiveCacheDelete(&gPrimitives);
 
 	// Detach shaders
 	glDetachShader(gSPObj, gVSObj);		// Detach vertex shader from final shader program
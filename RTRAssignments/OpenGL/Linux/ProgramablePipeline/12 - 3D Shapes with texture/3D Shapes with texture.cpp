@@ -8,13 +8,15 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/FrameScheduler.h"
+#include "../Include/ShaderBuild.h"
+#include "../Include/TextureLoader.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
-#include <SOIL/SOIL.h>
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -49,7 +51,10 @@ int giWindowWidth = 800;
 int giWindowHeight = 600;
 
 GLfloat gGLfAngle = 0.0f;
+GLfloat gGLfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 GLuint Kundali_texture, Stone_texture;
+TextureLoader gTextureLoader;	// Textures are decoded on worker threads, placeholders until uploaded
 
 GLuint gVSObj;		// Vertex Shader Object
 GLuint gFSObj;		// Fragment Shader Object
@@ -70,7 +75,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -145,8 +150,12 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
+		textureLoaderUpdate(&gTextureLoader);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -275,8 +284,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
-	GLuint LoadBitmapAsTexture(const char*);	// Texture loading funtion
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -311,6 +319,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -345,7 +355,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -360,7 +370,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -369,7 +379,7 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_TEX, "vTexCoord");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -528,8 +538,9 @@ void Initialize(void) {
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
 
-	Stone_texture = LoadBitmapAsTexture("stone.png");
-	Kundali_texture = LoadBitmapAsTexture("vijay_kundali.png");
+	textureLoaderInitialize(&gTextureLoader);
+	textureLoaderRequest(&gTextureLoader, "stone.png", &Stone_texture);
+	textureLoaderRequest(&gTextureLoader, "vijay_kundali.png", &Kundali_texture);
 	glEnable(GL_TEXTURE_2D);
 
 	gPerspMatrix = mat4::identity();
@@ -538,80 +549,17 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 		exit(1);
 	}
 }
 
-GLuint LoadBitmapAsTexture(const char* path) {
-	// Variable declaration
-	int width, height;
-	unsigned char *imageData = NULL;
-	GLuint textureID;
-
-	// Code
-	imageData = SOIL_load_image(path, &width, &height, NULL, SOIL_LOAD_RGB);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-//	gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, imageData);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, (const void *)imageData);
-	glGenerateMipmap(GL_TEXTURE_2D);
-
-	SOIL_free_image_data(imageData);
-	return textureID;
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -623,6 +571,7 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
+	GLfloat angle = frameSchedulerLerpAngle(gGLfPrevAngle, gGLfAngle, gScheduler.alpha);
 	mat4 ModelViewMatrix, ModelViewProjectionMatrix;
 	mat4 translationMatrix, rotationMatrix;
 
@@ -639,7 +588,7 @@ void display(void) {
 	rotationMatrix = mat4::identity();
 
 	translationMatrix = translate(-2.0f, 0.0f, -7.0f);
-	rotationMatrix = rotate(gGLfAngle, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(angle, 0.0f, 1.0f, 0.0f);
 	ModelViewMatrix = translationMatrix * rotationMatrix;
 	ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
 	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
@@ -659,11 +608,11 @@ void display(void) {
 	rotationMatrix = mat4::identity();
 
 	translationMatrix = translate(2.0f, 0.0f, -7.0f);
-	rotationMatrix = rotate(gGLfAngle, 1.0f, 0.0f, 0.0f);
+	rotationMatrix = rotate(angle, 1.0f, 0.0f, 0.0f);
 	ModelViewMatrix = translationMatrix * rotationMatrix;
-	rotationMatrix = rotate(gGLfAngle, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(angle, 0.0f, 1.0f, 0.0f);
 	ModelViewMatrix *= rotationMatrix;
-	rotationMatrix = rotate(gGLfAngle, 0.0f, 0.0f, 1.0f);
+	rotationMatrix = rotate(angle, 0.0f, 0.0f, 1.0f);
 	ModelViewMatrix *= rotationMatrix;
 	ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
 	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
@@ -687,11 +636,12 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
-	gGLfAngle += 0.5f;
+	gGLfPrevAngle = gGLfAngle;
+	gGLfAngle += 30.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
+		gGLfAngle -= 360.0f;
 }
 
 void Uninitialize() {
@@ -743,14 +693,7 @@ void Uninitialize() {
 		gSPObj = 0;
 	}
 
-	if(Stone_texture) {
-		glDeleteTextures(1, &Stone_texture);
-		Stone_texture = 0;
-	}
-	if(Kundali_texture) {
-		glDeleteTextures(1, &Kundali_texture);
-		Kundali_texture = 0;
-	}
+	textureLoaderUninitialize(&gTextureLoader);	// Deletes Stone_texture and Kundali_texture too
 
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
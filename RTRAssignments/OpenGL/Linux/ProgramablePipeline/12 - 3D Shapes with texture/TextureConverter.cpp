@@ -0,0 +1,77 @@
+// Offline converter : images -> compressed textures with precomputed mip chain (.dvtx)
+// Every image is written next to itself with its extension replaced ("stone.png" -> "stone.dvtx"),
+// see TextureFile.h for file layout and TextureCompressor.h for mip filtering and block encoding.
+// TextureLoader.h makes these files on first run too; converting offline only moves that cost out of first start.
+// Date : 17 October 2026
+// By : Darshan Vikam
+//
+// Build & run (whenever an image changes) :
+//	g++ -O2 -o TextureConverter TextureConverter.cpp -lSOIL -lpthread
+//	./TextureConverter [-bc1 | -bc3 | -rgba8] [-threads N] stone.png vijay_kundali.png ../13\ -\ Static\ Smiley/smiley.png ...
+
+// General Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Local header files
+#include "../Include/TextureCompressor.h"
+
+// Entry point function
+int main(int argc, char *argv[]) {
+	// Variable declaration
+	TextureFormat format = TEXTURE_FORMAT_AUTO;	// BC1 for opaque images, BC3 for images with alpha
+	int numThreads = 0;				// Every CPU
+	int numFailed = 0, numImages = 0;
+	TextureFile file;
+	char path[512];
+	struct timespec start, end;
+	double ms;
+	size_t uncompressed;
+
+	// Code
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "-bc1") == 0)
+			format = TEXTURE_FORMAT_BC1;
+		else if(strcmp(argv[i], "-bc3") == 0)
+			format = TEXTURE_FORMAT_BC3;
+		else if(strcmp(argv[i], "-rgba8") == 0)
+			format = TEXTURE_FORMAT_RGBA8;
+		else if(strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else {
+			numImages++;
+			textureFilePath(argv[i], path, sizeof(path));
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			if(textureCompressImage(argv[i], format, numThreads, &file) == false) {
+				printf("\n ERROR : Unable to load or compress %s.", argv[i]);
+				numFailed++;
+				continue;
+			}
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			ms = ((double)(end.tv_sec - start.tv_sec) * 1000.0) + ((double)(end.tv_nsec - start.tv_nsec) / 1000000.0);
+
+			// Same chain as RGBA8 texture with glGenerateMipmap(); drivers keep RGB8 as 4 bytes per texel too
+			uncompressed = 0;
+			for(unsigned int l = 0; l < file.header->numLevels; l++)
+				uncompressed += (size_t)file.header->level[l].width * file.header->level[l].height * 4;
+
+			if(textureFileWrite(path, &file) == false)
+				numFailed++;
+			else
+				printf("\n %s -> %s : %u x %u, %s, %u levels, %zu KB (RGBA8 %zu KB, %.1fx smaller) in %.1f ms",
+					argv[i], path, file.header->width, file.header->height, textureFormatName(file.header->format), file.header->numLevels,
+					(size_t)(file.header->fileSize - file.header->level[0].offset) / 1024, uncompressed / 1024,
+					(double)uncompressed / (double)(file.header->fileSize - file.header->level[0].offset), ms);
+			textureFileUnload(&file);
+		}
+	}
+
+	if(numImages == 0)
+		printf("\n Usage : %s [-bc1 | -bc3 | -rgba8] [-threads N] image ...", argv[0]);
+	else
+		printf("\n %d of %d images converted (%s block encoder).", numImages - numFailed, numImages, TEXTURE_COMPRESSOR_SIMD_NAME);
+	printf("\n");
+	return (numFailed == 0 && numImages > 0) ? 0 : 1;
+}
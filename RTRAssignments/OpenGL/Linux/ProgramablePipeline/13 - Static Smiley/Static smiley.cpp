@@ -8,13 +8,15 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/RenderOnDemand.h"
+#include "../Include/ShaderBuild.h"
+#include "../Include/TextureLoader.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
-#include <SOIL/SOIL.h>
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -49,6 +51,7 @@ int giWindowWidth = 800;
 int giWindowHeight = 600;
 
 GLuint Smiley_texture;
+TextureLoader gTextureLoader;	// Texture is decoded on worker thread, placeholder until uploaded
 
 GLuint gVSObj;		// Vertex Shader Object
 GLuint gFSObj;		// Fragment Shader Object
@@ -59,6 +62,7 @@ GLuint gMVPUniform;	// Matrix
 GLuint gTextureSamplerUniform;
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
+RenderOnDemand gRenderLoop;	// Draws only when a frame is due
 
 // Entry point function
 int main() {
@@ -79,17 +83,21 @@ int main() {
 	// Code
 	CreateWindow();
 	Initialize();
+	renderOnDemandInitialize(&gRenderLoop, gpDisplay);
 
 	// Message loop
 	XEvent event;
 	KeySym keysym;
 	while(bDone == false) {
+		renderOnDemandWait(&gRenderLoop);	// Sleeps until an event comes or a frame is due
 		while(XPending(gpDisplay)) {
 			XNextEvent(gpDisplay, &event);
 			switch(event.type) {
 				case MapNotify :
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case KeyPress :
+					renderOnDemandInvalidate(&gRenderLoop);
 					keysym = XkbKeycodeToKeysym(gpDisplay, event.xkey.keycode, 0, 0);
 					switch(keysym) {
 						case XK_Escape :
@@ -114,6 +122,7 @@ int main() {
 					}
 					break;
 				case ButtonPress :
+					renderOnDemandInvalidate(&gRenderLoop);
 					switch(event.xbutton.button) {
 						case 1 :
 							break;
@@ -131,8 +140,10 @@ int main() {
 					winWidth = event.xconfigure.width;
 					winHeight = event.xconfigure.height;
 					Resize(winWidth, winHeight);
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case Expose :
+					renderOnDemandInvalidate(&gRenderLoop);
 					break;
 				case DestroyNotify :
 					break;
@@ -143,9 +154,14 @@ int main() {
 					break;
 			}
 		}
-		Update();
-		display();
+		if(renderOnDemandShouldDraw(&gRenderLoop) == true) {
+			if(textureLoaderUpdate(&gTextureLoader) == false)
+				renderOnDemandInvalidate(&gRenderLoop);		// Draw again until texture is resident
+			Update();
+			display();
+		}
 	}
+	renderOnDemandUninitialize(&gRenderLoop);
 	Uninitialize();
 	return 0;
 }
@@ -273,8 +289,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
-	GLuint LoadBitmapAsTexture(const char*);	// Texture loading funtion
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -343,7 +358,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -358,7 +373,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -367,7 +382,7 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_TEX, "vTexCoord");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -408,7 +423,8 @@ void Initialize(void) {
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
 
-	Smiley_texture = LoadBitmapAsTexture("smiley.png");
+	textureLoaderInitialize(&gTextureLoader);
+	textureLoaderRequest(&gTextureLoader, "smiley.png", &Smiley_texture);
 	glEnable(GL_TEXTURE_2D);
 
 	gPerspMatrix = mat4::identity();
@@ -417,80 +433,17 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 		exit(1);
 	}
 }
 
-GLuint LoadBitmapAsTexture(const char* path) {
-	// Variable declaration
-	int width, height;
-	unsigned char *imageData = NULL;
-	GLuint textureID;
-
-	// Code
-	imageData = SOIL_load_image(path, &width, &height, NULL, SOIL_LOAD_RGB);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-//	gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, imageData);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, (const void *)imageData);
-	glGenerateMipmap(GL_TEXTURE_2D);
-
-	SOIL_free_image_data(imageData);
-	return textureID;
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -582,10 +535,7 @@ void Uninitialize() {
 		gSPObj = 0;
 	}
 
-	if(Smiley_texture) {
-		glDeleteTextures(1, &Smiley_texture);
-		Smiley_texture = 0;
-	}
+	textureLoaderUninitialize(&gTextureLoader);	// Deletes Smiley_texture too
 
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
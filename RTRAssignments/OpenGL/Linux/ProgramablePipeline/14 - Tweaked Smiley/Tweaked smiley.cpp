@@ -8,13 +8,15 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/StreamBuffer.h"
+#include "../Include/ShaderBuild.h"
+#include "../Include/TextureLoader.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
-#include <SOIL/SOIL.h>
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -49,13 +51,15 @@ int giWindowWidth = 800;
 int giWindowHeight = 600;
 
 GLuint Smiley_texture;
+TextureLoader gTextureLoader;	// Texture is decoded on worker thread, placeholder until uploaded
 int KeyPressed = 0;
 
 GLuint gVSObj;		// Vertex Shader Object
 GLuint gFSObj;		// Fragment Shader Object
 GLuint gSPObj;		// Shader Program Object
 GLuint gVAObj_Smiley;		// Vertex Array Object - Static smiley 
-GLuint gVBObj_Smiley[2];	// Buffer Object - Static smiley = [1]-Vertices; [2]-TexCoord
+GLuint gVBObj_Smiley;		// Buffer Object - Static smiley vertices
+StreamBuffer gStreamBuffer;	// Texture coordinates, written every frame
 GLuint gMVPUniform;	// Matrix
 GLuint gTextureSamplerUniform;
 
@@ -165,6 +169,7 @@ int main() {
 			}
 		}
 		Update();
+		textureLoaderUpdate(&gTextureLoader);
 		display();
 	}
 	Uninitialize();
@@ -294,8 +299,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
-	GLuint LoadBitmapAsTexture(const char*);	// Texture loading funtion
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -364,7 +368,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -384,7 +388,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -393,7 +397,7 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_TEX, "vTexCoord");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -410,25 +414,27 @@ void Initialize(void) {
 	// For 3D Shapes
 	glGenVertexArrays(1, &gVAObj_Smiley);
 	glBindVertexArray(gVAObj_Smiley);		// For Quad
-		glGenBuffers(2, gVBObj_Smiley);
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Smiley[0]);		// For Position
+		glGenBuffers(1, &gVBObj_Smiley);
+		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Smiley);		// For Position
 		glBufferData(GL_ARRAY_BUFFER, sizeof(QuadVertex), QuadVertex, GL_STATIC_DRAW);
 		glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
 		glEnableVertexAttribArray(DV_ATTRIB_POS);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Smiley[1]);		// For Texture
-		glBufferData(GL_ARRAY_BUFFER, 4 * 2 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_TEX, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_TEX);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glEnableVertexAttribArray(DV_ATTRIB_TEX);		// For Texture, from gStreamBuffer while drawing
 	glBindVertexArray(0);
+	if(streamBufferCreate(&gStreamBuffer, 4 * 2 * sizeof(GLfloat)) == false) {
+		printf("\n Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
 
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
 
-	Smiley_texture = LoadBitmapAsTexture("smiley.png");
+	textureLoaderInitialize(&gTextureLoader);
+	textureLoaderRequest(&gTextureLoader, "smiley.png", &Smiley_texture);
 	glEnable(GL_TEXTURE_2D);
 
 	gPerspMatrix = mat4::identity();
@@ -437,80 +443,17 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 		exit(1);
 	}
 }
 
-GLuint LoadBitmapAsTexture(const char* path) {
-	// Variable declaration
-	int width, height;
-	unsigned char *imageData = NULL;
-	GLuint textureID;
-
-	// Code
-	imageData = SOIL_load_image(path, &width, &height, NULL, SOIL_LOAD_RGB);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-//	gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, imageData);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, (const void *)imageData);
-	glGenerateMipmap(GL_TEXTURE_2D);
-
-	SOIL_free_image_data(imageData);
-	return textureID;
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -528,6 +471,7 @@ void display(void) {
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	streamBufferBeginFrame(&gStreamBuffer);
 
 	// Starting of OpenGL shading program
 	glUseProgram(gSPObj);
@@ -597,16 +541,18 @@ void display(void) {
 		texCoord[6] = -1.0f;
 		texCoord[7] = -1.0f;
 	}
-	glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Smiley[1]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 4 * 2, texCoord, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(DV_ATTRIB_TEX, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-	glEnableVertexAttribArray(DV_ATTRIB_TEX);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	GLintptr texCoordOffset = streamBufferUpload(&gStreamBuffer, texCoord, sizeof(texCoord));
+	if(texCoordOffset >= 0) {
+		glBindBuffer(GL_ARRAY_BUFFER, gStreamBuffer.buffer);
+		glVertexAttribPointer(DV_ATTRIB_TEX, 2, GL_FLOAT, GL_FALSE, 0, (void *)texCoordOffset);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	}
 	glBindVertexArray(0);
 
 	// End of OpenGL shading program
 	glUseProgram(0);
+	streamBufferEndFrame(&gStreamBuffer);
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
@@ -635,10 +581,10 @@ void Uninitialize() {
 
 	// Destroy Vertex Buffer Object
 	if(gVBObj_Smiley) {
-		glDeleteBuffers(2, gVBObj_Smiley);
-		gVBObj_Smiley[0] = 0;
-		gVBObj_Smiley[1] = 0;
+		glDeleteBuffers(1, &gVBObj_Smiley);
+		gVBObj_Smiley = 0;
 	}
+	streamBufferDestroy(&gStreamBuffer);
 
 	// Detach shaders
 	glDetachShader(gSPObj, gVSObj);		// Detach vertex shader from final shader program
@@ -658,10 +604,7 @@ void Uninitialize() {
 		gSPObj = 0;
 	}
 
-	if(Smiley_texture) {
-		glDeleteTextures(1, &Smiley_texture);
-		Smiley_texture = 0;
-	}
+	textureLoaderUninitialize(&gTextureLoader);	// Deletes Smiley_texture too
 
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -59,7 +60,7 @@ GLuint gVSObj;		// Vertex Shader Object
 GLuint gFSObj;		// Fragment Shader Object
 GLuint gSPObj;		// Shader Program Object
 GLuint gVAObj_Checkerboard;	// Vertex Array Object - Static smiley 
-GLuint gVBObj_Checkerboard[2];	// Buffer Object - Static smiley = [1]-Vertices; [2]-TexCoord
+GLuint gVBObj_Checkerboard[2];	// Buffer Object - [0]-Vertices of both quads; [1]-TexCoord (never change, uploaded once)
 GLuint gMVPUniform;	// Matrix
 GLuint gTextureSamplerUniform;
 
@@ -278,7 +279,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 	void loadProceduralTexture(void);	// Procedural Texture loading funtion
 
 	// Variable declaration
@@ -348,7 +349,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -363,7 +364,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -372,18 +373,36 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_TEX, "vTexCoord");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
 	gTextureSamplerUniform = glGetUniformLocation(gSPObj, "u_texture_sampler");
 
 	// other variable initialization
+	const GLfloat CheckerboardVertices[] = {
+		// Straight board
+		-2.0f,  1.0f, 0.0f,	// top left
+		-2.0f, -1.0f, 0.0f,	// bottom left
+		 0.0f, -1.0f, 0.0f,	// bottom right
+		 0.0f,  1.0f, 0.0f,	// top right
+		// Tilted board
+		1.0f,  1.0f, 0.0f,		// Left top
+		1.0f, -1.0f, 0.0f,		// Left bottom
+		2.41421f, -1.0f, -1.41421f,	// Right bottom
+		2.41421f,  1.0f, -1.41421f	// Right top
+	};
 	const GLfloat CheckerboardTexture[] = {
+		// Straight board
 		0.0f, 1.0f,	// top left
 		0.0f, 0.0f,	// bottom left
 		1.0f, 0.0f,	// bottom right
-		1.0f, 1.0f	// top right
+		1.0f, 1.0f,	// top right
+		// Tilted board
+		0.0f, 1.0f,
+		0.0f, 0.0f,
+		1.0f, 0.0f,
+		1.0f, 1.0f
 	};
 
 	// For Quad
@@ -391,7 +410,7 @@ void Initialize(void) {
 	glBindVertexArray(gVAObj_Checkerboard);		// For Quad
 		glGenBuffers(2, gVBObj_Checkerboard);
 		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Checkerboard[0]);		// For Position
-		glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 4 * 3, NULL, GL_DYNAMIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(CheckerboardVertices), CheckerboardVertices, GL_STATIC_DRAW);
 		glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
 		glEnableVertexAttribArray(DV_ATTRIB_POS);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -416,54 +435,12 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 		exit(1);
 	}
@@ -515,20 +492,6 @@ void display(void) {
 	// Variable declaration
 	mat4 ModelViewMatrix, ModelViewProjectionMatrix;
 	mat4 translationMatrix;
-	const GLfloat StraightCheckerBoard[] = {
-		// Straight board
-		-2.0f,  1.0f, 0.0f,	// top left
-		-2.0f, -1.0f, 0.0f,	// bottom left
-		 0.0f, -1.0f, 0.0f,	// bottom right
-		 0.0f,  1.0f, 0.0f,	// top right
-	};
-	const GLfloat TiltedCheckerBoard[] = {
-		// Tilted board
-		1.0f,  1.0f, 0.0f,		// Left top
-		1.0f, -1.0f, 0.0f,		// Left bottom
-		2.41421f, -1.0f, -1.41421f,	// Right bottom
-		2.41421f,  1.0f, -1.41421f	// Right top
-	};
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -550,22 +513,9 @@ void display(void) {
 	glBindTexture(GL_TEXTURE_2D, TexImage);
 	glUniform1i(gTextureSamplerUniform, 0);
 
-	// For straight quad
-	glBindVertexArray(gVAObj_Checkerboard);
-	glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Checkerboard[0]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 4 * 3, StraightCheckerBoard, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-	glEnableVertexAttribArray(DV_ATTRIB_POS);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-	glBindVertexArray(0);
-
-	// For Tilted quad
 	glBindVertexArray(gVAObj_Checkerboard);
-	glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Checkerboard[0]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 4 * 3, TiltedCheckerBoard, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-	glEnableVertexAttribArray(DV_ATTRIB_POS);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);		// For straight quad
+	glDrawArrays(GL_TRIANGLE_FAN, 4, 4);		// For Tilted quad
 	glBindVertexArray(0);
 
 	// End of OpenGL shading program
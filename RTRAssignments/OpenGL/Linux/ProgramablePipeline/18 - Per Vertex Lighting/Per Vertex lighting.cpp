@@ -9,6 +9,8 @@
 #include <memory.h>
 #include "../Include/vmath.h"
 #include "../Include/Sphere.h"
+#include "../Include/LightMaterial.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -67,15 +69,12 @@ GLuint gVUniform;	// View Matrix uniform
 GLuint gPUniform;	// Projection Matrix uniform
 GLuint gKeyUniform;	// Key press uniform
 
-// Light related uniforms
-GLuint gLAmbUniform;		// Ambiemt component of light
-GLuint gLDiffUniform;		// Diffuse component of light
-GLuint gLSpecUniform;		// Specular componenet of light
-GLuint gLPosUniform;		// Light Position
-GLuint gKAmbUniform;		// Ambient componenet of Material
-GLuint gKDiffUniform;		// Diffuse component of Material
-GLuint gKSpecUniform;		// Specular componenet of Material
-GLuint gKShineUniform;		//  Shininess of Material
+GLuint gMaterialIndexUniform;	// Index of material in material library
+
+// Light and material uniform blocks
+MaterialLibrary gMaterials;
+LightBlock gLights;
+int gMaterialWhite, gMaterialAlbedo;	// Indices in gMaterials
 
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
@@ -301,7 +300,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -368,21 +367,18 @@ void Initialize(void) {
 		"uniform mat4 u_VMatrix;" \
 		"uniform mat4 u_PMatrix;" \
 		"uniform int u_KeyPressed;" \
-		"uniform vec3 u_LAmb, u_LDiff, u_LSpec;" \
-		"uniform vec4 u_LPos;" \
-		"uniform vec3 u_KAmb, u_KDiff, u_KSpec;" \
-		"uniform float u_KShine;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"out vec3 Phong_ADS_light;" \
 		"void main(void) {" \
 			"if(u_KeyPressed == 1) {" \
 				"vec4 eyeCoords = u_VMatrix * u_MMatrix * vPosition;" \
 				"vec3 transformedNormal = normalize(mat3(u_VMatrix * u_MMatrix) * vNormal);" \
-				"vec3 lightSource = normalize(vec3(u_LPos - eyeCoords));" \
+				"vec3 lightSource = normalize(vec3(u_Light[0].position - eyeCoords));" \
 				"vec3 reflectionVector = reflect(-lightSource, transformedNormal);" \
 				"vec3 viewVector = normalize(-eyeCoords.xyz);" \
-				"vec3 ambient = u_LAmb * u_KAmb;" \
-				"vec3 diffuse = u_LDiff * u_KDiff * max(dot(lightSource, transformedNormal), 0.0f);" \
-				"vec3 specular = u_LSpec * u_KSpec * pow(max(dot(reflectionVector, viewVector), 0.0f), u_KShine);" \
+				"vec3 ambient = u_Light[0].ambient.rgb * u_Material[u_MaterialIndex].ambient.rgb;" \
+				"vec3 diffuse = u_Light[0].diffuse.rgb * u_Material[u_MaterialIndex].diffuse.rgb * max(dot(lightSource, transformedNormal), 0.0f);" \
+				"vec3 specular = u_Light[0].specular.rgb * u_Material[u_MaterialIndex].specular.rgb * pow(max(dot(reflectionVector, viewVector), 0.0f), u_Material[u_MaterialIndex].specular.w);" \
 				"Phong_ADS_light = ambient + diffuse + specular;" \
 			"}" \
 			"else {" \
@@ -392,8 +388,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
-//	ShaderErrorCheck(gVSObj, "COMIPLE");		// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -407,8 +402,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
-//	ShaderErrorCheck(gFSObj, "COMPILE");		// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -417,21 +411,13 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_NORM, "vNormal");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
-//	ShaderErrorCheck(gSPObj, "LINK");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMUniform = glGetUniformLocation(gSPObj, "u_MMatrix");
 	gVUniform = glGetUniformLocation(gSPObj, "u_VMatrix");
 	gPUniform = glGetUniformLocation(gSPObj, "u_PMatrix");
-	gLAmbUniform = glGetUniformLocation(gSPObj, "u_LAmb");
-	gLDiffUniform = glGetUniformLocation(gSPObj, "u_LDiff");
-	gLSpecUniform = glGetUniformLocation(gSPObj, "u_LSpec");
-	gLPosUniform = glGetUniformLocation(gSPObj, "u_LPos");
-	gKAmbUniform = glGetUniformLocation(gSPObj, "u_KAmb");
-	gKDiffUniform = glGetUniformLocation(gSPObj, "u_KDiff");
-	gKSpecUniform = glGetUniformLocation(gSPObj, "u_KSpec");
-	gKShineUniform = glGetUniformLocation(gSPObj, "u_KShine");
+	gMaterialIndexUniform = glGetUniformLocation(gSPObj, "u_MaterialIndex");
 	gKeyUniform = glGetUniformLocation(gSPObj, "u_KeyPressed");
 
 	// Variable declaration - sphere related
@@ -460,6 +446,18 @@ void Initialize(void) {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
+	// Variable declaration - material related
+	GLfloat materialAmbient[] = { 0.0f, 0.0f, 0.0f };
+	GLfloat materialWhite[] = { 1.0f, 1.0f, 1.0f };
+	GLfloat albedoDiffuse[] = { 0.5f, 0.2f, 0.7f };
+	GLfloat albedoSpecular[] = { 0.7f, 0.7f, 0.7f };
+
+	// Materials are uploaded once, lights are updated every frame
+	gMaterialWhite = addMaterial(&gMaterials, materialAmbient, materialWhite, materialWhite, 50.0f);
+	gMaterialAlbedo = addMaterial(&gMaterials, materialAmbient, albedoDiffuse, albedoSpecular, 128.0f);
+	uploadMaterialLibrary(&gMaterials);
+	createLightBlock(&gLights);
+
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
@@ -470,54 +468,12 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -535,10 +491,6 @@ void display(void) {
 	// Variable declaration
 	mat4 ModelMatrix, ViewMatrix, ProjectionMatrix;
 	mat4 translationMatrix;
-	vec3 lightAmbient, lightDiffuse, lightSpecular;
-	vec4 lightPosition;
-	vec3 materialAmbient, materialDiffuse, materialSpecular;
-	GLfloat materialShininess;
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -552,36 +504,17 @@ void display(void) {
 	ProjectionMatrix = mat4::identity();
 	translationMatrix = mat4::identity();
 
-	if(gbAlbedoEnabled == true) {
-		lightAmbient = { 0.1f, 0.1f, 0.1f };
-		lightDiffuse = { 1.0f, 1.0f, 1.0f };
-		lightSpecular = { 1.0f, 1.0f, 1.0f };
-		lightPosition = { 100.0f, 100.0f, 100.0f, 1.0f };
-		materialAmbient = { 0.0f, 0.0f, 0.0f };
-		materialDiffuse = { 0.5f, 0.2f, 0.7f };
-		materialSpecular = { 0.7f, 0.7f, 0.7f };
-		materialShininess = 128.0f;
-	}
-	else {
-		lightAmbient = { 0.0f, 0.0f, 0.0f };
-		lightDiffuse = { 1.0f, 1.0f, 1.0f };
-		lightSpecular = { 1.0f, 1.0f, 1.0f };
-		lightPosition = { 100.0f, 100.0f, 100.0f, 1.0f };
-		materialAmbient = { 0.0f, 0.0f, 0.0f };
-		materialDiffuse = { 1.0f, 1.0f, 1.0f };
-		materialSpecular = { 1.0f, 1.0f, 1.0f };
-		materialShininess = 50.0f;
-	}
 	if(gbLightingEnabled == true) {
+		GLfloat lightAmbient[] = { 0.0f, 0.0f, 0.0f };
+		GLfloat lightAlbedoAmbient[] = { 0.1f, 0.1f, 0.1f };
+		GLfloat lightDiffuse[] = { 1.0f, 1.0f, 1.0f };
+		GLfloat lightSpecular[] = { 1.0f, 1.0f, 1.0f };
+		GLfloat lightPosition[] = { 100.0f, 100.0f, 100.0f, 1.0f };
+
 		glUniform1i(gKeyUniform, 1);
-		glUniform3fv(gLAmbUniform, 1, lightAmbient);
-		glUniform3fv(gLDiffUniform, 1, lightDiffuse);
-		glUniform3fv(gLSpecUniform, 1, lightSpecular);
-		glUniform4fv(gLPosUniform, 1, lightPosition);
-		glUniform3fv(gKAmbUniform, 1, materialAmbient);
-		glUniform3fv(gKDiffUniform, 1, materialDiffuse);
-		glUniform3fv(gKSpecUniform, 1, materialSpecular);
-		glUniform1f(gKShineUniform, 128);
+		setLight(&gLights, 0, (gbAlbedoEnabled == true) ? lightAlbedoAmbient : lightAmbient, lightDiffuse, lightSpecular, lightPosition);
+		updateLightBlock(&gLights);
+		glUniform1i(gMaterialIndexUniform, (gbAlbedoEnabled == true) ? gMaterialAlbedo : gMaterialWhite);
 	}
 	else
 		glUniform1i(gKeyUniform, 0);
@@ -635,6 +568,10 @@ void Uninitialize() {
 		gVBObj_Sphere[2] = 0;
 	}
 
+	// Delete uniform buffers
+	deleteMaterialLibrary(&gMaterials);
+	deleteLightBlock(&gLights);
+
 	// Detach shaders
 	glDetachShader(gSPObj, gVSObj);		// Detach vertex shader from final shader program
 	glDetachShader(gSPObj, gFSObj);		// Detach fragment shader from final shader program
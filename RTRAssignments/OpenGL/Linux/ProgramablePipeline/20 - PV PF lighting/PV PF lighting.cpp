@@ -9,6 +9,8 @@
 #include <memory.h>
 #include "../Include/vmath.h"
 #include "../Include/Sphere.h"
+#include "../Include/LightMaterial.h"
+#include "../Include/ShaderCache.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -57,15 +59,9 @@ GLfloat sphereTextures[764];
 unsigned short sphereElements[2280];
 GLuint gNumVertices, gNumElements;
 
-// For per vertex lighting
-GLuint gVSObj_PVL;		// Vertex Shader Object
-GLuint gFSObj_PVL;		// Fragment Shader Object
-GLuint gSPObj_PVL;		// Shader Program Object
-
-// For per fragment lighting
-GLuint gVSObj_PFL;		// Vertex Shader Object
-GLuint gFSObj_PFL;		// Fragment Shader Object
-GLuint gSPObj_PFL;		// Shader Program Object
+GLuint gSPObj_PVL;		// Shader Program Object - per vertex lighting
+GLuint gSPObj_PFL;		// Shader Program Object - per fragment lighting
+ShaderCache gShaderCache;	// Linked programs are reused from disk on next start
 
 GLuint gVAObj_Sphere;		// Vertex Array Object - 3D Sphere 
 GLuint gVBObj_Sphere[3];	// Buffer Object - Sphere[3] = [0]-Position; [1]-Normals; [2]-elements;
@@ -76,15 +72,12 @@ GLuint gVUniform;	// View Matrix uniform
 GLuint gPUniform;	// Projection Matrix uniform
 GLuint gKeyUniform;	// Key press uniform
 
-// Light related uniform declarations
-GLuint gLAmbUniform;		// Ambiemt component of light
-GLuint gLDiffUniform;		// Diffuse component of light
-GLuint gLSpecUniform;		// Specular componenet of light
-GLuint gLPosUniform;		// Light Position
-GLuint gKAmbUniform;		// Ambient componenet of Material
-GLuint gKDiffUniform;		// Diffuse component of Material
-GLuint gKSpecUniform;		// Specular componenet of Material
-GLuint gKShineUniform;		// Shininess of Material
+GLuint gMaterialIndexUniform;	// Index of material in material library
+
+// Light and material uniform blocks
+MaterialLibrary gMaterials;
+LightBlock gLights;
+int gMaterialWhite, gMaterialAlbedo;	// Indices in gMaterials
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
 
@@ -313,7 +306,6 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -347,6 +339,7 @@ void Initialize(void) {
 	GLenum glew_error = glewInit();
 	if(glew_error != GLEW_OK)
 		Uninitialize();
+	shaderCacheInitialize(&gShaderCache);
 
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
@@ -369,7 +362,6 @@ void Initialize(void) {
 
 	// Per Vertex lighting
 	// Vertex Shader
-	gVSObj_PVL = glCreateShader(GL_VERTEX_SHADER);	// Create shader
 	const GLchar *VSSrcCode_PVL =			// Source code of shader
 		"#version 450 core" \
 		"\n" \
@@ -377,21 +369,18 @@ void Initialize(void) {
 		"in vec3 vNormal;" \
 		"uniform mat4 u_MMatrix, u_VMatrix, u_PMatrix;" \
 		"uniform int u_KeyPressed;" \
-		"uniform vec4 u_LPos;" \
-		"uniform vec3 u_LAmb, u_LDiff, u_LSpec;" \
-		"uniform vec3 u_KAmb, u_KDiff, u_KSpec;" \
-		"uniform float u_KShine;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"out vec3 lighting;" \
 		"void main(void) {" \
 			"if(u_KeyPressed == 1) {" \
 				"vec4 eyeCoords = u_VMatrix * u_MMatrix * vPosition;" \
 				"vec3 transformedNormal = normalize(mat3(transpose(inverse(u_VMatrix * u_MMatrix))) * vNormal);" \
-				"vec3 lightSource = normalize(vec3(u_LPos - eyeCoords));" \
+				"vec3 lightSource = normalize(vec3(u_Light[0].position - eyeCoords));" \
 				"vec3 reflectionVector = reflect(-lightSource, transformedNormal);" \
 				"vec3 viewVector = normalize(-eyeCoords.xyz);" \
-				"vec3 ambient = u_LAmb * u_KAmb;" \
-				"vec3 diffuse = u_LDiff * u_KDiff * max(dot(lightSource, transformedNormal), 0.0f);" \
-				"vec3 specular = u_LSpec * u_KSpec * pow(max(dot(reflectionVector, viewVector), 0.0f), u_KShine);" \
+				"vec3 ambient = u_Light[0].ambient.rgb * u_Material[u_MaterialIndex].ambient.rgb;" \
+				"vec3 diffuse = u_Light[0].diffuse.rgb * u_Material[u_MaterialIndex].diffuse.rgb * max(dot(lightSource, transformedNormal), 0.0f);" \
+				"vec3 specular = u_Light[0].specular.rgb * u_Material[u_MaterialIndex].specular.rgb * pow(max(dot(reflectionVector, viewVector), 0.0f), u_Material[u_MaterialIndex].specular.w);" \
 				"lighting = ambient + diffuse + specular;" \
 			"}" \
 			"else {" \
@@ -399,12 +388,8 @@ void Initialize(void) {
 			"}" \
 			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * vPosition;" \
 		"}";
-	glShaderSource(gVSObj_PVL, 1, (const GLchar**)&VSSrcCode_PVL, NULL);
-	glCompileShader(gVSObj_PVL);			// Compile Shader
-	ShaderErrorCheck(gVSObj_PVL, (char *)"VERTEX");	// Error checking for shader
 
 	// Fragment Shader
-	gFSObj_PVL = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
 	const GLchar *FSSrcCode_PVL = 			// Source code of shader
 		"#version 450 core" \
 		"\n" \
@@ -413,22 +398,14 @@ void Initialize(void) {
 		"void main(void) {" \
 			"FragColor = vec4(lighting, 1.0f);" \
 		"}";
-	glShaderSource(gFSObj_PVL, 1, (const GLchar**)&FSSrcCode_PVL, NULL);
-	glCompileShader(gFSObj_PVL);			// Compile Shader
-	ShaderErrorCheck(gFSObj_PVL, (char *)"FRAGMENT");	// Error checking for shader
 
-	// Shader program
-	gSPObj_PVL = glCreateProgram();		// Create final shader
-	glAttachShader(gSPObj_PVL, gVSObj_PVL);		// Add Vertex shader code to final shader
-	glAttachShader(gSPObj_PVL, gFSObj_PVL);		// Add Fragment shader code to final shader
-	glBindAttribLocation(gSPObj_PVL, DV_ATTRIB_POS, "vPosition");
-	glBindAttribLocation(gSPObj_PVL, DV_ATTRIB_NORM, "vNormal");
-	glLinkProgram(gSPObj_PVL);
-	ShaderErrorCheck(gSPObj_PVL, (char *)"PROGRAM");	// Error checking for shader
+	// Shader program - loaded from shader cache, or submitted for compiling with other misses and stored in shaderCacheFinish()
+	const ShaderAttrib lightingAttribs[] = { { DV_ATTRIB_POS, "vPosition" }, { DV_ATTRIB_NORM, "vNormal" } };
+	const ShaderSource stages_PVL[] = { { SHADER_STAGE_VERTEX, VSSrcCode_PVL }, { SHADER_STAGE_FRAGMENT, FSSrcCode_PVL } };
+	shaderCacheAdd(&gShaderCache, &gSPObj_PVL, stages_PVL, 2, lightingAttribs, 2);
 
 	// Per Fragment lighting
 	// Vertex Shader
-	gVSObj_PFL = glCreateShader(GL_VERTEX_SHADER);	// Create shader
 	const GLchar *VSSrcCode_PFL =			// Source code of shader
 		"#version 450 core" \
 		"\n" \
@@ -436,30 +413,24 @@ void Initialize(void) {
 		"in vec3 vNormal;" \
 		"uniform mat4 u_MMatrix, u_VMatrix, u_PMatrix;" \
 		"uniform int u_KeyPressed;" \
-		"uniform vec4 u_LPos;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"out vec3 tNorm, LSrc, viewVec;" \
 		"void main(void) {" \
 			"if(u_KeyPressed == 1) {" \
 				"vec4 eyeCoords = u_VMatrix * u_MMatrix * vPosition;" \
 				"tNorm = mat3(transpose(inverse(u_VMatrix * u_MMatrix))) * vNormal;" \
-				"LSrc = vec3(u_LPos - eyeCoords);" \
+				"LSrc = vec3(u_Light[0].position - eyeCoords);" \
 				"viewVec = -eyeCoords.xyz;" \
 			"}" \
 			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * vPosition;" \
 		"}";
-	glShaderSource(gVSObj_PFL, 1, (const GLchar**)&VSSrcCode_PFL, NULL);
-	glCompileShader(gVSObj_PFL);			// Compile Shader
-	ShaderErrorCheck(gVSObj_PFL, (char *)"VERTEX");	// Error checking for shader
 
 	// Fragment Shader
-	gFSObj_PFL = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
 	const GLchar *FSSrcCode_PFL = 			// Source code of shader
 		"#version 450 core" \
 		"\n" \
 		"in vec3 tNorm, LSrc, viewVec;" \
-		"uniform vec3 u_LAmb, u_LDiff, u_LSpec;" \
-		"uniform vec3 u_KAmb, u_KDiff, u_KSpec;" \
-		"uniform float u_KShine;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"uniform int u_KeyPressed;" \
 		"out vec4 FragColor;" \
 		"void main(void) {" \
@@ -469,9 +440,9 @@ void Initialize(void) {
 				"vec3 lightSource = normalize(LSrc);" \
 				"vec3 reflectionVector = reflect(-lightSource, transformedNormal);" \
 				"vec3 viewVector = normalize(viewVec);" \
-				"vec3 ambient = u_LAmb * u_KAmb;" \
-				"vec3 diffuse = u_LDiff * u_KDiff * max(dot(lightSource, transformedNormal), 0.0f);" \
-				"vec3 specular = u_LSpec * u_KSpec * pow(max(dot(reflectionVector, viewVector), 0.0f), u_KShine);" \
+				"vec3 ambient = u_Light[0].ambient.rgb * u_Material[u_MaterialIndex].ambient.rgb;" \
+				"vec3 diffuse = u_Light[0].diffuse.rgb * u_Material[u_MaterialIndex].diffuse.rgb * max(dot(lightSource, transformedNormal), 0.0f);" \
+				"vec3 specular = u_Light[0].specular.rgb * u_Material[u_MaterialIndex].specular.rgb * pow(max(dot(reflectionVector, viewVector), 0.0f), u_Material[u_MaterialIndex].specular.w);" \
 				"lighting = ambient + diffuse + specular;" \
 			"}" \
 			"else {" \
@@ -479,31 +450,23 @@ void Initialize(void) {
 			"}" \
 			"FragColor = vec4(lighting, 1.0f);" \
 		"}";
-	glShaderSource(gFSObj_PFL, 1, (const GLchar**)&FSSrcCode_PFL, NULL);
-	glCompileShader(gFSObj_PFL);			// Compile Shader
-	ShaderErrorCheck(gFSObj_PFL, (char *)"FRAGMENT");	// Error checking for shader
 
 	// Shader program
-	gSPObj_PFL = glCreateProgram();		// Create final shader
-	glAttachShader(gSPObj_PFL, gVSObj_PFL);		// Add Vertex shader code to final shader
-	glAttachShader(gSPObj_PFL, gFSObj_PFL);		// Add Fragment shader code to final shader
-	glBindAttribLocation(gSPObj_PFL, DV_ATTRIB_POS, "vPosition");
-	glBindAttribLocation(gSPObj_PFL, DV_ATTRIB_NORM, "vNormal");
-	glLinkProgram(gSPObj_PFL);
-	ShaderErrorCheck(gSPObj_PFL, (char *)"PROGRAM");	// Error checking for shader
+	const ShaderSource stages_PFL[] = { { SHADER_STAGE_VERTEX, VSSrcCode_PFL }, { SHADER_STAGE_FRAGMENT, FSSrcCode_PFL } };
+	shaderCacheAdd(&gShaderCache, &gSPObj_PFL, stages_PFL, 2, lightingAttribs, 2);
+
+	// Both programs compile together on a miss; status is asked only here
+	if(shaderCacheFinish(&gShaderCache) == false) {
+		printf("\n Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
 
 	// Get uniform location(s)
 	gMUniform = glGetUniformLocation(gSPObj_PVL, "u_MMatrix");
 	gVUniform = glGetUniformLocation(gSPObj_PVL, "u_VMatrix");
 	gPUniform = glGetUniformLocation(gSPObj_PVL, "u_PMatrix");
-	gLAmbUniform = glGetUniformLocation(gSPObj_PVL, "u_LAmb");
-	gLDiffUniform = glGetUniformLocation(gSPObj_PVL, "u_LDiff");
-	gLSpecUniform = glGetUniformLocation(gSPObj_PVL, "u_LSpec");
-	gLPosUniform = glGetUniformLocation(gSPObj_PVL, "u_LPos");
-	gKAmbUniform = glGetUniformLocation(gSPObj_PVL, "u_KAmb");
-	gKDiffUniform = glGetUniformLocation(gSPObj_PVL, "u_KDiff");
-	gKSpecUniform = glGetUniformLocation(gSPObj_PVL, "u_KSpec");
-	gKShineUniform = glGetUniformLocation(gSPObj_PVL, "u_KShine");
+	gMaterialIndexUniform = glGetUniformLocation(gSPObj_PVL, "u_MaterialIndex");
 	gKeyUniform = glGetUniformLocation(gSPObj_PVL, "u_KeyPressed");
 
 	// Variable declaration - sphere related
@@ -532,6 +495,18 @@ void Initialize(void) {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
+	// Variable declaration - material related
+	GLfloat materialAmbient[] = { 0.0f, 0.0f, 0.0f };
+	GLfloat materialWhite[] = { 1.0f, 1.0f, 1.0f };
+	GLfloat albedoDiffuse[] = { 0.5f, 0.2f, 0.7f };
+	GLfloat albedoSpecular[] = { 0.7f, 0.7f, 0.7f };
+
+	// Materials are uploaded once, lights are updated every frame
+	gMaterialWhite = addMaterial(&gMaterials, materialAmbient, materialWhite, materialWhite, 50.0f);
+	gMaterialAlbedo = addMaterial(&gMaterials, materialAmbient, albedoDiffuse, albedoSpecular, 128.0f);
+	uploadMaterialLibrary(&gMaterials);
+	createLightBlock(&gLights);
+
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
@@ -542,58 +517,6 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
-	// Function declaration
-	void Uninitialize(void);
-
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
-	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
-		Uninitialize();
-	}
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -607,10 +530,6 @@ void display(void) {
 	// Variable declaration
 	mat4 ModelMatrix, ViewMatrix, ProjectionMatrix;
 	mat4 translationMatrix;
-	vec3 lightAmbient, lightDiffuse, lightSpecular;
-	vec4 lightPosition;
-	vec3 materialAmbient, materialDiffuse, materialSpecular;
-	GLfloat materialShininess;
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -627,36 +546,17 @@ void display(void) {
 	ProjectionMatrix = mat4::identity();
 	translationMatrix = mat4::identity();
 
-	if(gbAlbedoEnabled == true) {
-		lightAmbient = { 0.1f, 0.1f, 0.1f };
-		lightDiffuse = { 1.0f, 1.0f, 1.0f };
-		lightSpecular = { 1.0f, 1.0f, 1.0f };
-		lightPosition = { 100.0f, 100.0f, 100.0f, 1.0f };
-		materialAmbient = { 0.0f, 0.0f, 0.0f };
-		materialDiffuse = { 0.5f, 0.2f, 0.7f };
-		materialSpecular = { 0.7f, 0.7f, 0.7f };
-		materialShininess = 128.0f;
-	}
-	else {
-		lightAmbient = { 0.0f, 0.0f, 0.0f };
-		lightDiffuse = { 1.0f, 1.0f, 1.0f };
-		lightSpecular = { 1.0f, 1.0f, 1.0f };
-		lightPosition = { 100.0f, 100.0f, 100.0f, 1.0f };
-		materialAmbient = { 0.0f, 0.0f, 0.0f };
-		materialDiffuse = { 1.0f, 1.0f, 1.0f };
-		materialSpecular = { 1.0f, 1.0f, 1.0f };
-		materialShininess = 50.0f;
-	}
 	if(gbLightingEnabled == true) {
+		GLfloat lightAmbient[] = { 0.0f, 0.0f, 0.0f };
+		GLfloat lightAlbedoAmbient[] = { 0.1f, 0.1f, 0.1f };
+		GLfloat lightDiffuse[] = { 1.0f, 1.0f, 1.0f };
+		GLfloat lightSpecular[] = { 1.0f, 1.0f, 1.0f };
+		GLfloat lightPosition[] = { 100.0f, 100.0f, 100.0f, 1.0f };
+
 		glUniform1i(gKeyUniform, 1);
-		glUniform3fv(gLAmbUniform, 1, lightAmbient);
-		glUniform3fv(gLDiffUniform, 1, lightDiffuse);
-		glUniform3fv(gLSpecUniform, 1, lightSpecular);
-		glUniform4fv(gLPosUniform, 1, lightPosition);
-		glUniform3fv(gKAmbUniform, 1, materialAmbient);
-		glUniform3fv(gKDiffUniform, 1, materialDiffuse);
-		glUniform3fv(gKSpecUniform, 1, materialSpecular);
-		glUniform1fv(gKShineUniform, 1, &materialShininess);
+		setLight(&gLights, 0, (gbAlbedoEnabled == true) ? lightAlbedoAmbient : lightAmbient, lightDiffuse, lightSpecular, lightPosition);
+		updateLightBlock(&gLights);
+		glUniform1i(gMaterialIndexUniform, (gbAlbedoEnabled == true) ? gMaterialAlbedo : gMaterialWhite);
 	}
 	else
 		glUniform1i(gKeyUniform, 0);
@@ -678,6 +578,7 @@ void display(void) {
 	glUseProgram(0);
 
 	glXSwapBuffers(gpDisplay, gWindow);
+	shaderCacheFirstFrame(&gShaderCache);
 }
 
 void Update(void) {
@@ -710,40 +611,16 @@ void Uninitialize() {
 		gVBObj_Sphere[2] = 0;
 	}
 
-	// Pre Fragment lighting related
-	// Detach shaders
-	glDetachShader(gSPObj_PFL, gVSObj_PFL);		// Detach vertex shader from final shader program
-	glDetachShader(gSPObj_PFL, gFSObj_PFL);		// Detach fragment shader from final shader program
+	// Delete uniform buffers
+	deleteMaterialLibrary(&gMaterials);
+	deleteLightBlock(&gLights);
 
-	// Delete shaders
-	if(gVSObj_PFL) {			// Delete Vertex shader
-		glDeleteShader(gVSObj_PFL);
-		gVSObj_PFL = 0;
-	}
-	if(gFSObj_PFL) {			// Delete Fragment shader
-		glDeleteShader(gFSObj_PFL);
-		gFSObj_PFL = 0;
-	}
-	if(gSPObj_PFL) {		// Delete final shader program
+	// Delete shader programs (shader objects were deleted right after linking)
+	if(gSPObj_PFL) {		// Per fragment lighting
 		glDeleteProgram(gSPObj_PFL);
 		gSPObj_PFL = 0;
 	}
-
-	// Pre Vertex lighting related
-	// Detach shaders
-	glDetachShader(gSPObj_PVL, gVSObj_PVL);		// Detach vertex shader from final shader program
-	glDetachShader(gSPObj_PVL, gFSObj_PVL);		// Detach fragment shader from final shader program
-
-	// Delete shaders
-	if(gVSObj_PVL) {			// Delete Vertex shader
-		glDeleteShader(gVSObj_PVL);
-		gVSObj_PVL = 0;
-	}
-	if(gFSObj_PVL) {			// Delete Fragment shader
-		glDeleteShader(gFSObj_PVL);
-		gFSObj_PVL = 0;
-	}
-	if(gSPObj_PVL) {		// Delete final shader program
+	if(gSPObj_PVL) {		// Per vertex lighting
 		glDeleteProgram(gSPObj_PVL);
 		gSPObj_PVL = 0;
 	}
@@ -8,6 +8,9 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/LightMaterial.h"
+#include "../Include/FrameScheduler.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -49,6 +52,8 @@ int giWindowHeight = 600;
 bool gbLightingEnabled = false;
 bool gbAnimationEnabled = false;
 GLfloat gGLfAngle = 0.0f;
+GLfloat gGLfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 
 GLuint gVSObj;		// Vertex Shader Object
 GLuint gFSObj;		// Fragment Shader Object
@@ -61,15 +66,12 @@ GLuint gVUniform;	// View Matrix uniform
 GLuint gPUniform;	// Projection Matrix uniform
 GLuint gKeyUniform;	// Key press uniform
 
-// Light related uniforms
-GLuint gLAmbUniform;		// Ambiemt component of light
-GLuint gLDiffUniform;		// Diffuse component of light
-GLuint gLSpecUniform;		// Specular componenet of light
-GLuint gLPosUniform;		// Light Position
-GLuint gKAmbUniform;		// Ambient componenet of Material
-GLuint gKDiffUniform;		// Diffuse component of Material
-GLuint gKSpecUniform;		// Specular componenet of Material
-GLuint gKShineUniform;		// Shininess of Material
+GLuint gMaterialIndexUniform;	// Index of material in material library
+
+// Light and material uniform blocks
+MaterialLibrary gMaterials;
+LightBlock gLights;
+int gMaterialPyramid;	// Index in gMaterials
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
 
@@ -81,7 +83,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -164,8 +166,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -294,7 +299,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -329,6 +334,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -357,25 +364,22 @@ void Initialize(void) {
 		"in vec3 vNormal;" \
 		"uniform mat4 u_MMatrix, u_VMatrix, u_PMatrix;" \
 		"uniform int u_KeyPressed;" \
-		"uniform vec3 u_LAmb[2], u_LDiff[2], u_LSpec[2];" \
-		"uniform vec4 u_LPos[2];" \
-		"uniform vec3 u_KAmb, u_KDiff, u_KSpec;" \
-		"uniform float u_KShine;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"out vec3 ADS_light;" \
 		"void main(void) {" \
 			"if(u_KeyPressed == 1) {" \
 				"vec4 eyeCoords = u_VMatrix * u_MMatrix * vPosition;" \
 				"vec3 transformedNormal = normalize(mat3(u_VMatrix * u_MMatrix) * vNormal);" \
-				"vec3 lightSource[2], reflectionVector[2];" \
-				"vec3 ambient[2], diffuse[2], specular[2];" \
+				"vec3 lightSource[" LM_TOSTRING(LIGHT_MAX) "], reflectionVector[" LM_TOSTRING(LIGHT_MAX) "];" \
+				"vec3 ambient[" LM_TOSTRING(LIGHT_MAX) "], diffuse[" LM_TOSTRING(LIGHT_MAX) "], specular[" LM_TOSTRING(LIGHT_MAX) "];" \
 				"vec3 viewVector = normalize(-eyeCoords.xyz);" \
 				"ADS_light = vec3(0.0f);" \
-				"for(int i = 0; i < 2; i++) {" \
-					"lightSource[i] = normalize(vec3(u_LPos[i] - eyeCoords));" \
+				"for(int i = 0; i < u_LightCount; i++) {" \
+					"lightSource[i] = normalize(vec3(u_Light[i].position - eyeCoords));" \
 					"reflectionVector[i] = reflect(-lightSource[i], transformedNormal);" \
-					"ambient[i] = u_LAmb[i] * u_KAmb;" \
-					"diffuse[i] = u_LDiff[i] * u_KDiff * max(dot(lightSource[i], transformedNormal), 0.0f);" \
-					"specular[i] = u_LSpec[i] * u_KSpec * pow(max(dot(reflectionVector[i], viewVector), 0.0f), u_KShine);" \
+					"ambient[i] = u_Light[i].ambient.rgb * u_Material[u_MaterialIndex].ambient.rgb;" \
+					"diffuse[i] = u_Light[i].diffuse.rgb * u_Material[u_MaterialIndex].diffuse.rgb * max(dot(lightSource[i], transformedNormal), 0.0f);" \
+					"specular[i] = u_Light[i].specular.rgb * u_Material[u_MaterialIndex].specular.rgb * pow(max(dot(reflectionVector[i], viewVector), 0.0f), u_Material[u_MaterialIndex].specular.w);" \
 					"ADS_light += (ambient[i] + diffuse[i] + specular[i]);" \
 				"}" \
 			"}" \
@@ -386,7 +390,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);	// Error checking for shader
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
@@ -400,7 +404,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);	// Error checking for shader
 
 	// Shader program
 	gSPObj = glCreateProgram();		// Create final shader
@@ -409,20 +413,13 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_NORM, "vNormal");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);	// Error checking for shader
 
 	// Get uniform location(s)
 	gMUniform = glGetUniformLocation(gSPObj, "u_MMatrix");
 	gVUniform = glGetUniformLocation(gSPObj, "u_VMatrix");
 	gPUniform = glGetUniformLocation(gSPObj, "u_PMatrix");
-	gLAmbUniform = glGetUniformLocation(gSPObj, "u_LAmb");
-	gLDiffUniform = glGetUniformLocation(gSPObj, "u_LDiff");
-	gLSpecUniform = glGetUniformLocation(gSPObj, "u_LSpec");
-	gLPosUniform = glGetUniformLocation(gSPObj, "u_LPos");
-	gKAmbUniform = glGetUniformLocation(gSPObj, "u_KAmb");
-	gKDiffUniform = glGetUniformLocation(gSPObj, "u_KDiff");
-	gKSpecUniform = glGetUniformLocation(gSPObj, "u_KSpec");
-	gKShineUniform = glGetUniformLocation(gSPObj, "u_KShine");
+	gMaterialIndexUniform = glGetUniformLocation(gSPObj, "u_MaterialIndex");
 	gKeyUniform = glGetUniformLocation(gSPObj, "u_KeyPressed");
 
 	// Variable declarations
@@ -486,6 +483,13 @@ void Initialize(void) {
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
+	// Material is uploaded once, lights are updated every frame
+	GLfloat materialAmbient[] = { 0.0f, 0.0f, 0.0f };
+	GLfloat materialWhite[] = { 1.0f, 1.0f, 1.0f };
+	gMaterialPyramid = addMaterial(&gMaterials, materialAmbient, materialWhite, materialWhite, 50.0f);
+	uploadMaterialLibrary(&gMaterials);
+	createLightBlock(&gLights);
+
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
@@ -496,54 +500,12 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -559,6 +521,7 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
+	GLfloat angle = frameSchedulerLerpAngle(gGLfPrevAngle, gGLfAngle, gScheduler.alpha);
 	mat4 ModelMatrix, ViewMatrix, ProjectionMatrix;
 	mat4 translationMatrix, rotationMatrix;
 
@@ -587,21 +550,16 @@ void display(void) {
 
 		glUniform1i(gKeyUniform, 1);
 
-		glUniform3fv(gLAmbUniform, 2, lightAmbient);
-		glUniform3fv(gLDiffUniform, 2, lightDiffuse);
-		glUniform3fv(gLSpecUniform, 2, lightSpecular);
-		glUniform4fv(gLPosUniform, 2, lightPosition);
-
-		glUniform3f(gKAmbUniform, 0.0f, 0.0f, 0.0f);
-		glUniform3f(gKDiffUniform, 1.0f, 1.0f, 1.0f);
-		glUniform3f(gKSpecUniform, 1.0f, 1.0f, 1.0f);
-		glUniform1f(gKShineUniform, 50);
+		for(int i = 0; i < 2; i++)
+			setLight(&gLights, i, &lightAmbient[i * 3], &lightDiffuse[i * 3], &lightSpecular[i * 3], &lightPosition[i * 4]);
+		updateLightBlock(&gLights);
+		glUniform1i(gMaterialIndexUniform, gMaterialPyramid);
 	}
 	else
 		glUniform1i(gKeyUniform, 0);
 
 	translationMatrix = translate(-0.0f, 0.0f, -5.0f);
-	rotationMatrix = rotate(gGLfAngle, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(angle, 0.0f, 1.0f, 0.0f);
 	ModelMatrix = translationMatrix * rotationMatrix;
 	ProjectionMatrix = gPerspMatrix;
 
@@ -619,12 +577,13 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
+	gGLfPrevAngle = gGLfAngle;
 	if(gbAnimationEnabled)
-		gGLfAngle += 0.5f;
+		gGLfAngle += 30.0f * delta;	// Degrees per second
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
+		gGLfAngle -= 360.0f;
 }
 
 void Uninitialize() {
@@ -652,6 +611,10 @@ void Uninitialize() {
 		gVBObj_Pyramid[1] = 0;
 	}
 
+	// Delete uniform buffers
+	deleteMaterialLibrary(&gMaterials);
+	deleteLightBlock(&gLights);
+
 	// Detach shaders
 	glDetachShader(gSPObj, gVSObj);		// Detach vertex shader from final shader program
 	glDetachShader(gSPObj, gFSObj);		// Detach fragment shader from final shader program
@@ -9,6 +9,9 @@
 #include <memory.h>
 #include "../Include/vmath.h"
 #include "../Include/Sphere.h"
+#include "../Include/LightMaterial.h"
+#include "../Include/FrameScheduler.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -52,6 +55,8 @@ bool gbToggleLighting = false;
 GLfloat gGLfXAngle = 0.0f;
 GLfloat gGLfYAngle = 0.0f;
 GLfloat gGLfZAngle = 0.0f;
+GLfloat gGLfPrevXAngle = 0.0f, gGLfPrevYAngle = 0.0f, gGLfPrevZAngle = 0.0f;	// At previous update, display() interpolates from them
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 
 GLfloat sphereVertices[1146];
 GLfloat sphereNormals[1146];
@@ -59,15 +64,8 @@ GLfloat sphereTextures[764];
 unsigned short sphereElements[2280];
 GLuint gNumVertices, gNumElements;
 
-// For per vertex lighting
-GLuint gVSObj_PVL;		// Vertex Shader Object
-GLuint gFSObj_PVL;		// Fragment Shader Object
-GLuint gSPObj_PVL;		// Shader Program Object
-
-// For per fragment lighting
-GLuint gVSObj_PFL;		// Vertex Shader Object
-GLuint gFSObj_PFL;		// Fragment Shader Object
-GLuint gSPObj_PFL;		// Shader Program Object
+GLuint gSPObj_PVL;		// Shader Program Object - per vertex lighting
+GLuint gSPObj_PFL;		// Shader Program Object - per fragment lighting
 
 GLuint gVAObj_Sphere;		// Vertex Array Object - 3D Sphere 
 GLuint gVBObj_Sphere[3];	// Buffer Object - Sphere[3] = [0]-Position; [1]-Normals; [2]-elements;
@@ -78,15 +76,12 @@ GLuint gVUniform;	// View Matrix uniform
 GLuint gPUniform;	// Projection Matrix uniform
 GLuint gKeyUniform;	// Key press uniform
 
-// Light related uniform declarations
-GLuint gLAmbUniform;		// Ambiemt component of light
-GLuint gLDiffUniform;		// Diffuse component of light
-GLuint gLSpecUniform;		// Specular componenet of light
-GLuint gLPosUniform;		// Light Position
-GLuint gKAmbUniform;		// Ambient componenet of Material
-GLuint gKDiffUniform;		// Diffuse component of Material
-GLuint gKSpecUniform;		// Specular componenet of Material
-GLuint gKShineUniform;		// Shininess of Material
+GLuint gMaterialIndexUniform;	// Index of material in material library
+
+// Light and material uniform blocks
+MaterialLibrary gMaterials;
+LightBlock gLights;
+int gMaterialSphere;	// Index in gMaterials
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
 
@@ -98,7 +93,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -181,8 +176,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -311,10 +309,10 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
+	ShaderBuild shaderBuild;		// Both programs are compiled together, status is asked only once
 	const int attribs[] = { GLX_CONTEXT_MAJOR_VERSION_ARB, 4,
 		GLX_CONTEXT_MINOR_VERSION_ARB, 5,
 		GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
@@ -346,6 +344,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -365,9 +365,10 @@ void Initialize(void) {
 	fclose(OGL_info);
 	OGL_info = NULL;
 
+	shaderBuildBegin(&shaderBuild);
+
 	// Per Vertex lighting
 	// Vertex Shader
-	gVSObj_PVL = glCreateShader(GL_VERTEX_SHADER);	// Create shader
 	const GLchar *VSSrcCode_PVL =			// Source code of shader
 		"#version 450 core" \
 		"\n" \
@@ -375,10 +376,7 @@ void Initialize(void) {
 		"in vec3 vNormal;" \
 		"uniform mat4 u_MMatrix, u_VMatrix, u_PMatrix;" \
 		"uniform int u_KeyPressed;" \
-		"uniform vec4 u_LPos[3];" \
-		"uniform vec3 u_LAmb[3], u_LDiff[3], u_LSpec[3];" \
-		"uniform vec3 u_KAmb, u_KDiff, u_KSpec;" \
-		"uniform float u_KShine;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"out vec3 lighting;" \
 		"void main(void) {" \
 			"if(u_KeyPressed == 1) {" \
@@ -388,12 +386,12 @@ void Initialize(void) {
 				"vec3 viewVector = normalize(-eyeCoords.xyz);" \
 				"vec3 lightSource, reflectionVector;" \
 				"vec3 ambient, diffuse, specular;" \
-				"for(int i = 0; i < 3; i++) {" \
-					"lightSource = normalize(vec3(u_LPos[i] - eyeCoords));" \
+				"for(int i = 0; i < u_LightCount; i++) {" \
+					"lightSource = normalize(vec3(u_Light[i].position - eyeCoords));" \
 					"reflectionVector = reflect(-lightSource, transformedNormal);" \
-					"ambient = u_LAmb[i] * u_KAmb;" \
-					"diffuse = u_LDiff[i] * u_KDiff * max(dot(lightSource, transformedNormal), 0.0f);" \
-					"specular = u_LSpec[i] * u_KSpec * pow(max(dot(reflectionVector, viewVector), 0.0f), u_KShine);" \
+					"ambient = u_Light[i].ambient.rgb * u_Material[u_MaterialIndex].ambient.rgb;" \
+					"diffuse = u_Light[i].diffuse.rgb * u_Material[u_MaterialIndex].diffuse.rgb * max(dot(lightSource, transformedNormal), 0.0f);" \
+					"specular = u_Light[i].specular.rgb * u_Material[u_MaterialIndex].specular.rgb * pow(max(dot(reflectionVector, viewVector), 0.0f), u_Material[u_MaterialIndex].specular.w);" \
 					"lighting += (ambient + diffuse + specular);" \
 				"}" \
 			"}" \
@@ -402,12 +400,8 @@ void Initialize(void) {
 			"}" \
 			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * vPosition;" \
 		"}";
-	glShaderSource(gVSObj_PVL, 1, (const GLchar**)&VSSrcCode_PVL, NULL);
-	glCompileShader(gVSObj_PVL);			// Compile Shader
-	ShaderErrorCheck(gVSObj_PVL, (char *)"VERTEX");	// Error checking for shader
 
 	// Fragment Shader
-	gFSObj_PVL = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
 	const GLchar *FSSrcCode_PVL = 			// Source code of shader
 		"#version 450 core" \
 		"\n" \
@@ -416,22 +410,14 @@ void Initialize(void) {
 		"void main(void) {" \
 			"FragColor = vec4(lighting, 1.0f);" \
 		"}";
-	glShaderSource(gFSObj_PVL, 1, (const GLchar**)&FSSrcCode_PVL, NULL);
-	glCompileShader(gFSObj_PVL);			// Compile Shader
-	ShaderErrorCheck(gFSObj_PVL, (char *)"FRAGMENT");	// Error checking for shader
 
-	// Shader program
-	gSPObj_PVL = glCreateProgram();		// Create final shader
-	glAttachShader(gSPObj_PVL, gVSObj_PVL);		// Add Vertex shader code to final shader
-	glAttachShader(gSPObj_PVL, gFSObj_PVL);		// Add Fragment shader code to final shader
-	glBindAttribLocation(gSPObj_PVL, DV_ATTRIB_POS, "vPosition");
-	glBindAttribLocation(gSPObj_PVL, DV_ATTRIB_NORM, "vNormal");
-	glLinkProgram(gSPObj_PVL);
-	ShaderErrorCheck(gSPObj_PVL, (char *)"PROGRAM");	// Error checking for shader
+	// Shader program - only submitted here, checked in shaderBuildFinish()
+	const ShaderAttrib lightingAttribs[] = { { DV_ATTRIB_POS, "vPosition" }, { DV_ATTRIB_NORM, "vNormal" } };
+	const ShaderSource stages_PVL[] = { { SHADER_STAGE_VERTEX, VSSrcCode_PVL }, { SHADER_STAGE_FRAGMENT, FSSrcCode_PVL } };
+	shaderBuildAdd(&shaderBuild, &gSPObj_PVL, stages_PVL, 2, lightingAttribs, 2);
 
 	// Per Fragment lighting
 	// Vertex Shader
-	gVSObj_PFL = glCreateShader(GL_VERTEX_SHADER);	// Create shader
 	const GLchar *VSSrcCode_PFL =			// Source code of shader
 		"#version 450 core" \
 		"\n" \
@@ -439,31 +425,25 @@ void Initialize(void) {
 		"in vec3 vNormal;" \
 		"uniform mat4 u_MMatrix, u_VMatrix, u_PMatrix;" \
 		"uniform int u_KeyPressed;" \
-		"uniform vec4 u_LPos[3];" \
-		"out vec3 tNorm, LSrc[3], viewVec;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
+		"out vec3 tNorm, LSrc[" LM_TOSTRING(LIGHT_MAX) "], viewVec;" \
 		"void main(void) {" \
 			"if(u_KeyPressed == 1) {" \
 				"vec4 eyeCoords = u_VMatrix * u_MMatrix * vPosition;" \
 				"tNorm = mat3(transpose(inverse(u_VMatrix * u_MMatrix))) * vNormal;" \
-				"for(int i = 0; i < 3; i ++)" \
-					"LSrc[i] = vec3(u_LPos[i] - eyeCoords);" \
+				"for(int i = 0; i < u_LightCount; i ++)" \
+					"LSrc[i] = vec3(u_Light[i].position - eyeCoords);" \
 				"viewVec = -eyeCoords.xyz;" \
 			"}" \
 			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * vPosition;" \
 		"}";
-	glShaderSource(gVSObj_PFL, 1, (const GLchar**)&VSSrcCode_PFL, NULL);
-	glCompileShader(gVSObj_PFL);			// Compile Shader
-	ShaderErrorCheck(gVSObj_PFL, (char *)"VERTEX");	// Error checking for shader
 
 	// Fragment Shader
-	gFSObj_PFL = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
 	const GLchar *FSSrcCode_PFL = 			// Source code of shader
 		"#version 450 core" \
 		"\n" \
-		"in vec3 tNorm, LSrc[3], viewVec;" \
-		"uniform vec3 u_LAmb[3], u_LDiff[3], u_LSpec[3];" \
-		"uniform vec3 u_KAmb, u_KDiff, u_KSpec;" \
-		"uniform float u_KShine;" \
+		"in vec3 tNorm, LSrc[" LM_TOSTRING(LIGHT_MAX) "], viewVec;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"uniform int u_KeyPressed;" \
 		"out vec4 FragColor;" \
 		"void main(void) {" \
@@ -473,12 +453,12 @@ void Initialize(void) {
 				"vec3 viewVector = normalize(viewVec);" \
 				"vec3 lightSource, reflectionVector;" \
 				"vec3 ambient, diffuse, specular;" \
-				"for(int i = 0; i < 3; i++) {" \
+				"for(int i = 0; i < u_LightCount; i++) {" \
 					"lightSource = normalize(LSrc[i]);" \
 					"reflectionVector = reflect(-lightSource, transformedNormal);" \
-					"ambient = u_LAmb[i] * u_KAmb;" \
-					"diffuse = u_LDiff[i] * u_KDiff * max(dot(lightSource, transformedNormal), 0.0f);" \
-					"specular = u_LSpec[i] * u_KSpec * pow(max(dot(reflectionVector, viewVector), 0.0f), u_KShine);" \
+					"ambient = u_Light[i].ambient.rgb * u_Material[u_MaterialIndex].ambient.rgb;" \
+					"diffuse = u_Light[i].diffuse.rgb * u_Material[u_MaterialIndex].diffuse.rgb * max(dot(lightSource, transformedNormal), 0.0f);" \
+					"specular = u_Light[i].specular.rgb * u_Material[u_MaterialIndex].specular.rgb * pow(max(dot(reflectionVector, viewVector), 0.0f), u_Material[u_MaterialIndex].specular.w);" \
 					"lighting += (ambient + diffuse + specular);" \
 				"}" \
 			"}" \
@@ -487,32 +467,10 @@ void Initialize(void) {
 			"}" \
 			"FragColor = vec4(lighting, 1.0f);" \
 		"}";
-	glShaderSource(gFSObj_PFL, 1, (const GLchar**)&FSSrcCode_PFL, NULL);
-	glCompileShader(gFSObj_PFL);			// Compile Shader
-	ShaderErrorCheck(gFSObj_PFL, (char *)"FRAGMENT");	// Error checking for shader
 
 	// Shader program
-	gSPObj_PFL = glCreateProgram();		// Create final shader
-	glAttachShader(gSPObj_PFL, gVSObj_PFL);		// Add Vertex shader code to final shader
-	glAttachShader(gSPObj_PFL, gFSObj_PFL);		// Add Fragment shader code to final shader
-	glBindAttribLocation(gSPObj_PFL, DV_ATTRIB_POS, "vPosition");
-	glBindAttribLocation(gSPObj_PFL, DV_ATTRIB_NORM, "vNormal");
-	glLinkProgram(gSPObj_PFL);
-	ShaderErrorCheck(gSPObj_PFL, (char *)"PROGRAM");	// Error checking for shader
-
-	// Get uniform location(s)
-	gMUniform = glGetUniformLocation(gSPObj_PVL, "u_MMatrix");
-	gVUniform = glGetUniformLocation(gSPObj_PVL, "u_VMatrix");
-	gPUniform = glGetUniformLocation(gSPObj_PVL, "u_PMatrix");
-	gLAmbUniform = glGetUniformLocation(gSPObj_PVL, "u_LAmb");
-	gLDiffUniform = glGetUniformLocation(gSPObj_PVL, "u_LDiff");
-	gLSpecUniform = glGetUniformLocation(gSPObj_PVL, "u_LSpec");
-	gLPosUniform = glGetUniformLocation(gSPObj_PVL, "u_LPos");
-	gKAmbUniform = glGetUniformLocation(gSPObj_PVL, "u_KAmb");
-	gKDiffUniform = glGetUniformLocation(gSPObj_PVL, "u_KDiff");
-	gKSpecUniform = glGetUniformLocation(gSPObj_PVL, "u_KSpec");
-	gKShineUniform = glGetUniformLocation(gSPObj_PVL, "u_KShine");
-	gKeyUniform = glGetUniformLocation(gSPObj_PVL, "u_KeyPressed");
+	const ShaderSource stages_PFL[] = { { SHADER_STAGE_VERTEX, VSSrcCode_PFL }, { SHADER_STAGE_FRAGMENT, FSSrcCode_PFL } };
+	shaderBuildAdd(&shaderBuild, &gSPObj_PFL, stages_PFL, 2, lightingAttribs, 2);
 
 	// Variable declaration - sphere related
 	getSphereVertexData(sphereVertices, sphereNormals, sphereTextures, sphereElements);
@@ -540,6 +498,27 @@ void Initialize(void) {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
+	// Sphere buffers were made while driver compiled; programs are needed from here on
+	if(shaderBuildFinish(&shaderBuild) == false) {
+		printf("\n Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
+
+	// Get uniform location(s)
+	gMUniform = glGetUniformLocation(gSPObj_PVL, "u_MMatrix");
+	gVUniform = glGetUniformLocation(gSPObj_PVL, "u_VMatrix");
+	gPUniform = glGetUniformLocation(gSPObj_PVL, "u_PMatrix");
+	gMaterialIndexUniform = glGetUniformLocation(gSPObj_PVL, "u_MaterialIndex");
+	gKeyUniform = glGetUniformLocation(gSPObj_PVL, "u_KeyPressed");
+
+	// Material is uploaded once, lights are updated every frame
+	GLfloat materialAmbient[] = { 0.0f, 0.0f, 0.0f };
+	GLfloat materialWhite[] = { 1.0f, 1.0f, 1.0f };
+	gMaterialSphere = addMaterial(&gMaterials, materialAmbient, materialWhite, materialWhite, 50.0f);
+	uploadMaterialLibrary(&gMaterials);
+	createLightBlock(&gLights);
+
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
@@ -550,58 +529,6 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
-	// Function declaration
-	void Uninitialize(void);
-
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
-	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
-		Uninitialize();
-	}
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -613,6 +540,9 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
+	GLfloat xAngle = frameSchedulerLerpAngle(gGLfPrevXAngle, gGLfXAngle, gScheduler.alpha);
+	GLfloat yAngle = frameSchedulerLerpAngle(gGLfPrevYAngle, gGLfYAngle, gScheduler.alpha);
+	GLfloat zAngle = frameSchedulerLerpAngle(gGLfPrevZAngle, gGLfZAngle, gScheduler.alpha);
 	mat4 ModelMatrix, ViewMatrix, ProjectionMatrix;
 	mat4 translationMatrix;
 
@@ -647,23 +577,15 @@ void display(void) {
 			 0.0f, 1.0f, 0.0f,
 			 0.0f, 0.0f, 1.0f };
 		GLfloat lightPosition[] = 
-			{ 0.0f, radius * (GLfloat)cos(gGLfXAngle * radian), radius * (GLfloat)sin(gGLfXAngle * radian), 1.0f,
-			 radius * (GLfloat)sin(gGLfYAngle * radian), 0.0f, radius * (GLfloat)cos(gGLfYAngle * radian), 1.0f,
-			 radius * (GLfloat)cos(gGLfZAngle * radian), radius * (GLfloat)sin(gGLfZAngle * radian), 0.0f, 1.0f };
-		const GLfloat materialAmbient[] = { 0.0f, 0.0f, 0.0f };
-		const GLfloat materialDiffuse[] = { 1.0f, 1.0f, 1.0f };
-		const GLfloat materialSpecular[] = { 1.0f, 1.0f, 1.0f };
-		const GLfloat materialShininess = 50.0f;
+			{ 0.0f, radius * (GLfloat)cos(xAngle * radian), radius * (GLfloat)sin(xAngle * radian), 1.0f,
+			 radius * (GLfloat)sin(yAngle * radian), 0.0f, radius * (GLfloat)cos(yAngle * radian), 1.0f,
+			 radius * (GLfloat)cos(zAngle * radian), radius * (GLfloat)sin(zAngle * radian), 0.0f, 1.0f };
 
 		glUniform1i(gKeyUniform, 1);
-		glUniform3fv(gLAmbUniform, 3, lightAmbient);
-		glUniform3fv(gLDiffUniform, 3, lightDiffuse);
-		glUniform3fv(gLSpecUniform, 3, lightSpecular);
-		glUniform4fv(gLPosUniform, 3, lightPosition);
-		glUniform3fv(gKAmbUniform, 1, materialAmbient);
-		glUniform3fv(gKDiffUniform, 1, materialDiffuse);
-		glUniform3fv(gKSpecUniform, 1, materialSpecular);
-		glUniform1fv(gKShineUniform, 1, &materialShininess);
+		for(int i = 0; i < 3; i++)
+			setLight(&gLights, i, &lightAmbient[i * 3], &lightDiffuse[i * 3], &lightSpecular[i * 3], &lightPosition[i * 4]);
+		updateLightBlock(&gLights);
+		glUniform1i(gMaterialIndexUniform, gMaterialSphere);
 	}
 	else
 		glUniform1i(gKeyUniform, 0);
@@ -687,20 +609,23 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
+	gGLfPrevXAngle = gGLfXAngle;
+	gGLfPrevYAngle = gGLfYAngle;
+	gGLfPrevZAngle = gGLfZAngle;
 	if(gbLightingEnabled) {
-		gGLfXAngle += 0.25f;
+		gGLfXAngle += 15.0f * delta;	// Degrees per second
 		if(gGLfXAngle >= 360.0f)
-			gGLfXAngle = 0.0f;
+			gGLfXAngle -= 360.0f;
 
-		gGLfYAngle += 0.50f;
+		gGLfYAngle += 30.0f * delta;	// Degrees per second
 		if(gGLfYAngle >= 360.0f)
-			gGLfYAngle = 0.0f;
+			gGLfYAngle -= 360.0f;
 
-		gGLfZAngle += 0.75f;
+		gGLfZAngle += 45.0f * delta;	// Degrees per second
 		if(gGLfZAngle >= 360.0f)
-			gGLfZAngle = 0.0f;
+			gGLfZAngle -= 360.0f;
 	}
 }
 
@@ -730,40 +655,16 @@ void Uninitialize() {
 		gVBObj_Sphere[2] = 0;
 	}
 
-	// Pre Fragment lighting related
-	// Detach shaders
-	glDetachShader(gSPObj_PFL, gVSObj_PFL);		// Detach vertex shader from final shader program
-	glDetachShader(gSPObj_PFL, gFSObj_PFL);		// Detach fragment shader from final shader program
+	// Delete uniform buffers
+	deleteMaterialLibrary(&gMaterials);
+	deleteLightBlock(&gLights);
 
-	// Delete shaders
-	if(gVSObj_PFL) {			// Delete Vertex shader
-		glDeleteShader(gVSObj_PFL);
-		gVSObj_PFL = 0;
-	}
-	if(gFSObj_PFL) {			// Delete Fragment shader
-		glDeleteShader(gFSObj_PFL);
-		gFSObj_PFL = 0;
-	}
-	if(gSPObj_PFL) {		// Delete final shader program
+	// Delete shader programs (shader objects were deleted right after linking)
+	if(gSPObj_PFL) {		// Per fragment lighting
 		glDeleteProgram(gSPObj_PFL);
 		gSPObj_PFL = 0;
 	}
-
-	// Pre Vertex lighting related
-	// Detach shaders
-	glDetachShader(gSPObj_PVL, gVSObj_PVL);		// Detach vertex shader from final shader program
-	glDetachShader(gSPObj_PVL, gFSObj_PVL);		// Detach fragment shader from final shader program
-
-	// Delete shaders
-	if(gVSObj_PVL) {			// Delete Vertex shader
-		glDeleteShader(gVSObj_PVL);
-		gVSObj_PVL = 0;
-	}
-	if(gFSObj_PVL) {			// Delete Fragment shader
-		glDeleteShader(gFSObj_PVL);
-		gFSObj_PVL = 0;
-	}
-	if(gSPObj_PVL) {		// Delete final shader program
+	if(gSPObj_PVL) {		// Per vertex lighting
 		glDeleteProgram(gSPObj_PVL);
 		gSPObj_PVL = 0;
 	}
@@ -7,8 +7,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <stddef.h>		// for offsetof()
+#include <time.h>		// for CPU frame time
 #include "../Include/vmath.h"
 #include "../Include/Sphere.h"
+#include "../Include/MeshOptimizer.h"
+#include "../Include/VertexFormat.h"
+#include "../Include/LightMaterial.h"
+#include "../Include/FrameScheduler.h"
+#include "../Include/Profiler.h"
+#include "../Include/ShaderBuild.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -31,6 +39,8 @@ enum {
 	DV_ATTRIB_COLOR,
 	DV_ATTRIB_NORM,
 	DV_ATTRIB_TEX,
+	DV_ATTRIB_CELL,		// Per instance
+	DV_ATTRIB_MATERIAL,	// Per instance
 };
 
 typedef GLXContext (* glXCreateContextAttribsARBProc)(Display *, GLXFBConfig, GLXContext, Bool, const int *);
@@ -52,46 +62,63 @@ bool gbXRotationEnabled = false;
 bool gbYRotationEnabled = false;
 bool gbZRotationEnabled = false;
 GLfloat gGLfAngle = 0.0f;
+GLfloat gGLfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 int gWidth, gHeight;
 
-GLfloat sphereVertices[1146];
-GLfloat sphereNormals[1146];
-GLfloat sphereTextures[764];
-unsigned short sphereElements[2280];
-GLuint gNumVertices, gNumElements;
+SphereLODChain gSphereLOD;	// Level of detail chain of sphere (all levels in one buffer)
+GLenum gSphereIndexType;	// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, as per gSphereLOD.indexSize
+VertexFormat gSphereFormat;	// Quantized layout of sphere vertices in buffer (position - snorm16, normal - octahedral)
 
-GLuint gVSObj;		// Vertex Shader Object
-GLuint gFSObj;		// Fragment Shader Object
 GLuint gSPObj;		// Shader Program Object
 GLuint gVAObj_Sphere;	// Vertex Array Object - 3D Sphere 
-GLuint gVBObj_Sphere[3];	// Buffer Object - Sphere[3] = [0]-Position; [1]-Normals; [2]-elements;
+GLuint gVBObj_Sphere[2];	// Buffer Object - Sphere[2] = [0]-Interleaved(Position, Normal) as per gSphereFormat; [1]-elements;
 
 GLuint gMUniform;	// Model Matrix uniform
 GLuint gVUniform;	// View Matrix uniform
 GLuint gPUniform;	// Projection Matrix uniform
 GLuint gKeyUniform;	// Key press uniform
 
-// Light related uniforms
-GLuint gLAmbUniform;		// Ambiemt component of light
-GLuint gLDiffUniform;		// Diffuse component of light
-GLuint gLSpecUniform;		// Specular componenet of light
-GLuint gLPosUniform;		// Light Position
-GLuint gKAmbUniform;		// Ambient componenet of Material
-GLuint gKDiffUniform;		// Diffuse component of Material
-GLuint gKSpecUniform;		// Specular componenet of Material
-GLuint gKShineUniform;		//  Shininess of Material
+GLuint gMaterialIndexUniform;	// Index of material in material library
+
+// Light and material uniform blocks
+MaterialLibrary gMaterials;
+LightBlock gLights;
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
 
-// Entry point function
-int main() {
+// Grid of spheres; default is 4 columns x 6 rows (one per material), can be given on command line
+int giGridColumns = 4;
+int giGridRows = 6;
+
+// Instanced mode : all spheres in one glDrawElementsInstanced() call
+bool gbInstanced = true;
+Profiler gProfiler;		// CPU and GPU time of frame parts, written to 24Spheres_profile.csv/.json on exit
+bool gbProfilerGraph = false;	// 'P' toggles on screen bar graph
+GLuint gSPObj_Instanced;	// Shader Program Object (instanced)
+GLuint gVAObj_Instanced;	// Vertex Array Object - sphere vertices + per instance data
+GLuint gVBObj_Instance;		// Buffer Object - per instance cell rectangle and material index
+GLuint gMUniform_Instanced, gVUniform_Instanced, gPUniform_Instanced, gKeyUniform_Instanced;
+
+// Per instance data; cell is viewport rectangle of sphere in NDC, applied after projection
+typedef struct {
+	GLfloat cell[4];	// x scale, y scale, x offset, y offset
+	GLuint material;
+} SphereInstance;
+
+#define FRAME_TIME_SAMPLES	256
+double gdFrameTimeSum = 0.0;	// CPU time of display() (excluding swap), averaged over FRAME_TIME_SAMPLES frames
+int giFrameTimeCount = 0;
+
+// Entry point function (optional arguments : columns rows, e.g. '300 300' for 90000 spheres)
+int main(int argc, char *argv[]) {
 	// Function declaration
 	void CreateWindow(void);
 	void ToggleFullscreen(void);
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -100,6 +127,16 @@ int main() {
 	int winHeight = giWindowHeight;
 
 	// Code
+	if(argc == 3) {
+		giGridColumns = atoi(argv[1]);
+		giGridRows = atoi(argv[2]);
+		if(giGridColumns < 1 || giGridRows < 1) {
+			giGridColumns = 4;
+			giGridRows = 6;
+		}
+	}
+	printf("\n Grid : %d x %d spheres", giGridColumns, giGridRows);
+
 	CreateWindow();
 	Initialize();
 
@@ -142,6 +179,7 @@ int main() {
 							gbYRotationEnabled = false;
 							gbZRotationEnabled = false;
 							gGLfAngle = 0.0f;
+							gGLfPrevAngle = 0.0f;
 							break;
 						case XK_Y :
 						case XK_y :
@@ -149,6 +187,7 @@ int main() {
 							gbYRotationEnabled = true;
 							gbZRotationEnabled = false;
 							gGLfAngle = 0.0f;
+							gGLfPrevAngle = 0.0f;
 							break;
 						case XK_Z :
 						case XK_z :
@@ -156,6 +195,18 @@ int main() {
 							gbYRotationEnabled = false;
 							gbZRotationEnabled = true;
 							gGLfAngle = 0.0f;
+							gGLfPrevAngle = 0.0f;
+							break;
+						case XK_I :
+						case XK_i :
+							gbInstanced = !gbInstanced;
+							printf("\n Rendering mode : %s", gbInstanced ? "Instanced (1 draw call)" : "Per sphere (1 draw call per sphere)");
+							gdFrameTimeSum = 0.0;
+							giFrameTimeCount = 0;
+							break;
+						case XK_P :
+						case XK_p :
+							gbProfilerGraph = !gbProfilerGraph;
 							break;
 						default :
 							break;
@@ -191,8 +242,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -321,10 +375,10 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
+	ShaderBuild shaderBuild;		// Both programs are compiled while sphere is generated, status is asked only once
 	const int attribs[] = { GLX_CONTEXT_MAJOR_VERSION_ARB, 4,
 		GLX_CONTEXT_MINOR_VERSION_ARB, 5,
 		GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
@@ -358,6 +412,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -377,38 +433,35 @@ void Initialize(void) {
 	fclose(OGL_info);
 	OGL_info = NULL;
 
+	shaderBuildBegin(&shaderBuild);
+
 	// Vertex Shader
-	gVSObj = glCreateShader(GL_VERTEX_SHADER);	// Create shader
 	const GLchar *VSSrcCode =			// Source code of shader
 		"#version 450 core" \
 		"\n" \
+		VERTEX_FORMAT_GLSL_DECODE \
 		"in vec4 vPosition;" \
-		"in vec3 vNormal;" \
+		"in vec2 vNormal;" \
 		"uniform mat4 u_MMatrix, u_VMatrix, u_PMatrix;" \
 		"uniform int u_KeyPressed;" \
-		"uniform vec4 u_LPos;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"out vec3 tNorm, LSrc, viewVec;" \
 		"void main(void) {" \
+			"vec4 position = vfDecodePosition(vPosition);" \
 			"if(u_KeyPressed == 1) {" \
-				"vec4 eyeCoords = u_VMatrix * u_MMatrix * vPosition;" \
-				"tNorm = mat3(u_VMatrix * u_MMatrix) * vNormal;" \
-				"LSrc = vec3(u_LPos - eyeCoords);" \
+				"vec4 eyeCoords = u_VMatrix * u_MMatrix * position;" \
+				"tNorm = mat3(u_VMatrix * u_MMatrix) * vfDecodeOctahedral(vNormal);" \
+				"LSrc = vec3(u_Light[0].position - eyeCoords);" \
 				"viewVec = -eyeCoords.xyz;" \
 			"}" \
-			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * vPosition;" \
+			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * position;" \
 		"}";
-	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
-	glCompileShader(gVSObj);			// Compile Shader
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");	// Error checking for shader
 
 	// Fragment Shader
-	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);	// Create shader
 	const GLchar *FSSrcCode = 			// Source code of shader
 		"#version 450 core" \
 		"\n" \
-		"uniform vec3 u_LAmb, u_LDiff, u_LSpec;" \
-		"uniform vec3 u_KAmb, u_KDiff, u_KSpec;" \
-		"uniform float u_KShine;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
 		"uniform int u_KeyPressed;" \
 		"in vec3 tNorm, LSrc, viewVec;" \
 		"out vec4 FragColor;" \
@@ -419,9 +472,9 @@ void Initialize(void) {
 				"vec3 lightSource = normalize(LSrc);" \
 				"vec3 reflectionVector = reflect(-lightSource, transformedNormal);" \
 				"vec3 viewVector = normalize(viewVec);" \
-				"vec3 ambient = u_LAmb * u_KAmb;" \
-				"vec3 diffuse = u_LDiff * u_KDiff * max(dot(lightSource, transformedNormal), 0.0f);" \
-				"vec3 specular = u_LSpec * u_KSpec * pow(max(dot(reflectionVector, viewVector), 0.0f), u_KShine);" \
+				"vec3 ambient = u_Light[0].ambient.rgb * u_Material[u_MaterialIndex].ambient.rgb;" \
+				"vec3 diffuse = u_Light[0].diffuse.rgb * u_Material[u_MaterialIndex].diffuse.rgb * max(dot(lightSource, transformedNormal), 0.0f);" \
+				"vec3 specular = u_Light[0].specular.rgb * u_Material[u_MaterialIndex].specular.rgb * pow(max(dot(reflectionVector, viewVector), 0.0f), u_Material[u_MaterialIndex].specular.w);" \
 				"lighting = ambient + diffuse + specular;" \
 			"}" \
 			"else {" \
@@ -429,58 +482,195 @@ void Initialize(void) {
 			"}" \
 			"FragColor = vec4(lighting, 1.0f);" \
 		"}";
-	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
-	glCompileShader(gFSObj);			// Compile Shader
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");	// Error checking for shader
-
-	// Shader program
-	gSPObj = glCreateProgram();		// Create final shader
-	glAttachShader(gSPObj, gVSObj);		// Add Vertex shader code to final shader
-	glAttachShader(gSPObj, gFSObj);		// Add Fragment shader code to final shader
-	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
-	glBindAttribLocation(gSPObj, DV_ATTRIB_NORM, "vNormal");
-	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");	// Error checking for shader
+
+	// Shader program - only submitted here, checked in shaderBuildFinish()
+	const ShaderAttrib sphereAttribs[] = { { DV_ATTRIB_POS, "vPosition" }, { DV_ATTRIB_NORM, "vNormal" } };
+	const ShaderSource sphereStages[] = { { SHADER_STAGE_VERTEX, VSSrcCode }, { SHADER_STAGE_FRAGMENT, FSSrcCode } };
+	shaderBuildAdd(&shaderBuild, &gSPObj, sphereStages, 2, sphereAttribs, 2);
+
+	// Instanced program : same lighting, material comes from uniform block by per instance index
+	const GLchar *VSSrcCode_Instanced =
+		"#version 450 core" \
+		"\n" \
+		VERTEX_FORMAT_GLSL_DECODE \
+		"in vec4 vPosition;" \
+		"in vec2 vNormal;" \
+		"in vec4 vCell;" \
+		"in uint vMaterial;" \
+		"uniform mat4 u_MMatrix, u_VMatrix, u_PMatrix;" \
+		"uniform int u_KeyPressed;" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
+		"out vec3 tNorm, LSrc, viewVec;" \
+		"flat out uint material;" \
+		"void main(void) {" \
+			"vec4 position = vfDecodePosition(vPosition);" \
+			"if(u_KeyPressed == 1) {" \
+				"vec4 eyeCoords = u_VMatrix * u_MMatrix * position;" \
+				"tNorm = mat3(u_VMatrix * u_MMatrix) * vfDecodeOctahedral(vNormal);" \
+				"LSrc = vec3(u_Light[0].position - eyeCoords);" \
+				"viewVec = -eyeCoords.xyz;" \
+			"}" \
+			"material = vMaterial;" \
+			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * position;" \
+			"gl_Position.xy = (gl_Position.xy * vCell.xy) + (vCell.zw * gl_Position.w);" \
+		"}";
+
+	const GLchar *FSSrcCode_Instanced =
+		"#version 450 core" \
+		"\n" \
+		LIGHT_MATERIAL_GLSL_BLOCKS \
+		"uniform int u_KeyPressed;" \
+		"in vec3 tNorm, LSrc, viewVec;" \
+		"flat in uint material;" \
+		"out vec4 FragColor;" \
+		"void main(void) {" \
+			"vec3 lighting;" \
+			"if(u_KeyPressed == 1) {" \
+				"Material k = u_Material[material];" \
+				"vec3 transformedNormal = normalize(tNorm);" \
+				"vec3 lightSource = normalize(LSrc);" \
+				"vec3 reflectionVector = reflect(-lightSource, transformedNormal);" \
+				"vec3 viewVector = normalize(viewVec);" \
+				"vec3 ambient = u_Light[0].ambient.rgb * k.ambient.rgb;" \
+				"vec3 diffuse = u_Light[0].diffuse.rgb * k.diffuse.rgb * max(dot(lightSource, transformedNormal), 0.0f);" \
+				"vec3 specular = u_Light[0].specular.rgb * k.specular.rgb * pow(max(dot(reflectionVector, viewVector), 0.0f), k.specular.w);" \
+				"lighting = ambient + diffuse + specular;" \
+			"}" \
+			"else {" \
+				"lighting = vec3(0.0f);" \
+			"}" \
+			"FragColor = vec4(lighting, 1.0f);" \
+		"}";
+
+	const ShaderAttrib instancedAttribs[] = { { DV_ATTRIB_POS, "vPosition" }, { DV_ATTRIB_NORM, "vNormal" }, { DV_ATTRIB_CELL, "vCell" }, { DV_ATTRIB_MATERIAL, "vMaterial" } };
+	const ShaderSource instancedStages[] = { { SHADER_STAGE_VERTEX, VSSrcCode_Instanced }, { SHADER_STAGE_FRAGMENT, FSSrcCode_Instanced } };
+	shaderBuildAdd(&shaderBuild, &gSPObj_Instanced, instancedStages, 2, instancedAttribs, 4);
+
+	// Variable declaration - sphere related (64 x 32 sphere with 4 levels of detail)
+	makeSphereLODChain(&gSphereLOD, 64, 32, 4);
+	gSphereIndexType = (gSphereLOD.indexSize == sizeof(GLushort)) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	GLsizeiptr sizeofSphereVertices = gSphereLOD.numVertices * SPHERE_VERTEX_STRIDE * sizeof(GLfloat);
+	GLsizeiptr sizeofSphereElements = gSphereLOD.numElements * gSphereLOD.indexSize;
+	GLfloat *sphereVertices = (GLfloat *)malloc(sizeofSphereVertices);
+	void *sphereElements = malloc(sizeofSphereElements);
+	if(sphereVertices == NULL || sphereElements == NULL) {
+		printf("\n ERROR : Unable to allocate memory for sphere.");
+		Uninitialize();
+	}
+	generateSphereLODChain(&gSphereLOD, 0.75f, sphereVertices, sphereElements);
+
+	// Reordering of every level for post-transform cache and vertex fetch (sphere is convex, so no overdraw sort)
+	for(unsigned int l = 0; l < gSphereLOD.numLevels; l++) {
+		const SphereLOD *lod = &gSphereLOD.level[l];
+		void *lodElements = (char *)sphereElements + ((size_t)lod->firstElement * gSphereLOD.indexSize);
+		float acmrBefore = analyzeVertexCache(lodElements, gSphereLOD.indexSize, lod->numElements, lod->baseVertex, lod->numVertices, MESH_ANALYZE_CACHE_SIZE);
+
+		if(optimizeVertexCache(lodElements, gSphereLOD.indexSize, lod->numElements, lod->baseVertex, lod->numVertices) == false ||
+			optimizeVertexFetch(sphereVertices, SPHERE_VERTEX_STRIDE * sizeof(GLfloat), lodElements, gSphereLOD.indexSize, lod->numElements, lod->baseVertex, lod->numVertices) == false) {
+			printf("\n ERROR : Unable to allocate memory for sphere optimization.");
+			break;
+		}
+		printf("\n Sphere LOD %u (%u x %u) : ACMR %.3f -> %.3f", l, lod->slices, lod->stacks, acmrBefore,
+			analyzeVertexCache(lodElements, gSphereLOD.indexSize, lod->numElements, lod->baseVertex, lod->numVertices, MESH_ANALYZE_CACHE_SIZE));
+	}
+
+	// Quantization of vertices (texcoords are not used by this sample)
+	VertexSource sphereSource = { SPHERE_VERTEX_STRIDE, SPHERE_POSITION_OFFSET, SPHERE_NORMAL_OFFSET, SPHERE_TEXCOORD_OFFSET, -1 };
+	makeVertexFormat(&gSphereFormat, &sphereSource, VF_SNORM16, VF_OCTAHEDRAL16, VF_NONE, VF_NONE);
+	GLsizeiptr sizeofSphereEncoded = gSphereLOD.numVertices * gSphereFormat.stride;
+	void *sphereEncoded = malloc(sizeofSphereEncoded);
+	if(sphereEncoded == NULL) {
+		printf("\n ERROR : Unable to allocate memory for sphere.");
+		Uninitialize();
+	}
+	encodeVertices(&gSphereFormat, &sphereSource, sphereVertices, gSphereLOD.numVertices, sphereEncoded);
+	printVertexFormatReport("Sphere", &gSphereFormat, &sphereSource, gSphereLOD.numVertices);
+
+	// Sphere generation and optimization above ran while driver compiled; programs are needed from here on
+	if(shaderBuildFinish(&shaderBuild) == false) {
+		printf("\n Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
 
 	// Get uniform location(s)
 	gMUniform = glGetUniformLocation(gSPObj, "u_MMatrix");
 	gVUniform = glGetUniformLocation(gSPObj, "u_VMatrix");
 	gPUniform = glGetUniformLocation(gSPObj, "u_PMatrix");
-	gLAmbUniform = glGetUniformLocation(gSPObj, "u_LAmb");
-	gLDiffUniform = glGetUniformLocation(gSPObj, "u_LDiff");
-	gLSpecUniform = glGetUniformLocation(gSPObj, "u_LSpec");
-	gLPosUniform = glGetUniformLocation(gSPObj, "u_LPos");
-	gKAmbUniform = glGetUniformLocation(gSPObj, "u_KAmb");
-	gKDiffUniform = glGetUniformLocation(gSPObj, "u_KDiff");
-	gKSpecUniform = glGetUniformLocation(gSPObj, "u_KSpec");
-	gKShineUniform = glGetUniformLocation(gSPObj, "u_KShine");
+	gMaterialIndexUniform = glGetUniformLocation(gSPObj, "u_MaterialIndex");
 	gKeyUniform = glGetUniformLocation(gSPObj, "u_KeyPressed");
+	gMUniform_Instanced = glGetUniformLocation(gSPObj_Instanced, "u_MMatrix");
+	gVUniform_Instanced = glGetUniformLocation(gSPObj_Instanced, "u_VMatrix");
+	gPUniform_Instanced = glGetUniformLocation(gSPObj_Instanced, "u_PMatrix");
+	gKeyUniform_Instanced = glGetUniformLocation(gSPObj_Instanced, "u_KeyPressed");
 
-	// Variable declaration - sphere related
-	getSphereVertexData(sphereVertices, sphereNormals, sphereTextures, sphereElements);
-	gNumVertices = getNumberOfSphereVertices();
-	gNumElements = getNumberOfSphereElements();
+	glUseProgram(gSPObj);
+	setVertexFormatUniforms(&gSphereFormat, glGetUniformLocation(gSPObj, "u_PositionScale"), glGetUniformLocation(gSPObj, "u_PositionBias"));
+	glUseProgram(gSPObj_Instanced);
+	setVertexFormatUniforms(&gSphereFormat, glGetUniformLocation(gSPObj_Instanced, "u_PositionScale"), glGetUniformLocation(gSPObj_Instanced, "u_PositionBias"));
+	glUseProgram(0);
 
 	// For 3D Sphere
 	glGenVertexArrays(1, &gVAObj_Sphere);
 	glBindVertexArray(gVAObj_Sphere);		// For Sphere
-		glGenBuffers(3, gVBObj_Sphere);
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Sphere[0]);	// For Position
-		glBufferData(GL_ARRAY_BUFFER, sizeof(sphereVertices), sphereVertices, GL_STATIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_POS);
+		glGenBuffers(2, gVBObj_Sphere);
+		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Sphere[0]);	// For Position and Normals (interleaved, quantized)
+		glBufferData(GL_ARRAY_BUFFER, sizeofSphereEncoded, sphereEncoded, GL_STATIC_DRAW);
+		setVertexFormatAttribPointers(&gSphereFormat, DV_ATTRIB_POS, DV_ATTRIB_NORM, DV_ATTRIB_TEX, DV_ATTRIB_COLOR);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Sphere[1]);	// For Normals
-		glBufferData(GL_ARRAY_BUFFER, sizeof(sphereNormals), sphereNormals, GL_STATIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_NORM, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(DV_ATTRIB_NORM);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj_Sphere[1]);	// For Elements (stays bound to VAO)
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeofSphereElements, sphereElements, GL_STATIC_DRAW);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	// Per instance data : viewport cell of every sphere (as per-sphere glViewport() would give) and its material
+	GLsizeiptr sizeofInstances = (GLsizeiptr)giGridColumns * giGridRows * sizeof(SphereInstance);
+	SphereInstance *sphereInstances = (SphereInstance *)malloc(sizeofInstances);
+	if(sphereInstances == NULL) {
+		printf("\n ERROR : Unable to allocate memory for sphere instances.");
+		Uninitialize();
+	}
+	for(int i = 0; i < giGridColumns; i++) {
+		for(int j = 0; j < giGridRows; j++) {
+			SphereInstance *instance = &sphereInstances[(i * giGridRows) + j];
+			instance->cell[0] = 1.0f / (GLfloat)giGridColumns;
+			instance->cell[1] = 1.0f / (GLfloat)giGridRows;
+			instance->cell[2] = -1.0f + ((2.0f * (GLfloat)i + 1.0f) / (GLfloat)giGridColumns);
+			instance->cell[3] = -1.0f + ((2.0f * (GLfloat)(giGridRows - 1 - j) + 1.0f) / (GLfloat)giGridRows);
+			instance->material = MATERIAL_EMERALD + (((i * giGridRows) + j) % MATERIAL_STANDARD_COUNT);
+		}
+	}
+
+	glGenVertexArrays(1, &gVAObj_Instanced);
+	glBindVertexArray(gVAObj_Instanced);		// Same sphere buffers plus instance buffer
+		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Sphere[0]);
+		setVertexFormatAttribPointers(&gSphereFormat, DV_ATTRIB_POS, DV_ATTRIB_NORM, DV_ATTRIB_TEX, DV_ATTRIB_COLOR);
+
+		glGenBuffers(1, &gVBObj_Instance);
+		glBindBuffer(GL_ARRAY_BUFFER, gVBObj_Instance);
+		glBufferData(GL_ARRAY_BUFFER, sizeofInstances, sphereInstances, GL_STATIC_DRAW);
+		glVertexAttribPointer(DV_ATTRIB_CELL, 4, GL_FLOAT, GL_FALSE, sizeof(SphereInstance), (void *)offsetof(SphereInstance, cell));
+		glVertexAttribIPointer(DV_ATTRIB_MATERIAL, 1, GL_UNSIGNED_INT, sizeof(SphereInstance), (void *)offsetof(SphereInstance, material));
+		glVertexAttribDivisor(DV_ATTRIB_CELL, 1);
+		glVertexAttribDivisor(DV_ATTRIB_MATERIAL, 1);
+		glEnableVertexAttribArray(DV_ATTRIB_CELL);
+		glEnableVertexAttribArray(DV_ATTRIB_MATERIAL);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj_Sphere[2]);	// For Elements
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(sphereElements), sphereElements, GL_STATIC_DRAW);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj_Sphere[1]);
 	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	free(sphereInstances);
+
+	// All materials in one uniform buffer, uploaded once (library is empty, so first one is MATERIAL_EMERALD)
+	addStandardMaterials(&gMaterials);
+	uploadMaterialLibrary(&gMaterials);
+	createLightBlock(&gLights);
+
+	free(sphereVertices);
+	free(sphereEncoded);
+	free(sphereElements);
 
 	glClearDepth(1.0f);
 	glEnable(GL_DEPTH_TEST);
@@ -488,62 +678,12 @@ void Initialize(void) {
 
 	gPerspMatrix = mat4::identity();
 
+	profilerInitialize(&gProfiler);
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
-	// Function declaration
-	void Uninitialize(void);
-
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
-	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
-		Uninitialize();
-	}
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -558,205 +698,133 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
+	GLfloat angle = frameSchedulerLerpAngle(gGLfPrevAngle, gGLfAngle, gScheduler.alpha);
 	mat4 ModelMatrix, ViewMatrix, ProjectionMatrix;
-	mat4 translationMatrix;
 	GLfloat lightAmbient[] = { 0.0f, 0.0f, 0.0f };
 	GLfloat lightDiffuse[] = { 1.0f, 1.0f, 1.0f };
 	GLfloat lightSpecular[] = { 1.0f, 1.0f, 1.0f };
 	GLfloat lightPosition[4];
-	GLfloat materialAmbient[][4] =
-	{
-		{0.0215f, 0.1745f, 0.0215f, 1.0f},	// 1R 1C - Emerald
-		{0.135f, 0.2225f, 0.1575f, 1.0f},	// 2R 1C - Jade
-		{0.05375f, 0.05f, 0.06625f, 1.0f},	// 3R 1C - Obsidian
-		{0.25f, 0.20725f, 0.20725f, 1.0f},	// 4R 1C - Pearl
-		{0.1745f, 0.01175f, 0.01175f, 1.0f},	// 5R 1C - Ruby
-		{0.1f, 0.18725f, 0.1745f, 1.0f},	// 6R 1C - Turquoise
-		{0.329412f, 0.223529f, 0.027451f, 1.0f},// 1R 2C - Brass
-		{0.2125f, 0.1275f, 0.054f, 1.0f},	// 2R 2C - Bronze
-		{0.25f, 0.25f, 0.25f, 1.0f},		// 3R 2C - Chrome
-		{0.19125f, 0.0735f, 0.0225f, 1.0f},	// 4R 2C - Copper
-		{0.24725f, 0.1995f, 0.0745f, 1.0f},	// 5R 2C - Gold
-		{0.19225f, 0.19225f, 0.19225f, 1.0f},	// 6R 2C - Silver
-		{0.0f, 0.0f, 0.0f, 1.0f},		// 1R 3C - Black plastic
-		{0.0f, 0.1f, 0.06f, 1.0f},		// 2R 3C - Cyan plastic
-		{0.0f, 0.0f, 0.0f, 1.0f},		// 3R 3C - Green plastic
-		{0.0f, 0.0f, 0.0f, 1.0f},		// 4R 3C - Red plastic
-		{0.0f, 0.0f, 0.0f, 1.0f},		// 5R 3C - White plastic
-		{0.0f, 0.0f, 0.0f, 1.0f},		// 6R 3C - Yellow plastic
-		{0.02f, 0.02f, 0.02f, 1.0f},		// 1R 4C - Black rubber
-		{0.0f, 0.05f, 0.05f, 1.0f},		// 2R 4C - Cyan rubber
-		{0.0f, 0.05f, 0.0f, 1.0f},		// 3R 4C - Green rubber
-		{0.05f, 0.0f, 0.0f, 1.0f},		// 4R 4C - Red rubber
-		{0.05f, 0.05f, 0.05f, 1.0f},		// 5R 4C - White rubber
-		{0.05f, 0.05f, 0.04f, 1.0f}		// 6R 4C - Yellow rubber
-	};
-	GLfloat materialDiffuse[][4] =
-	{
-		{0.07568f, 0.61424f, 0.07568f, 1.0f},	// 1R 1C - Emerald
-		{0.54f, 0.89f, 0.63f, 1.0f},		// 2R 1C - Jade
-		{0.18275f, 0.17f, 0.22525f, 1.0f},	// 3R 1C - Obsidian
-		{1.0f, 0.829f, 0.829f, 1.0f},		// 4R 1C - Pearl
-		{0.61424f, 0.04136f, 0.04163f, 1.0f},	// 5R 1C - Ruby
-		{0.396f, 0.74151f, 0.69102f, 1.0f},	// 6R 1C - Turquoise
-		{0.780392f, 0.568627f, 0.113725f, 1.0f},// 1R 2C - Brass
-		{0.714f, 0.4284f, 0.18144f, 1.0f},	// 2R 2C - Bronze
-		{0.4f, 0.4f, 0.4f, 1.0f},		// 3R 2C - Chrome
-		{0.7038f, 0.27048f, 0.0828f, 1.0f},	// 4R 2C - Copper
-		{0.75164f, 0.60648f, 0.22648f, 1.0f},	// 5R 2C - Gold
-		{0.50754f, 0.50754f, 0.50754f, 1.0f},	// 6R 2C - Silver
-		{0.01f, 0.01f, 0.01f, 1.0f},		// 1R 3C - Black plastic
-		{0.0f, 0.50980392f, 0.50980392f, 1.0f},	// 2R 3C - Cyan plastic
-		{0.1f, 0.35f, 0.1f, 1.0f},		// 3R 3C - Green plastic
-		{0.5f, 0.0f, 0.0f, 1.0f},		// 4R 3C - Red plastic
-		{0.55f, 0.55f, 0.55f, 1.0f},		// 5R 3C - White plastic
-		{0.5f, 0.5f, 0.0f, 1.0f},		// 6R 3C - Yellow plastic
-		{0.01f, 0.01f, 0.01f, 1.0f},		// 1R 4C - Black rubber
-		{0.4f, 0.5f, 0.5f, 1.0f},		// 2R 4C - Cyan rubber
-		{0.4f, 0.5f, 0.4f, 1.0f},		// 3R 4C - Green rubber
-		{0.5f, 0.4f, 0.4f, 1.0f},		// 4R 4C - Red rubber
-		{0.5f, 0.5f, 0.5, 1.0f},		// 5R 4C - White rubber
-		{0.5f, 0.5f, 0.4f, 1.0f}		// 6R 4C - Yellow rubber
-	};
-	GLfloat materialSpecular[][4] =
-	{
-		{0.633f, 0.727811f, 0.33f, 1.0f},		// 1R 1C - Emerald
-		{0.316228f, 0.316228f, 0.316228f, 1.0f},	// 2R 1C - Jade
-		{0.332741f, 0.328634f, 0.346435f, 1.0f},	// 3R 1C - Obsidian
-		{0.296648f, 0.296648f, 0.296648f, 1.0f},	// 4R 1C - Pearl
-		{0.727811f, 0.626959f, 0.626959f, 1.0f},	// 5R 1C - Ruby
-		{0.297254f, 0.308290f, 0.306678f, 1.0f},	// 6R 1C - Turquoise
-		{0.992157f, 0.941176f, 0.807843f, 1.0f},	// 1R 2C - Brass
-		{0.393548f, 0.271906f, 0.166721f, 1.0f},	// 2R 2C - Bronze
-		{0.774597f, 0.774597f, 0.774597f, 1.0f},	// 3R 2C - Chrome
-		{0.256777f, 0.137622f, 0.086014f, 1.0f},	// 4R 2C - Copper
-		{0.628281f, 0.555802f, 0.366065f, 1.0f},	// 5R 2C - Gold
-		{0.508273f, 0.508273f, 0.508273f, 1.0f},	// 6R 2C - Silver
-		{0.5f, 0.5f, 0.5f, 1.0f},			// 1R 3C - Black plastic
-		{0.50196078f, 0.50196078f, 0.50196078f, 1.0f},	// 2R 3C - Cyan plastic
-		{0.45f, 0.55f, 0.45f, 1.0f},		// 3R 3C - Green plastic
-		{0.7f, 0.6f, 0.6f, 1.0f},		// 4R 3C - Red plastic
-		{0.7f, 0.7f, 0.7f, 1.0f},		// 5R 3C - White plastic
-		{0.6f, 0.6f, 0.5f, 1.0f},		// 6R 3C - Yellow plastic
-		{0.4f, 0.4f, 0.4f, 1.0f},		// 1R 4C - Black rubber
-		{0.04f, 0.7f, 0.7f, 1.0f},		// 2R 4C - Cyan rubber
-		{0.04f, 0.7f, 0.04f, 1.0f},		// 3R 4C - Green rubber
-		{0.7f, 0.04f, 0.04f, 1.0f},		// 4R 4C - Red rubber
-		{0.7f, 0.7f, 0.7f, 1.0f},		// 5R 4C - White rubber
-		{0.7f, 0.7f, 0.04f, 1.0f}		// 6R 4C - Yellow rubber
-	};
-	GLfloat materialShininess[] =
-	{	0.6f,		// 1R 1C - Emerald
-		0.1f,		// 2R 1C - Jade
-		0.3f,		// 3R 1C - Obsidian
-		0.088f,		// 4R 1C - Pearl
-		0.6f,		// 5R 1C - Ruby
-		0.1f,		// 6R 1C - Turquoise
-		0.21794872f,	// 1R 2C - Brass
-		0.2f,		// 2R 2C - Bronze
-		0.6f,		// 3R 2C - Chrome
-		0.1f,		// 4R 2C - Copper
-		0.4f,		// 5R 2C - Gold
-		0.4f,		// 6R 2C - Silver
-		0.25f,		// 1R 3C - Black plastic
-		0.25f,		// 2R 3C - Cyan plastic
-		0.25f,		// 3R 3C - Green plastic
-		0.25f,		// 4R 3C - Red plastic
-		0.25f,		// 5R 3C - White plastic
-		0.25f,		// 6R 3C - Yellow plastic
-		0.078125f,	// 1R 4C - Black rubber
-		0.078125f,	// 2R 4C - Cyan rubber
-		0.078125f,	// 3R 4C - Green rubber
-		0.078125f,	// 4R 4C - Red rubber
-		0.078125f,	// 5R 4C - White rubber
-		0.078125f	// 6R 4C - Yellow rubber
-	};
 	GLfloat radian = M_PI / 180.0f;
 	GLfloat radius = 10.0f;
+	GLsizei cellWidth = gWidth / giGridColumns;
+	GLsizei cellHeight = gHeight / giGridRows;
+	const SphereLOD *sphereLOD;
+	void *sphereLODElements;
+	struct timespec frameStart, frameEnd;
 
 	// Code
+	clock_gettime(CLOCK_MONOTONIC, &frameStart);
+	profilerBeginFrame(&gProfiler);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	for(int i = 0; i < 4; i++) {
-		for(int j = 0; j < 6; j++) {
-			// Starting of OpenGL shading program
-			glUseProgram(gSPObj);
-
-			glViewport((gWidth / 4) * i, (gHeight / 6) * (5-j), (GLsizei)(gWidth/4), (GLsizei)(gHeight/6));
+	// Every sphere gets height of one grid cell, at 2.5 units from eye
+	sphereLOD = &gSphereLOD.level[selectSphereLOD(&gSphereLOD, getSphereProjectedRadius(0.75f, 2.5f, 45.0f, (GLfloat)cellHeight), 4.0f)];
+	sphereLODElements = (void *)((size_t)sphereLOD->firstElement * gSphereLOD.indexSize);
 
-			ModelMatrix = mat4::identity();
-			ViewMatrix = mat4::identity();
-			ProjectionMatrix = mat4::identity();
-			translationMatrix = mat4::identity();
-
-			if(gbXRotationEnabled == true) {
-				lightPosition[0] = 0.0f; 
-				lightPosition[1] = radius * (GLfloat)cos(gGLfAngle * radian);
-				lightPosition[2] = radius * (GLfloat)sin(gGLfAngle * radian);
-			}
-			else if(gbYRotationEnabled == true) {
-				lightPosition[0] = radius * (GLfloat)sin(gGLfAngle * radian);
-				lightPosition[1] = 0.0f;
-				lightPosition[2] = radius * (GLfloat)cos(gGLfAngle * radian);
-			}
-			else if(gbZRotationEnabled == true) {
-				lightPosition[0] = radius * (GLfloat)cos(gGLfAngle * radian);
-				lightPosition[1] = radius * (GLfloat)sin(gGLfAngle * radian);
-				lightPosition[2] = 0.0f;
-			}
-			else {
-				lightPosition[0] = 10.0f;
-				lightPosition[1] = 10.0f;
-				lightPosition[2] = 10.0f;
-				lightPosition[3] = 1.0f;
-			}
+	// Light and matrices are same for every sphere
+	profilerBeginScope(&gProfiler, "Light");
+	if(gbXRotationEnabled == true) {
+		lightPosition[0] = 0.0f;
+		lightPosition[1] = radius * (GLfloat)cos(angle * radian);
+		lightPosition[2] = radius * (GLfloat)sin(angle * radian);
+	}
+	else if(gbYRotationEnabled == true) {
+		lightPosition[0] = radius * (GLfloat)sin(angle * radian);
+		lightPosition[1] = 0.0f;
+		lightPosition[2] = radius * (GLfloat)cos(angle * radian);
+	}
+	else if(gbZRotationEnabled == true) {
+		lightPosition[0] = radius * (GLfloat)cos(angle * radian);
+		lightPosition[1] = radius * (GLfloat)sin(angle * radian);
+		lightPosition[2] = 0.0f;
+	}
+	else {
+		lightPosition[0] = 10.0f;
+		lightPosition[1] = 10.0f;
+		lightPosition[2] = 10.0f;
+	}
+	lightPosition[3] = 1.0f;
 
-			if(materialShininess[(i*6)+j] < 1.0f)
-				materialShininess[(i*6)+j] *= 128.0f;
-			if(gbLightingEnabled == true) {
-				glUniform1i(gKeyUniform, 1);
-				glUniform3fv(gLAmbUniform, 1, lightAmbient);
-				glUniform3fv(gLDiffUniform, 1, lightDiffuse);
-				glUniform3fv(gLSpecUniform, 1, lightSpecular);
-				glUniform4fv(gLPosUniform, 1, lightPosition);
-				glUniform3fv(gKAmbUniform, 1, materialAmbient[(i*6)+j]);
-				glUniform3fv(gKDiffUniform, 1, materialDiffuse[(i*6)+j]);
-				glUniform3fv(gKSpecUniform, 1, materialSpecular[(i*6)+j]);
-				glUniform1fv(gKShineUniform, 1, &materialShininess[(i*6)+j]);
+	if(gbLightingEnabled == true) {
+		setLight(&gLights, 0, lightAmbient, lightDiffuse, lightSpecular, lightPosition);
+		updateLightBlock(&gLights);
+	}
+	profilerEndScope(&gProfiler);
+
+	ModelMatrix = translate(0.0f, 0.0f, -2.5f);
+	ViewMatrix = mat4::identity();
+	ProjectionMatrix = gPerspMatrix;
+
+	profilerBeginScope(&gProfiler, gbInstanced ? "Spheres (instanced)" : "Spheres (per sphere)");
+	if(gbInstanced == true) {
+		// Whole grid in one draw call; every instance maps itself into its cell
+		glViewport(0, 0, (GLsizei)gWidth, (GLsizei)gHeight);
+		glUseProgram(gSPObj_Instanced);
+		glUniform1i(gKeyUniform_Instanced, (gbLightingEnabled == true) ? 1 : 0);
+		glUniformMatrix4fv(gMUniform_Instanced, 1, GL_FALSE, ModelMatrix);
+		glUniformMatrix4fv(gVUniform_Instanced, 1, GL_FALSE, ViewMatrix);
+		glUniformMatrix4fv(gPUniform_Instanced, 1, GL_FALSE, ProjectionMatrix);
+
+		glBindVertexArray(gVAObj_Instanced);
+		glDrawElementsInstanced(GL_TRIANGLES, sphereLOD->numElements, gSphereIndexType, sphereLODElements, giGridColumns * giGridRows);
+		glBindVertexArray(0);
+		glUseProgram(0);
+	}
+	else {
+		// Starting of OpenGL shading program; light and matrices are set once, only material index per sphere
+		glUseProgram(gSPObj);
+		glUniform1i(gKeyUniform, (gbLightingEnabled == true) ? 1 : 0);
+		glUniformMatrix4fv(gMUniform, 1, GL_FALSE, ModelMatrix);
+		glUniformMatrix4fv(gVUniform, 1, GL_FALSE, ViewMatrix);
+		glUniformMatrix4fv(gPUniform, 1, GL_FALSE, ProjectionMatrix);
+		glBindVertexArray(gVAObj_Sphere);
+
+		for(int i = 0; i < giGridColumns; i++) {
+			for(int j = 0; j < giGridRows; j++) {
+				glViewport(cellWidth * i, cellHeight * (giGridRows - 1 - j), cellWidth, cellHeight);
+				glUniform1i(gMaterialIndexUniform, MATERIAL_EMERALD + (((i * giGridRows) + j) % MATERIAL_STANDARD_COUNT));
+
+				// OpenGL Drawing
+				glDrawElements(GL_TRIANGLES, sphereLOD->numElements, gSphereIndexType, sphereLODElements);
 			}
-			else
-				glUniform1i(gKeyUniform, 0);
-
-			translationMatrix = translate(0.0f, 0.0f, -2.5f);
-			ModelMatrix = translationMatrix;
-			ProjectionMatrix = gPerspMatrix;
+		}
 
-			glUniformMatrix4fv(gMUniform, 1, GL_FALSE, ModelMatrix);
-			glUniformMatrix4fv(gVUniform, 1, GL_FALSE, ViewMatrix);
-			glUniformMatrix4fv(gPUniform, 1, GL_FALSE, ProjectionMatrix);
+		// End of OpenGL shading program
+		glBindVertexArray(0);
+		glUseProgram(0);
+	}
 
-			// OpenGL Drawing
-			glBindVertexArray(gVAObj_Sphere);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj_Sphere[2]);
-			glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
-			glBindVertexArray(0);
+	profilerEndScope(&gProfiler);
+
+	// CPU cost of submitting frame; swap is excluded as it may wait for vsync
+	clock_gettime(CLOCK_MONOTONIC, &frameEnd);
+	gdFrameTimeSum += ((double)(frameEnd.tv_sec - frameStart.tv_sec) * 1000.0) + ((double)(frameEnd.tv_nsec - frameStart.tv_nsec) / 1000000.0);
+	if(++giFrameTimeCount == FRAME_TIME_SAMPLES) {
+		printf("\n %s : %d spheres, %d draw call(s), %.3f ms CPU per frame", gbInstanced ? "Instanced " : "Per sphere", giGridColumns * giGridRows,
+			gbInstanced ? 1 : giGridColumns * giGridRows, gdFrameTimeSum / FRAME_TIME_SAMPLES);
+		fflush(stdout);
+		gdFrameTimeSum = 0.0;
+		giFrameTimeCount = 0;
+	}
 
-			// End of OpenGL shading program
-			glUseProgram(0);
-		}
+	if(gbProfilerGraph == true) {
+		glViewport(0, 0, (GLsizei)gWidth, (GLsizei)gHeight);
+		profilerDrawGraph(&gProfiler);
 	}
+	profilerEndFrame(&gProfiler);
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
+	gGLfPrevAngle = gGLfAngle;
 	if(gbLightingEnabled == true) {
 		if(gbXRotationEnabled == true || gbYRotationEnabled == true || gbZRotationEnabled == true)
-			gGLfAngle += 0.5f;
+			gGLfAngle += 30.0f * delta;	// Degrees per second
 	}
 	if(gGLfAngle >= 360.0f)
-		gGLfAngle = 0.0f;
+		gGLfAngle -= 360.0f;
 }
 
 void Uninitialize() {
@@ -771,6 +839,9 @@ void Uninitialize() {
 	if(glXGetCurrentContext != NULL)
 		glUseProgram(0);
 
+	profilerDump(&gProfiler, "24Spheres_profile");
+	profilerUninitialize(&gProfiler);
+
 	// Destroy Vertex Array Object
 	if(gVAObj_Sphere) {
 		glDeleteVertexArrays(1, &gVAObj_Sphere);
@@ -779,29 +850,30 @@ void Uninitialize() {
 
 	// Destroy Vertex Buffer Object
 	if(gVBObj_Sphere) {
-		glDeleteBuffers(3, gVBObj_Sphere);
+		glDeleteBuffers(2, gVBObj_Sphere);
 		gVBObj_Sphere[0] = 0;
 		gVBObj_Sphere[1] = 0;
-		gVBObj_Sphere[2] = 0;
 	}
-
-	// Detach shaders
-	glDetachShader(gSPObj, gVSObj);		// Detach vertex shader from final shader program
-	glDetachShader(gSPObj, gFSObj);		// Detach fragment shader from final shader program
-
-	// Delete shaders
-	if(gVSObj) {			// Delete Vertex shader
-		glDeleteShader(gVSObj);
-		gVSObj = 0;
+	if(gVAObj_Instanced) {
+		glDeleteVertexArrays(1, &gVAObj_Instanced);
+		gVAObj_Instanced = 0;
 	}
-	if(gFSObj) {			// Delete Fragment shader
-		glDeleteShader(gFSObj);
-		gFSObj = 0;
+	if(gVBObj_Instance) {
+		glDeleteBuffers(1, &gVBObj_Instance);
+		gVBObj_Instance = 0;
 	}
-	if(gSPObj) {		// Delete final shader program
+	deleteMaterialLibrary(&gMaterials);
+	deleteLightBlock(&gLights);
+
+	// Delete shader programs (shader objects were deleted right after linking)
+	if(gSPObj) {
 		glDeleteProgram(gSPObj);
 		gSPObj = 0;
 	}
+	if(gSPObj_Instanced) {
+		glDeleteProgram(gSPObj_Instanced);
+		gSPObj_Instanced = 0;
+	}
 
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
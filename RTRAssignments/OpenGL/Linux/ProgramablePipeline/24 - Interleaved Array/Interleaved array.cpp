@@ -8,13 +8,16 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/VertexFormat.h"
+#include "../Include/ShaderBuild.h"
+#include "../Include/TextureLoader.h"
+#include "../Include/FrameScheduler.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glx.h>
-#include <SOIL/SOIL.h>
 
 // XWindows specific header files
 #include <X11/Xlib.h>
@@ -51,9 +54,12 @@ int giWindowHeight = 600;
 bool gbEnableInterleaved = false;
 bool gbEnableAnimation = false;
 GLfloat gfAngle = 0.0f;
+GLfloat gfPrevAngle = 0.0f;	// At previous update, display() interpolates from it
+FrameScheduler gScheduler;	// Vsync, fixed step updates and frame pacing
 
 GLuint gVSObj, gFSObj, gSPObj;
 GLuint gVAObj, gVBObj;
+VertexFormat gCubeFormat;	// Quantized layout of cube vertices in gVBObj
 
 GLuint MMatrixUniform, VMatrixUniform, PMatrixUniform;
 GLuint LAmbUniform, LDiffUniform, LSpecUniform, LPosUniform;
@@ -62,6 +68,7 @@ GLuint InterleavedEnabledUniform;
 
 GLuint gTextureSamplerUniform;
 GLuint marble_texture;
+TextureLoader gTextureLoader;	// Textures are decoded on worker threads, placeholders until uploaded
 
 mat4 gPerspMatrix;
 
@@ -73,7 +80,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -156,8 +163,12 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
+		textureLoaderUpdate(&gTextureLoader);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -286,8 +297,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
-	GLuint LoadBitmapAsTexture(const char*);	// Texture loading funtion
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -322,6 +332,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Update() runs 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -345,6 +357,7 @@ void Initialize(void) {
 	gVSObj = glCreateShader(GL_VERTEX_SHADER);
 	const GLchar *VSSrcCode =
 		"#version 450 core \n" \
+		VERTEX_FORMAT_GLSL_DECODE \
 		"in vec4 vPosition;" \
 		"in vec3 vColor, vNormal;" \
 		"in vec2 vTexCoord;" \
@@ -357,10 +370,11 @@ void Initialize(void) {
 		"out vec3 out_light;" \
 		"out vec2 out_texCoord;" \
 		"void main(void) {" \
+			"vec4 position = vfDecodePosition(vPosition);" \
 			"out_light = vec3(0.0);" \
 			"out_texCoord = vec2(0.0);" \
 			"if(u_InterleavedEnabled == 1) {" \
-				"vec4 eyeCoords = u_VMatrix * u_MMatrix * vPosition;" \
+				"vec4 eyeCoords = u_VMatrix * u_MMatrix * position;" \
 				"vec3 transformedNormal = normalize(mat3(u_VMatrix * u_MMatrix) * vNormal);" \
 				"vec3 lightSource = normalize(vec3(u_LPos - eyeCoords));" \
 				"vec3 reflectionVector = reflect(-lightSource, transformedNormal);" \
@@ -372,11 +386,11 @@ void Initialize(void) {
 				"out_light = ambient + diffuse + specular;" \
 				"out_texCoord = vTexCoord;" \
 			"}" \
-			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * vPosition;" \
+			"gl_Position = u_PMatrix * u_VMatrix * u_MMatrix * position;" \
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);
@@ -392,7 +406,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);
 
 	// Shader program
 	gSPObj = glCreateProgram();
@@ -403,7 +417,7 @@ void Initialize(void) {
 	glBindAttribLocation(gSPObj, DV_ATTRIB_NORM, "vNormal");
 	glBindAttribLocation(gSPObj, DV_ATTRIB_TEX, "vTexCoord");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);
 
 	// Get uniform location(s)
 	MMatrixUniform = glGetUniformLocation(gSPObj, "u_MMatrix");
@@ -477,20 +491,25 @@ void Initialize(void) {
 		-1.0f, 1.0, 1.0f,	0.0f, 0.0f, 1.0f,	0.0f, 1.0f, 0.0f,	1.0f, 1.0f,
 	};
 
+	// Quantization of cube : 44 bytes per vertex (3+3+3+2 floats) to 20 bytes
+	const VertexSource CubeSource = { 3+3+3+2, 0, 6, 9, 3 };	// stride, position, normal, texcoord, color
+	const unsigned int numCubeVertices = sizeof(Cube) / (CubeSource.stride * sizeof(float));
+	unsigned int CubeEncoded[sizeof(Cube) / sizeof(unsigned int)];	// Never larger than source; 4 byte aligned for short / packed stores
+	makeVertexFormat(&gCubeFormat, &CubeSource, VF_SNORM16, VF_INT_2_10_10_10, VF_HALF, VF_UNORM8);
+	encodeVertices(&gCubeFormat, &CubeSource, Cube, numCubeVertices, CubeEncoded);
+	printVertexFormatReport("Cube", &gCubeFormat, &CubeSource, numCubeVertices);
+
+	glUseProgram(gSPObj);
+	setVertexFormatUniforms(&gCubeFormat, glGetUniformLocation(gSPObj, "u_PositionScale"), glGetUniformLocation(gSPObj, "u_PositionBias"));
+	glUseProgram(0);
+
 	// For Quad
 	glGenVertexArrays(1, &gVAObj);
 	glBindVertexArray(gVAObj);
 		glGenBuffers(1, &gVBObj);
 		glBindBuffer(GL_ARRAY_BUFFER, gVBObj);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(Cube), Cube, GL_STATIC_DRAW);
-		glVertexAttribPointer(DV_ATTRIB_POS, 3, GL_FLOAT, GL_FALSE, (3+3+3+2)*sizeof(float), (void *)(0 * sizeof(float)));
-		glEnableVertexAttribArray(DV_ATTRIB_POS);
-		glVertexAttribPointer(DV_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, (3+3+3+2)*sizeof(float), (void *)(3 * sizeof(float)));
-		glEnableVertexAttribArray(DV_ATTRIB_COLOR);
-		glVertexAttribPointer(DV_ATTRIB_NORM, 3, GL_FLOAT, GL_FALSE, (3+3+3+2)*sizeof(float), (void *)(6 * sizeof(float)));
-		glEnableVertexAttribArray(DV_ATTRIB_NORM);
-		glVertexAttribPointer(DV_ATTRIB_TEX, 2, GL_FLOAT, GL_FALSE, (3+3+3+2)*sizeof(float), (void *)(9 * sizeof(float)));
-		glEnableVertexAttribArray(DV_ATTRIB_TEX);
+		glBufferData(GL_ARRAY_BUFFER, numCubeVertices * gCubeFormat.stride, CubeEncoded, GL_STATIC_DRAW);
+		setVertexFormatAttribPointers(&gCubeFormat, DV_ATTRIB_POS, DV_ATTRIB_NORM, DV_ATTRIB_TEX, DV_ATTRIB_COLOR);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
@@ -498,7 +517,8 @@ void Initialize(void) {
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
 
-	marble_texture = LoadBitmapAsTexture("marble.png");
+	textureLoaderInitialize(&gTextureLoader);
+	textureLoaderRequest(&gTextureLoader, "marble.png", &marble_texture);
 	glEnable(GL_TEXTURE_2D);
 
 	gbEnableInterleaved = false;
@@ -510,80 +530,17 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 		exit(1);
 	}
 }
 
-GLuint LoadBitmapAsTexture(const char* path) {
-	// Variable declaration
-	int width, height;
-	unsigned char *imageData = NULL;
-	GLuint textureID;
-
-	// Code
-	imageData = SOIL_load_image(path, &width, &height, NULL, SOIL_LOAD_RGB);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-//	gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, imageData);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, (const void *)imageData);
-	glGenerateMipmap(GL_TEXTURE_2D);
-
-	SOIL_free_image_data(imageData);
-	return textureID;
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -595,6 +552,7 @@ void Resize(int width, int height) {
 
 void display(void) {
 	// Variable declaration
+	GLfloat angle = frameSchedulerLerpAngle(gfPrevAngle, gfAngle, gScheduler.alpha);
 	mat4 modelMatrix, viewMatrix, projectionMatrix;
 	mat4 translateMatrix, rotationMatrix;
 
@@ -625,11 +583,11 @@ void display(void) {
 	rotationMatrix = mat4::identity();
 
 	translateMatrix = translate(0.0f, 0.0f, -5.0f);
-	rotationMatrix = rotate(gfAngle, 1.0f, 0.0f, 0.0f);
+	rotationMatrix = rotate(angle, 1.0f, 0.0f, 0.0f);
 	modelMatrix = translateMatrix * rotationMatrix;
-	rotationMatrix = rotate(gfAngle, 0.0f, 1.0f, 0.0f);
+	rotationMatrix = rotate(angle, 0.0f, 1.0f, 0.0f);
 	modelMatrix *= rotationMatrix;
-	rotationMatrix = rotate(gfAngle, 0.0f, 0.0f, 1.0f);
+	rotationMatrix = rotate(angle, 0.0f, 0.0f, 1.0f);
 	modelMatrix *= rotationMatrix;
 
 	glUniformMatrix4fv(MMatrixUniform, 1, GL_FALSE, modelMatrix);
@@ -657,12 +615,13 @@ void display(void) {
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update
 	// Code
+	gfPrevAngle = gfAngle;
 	if(gbEnableAnimation)
-		gfAngle += 0.1f;
+		gfAngle += 6.0f * delta;	// Degrees per second
 	if(gfAngle >= 360.0f)
-		gfAngle = 0.0f;
+		gfAngle -= 360.0f;
 }
 
 void Uninitialize() {
@@ -707,10 +666,7 @@ void Uninitialize() {
 		gSPObj = 0;
 	}
 
-	if(marble_texture) {
-		glDeleteTextures(1, &marble_texture);
-		marble_texture = 0;
-	}
+	textureLoaderUninitialize(&gTextureLoader);	// Deletes marble_texture too
 
 	currentGLXContext = glXGetCurrentContext();
 	if(currentGLXContext == gGLXContext)
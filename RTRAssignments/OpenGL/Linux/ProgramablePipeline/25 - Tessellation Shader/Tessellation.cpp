@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "../Include/vmath.h"
+#include "../Include/ShaderCache.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -46,11 +47,8 @@ Window gWindow;
 int giWindowWidth = 800;
 int giWindowHeight = 600;
 
-GLuint gVSObj;		// Vertex Shader Object
-GLuint gTCSObj;		// Tessellation Control Shader Object
-GLuint gTESObj;		// Tessellation Evaluation Shader Object
-GLuint gFSObj;		// Fragment Shader Object
 GLuint gSPObj;		// Shader Program Object
+ShaderCache gShaderCache;	// Linked programs are reused from disk on next start
 GLuint gVAObj;		// Vertex Array Object
 GLuint gVBObj;		// Vertex Buffer Object
 GLuint gMVPUniform;	// Model View Projection matrix Uniform
@@ -284,7 +282,6 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -318,6 +315,7 @@ void Initialize(void) {
 	GLenum glew_error = glewInit();
 	if(glew_error != GLEW_OK)
 		Uninitialize();
+	shaderCacheInitialize(&gShaderCache);
 
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
@@ -339,19 +337,14 @@ void Initialize(void) {
 	OGL_info = NULL;
 
 	// Vertex Shader
-	gVSObj = glCreateShader(GL_VERTEX_SHADER);
 	const GLchar *VSSrcCode =
 		"#version 450 core \n" \
 		"in vec2 vPosition;" \
 		"void main(void) {" \
 			"gl_Position = vec4(vPosition, 0.0, 0.0);" \
 		"}";
-	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
-	glCompileShader(gVSObj);
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");
 
 	// Tessellation Control shader
-	gTCSObj = glCreateShader(GL_TESS_CONTROL_SHADER);
 	const GLchar *TCSSrcCode = 
 		"#version 450 core \n" \
 		"layout(vertices = 4)out;" \
@@ -362,12 +355,8 @@ void Initialize(void) {
 			"gl_TessLevelOuter[0] = float(numberOfStrips);" \
 			"gl_TessLevelOuter[1] = float(numberOfSegments);" \
 		"}";
-	glShaderSource(gTCSObj, 1, (const GLchar**)&TCSSrcCode, NULL);
-	glCompileShader(gTCSObj);
-	ShaderErrorCheck(gTCSObj, (char *)"TESS_CONTROL");
 
 	// Tessellation Evaluation Shader
-	gTESObj = glCreateShader(GL_TESS_EVALUATION_SHADER);
 	const GLchar *TESSrcCode = 
 		"#version 450 core \n" \
 		"layout(isolines)in;" \
@@ -381,12 +370,8 @@ void Initialize(void) {
 			"vec3 p = (p0 * (1.0-tessCoords) * (1.0-tessCoords) * (1.0-tessCoords)) + (3.0 * p1 * (1.0-tessCoords) * (1.0-tessCoords) * tessCoords) + (3.0 * p2 * (1.0-tessCoords) * tessCoords * tessCoords) + (p3 * tessCoords * tessCoords * tessCoords);" \
 			"gl_Position = u_mvpMatrix * vec4(p, 1.0);" \
 		"}";
-	glShaderSource(gTESObj, 1, (const GLchar**)&TESSrcCode, NULL);
-	glCompileShader(gTESObj);
-	ShaderErrorCheck(gTESObj, (char *)"TESS_EVALUATION");
 
 	// Fragment Shader
-	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);
 	const GLchar *FSSrcCode =
 		"#version 450 core \n" \
 		"uniform vec4 lineColor;" \
@@ -394,19 +379,20 @@ void Initialize(void) {
 		"void main(void) {" \
 			"FragColor = lineColor;" \
 		"}";
-	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
-	glCompileShader(gFSObj);
-	ShaderErrorCheck(gVSObj, (char *)"FRAGMENT");
-
-	// Shader program
-	gSPObj = glCreateProgram();
-	glAttachShader(gSPObj, gVSObj);
-	glAttachShader(gSPObj, gTCSObj);
-	glAttachShader(gSPObj, gTESObj);
-	glAttachShader(gSPObj, gFSObj);
-	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
-	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");
+
+	// Shader program - loaded from shader cache, or compiled and linked then stored in it
+	const ShaderAttrib programAttribs[] = { { DV_ATTRIB_POS, "vPosition" } };
+	const ShaderSource programStages[] = {
+		{ SHADER_STAGE_VERTEX, VSSrcCode },
+		{ SHADER_STAGE_TESS_CONTROL, TCSSrcCode },
+		{ SHADER_STAGE_TESS_EVALUATION, TESSrcCode },
+		{ SHADER_STAGE_FRAGMENT, FSSrcCode } };
+	shaderCacheAdd(&gShaderCache, &gSPObj, programStages, 4, programAttribs, 1);
+	if(shaderCacheFinish(&gShaderCache) == false) {
+		printf("\n Exitting now...");
+		Uninitialize();
+		exit(1);
+	}
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -442,58 +428,6 @@ void Initialize(void) {
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
-	// Function declaration
-	void Uninitialize(void);
-
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
-	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
-		Uninitialize();
-	}
-}
-
 void Resize(int width, int height) {
 	// Code
 	if(height == 0)
@@ -537,6 +471,7 @@ void display(void) {
 	glUseProgram(0);
 
 	glXSwapBuffers(gpDisplay, gWindow);
+	shaderCacheFirstFrame(&gShaderCache);
 }
 
 void Update(void) {
@@ -566,44 +501,8 @@ void Uninitialize() {
 		gVBObj = 0;
 	}
 
-	// Detach shaders
-	glDetachShader(gSPObj, gVSObj);
-	glDetachShader(gSPObj, gTCSObj);
-	glDetachShader(gSPObj, gTESObj);
-	glDetachShader(gSPObj, gFSObj);
-
-	// Delete shaders
-	if(gVSObj) {
-		glDeleteShader(gVSObj);
-		gVSObj = 0;
-	}
-	if(gTCSObj) {
-		glDeleteShader(gTCSObj);
-		gTCSObj = 0;
-	}
-	if(gTESObj) {
-		glDeleteShader(gTESObj);
-		gTESObj = 0;
-	}
-	if(gFSObj) {
-		glDeleteShader(gFSObj);
-		gFSObj = 0;
-	}
+	// Delete shader program (shader objects were deleted right after linking)
 	if(gSPObj) {
-		glDeleteShader(gSPObj);
-		gSPObj = 0;
-	}
-
-	// Delete shaders
-	if(gVSObj) {			// Delete Vertex shader
-		glDeleteShader(gVSObj);
-		gVSObj = 0;
-	}
-	if(gFSObj) {			// Delete Fragment shader
-		glDeleteShader(gFSObj);
-		gFSObj = 0;
-	}
-	if(gSPObj) {		// Delete final shader program
 		glDeleteProgram(gSPObj);
 		gSPObj = 0;
 	}
@@ -9,7 +9,9 @@
 #include <memory.h>
 #include "../Include/vmath.h"
 #include "../Include/Sphere.h"
-#include "../Include/PushPop.h"
+#include "../Include/SceneGraph.h"
+#include "../Include/ShaderBuild.h"
+#include "../Include/FrameScheduler.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -62,6 +64,10 @@ GLuint colorUniform;
 int days, years;
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
+SceneGraph gSolarSystem;		// sun -> earth orbit -> earth
+int gSunNode, gEarthOrbitNode, gEarthNode;
+int gAppliedDays = -1, gAppliedYears = -1;	// days/years already in local transforms of scene graph
+FrameScheduler gScheduler;	// Vsync and frame pacing; days/years only change on key press
 
 // Entry point function
 int main() {
@@ -71,7 +77,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -162,8 +168,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -292,7 +301,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -329,6 +338,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Key presses are applied 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -359,7 +370,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);
@@ -372,7 +383,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);
 
 	// Shader program
 	gSPObj = glCreateProgram();
@@ -380,7 +391,7 @@ void Initialize(void) {
 	glAttachShader(gSPObj, gFSObj);
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -421,58 +432,23 @@ void Initialize(void) {
 
 	gPerspMatrix = mat4::identity();
 
+	// Hierarchy, in the order display() draws it; orbit and spin are set in Update()
+	if(sceneGraphCreate(&gSolarSystem, 3, 1) == false)
+		Uninitialize();
+	gSunNode = sceneGraphAddNode(&gSolarSystem, -1, translate(0.0f, 0.0f, -10.0f));
+	gEarthOrbitNode = sceneGraphAddNode(&gSolarSystem, gSunNode, mat4::identity());
+	gEarthNode = sceneGraphAddNode(&gSolarSystem, gEarthOrbitNode, mat4::identity());
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -484,55 +460,45 @@ void Resize(int width, int height) {
 	glViewport(0, 0, (GLsizei)width, (GLsizei)height);
 
 	gPerspMatrix = perspective(45.0f, (GLfloat)width/(GLfloat)height, 0.1f, 100.0f);
+	sceneGraphSetProjection(&gSolarSystem, gPerspMatrix);
 }
 
 void display(void) {
-	// Variable declaration
-	mat4 ModelViewMatrix, ModelViewProjectionMatrix;
-	mat4 translationMatrix;
-
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	ModelViewMatrix = mat4::identity();
-	ModelViewProjectionMatrix = mat4::identity();
-	translationMatrix = mat4::identity();
+	glUseProgram(gSPObj);
+	glBindVertexArray(gVAObj);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj[2]);
 
-	translationMatrix = translate(0.0f, 0.0f, -10.0f);
-	ModelViewMatrix *= translationMatrix;
+	// Sun
+	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, sceneGraphGetMVP(&gSolarSystem, gSunNode));	// Multiplied only if node moved or projection changed
+	glUniform3f(colorUniform, 1.0f, 1.0f, 0.0f);
+	glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
 
-	glUseProgram(gSPObj);
-	PushMatrix4x4(ModelViewMatrix);
-		ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
-		glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
-		glUniform3f(colorUniform, 1.0f, 1.0f, 0.0f);
-		glBindVertexArray(gVAObj);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj[2]);
-			glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
-		glBindVertexArray(0);
-	ModelViewMatrix = PopMatrix4x4();
-
-	PushMatrix4x4(ModelViewMatrix);
-		ModelViewMatrix *= rotate((GLfloat)years, 0.0f, 1.0f, 0.0f);
-		ModelViewMatrix *= translate(4.0f, 0.0f, 0.0f);
-		ModelViewMatrix *= rotate((GLfloat)90.0f, 1.0f, 0.0f, 0.0f);
-		ModelViewMatrix *= rotate((GLfloat)days, 0.0f, 0.0f, 1.0f);
-		ModelViewMatrix *= scale(0.5f);
-		ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
-		glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
-		glUniform3f(colorUniform, 0.4f, 0.9f, 1.0f);
-		glBindVertexArray(gVAObj);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj[2]);
-			glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
-		glBindVertexArray(0);
-	ModelViewMatrix = PopMatrix4x4();
+	// Earth
+	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, sceneGraphGetMVP(&gSolarSystem, gEarthNode));
+	glUniform3f(colorUniform, 0.4f, 0.9f, 1.0f);
+	glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
+
+	glBindVertexArray(0);
 	glUseProgram(0);
 
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+void Update(GLfloat delta) {	// delta : seconds since last update, unused as angles are stepped by keys
 	// Code
+	// Only transforms whose angle changed are set, so unchanged frames multiply nothing
+	if(years != gAppliedYears) {
+		sceneGraphSetLocal(&gSolarSystem, gEarthOrbitNode, rotate((GLfloat)years, 0.0f, 1.0f, 0.0f) * translate(4.0f, 0.0f, 0.0f));
+		gAppliedYears = years;
+	}
+	if(days != gAppliedDays) {
+		sceneGraphSetLocal(&gSolarSystem, gEarthNode, rotate(90.0f, 1.0f, 0.0f, 0.0f) * rotate((GLfloat)days, 0.0f, 0.0f, 1.0f) * scale(0.5f));
+		gAppliedDays = days;
+	}
+	sceneGraphUpdate(&gSolarSystem);
 }
 
 void Uninitialize() {
@@ -543,6 +509,8 @@ void Uninitialize() {
 	if(bFullscreen == true)
 		ToggleFullscreen();
 
+	sceneGraphDestroy(&gSolarSystem);
+
 	// Stop using shader program
 	if(glXGetCurrentContext != NULL)
 		glUseProgram(0);
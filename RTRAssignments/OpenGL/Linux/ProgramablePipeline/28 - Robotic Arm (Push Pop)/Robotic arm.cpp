@@ -7,9 +7,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <time.h>		// for CPU frame time
 #include "../Include/vmath.h"
 #include "../Include/Sphere.h"
+#define MATRIX_STACK_CAPACITY	72	// Stress arm nests one level per joint
 #include "../Include/PushPop.h"
+#include "../Include/SceneGraph.h"
+#include "../Include/ShaderBuild.h"
+#include "../Include/FrameScheduler.h"
 
 // OpenGL specific header files
 #include <GL/glew.h>
@@ -62,6 +67,21 @@ GLuint colorUniform;
 int elbow, shoulder;
 
 mat4 gPerspMatrix;	// 4x4 matrix for orthographic projection
+MatrixStack gMatrixStack;		// Stress mode only
+SceneGraph gArm;			// base -> shoulder -> (upper arm, elbow -> fore arm)
+int gBaseNode, gShoulderNode, gUpperArmNode, gElbowNode, gForeArmNode;
+int gAppliedShoulder = -1, gAppliedElbow = -1;	// shoulder/elbow already in local transforms of scene graph
+FrameScheduler gScheduler;	// Vsync and frame pacing; joints only change on key press
+
+// Stress mode : STRESS_ARMS arms of STRESS_JOINTS joints, only matrices are built (not drawn)
+#define STRESS_ARMS		1000
+#define STRESS_JOINTS		64
+#define FRAME_TIME_SAMPLES	256
+bool gbStress = false;
+bool gbLegacyStack = false;	// true - PushMatrix4x4()/PopMatrix4x4() with gPerspMatrix * ModelViewMatrix per level
+mat4 *gStressMVP = NULL;	// MVP of every stress joint, as would be uploaded
+double gdFrameTimeSum = 0.0;
+int giFrameTimeCount = 0;
 
 // Entry point function
 int main() {
@@ -71,7 +91,7 @@ int main() {
 	void Initialize(void);
 	void Resize(int, int);
 	void display(void);
-	void Update(void);
+	void Update(GLfloat);
 	void Uninitialize();
 
 	// Variable declaration
@@ -128,6 +148,21 @@ int main() {
 							if(shoulder > 360)
 								shoulder = 0;
 							break;
+						case XK_T :
+						case XK_t :
+							if(gStressMVP != NULL)
+								gbStress = !gbStress;
+							printf("\n Stress mode : %s", gbStress ? "On" : "Off");
+							gdFrameTimeSum = 0.0;
+							giFrameTimeCount = 0;
+							break;
+						case XK_L :
+						case XK_l :
+							gbLegacyStack = !gbLegacyStack;
+							printf("\n Matrix stack : %s", gbLegacyStack ? "PushMatrix4x4()/PopMatrix4x4()" : "MatrixStack (cached MVP)");
+							gdFrameTimeSum = 0.0;
+							giFrameTimeCount = 0;
+							break;
 						default :
 							break;
 					}
@@ -162,8 +197,11 @@ int main() {
 					break;
 			}
 		}
-		Update();
+		frameSchedulerBeginFrame(&gScheduler);
+		while(frameSchedulerStep(&gScheduler) == true)
+			Update(gScheduler.step);
 		display();
+		frameSchedulerEndFrame(&gScheduler);
 	}
 	Uninitialize();
 	return 0;
@@ -292,7 +330,7 @@ void Initialize(void) {
 	// Function declaration
 	void Resize(int, int);
 	void Uninitialize();
-	void ShaderErrorCheck(GLuint, char*);		// Check shader's post compilation and linking errors 
+	void ShaderErrorCheck(GLuint, ShaderStage);		// Check shader's post compilation and linking errors 
 
 	// Variable declaration
 	FILE *OGL_info = NULL;
@@ -329,6 +367,8 @@ void Initialize(void) {
 	if(glew_error != GLEW_OK)
 		Uninitialize();
 
+	frameSchedulerInitialize(&gScheduler, gpDisplay, gWindow, 60.0);	// Key presses are applied 60 times a second at any frame rate
+
 	// OpenGL related log entry
 	OGL_info = fopen("OpenGL_info.txt", "w");
 	if(OGL_info == NULL)
@@ -359,7 +399,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gVSObj, 1, (const GLchar**)&VSSrcCode, NULL);
 	glCompileShader(gVSObj);
-	ShaderErrorCheck(gVSObj, (char *)"VERTEX");
+	ShaderErrorCheck(gVSObj, SHADER_STAGE_VERTEX);
 
 	// Fragment Shader
 	gFSObj = glCreateShader(GL_FRAGMENT_SHADER);
@@ -372,7 +412,7 @@ void Initialize(void) {
 		"}";
 	glShaderSource(gFSObj, 1, (const GLchar**)&FSSrcCode, NULL);
 	glCompileShader(gFSObj);
-	ShaderErrorCheck(gFSObj, (char *)"FRAGMENT");
+	ShaderErrorCheck(gFSObj, SHADER_STAGE_FRAGMENT);
 
 	// Shader program
 	gSPObj = glCreateProgram();
@@ -380,7 +420,7 @@ void Initialize(void) {
 	glAttachShader(gSPObj, gFSObj);
 	glBindAttribLocation(gSPObj, DV_ATTRIB_POS, "vPosition");
 	glLinkProgram(gSPObj);
-	ShaderErrorCheck(gSPObj, (char *)"PROGRAM");
+	ShaderErrorCheck(gSPObj, SHADER_STAGE_PROGRAM);
 
 	// Get uniform location(s)
 	gMVPUniform = glGetUniformLocation(gSPObj, "u_mvpMatrix");
@@ -420,59 +460,31 @@ void Initialize(void) {
 	shoulder = 0;
 
 	gPerspMatrix = mat4::identity();
+	matrixStackInitialize(&gMatrixStack);
+
+	// Hierarchy, in the order display() draws it; joint angles are set in Update()
+	if(sceneGraphCreate(&gArm, 5, 1) == false)
+		Uninitialize();
+	gBaseNode = sceneGraphAddNode(&gArm, -1, translate(0.0f, 0.0f, -10.0f));
+	gShoulderNode = sceneGraphAddNode(&gArm, gBaseNode, mat4::identity());
+	gUpperArmNode = sceneGraphAddNode(&gArm, gShoulderNode, scale(2.0f, 0.65f, 1.0f));
+	gElbowNode = sceneGraphAddNode(&gArm, gShoulderNode, mat4::identity());
+	gForeArmNode = sceneGraphAddNode(&gArm, gElbowNode, scale(2.0f, 0.5f, 1.0f));
+
+	gStressMVP = (mat4 *)malloc(STRESS_ARMS * STRESS_JOINTS * sizeof(mat4));
+	if(gStressMVP == NULL)
+		printf("\n Unable to allocate memory for stress mode.");
 
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	Resize(giWindowWidth, giWindowHeight);
 }
 
-void ShaderErrorCheck(GLuint shaderObject, char *shaderName) {	// Error checking after shader compilation
+void ShaderErrorCheck(GLuint shaderObject, ShaderStage shaderStage) {	// Error checking after shader compilation or linking
 	// Function declaration
 	void Uninitialize(void);
 
-	// Variable declaration
-	GLint iErrorLen = 0;
-	GLint iStatus = 0;
-	char *szError = NULL;
-	char shaderOpr[8];
-
 	// Code
-	if(strcmp(shaderName, "VERTEX") == 0 || strcmp(shaderName, "TESS_CONTROL") == 0 || strcmp(shaderName, "TESS_EVALUATION") == 0 || strcmp(shaderName, "GEOMETRY") == 0 || strcmp(shaderName, "FRAGMENT") == 0 || strcmp(shaderName, "COMPUTE") == 0)
-		strcpy(shaderOpr, "COMPILE");
-	else if(strcmp(shaderName, "PROGRAM") == 0)
-		strcpy(shaderOpr, "LINK");
-	else {
-		printf("Invalid second parameter in ShaderErrorCheck()");
-		return;
-	}
-
-	if(strcmp(shaderOpr, "COMPILE") == 0)
-		glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &iStatus);
-	else if(strcmp(shaderOpr, "LINK") == 0)
-		glGetProgramiv(shaderObject, GL_LINK_STATUS, &iStatus);
-	if(iStatus == GL_FALSE) {
-		if(strcmp(shaderOpr, "COMPILE") == 0)
-			glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		else if(strcmp(shaderOpr, "LINK") == 0)
-			glGetProgramiv(shaderObject, GL_INFO_LOG_LENGTH, &iErrorLen);
-		if(iErrorLen > 0) {
-			szError = (char *)malloc(iErrorLen);
-			if(szError != NULL) {
-				GLsizei written;
-				if(strcmp(shaderOpr, "COMPILE") == 0) {
-					glGetShaderInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("%s Shader Compilation Error log : \n", shaderName);
-				}
-				else if(strcmp(shaderOpr, "LINK") == 0) {
-					glGetProgramInfoLog(shaderObject, iErrorLen, &written, szError);
-					printf("Shader %s linking Error log : \n", shaderName);
-				}
-				printf("%s \n", szError);
-				free(szError);
-				szError = NULL;
-			}
-		}
-		else
-			printf("Error occured during compilation/linking. No error message. \n");
+	if(shaderStatusCheck(shaderObject, shaderStage) == false) {
 		Uninitialize();
 	}
 }
@@ -484,61 +496,121 @@ void Resize(int width, int height) {
 	glViewport(0, 0, (GLsizei)width, (GLsizei)height);
 
 	gPerspMatrix = perspective(45.0f, (GLfloat)width/(GLfloat)height, 0.1f, 100.0f);
+	sceneGraphSetProjection(&gArm, gPerspMatrix);
+	matrixStackSetProjection(&gMatrixStack, gPerspMatrix);
 }
 
 void display(void) {
+	// Function declaration
+	void StressStack(void);
+	void StressLegacy(void);
+
 	// Variable declaration
-	mat4 ModelViewMatrix, ModelViewProjectionMatrix;
-	mat4 translationMatrix;
+	struct timespec frameStart, frameEnd;
 
 	// Code
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	// Starting of OpenGL shading program
 	glUseProgram(gSPObj);
+	glUniform3f(colorUniform, 0.5f, 0.35f, 0.05f);
+	glBindVertexArray(gVAObj);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj[2]);
 
-	ModelViewMatrix = mat4::identity();
-	ModelViewProjectionMatrix = mat4::identity();
-	translationMatrix = mat4::identity();
+	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, sceneGraphGetMVP(&gArm, gUpperArmNode));	// Multiplied only if node moved or projection changed
+	glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
 
-	translationMatrix = translate(0.0f, 0.0f, -10.0f);
-	ModelViewMatrix *= translationMatrix;
+	glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, sceneGraphGetMVP(&gArm, gForeArmNode));
+	glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
 
-	glUseProgram(gSPObj);
-	PushMatrix4x4(ModelViewMatrix);
-		ModelViewMatrix *= rotate((GLfloat)shoulder, 0.0f, 0.0f, 1.0f);
-		ModelViewMatrix *= translate(1.0f, 0.0f, 0.0f);
-		PushMatrix4x4(ModelViewMatrix);
-			ModelViewMatrix *= scale(2.0f, 0.65f, 1.0f);
-			ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
-			glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
-			glUniform3f(colorUniform, 0.5f, 0.35f, 0.05f);
-			glBindVertexArray(gVAObj);
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj[2]);
-				glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
-			glBindVertexArray(0);
-		ModelViewMatrix = PopMatrix4x4();
-		ModelViewMatrix *= translate(1.0f, 0.0f, 0.0f);
-		ModelViewMatrix *= rotate((GLfloat)elbow, 0.0f, 0.0f, 1.0f);
-		ModelViewMatrix *= translate(1.0f, 0.0f, 0.0f);
-		PushMatrix4x4(ModelViewMatrix);
-			ModelViewMatrix *= scale(2.0f, 0.5f, 1.0f);
-			ModelViewProjectionMatrix = gPerspMatrix * ModelViewMatrix;
-			glUniformMatrix4fv(gMVPUniform, 1, GL_FALSE, ModelViewProjectionMatrix);
-			glUniform3f(colorUniform, 0.5f, 0.35f, 0.05f);
-			glBindVertexArray(gVAObj);
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gVBObj[2]);
-				glDrawElements(GL_TRIANGLES, gNumElements, GL_UNSIGNED_SHORT, 0);
-			glBindVertexArray(0);
-		ModelViewMatrix = PopMatrix4x4();
-	ModelViewMatrix = PopMatrix4x4();
+	glBindVertexArray(0);
 	glUseProgram(0);
 
+	if(gbStress == true) {
+		clock_gettime(CLOCK_MONOTONIC, &frameStart);
+		matrixStackResetStats(&gMatrixStack);
+		if(gbLegacyStack == true)
+			StressLegacy();
+		else
+			StressStack();
+		clock_gettime(CLOCK_MONOTONIC, &frameEnd);
+
+		gdFrameTimeSum += ((double)(frameEnd.tv_sec - frameStart.tv_sec) * 1000.0) + ((double)(frameEnd.tv_nsec - frameStart.tv_nsec) / 1000000.0);
+		if(++giFrameTimeCount == FRAME_TIME_SAMPLES) {
+			printf("\n %s : %d arms x %d joints : %.3f ms CPU per frame", gbLegacyStack ? "PushMatrix4x4" : "MatrixStack  ", STRESS_ARMS, STRESS_JOINTS, gdFrameTimeSum / FRAME_TIME_SAMPLES);
+			if(gbLegacyStack == false)
+				printf(", %u MVP multiplications", gMatrixStack.compositions);
+			if(gMatrixStack.overflows > 0 || gPushPopStack.overflows > 0)
+				printf(" (stack overflowed)");
+			fflush(stdout);
+			gdFrameTimeSum = 0.0;
+			giFrameTimeCount = 0;
+		}
+	}
+
 	glXSwapBuffers(gpDisplay, gWindow);
 }
 
-void Update(void) {
+// Stress arm with MatrixStack : every joint nests one level, like shoulder and elbow above
+void StressStack(void) {
+	// Variable declaration
+	mat4 *mvp = gStressMVP;
+
 	// Code
+	for(int arm = 0; arm < STRESS_ARMS; arm++) {
+		matrixStackLoadIdentity(&gMatrixStack);
+		matrixStackTranslate(&gMatrixStack, (GLfloat)(arm % 40) - 20.0f, (GLfloat)(arm / 40) - 12.5f, -60.0f);
+		for(int joint = 0; joint < STRESS_JOINTS; joint++) {
+			matrixStackPush(&gMatrixStack);
+			matrixStackRotate(&gMatrixStack, (GLfloat)(shoulder + (joint * elbow) / STRESS_JOINTS), 0.0f, 0.0f, 1.0f);
+			matrixStackTranslate(&gMatrixStack, 0.1f, 0.0f, 0.0f);
+			matrixStackPush(&gMatrixStack);
+				matrixStackScale(&gMatrixStack, 0.2f, 0.05f, 0.05f);
+				memcpy(mvp++, matrixStackGetMVP(&gMatrixStack), sizeof(mat4));
+			matrixStackPop(&gMatrixStack);
+			matrixStackTranslate(&gMatrixStack, 0.1f, 0.0f, 0.0f);
+		}
+		for(int joint = 0; joint < STRESS_JOINTS; joint++)
+			matrixStackPop(&gMatrixStack);
+	}
+}
+
+// Same stress arm with old PushMatrix4x4()/PopMatrix4x4()
+void StressLegacy(void) {
+	// Variable declaration
+	mat4 ModelViewMatrix;
+	mat4 *mvp = gStressMVP;
+
+	// Code
+	for(int arm = 0; arm < STRESS_ARMS; arm++) {
+		ModelViewMatrix = translate((GLfloat)(arm % 40) - 20.0f, (GLfloat)(arm / 40) - 12.5f, -60.0f);
+		for(int joint = 0; joint < STRESS_JOINTS; joint++) {
+			PushMatrix4x4(ModelViewMatrix);
+			ModelViewMatrix *= rotate((GLfloat)(shoulder + (joint * elbow) / STRESS_JOINTS), 0.0f, 0.0f, 1.0f);
+			ModelViewMatrix *= translate(0.1f, 0.0f, 0.0f);
+			PushMatrix4x4(ModelViewMatrix);
+				ModelViewMatrix *= scale(0.2f, 0.05f, 0.05f);
+				*mvp++ = gPerspMatrix * ModelViewMatrix;
+			ModelViewMatrix = PopMatrix4x4();
+			ModelViewMatrix *= translate(0.1f, 0.0f, 0.0f);
+		}
+		for(int joint = 0; joint < STRESS_JOINTS; joint++)
+			ModelViewMatrix = PopMatrix4x4();
+	}
+}
+
+void Update(GLfloat delta) {	// delta : seconds since last update, unused as angles are stepped by keys
+	// Code
+	// Only joints whose angle changed are set, so unchanged frames multiply nothing
+	if(shoulder != gAppliedShoulder) {
+		sceneGraphSetLocal(&gArm, gShoulderNode, rotate((GLfloat)shoulder, 0.0f, 0.0f, 1.0f) * translate(1.0f, 0.0f, 0.0f));
+		gAppliedShoulder = shoulder;
+	}
+	if(elbow != gAppliedElbow) {
+		sceneGraphSetLocal(&gArm, gElbowNode, translate(1.0f, 0.0f, 0.0f) * rotate((GLfloat)elbow, 0.0f, 0.0f, 1.0f) * translate(1.0f, 0.0f, 0.0f));
+		gAppliedElbow = elbow;
+	}
+	sceneGraphUpdate(&gArm);
 }
 
 void Uninitialize() {
@@ -549,6 +621,12 @@ void Uninitialize() {
 	if(bFullscreen == true)
 		ToggleFullscreen();
 
+	if(gStressMVP) {
+		free(gStressMVP);
+		gStressMVP = NULL;
+	}
+	sceneGraphDestroy(&gArm);
+
 	// Stop using shader program
 	if(glXGetCurrentContext != NULL)
 		glUseProgram(0);
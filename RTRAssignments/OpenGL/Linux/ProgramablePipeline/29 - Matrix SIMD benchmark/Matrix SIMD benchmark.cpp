@@ -0,0 +1,188 @@
+// Microbenchmark of SIMD 4x4 matrix kernels against scalar vmath code (console program)
+// Date : 17 October 2026
+// By : Darshan Vikam
+//
+// Build :
+//	g++ -O2 -o MatrixBenchmark "Matrix SIMD benchmark.cpp"			(SSE2)
+//	g++ -O2 -mavx2 -mfma -o MatrixBenchmark "Matrix SIMD benchmark.cpp"	(AVX2/FMA)
+
+// General Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../Include/vmath.h"
+#include "../Include/MatrixSIMD.h"
+
+// Namespaces
+using namespace vmath;
+
+// Global macro definitions
+#define NUM_MATRICES	4096		// Like a scene of 4096 objects
+#define NUM_REPEATS	200
+
+// Global variable declaration
+mat4 *gMatrices = NULL;
+mat4 *gResults = NULL;
+vec4 *gVectors = NULL;
+vec4 *gVectorResults = NULL;
+volatile float gSink = 0.0f;		// Keeps compiler from dropping benchmarked work
+
+// Entry point function
+int main(void) {
+	// Function declaration
+	double GetTimeMS(void);
+	void Report(const char *, double, double);
+	float MaxError(const float *, const float *, unsigned int);
+
+	// Variable declaration
+	mat4 viewProjection, reference;
+	double start, scalarTime, simdTime;
+	float error;
+
+	// Code
+	gMatrices = (mat4 *)malloc(NUM_MATRICES * sizeof(mat4));
+	gResults = (mat4 *)malloc(NUM_MATRICES * sizeof(mat4));
+	gVectors = (vec4 *)malloc(NUM_MATRICES * sizeof(vec4));
+	gVectorResults = (vec4 *)malloc(NUM_MATRICES * sizeof(vec4));
+	if(gMatrices == NULL || gResults == NULL || gVectors == NULL || gVectorResults == NULL) {
+		printf("\n ERROR : Unable to allocate memory.\n");
+		return 1;
+	}
+
+	// Transforms like those built in display() : translate * rotate * scale
+	srand(1);
+	for(int i = 0; i < NUM_MATRICES; i++) {
+		gMatrices[i] = translate((float)(rand() % 200 - 100) * 0.1f, (float)(rand() % 200 - 100) * 0.1f, -(float)(rand() % 100) * 0.1f - 3.0f);
+		gMatrices[i] *= rotate((float)(rand() % 360), 0.3f, 1.0f, 0.2f);
+		gMatrices[i] *= scale(0.5f + (float)(rand() % 100) * 0.01f);
+		gVectors[i] = vec4((float)(rand() % 100) * 0.01f, (float)(rand() % 100) * 0.01f, (float)(rand() % 100) * 0.01f, 1.0f);
+	}
+	viewProjection = perspective(45.0f, 800.0f / 600.0f, 0.1f, 100.0f) * translate(0.0f, 0.0f, -6.0f);
+
+	printf("\n Matrix kernels : %s, %d matrices x %d repeats", MATRIX_SIMD_NAME, NUM_MATRICES, NUM_REPEATS);
+	printf("\n %-28s %12s %12s %9s %12s", "Operation", "Scalar(ms)", "SIMD(ms)", "Speedup", "Max error");
+
+	// mat4 * mat4 : vmath operator (scalar) vs multiply()
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			gResults[i] = viewProjection * gMatrices[i];
+	scalarTime = GetTimeMS() - start;
+	reference = gResults[NUM_MATRICES - 1];
+	gSink = gSink + gResults[rand() % NUM_MATRICES][0][0];
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			gResults[i] = multiply(viewProjection, gMatrices[i]);
+	simdTime = GetTimeMS() - start;
+	error = MaxError(reference, gResults[NUM_MATRICES - 1], 16);
+	Report("mat4 * mat4", scalarTime, simdTime);
+	printf(" %12.2e", error);
+
+	// Batch of mat4 * mat4 (one call per frame)
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		mat4MultiplyBatch((float *)gResults, viewProjection, (const float *)gMatrices, NUM_MATRICES);
+	simdTime = GetTimeMS() - start;
+	error = MaxError(reference, gResults[NUM_MATRICES - 1], 16);
+	Report("mat4 * mat4 (batch)", scalarTime, simdTime);
+	printf(" %12.2e", error);
+	gSink = gSink + gResults[rand() % NUM_MATRICES][0][0];
+
+	// mat4 * vec4
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			gVectorResults[i] = gMatrices[i] * gVectors[i];
+	scalarTime = GetTimeMS() - start;
+	vec4 referenceVector = gVectorResults[NUM_MATRICES - 1];
+	gSink = gSink + gVectorResults[rand() % NUM_MATRICES][0];
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			gVectorResults[i] = multiply(gMatrices[i], gVectors[i]);
+	simdTime = GetTimeMS() - start;
+	error = MaxError(referenceVector, gVectorResults[NUM_MATRICES - 1], 4);
+	Report("mat4 * vec4", scalarTime, simdTime);
+	printf(" %12.2e", error);
+
+	// Batch of mat4 * vec4 with one matrix
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			gVectorResults[i] = viewProjection * gVectors[i];
+	scalarTime = GetTimeMS() - start;
+	referenceVector = gVectorResults[NUM_MATRICES - 1];
+	gSink = gSink + gVectorResults[rand() % NUM_MATRICES][0];
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		mat4TransformBatch((float *)gVectorResults, viewProjection, (const float *)gVectors, NUM_MATRICES);
+	simdTime = GetTimeMS() - start;
+	error = MaxError(referenceVector, gVectorResults[NUM_MATRICES - 1], 4);
+	Report("mat4 * vec4 (batch)", scalarTime, simdTime);
+	printf(" %12.2e", error);
+
+	// Transpose
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			mat4TransposeScalar(gResults[i], gMatrices[i]);
+	scalarTime = GetTimeMS() - start;
+	reference = gResults[NUM_MATRICES - 1];
+	gSink = gSink + gResults[rand() % NUM_MATRICES][0][0];
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			gResults[i] = transpose(gMatrices[i]);
+	simdTime = GetTimeMS() - start;
+	error = MaxError(reference, gResults[NUM_MATRICES - 1], 16);
+	Report("transpose", scalarTime, simdTime);
+	printf(" %12.2e", error);
+
+	// Inverse (e.g. normal matrix on CPU instead of per vertex in shader)
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		for(int i = 0; i < NUM_MATRICES; i++)
+			mat4InverseScalar(gResults[i], gMatrices[i]);
+	scalarTime = GetTimeMS() - start;
+	reference = gResults[NUM_MATRICES - 1];
+	gSink = gSink + gResults[rand() % NUM_MATRICES][0][0];
+	start = GetTimeMS();
+	for(int n = 0; n < NUM_REPEATS; n++)
+		mat4InverseBatch((float *)gResults, (const float *)gMatrices, NUM_MATRICES);
+	simdTime = GetTimeMS() - start;
+	error = MaxError(reference, gResults[NUM_MATRICES - 1], 16);
+	Report("inverse (batch)", scalarTime, simdTime);
+	printf(" %12.2e\n", error);
+
+	free(gMatrices);
+	free(gResults);
+	free(gVectors);
+	free(gVectorResults);
+	return 0;
+}
+
+double GetTimeMS(void) {
+	// Variable declaration
+	struct timespec now;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((double)now.tv_sec * 1000.0) + ((double)now.tv_nsec / 1000000.0);
+}
+
+void Report(const char *operation, double scalarTime, double simdTime) {
+	// Code
+	printf("\n %-28s %12.3f %12.3f %8.2fx", operation, scalarTime, simdTime, (simdTime > 0.0) ? scalarTime / simdTime : 0.0);
+}
+
+float MaxError(const float *a, const float *b, unsigned int count) {
+	// Variable declaration
+	float error = 0.0f;
+
+	// Code
+	for(unsigned int i = 0; i < count; i++)
+		error = fmaxf(error, fabsf(a[i] - b[i]));
+	return error;
+}
@@ -0,0 +1,228 @@
+// Benchmark of flat scene graph update on a generated galaxy (console program)
+// Date : 17 October 2026
+// By : Darshan Vikam
+//
+// Build :
+//	g++ -O2 -o SceneGraphBenchmark "Scene graph benchmark.cpp" -lpthread
+//
+// Galaxy : 1 core -> 1000 stars -> 9 planets each -> 10 moons each (100,001 bodies).
+// Same hierarchy is also walked with nested matrix stack push/pop (as display() of Solar System does),
+// which recomputes every body every frame. Only update is timed; local matrices are built outside timing.
+
+// General Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "../Include/vmath.h"
+#include "../Include/MatrixSIMD.h"
+#include "../Include/PushPop.h"
+#include "../Include/SceneGraph.h"
+
+// Namespaces
+using namespace vmath;
+
+// Global macro definitions
+#define NUM_STARS	1000
+#define NUM_PLANETS	9		// per star
+#define NUM_MOONS	10		// per planet
+#define NUM_BODIES	(1 + NUM_STARS * (1 + NUM_PLANETS * (1 + NUM_MOONS)))
+#define NUM_FRAMES	100
+#define FRAME_BUDGET_MS	16.667
+
+// Global variable declaration
+int *gPlanetNodes = NULL;		// Node index of every planet
+mat4 *gStackWorld = NULL;		// World matrices built by matrix stack walk
+volatile float gSink = 0.0f;
+
+// Entry point function
+int main(void) {
+	// Function declaration
+	double GetTimeMS(void);
+	bool BuildGalaxy(SceneGraph *);
+	void Animate(SceneGraph *, int, unsigned int);
+	void StackWalk(MatrixStack *, const SceneGraph *);
+	void Report(const char *, double, unsigned int);
+	float MaxError(const SceneGraph *, const SceneGraph *);
+
+	// Variable declaration
+	SceneGraph serial, threaded;
+	MatrixStack stack;
+	unsigned int numThreads, updated = 0;
+	double start, total;
+
+	// Code
+	numThreads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	gPlanetNodes = (int *)malloc(NUM_STARS * NUM_PLANETS * sizeof(int));
+	gStackWorld = (mat4 *)malloc(NUM_BODIES * sizeof(mat4));
+	if(gPlanetNodes == NULL || gStackWorld == NULL || sceneGraphCreate(&serial, NUM_BODIES, 1) == false || sceneGraphCreate(&threaded, NUM_BODIES, numThreads) == false) {
+		printf("\n ERROR : Unable to allocate memory.\n");
+		return 1;
+	}
+	BuildGalaxy(&serial);
+	if(BuildGalaxy(&threaded) == false)
+		return 1;
+	matrixStackInitialize(&stack);
+	sceneGraphUpdate(&serial);
+	sceneGraphUpdate(&threaded);
+
+	printf("\n Galaxy : %d bodies, %d frames, %d worker thread(s), matrix kernels : %s", NUM_BODIES, NUM_FRAMES, threaded.numThreads, MATRIX_SIMD_NAME);
+	printf("\n %-40s %12s %8s %12s", "Update", "ms/frame", "% frame", "Bodies");
+
+	// Old way : nested push/pop every frame
+	total = 0.0;
+	for(int f = 0; f < NUM_FRAMES; f++) {
+		start = GetTimeMS();
+		StackWalk(&stack, &serial);
+		total += GetTimeMS() - start;
+	}
+	Report("Matrix stack walk (all bodies)", total, NUM_BODIES);
+
+	// Every star, planet and moon moves
+	total = 0.0;
+	for(int f = 0; f < NUM_FRAMES; f++) {
+		Animate(&serial, f, 100);
+		start = GetTimeMS();
+		updated = sceneGraphUpdate(&serial);
+		total += GetTimeMS() - start;
+	}
+	Report("Scene graph, all dirty, 1 thread", total, updated);
+
+	total = 0.0;
+	for(int f = 0; f < NUM_FRAMES; f++) {
+		Animate(&threaded, f, 100);
+		start = GetTimeMS();
+		updated = sceneGraphUpdate(&threaded);
+		total += GetTimeMS() - start;
+	}
+	Report("Scene graph, all dirty, all threads", total, updated);
+	printf("\n %-40s %12.2e", "Max error (threads vs 1 thread)", MaxError(&serial, &threaded));
+
+	// Only 1% of planets move; their moons follow
+	total = 0.0;
+	for(int f = 0; f < NUM_FRAMES; f++) {
+		Animate(&threaded, f, 1);
+		start = GetTimeMS();
+		updated = sceneGraphUpdate(&threaded);
+		total += GetTimeMS() - start;
+	}
+	Report("Scene graph, 1% planets dirty", total, updated);
+
+	// Nothing moves
+	start = GetTimeMS();
+	for(int f = 0; f < NUM_FRAMES; f++)
+		updated = sceneGraphUpdate(&threaded);
+	Report("Scene graph, static", GetTimeMS() - start, updated);
+	printf("\n");
+
+	gSink = gSink + threaded.world[NUM_BODIES - 1][3][0] + gStackWorld[NUM_BODIES - 1][3][0];
+	sceneGraphDestroy(&serial);
+	sceneGraphDestroy(&threaded);
+	free(gPlanetNodes);
+	free(gStackWorld);
+	return 0;
+}
+
+// Local transform of a body on circular orbit, spinning about its own axis
+mat4 OrbitMatrix(float orbitAngle, float radius, float spinAngle, float size) {
+	// Code
+	return rotate(orbitAngle, 0.0f, 1.0f, 0.0f) * translate(radius, 0.0f, 0.0f) * rotate(spinAngle, 0.0f, 1.0f, 0.0f) * scale(size);
+}
+
+bool BuildGalaxy(SceneGraph *graph) {
+	// Variable declaration
+	int core, star, planet;
+	int p = 0;
+
+	// Code
+	core = sceneGraphAddNode(graph, -1, mat4::identity());
+	for(int s = 0; s < NUM_STARS; s++) {
+		star = sceneGraphAddNode(graph, core, OrbitMatrix((float)s * 0.36f, 10.0f + (float)s * 0.1f, 0.0f, 1.0f));
+		for(int j = 0; j < NUM_PLANETS; j++) {
+			planet = sceneGraphAddNode(graph, star, OrbitMatrix((float)j * 40.0f, 1.0f + (float)j, 0.0f, 0.3f));
+			gPlanetNodes[p++] = planet;
+			for(int m = 0; m < NUM_MOONS; m++)
+				sceneGraphAddNode(graph, planet, OrbitMatrix((float)m * 36.0f, 2.0f + (float)m * 0.2f, 0.0f, 0.1f));
+		}
+	}
+	return (graph->count == NUM_BODIES);
+}
+
+// Moves 'percent' of planets (and, at 100%, also every star and moon)
+void Animate(SceneGraph *graph, int frame, unsigned int percent) {
+	// Variable declaration
+	float t = (float)frame;
+	unsigned int step = 100 / percent;
+
+	// Code
+	if(percent >= 100) {
+		for(unsigned int i = 1; i < graph->count; i++) {
+			float size = (graph->depth[i] == 1) ? 1.0f : ((graph->depth[i] == 2) ? 0.3f : 0.1f);
+			sceneGraphSetLocal(graph, i, OrbitMatrix((float)i * 0.36f + t * 0.1f, 1.0f + (float)(i % 13), t, size));
+		}
+	}
+	else {
+		for(unsigned int p = frame % step; p < NUM_STARS * NUM_PLANETS; p += step)
+			sceneGraphSetLocal(graph, gPlanetNodes[p], OrbitMatrix((float)p * 40.0f + t, 1.0f + (float)(p % NUM_PLANETS), t, 0.3f));
+	}
+}
+
+// Same hierarchy with nested push/pop, on local matrices of scene graph; every body is multiplied every frame
+void StackWalk(MatrixStack *stack, const SceneGraph *graph) {
+	// Variable declaration
+	unsigned int i = 0;
+
+	// Code
+	matrixStackLoad(stack, graph->local[i]);
+	gStackWorld[i++] = matrixStackGetModelView(stack);
+	for(int s = 0; s < NUM_STARS; s++) {
+		matrixStackPush(stack);
+		matrixStackMultiply(stack, graph->local[i]);
+		gStackWorld[i++] = matrixStackGetModelView(stack);
+		for(int j = 0; j < NUM_PLANETS; j++) {
+			matrixStackPush(stack);
+			matrixStackMultiply(stack, graph->local[i]);
+			gStackWorld[i++] = matrixStackGetModelView(stack);
+			for(int m = 0; m < NUM_MOONS; m++) {
+				matrixStackPush(stack);
+				matrixStackMultiply(stack, graph->local[i]);
+				gStackWorld[i++] = matrixStackGetModelView(stack);
+				matrixStackPop(stack);
+			}
+			matrixStackPop(stack);
+		}
+		matrixStackPop(stack);
+	}
+}
+
+double GetTimeMS(void) {
+	// Variable declaration
+	struct timespec now;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((double)now.tv_sec * 1000.0) + ((double)now.tv_nsec / 1000000.0);
+}
+
+void Report(const char *update, double totalTime, unsigned int bodies) {
+	// Variable declaration
+	double frameTime = totalTime / NUM_FRAMES;
+
+	// Code
+	printf("\n %-40s %12.3f %7.1f%% %12u", update, frameTime, (frameTime * 100.0) / FRAME_BUDGET_MS, bodies);
+}
+
+float MaxError(const SceneGraph *a, const SceneGraph *b) {
+	// Variable declaration
+	float error = 0.0f;
+
+	// Code
+	for(unsigned int i = 0; i < a->count; i++) {
+		const float *ma = a->world[i];
+		const float *mb = b->world[i];
+		for(int k = 0; k < 16; k++)
+			error = fmaxf(error, fabsf(ma[k] - mb[k]));
+	}
+	return error;
+}
@@ -0,0 +1,205 @@
+// Header file for frame scheduler : vsync, fixed time step updates and frame pacing
+// By : Darshan Vikam
+//
+// Swap interval is set to 1 with GLX_EXT_swap_control (or GLX_MESA_swap_control / GLX_SGI_swap_control),
+// so glXSwapBuffers() waits for vertical blank instead of message loop spinning a core. Without any of
+// them, loop sleeps with clock_nanosleep() until an absolute deadline, FRAME_SCHEDULER_FALLBACK_FPS times a second.
+// Animation is advanced in fixed steps of 'step' seconds taken out of an accumulator of real elapsed time,
+// so its speed does not depend on frame rate. 'alpha' (0 to 1) tells how far present time is between
+// last two updates; display() interpolates previous and current state with it.
+// CPU utilization of process and frame time jitter (standard deviation) are printed every
+// FRAME_SCHEDULER_REPORT_FRAMES frames.
+// Message loop :
+//	frameSchedulerBeginFrame(&scheduler);
+//	while(frameSchedulerStep(&scheduler) == true)
+//		Update(scheduler.step);
+//	display();
+//	frameSchedulerEndFrame(&scheduler);
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#if !defined(__gl_h_) && !defined(__GL_H__)		// Fixed function samples include only GL/gl.h, glew.h must precede it
+	#include <GL/glew.h>
+#endif
+#include <GL/glx.h>
+
+#define FRAME_SCHEDULER_MAX_STEPS	8		// Updates per frame at most, rest of lag is dropped (e.g. after window was stalled)
+#define FRAME_SCHEDULER_MAX_FRAME_TIME	0.25		// Longer frames are counted as this long (seconds)
+#ifndef FRAME_SCHEDULER_FALLBACK_FPS
+	#define FRAME_SCHEDULER_FALLBACK_FPS	60		// Frame rate when swap interval can not be set
+#endif
+#ifndef FRAME_SCHEDULER_REPORT_FRAMES
+	#define FRAME_SCHEDULER_REPORT_FRAMES	256		// Statistics are printed every these many frames, 0 - never
+#endif
+//=============================================================================
+
+typedef void (* glXSwapIntervalEXTProc)(Display *, GLXDrawable, int);
+typedef int (* glXSwapIntervalMESAProc)(unsigned int);
+typedef int (* glXSwapIntervalSGIProc)(int);
+
+typedef struct {
+	GLfloat step;				// Fixed update step (seconds)
+	GLfloat alpha;				// Interpolation factor for display()
+	bool vsync;				// Swap interval is set, else frames are paced by sleeping
+	double frameInterval;			// Sleep pacing interval (seconds), 0 with vsync
+
+	double accumulator;			// Elapsed time not yet consumed by updates
+	double lastTime;			// Start of last frame, 0 before first frame
+	double deadline;			// End of current frame when pacing by sleeping
+	unsigned int frameSteps;		// Updates run in current frame
+
+	// Statistics
+	double reportTime, reportCPUTime;	// Wall and process CPU time at start of report
+	double frameTimeSum, frameTimeSquareSum, frameTimeMax;
+	unsigned int reportFrames, reportSteps;
+} FrameScheduler;
+//=============================================================================
+
+static inline double frameSchedulerClock(clockid_t clock) {
+	// Variable declaration
+	struct timespec now;
+
+	// Code
+	clock_gettime(clock, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1000000000.0);
+}
+
+// Call after context is made current; updateRate is number of fixed updates per second
+void frameSchedulerInitialize(FrameScheduler *scheduler, Display *display, GLXDrawable drawable, double updateRate) {
+	// Variable declaration
+	const char *extensions;
+	const char *method = "sleeping";
+
+	// Code
+	memset(scheduler, 0, sizeof(FrameScheduler));
+	scheduler->step = (GLfloat)(1.0 / updateRate);
+
+	extensions = glXQueryExtensionsString(display, DefaultScreen(display));
+	if(extensions != NULL && strstr(extensions, "GLX_EXT_swap_control") != NULL) {
+		glXSwapIntervalEXTProc glXSwapIntervalEXT = (glXSwapIntervalEXTProc)glXGetProcAddressARB((const GLubyte *)"glXSwapIntervalEXT");
+		if(glXSwapIntervalEXT != NULL) {
+			glXSwapIntervalEXT(display, drawable, 1);
+			scheduler->vsync = true;
+			method = "GLX_EXT_swap_control";
+		}
+	}
+	if(scheduler->vsync == false && extensions != NULL && strstr(extensions, "GLX_MESA_swap_control") != NULL) {
+		glXSwapIntervalMESAProc glXSwapIntervalMESA = (glXSwapIntervalMESAProc)glXGetProcAddressARB((const GLubyte *)"glXSwapIntervalMESA");
+		if(glXSwapIntervalMESA != NULL && glXSwapIntervalMESA(1) == 0) {
+			scheduler->vsync = true;
+			method = "GLX_MESA_swap_control";
+		}
+	}
+	if(scheduler->vsync == false && extensions != NULL && strstr(extensions, "GLX_SGI_swap_control") != NULL) {
+		glXSwapIntervalSGIProc glXSwapIntervalSGI = (glXSwapIntervalSGIProc)glXGetProcAddressARB((const GLubyte *)"glXSwapIntervalSGI");
+		if(glXSwapIntervalSGI != NULL && glXSwapIntervalSGI(1) == 0) {
+			scheduler->vsync = true;
+			method = "GLX_SGI_swap_control";
+		}
+	}
+	scheduler->frameInterval = (scheduler->vsync == true) ? 0.0 : 1.0 / FRAME_SCHEDULER_FALLBACK_FPS;
+	printf("\n Frame scheduler : paced by %s, %.0f updates per second", method, updateRate);
+}
+
+void frameSchedulerBeginFrame(FrameScheduler *scheduler) {
+	// Variable declaration
+	double now, frameTime;
+
+	// Code
+	now = frameSchedulerClock(CLOCK_MONOTONIC);
+	if(scheduler->lastTime == 0.0) {		// First frame
+		scheduler->lastTime = now;
+		scheduler->deadline = now;
+		scheduler->reportTime = now;
+		scheduler->reportCPUTime = frameSchedulerClock(CLOCK_PROCESS_CPUTIME_ID);
+	}
+	frameTime = now - scheduler->lastTime;
+	scheduler->lastTime = now;
+
+	scheduler->frameTimeSum += frameTime;
+	scheduler->frameTimeSquareSum += frameTime * frameTime;
+	if(frameTime > scheduler->frameTimeMax)
+		scheduler->frameTimeMax = frameTime;
+
+	if(frameTime > FRAME_SCHEDULER_MAX_FRAME_TIME)
+		frameTime = FRAME_SCHEDULER_MAX_FRAME_TIME;
+	scheduler->accumulator += frameTime;
+	scheduler->frameSteps = 0;
+}
+
+// Returns true while one more fixed update is due in this frame; sets 'alpha' when it returns false
+bool frameSchedulerStep(FrameScheduler *scheduler) {
+	// Code
+	if(scheduler->accumulator >= scheduler->step) {
+		if(scheduler->frameSteps < FRAME_SCHEDULER_MAX_STEPS) {
+			scheduler->accumulator -= scheduler->step;
+			scheduler->frameSteps++;
+			scheduler->reportSteps++;
+			return true;
+		}
+		scheduler->accumulator = fmod(scheduler->accumulator, scheduler->step);
+	}
+	scheduler->alpha = (GLfloat)(scheduler->accumulator / scheduler->step);
+	return false;
+}
+
+// Call after display(); sleeps until next frame deadline if there is no vsync
+void frameSchedulerEndFrame(FrameScheduler *scheduler) {
+	// Variable declaration
+	struct timespec wakeup;
+	double now, wall, cpu, mean, jitter;
+
+	// Code
+	if(scheduler->frameInterval > 0.0) {
+		now = frameSchedulerClock(CLOCK_MONOTONIC);
+		scheduler->deadline += scheduler->frameInterval;
+		if(scheduler->deadline < now - scheduler->frameInterval)
+			scheduler->deadline = now;		// Too late already, do not try to catch up with a burst
+		else if(scheduler->deadline > now) {
+			wakeup.tv_sec = (time_t)scheduler->deadline;
+			wakeup.tv_nsec = (long)((scheduler->deadline - (double)wakeup.tv_sec) * 1000000000.0);
+			while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL) == EINTR);
+		}
+	}
+
+	scheduler->reportFrames++;
+	if(FRAME_SCHEDULER_REPORT_FRAMES > 0 && scheduler->reportFrames == FRAME_SCHEDULER_REPORT_FRAMES) {
+		now = frameSchedulerClock(CLOCK_MONOTONIC);
+		cpu = frameSchedulerClock(CLOCK_PROCESS_CPUTIME_ID);
+		wall = now - scheduler->reportTime;
+		mean = scheduler->frameTimeSum / scheduler->reportFrames;
+		jitter = sqrt(fmax(0.0, (scheduler->frameTimeSquareSum / scheduler->reportFrames) - (mean * mean)));
+		printf("\n Frame scheduler : %.2f ms per frame (jitter %.3f ms, worst %.2f ms), %.2f updates per frame, %.1f%% CPU",
+			mean * 1000.0, jitter * 1000.0, scheduler->frameTimeMax * 1000.0, (double)scheduler->reportSteps / scheduler->reportFrames,
+			(wall > 0.0) ? ((cpu - scheduler->reportCPUTime) * 100.0 / wall) : 0.0);
+		fflush(stdout);
+		scheduler->reportTime = now;
+		scheduler->reportCPUTime = cpu;
+		scheduler->frameTimeSum = 0.0;
+		scheduler->frameTimeSquareSum = 0.0;
+		scheduler->frameTimeMax = 0.0;
+		scheduler->reportFrames = 0;
+		scheduler->reportSteps = 0;
+	}
+}
+//=============================================================================
+
+// Angle (degrees, kept in [0, 360)) between previous and current update, 'current' may have wrapped past 360
+static inline GLfloat frameSchedulerLerpAngle(GLfloat previous, GLfloat current, GLfloat alpha) {
+	// Variable declaration
+	GLfloat angle;
+
+	// Code
+	if(current < previous)
+		current += 360.0f;
+	angle = previous + ((current - previous) * alpha);
+	return (angle >= 360.0f) ? angle - 360.0f : angle;
+}
+//=============================================================================
@@ -0,0 +1,208 @@
+// Header file for light and material uniform blocks (std140 uniform buffer objects)
+// By : Darshan Vikam
+//
+// MaterialLibrary holds every material of a sample in one uniform buffer, uploaded once after all
+// materials are added. A draw selects its material with one glUniform1i(u_MaterialIndex).
+// LightBlock holds all lights of a frame; updateLightBlock() sends them with one glBufferSubData().
+// Shaders declare both blocks with LIGHT_MATERIAL_GLSL_BLOCKS (needs '#version 430' or above) :
+//	u_LightCount, u_Light[i].ambient/diffuse/specular (rgb), u_Light[i].position
+//	u_Material[u_MaterialIndex].ambient/diffuse/specular (rgb), shininess in .specular.w
+// Blocks have fixed binding points, so no glUniformBlockBinding() is needed per program, and
+// u_MaterialIndex has fixed location, so samples with two programs can share one location.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <GL/glew.h>
+
+#define MATERIAL_MAX		64
+#define LIGHT_MAX		4
+#define MATERIAL_BINDING	0		// Uniform buffer binding points
+#define LIGHT_BINDING		1
+#define MATERIAL_INDEX_LOCATION	15		// Explicit location of u_MaterialIndex
+
+#define LM_STRINGIFY(x)		#x
+#define LM_TOSTRING(x)		LM_STRINGIFY(x)
+
+#define LIGHT_MATERIAL_GLSL_BLOCKS \
+	"struct Light { vec4 ambient, diffuse, specular, position; };" \
+	"layout(std140, binding = " LM_TOSTRING(LIGHT_BINDING) ") uniform Lights { int u_LightCount; Light u_Light[" LM_TOSTRING(LIGHT_MAX) "]; };" \
+	"struct Material { vec4 ambient, diffuse, specular; };" \
+	"layout(std140, binding = " LM_TOSTRING(MATERIAL_BINDING) ") uniform Materials { Material u_Material[" LM_TOSTRING(MATERIAL_MAX) "]; };" \
+	"layout(location = " LM_TOSTRING(MATERIAL_INDEX_LOCATION) ") uniform int u_MaterialIndex;"
+//=============================================================================
+
+// std140 layouts; every member is a vec4
+typedef struct {
+	GLfloat ambient[4];
+	GLfloat diffuse[4];
+	GLfloat specular[4];		// w - shininess (specular exponent)
+} MaterialStd140;
+
+typedef struct {
+	GLfloat ambient[4];
+	GLfloat diffuse[4];
+	GLfloat specular[4];
+	GLfloat position[4];
+} LightStd140;
+
+typedef struct {
+	GLint count;
+	GLint padding[3];		// u_Light[] starts at 16 bytes
+	LightStd140 light[LIGHT_MAX];
+} LightBlockStd140;
+
+typedef struct {
+	MaterialStd140 material[MATERIAL_MAX];
+	unsigned int count;
+	GLuint buffer;
+} MaterialLibrary;
+
+typedef struct {
+	LightBlockStd140 data;
+	GLuint buffer;
+} LightBlock;
+//=============================================================================
+
+// Standard materials (as in 24 spheres), shininess already scaled by 128
+enum {
+	MATERIAL_EMERALD = 0, MATERIAL_JADE, MATERIAL_OBSIDIAN, MATERIAL_PEARL, MATERIAL_RUBY, MATERIAL_TURQUOISE,
+	MATERIAL_BRASS, MATERIAL_BRONZE, MATERIAL_CHROME, MATERIAL_COPPER, MATERIAL_GOLD, MATERIAL_SILVER,
+	MATERIAL_BLACK_PLASTIC, MATERIAL_CYAN_PLASTIC, MATERIAL_GREEN_PLASTIC, MATERIAL_RED_PLASTIC, MATERIAL_WHITE_PLASTIC, MATERIAL_YELLOW_PLASTIC,
+	MATERIAL_BLACK_RUBBER, MATERIAL_CYAN_RUBBER, MATERIAL_GREEN_RUBBER, MATERIAL_RED_RUBBER, MATERIAL_WHITE_RUBBER, MATERIAL_YELLOW_RUBBER,
+	MATERIAL_STANDARD_COUNT
+};
+
+const MaterialStd140 gStandardMaterials[MATERIAL_STANDARD_COUNT] = {
+	{ {0.0215f, 0.1745f, 0.0215f, 1.0f},	{0.07568f, 0.61424f, 0.07568f, 1.0f},		{0.633f, 0.727811f, 0.33f, 0.6f * 128.0f} },			// Emerald
+	{ {0.135f, 0.2225f, 0.1575f, 1.0f},	{0.54f, 0.89f, 0.63f, 1.0f},			{0.316228f, 0.316228f, 0.316228f, 0.1f * 128.0f} },		// Jade
+	{ {0.05375f, 0.05f, 0.06625f, 1.0f},	{0.18275f, 0.17f, 0.22525f, 1.0f},		{0.332741f, 0.328634f, 0.346435f, 0.3f * 128.0f} },		// Obsidian
+	{ {0.25f, 0.20725f, 0.20725f, 1.0f},	{1.0f, 0.829f, 0.829f, 1.0f},			{0.296648f, 0.296648f, 0.296648f, 0.088f * 128.0f} },		// Pearl
+	{ {0.1745f, 0.01175f, 0.01175f, 1.0f},	{0.61424f, 0.04136f, 0.04163f, 1.0f},		{0.727811f, 0.626959f, 0.626959f, 0.6f * 128.0f} },		// Ruby
+	{ {0.1f, 0.18725f, 0.1745f, 1.0f},	{0.396f, 0.74151f, 0.69102f, 1.0f},		{0.297254f, 0.308290f, 0.306678f, 0.1f * 128.0f} },		// Turquoise
+	{ {0.329412f, 0.223529f, 0.027451f, 1.0f},	{0.780392f, 0.568627f, 0.113725f, 1.0f},	{0.992157f, 0.941176f, 0.807843f, 0.21794872f * 128.0f} },	// Brass
+	{ {0.2125f, 0.1275f, 0.054f, 1.0f},	{0.714f, 0.4284f, 0.18144f, 1.0f},		{0.393548f, 0.271906f, 0.166721f, 0.2f * 128.0f} },		// Bronze
+	{ {0.25f, 0.25f, 0.25f, 1.0f},		{0.4f, 0.4f, 0.4f, 1.0f},			{0.774597f, 0.774597f, 0.774597f, 0.6f * 128.0f} },		// Chrome
+	{ {0.19125f, 0.0735f, 0.0225f, 1.0f},	{0.7038f, 0.27048f, 0.0828f, 1.0f},		{0.256777f, 0.137622f, 0.086014f, 0.1f * 128.0f} },		// Copper
+	{ {0.24725f, 0.1995f, 0.0745f, 1.0f},	{0.75164f, 0.60648f, 0.22648f, 1.0f},		{0.628281f, 0.555802f, 0.366065f, 0.4f * 128.0f} },		// Gold
+	{ {0.19225f, 0.19225f, 0.19225f, 1.0f},	{0.50754f, 0.50754f, 0.50754f, 1.0f},		{0.508273f, 0.508273f, 0.508273f, 0.4f * 128.0f} },		// Silver
+	{ {0.0f, 0.0f, 0.0f, 1.0f},		{0.01f, 0.01f, 0.01f, 1.0f},			{0.5f, 0.5f, 0.5f, 0.25f * 128.0f} },				// Black plastic
+	{ {0.0f, 0.1f, 0.06f, 1.0f},		{0.0f, 0.50980392f, 0.50980392f, 1.0f},		{0.50196078f, 0.50196078f, 0.50196078f, 0.25f * 128.0f} },	// Cyan plastic
+	{ {0.0f, 0.0f, 0.0f, 1.0f},		{0.1f, 0.35f, 0.1f, 1.0f},			{0.45f, 0.55f, 0.45f, 0.25f * 128.0f} },			// Green plastic
+	{ {0.0f, 0.0f, 0.0f, 1.0f},		{0.5f, 0.0f, 0.0f, 1.0f},			{0.7f, 0.6f, 0.6f, 0.25f * 128.0f} },				// Red plastic
+	{ {0.0f, 0.0f, 0.0f, 1.0f},		{0.55f, 0.55f, 0.55f, 1.0f},			{0.7f, 0.7f, 0.7f, 0.25f * 128.0f} },				// White plastic
+	{ {0.0f, 0.0f, 0.0f, 1.0f},		{0.5f, 0.5f, 0.0f, 1.0f},			{0.6f, 0.6f, 0.5f, 0.25f * 128.0f} },				// Yellow plastic
+	{ {0.02f, 0.02f, 0.02f, 1.0f},		{0.01f, 0.01f, 0.01f, 1.0f},			{0.4f, 0.4f, 0.4f, 0.078125f * 128.0f} },			// Black rubber
+	{ {0.0f, 0.05f, 0.05f, 1.0f},		{0.4f, 0.5f, 0.5f, 1.0f},			{0.04f, 0.7f, 0.7f, 0.078125f * 128.0f} },			// Cyan rubber
+	{ {0.0f, 0.05f, 0.0f, 1.0f},		{0.4f, 0.5f, 0.4f, 1.0f},			{0.04f, 0.7f, 0.04f, 0.078125f * 128.0f} },			// Green rubber
+	{ {0.05f, 0.0f, 0.0f, 1.0f},		{0.5f, 0.4f, 0.4f, 1.0f},			{0.7f, 0.04f, 0.04f, 0.078125f * 128.0f} },			// Red rubber
+	{ {0.05f, 0.05f, 0.05f, 1.0f},		{0.5f, 0.5f, 0.5f, 1.0f},			{0.7f, 0.7f, 0.7f, 0.078125f * 128.0f} },			// White rubber
+	{ {0.05f, 0.05f, 0.04f, 1.0f},		{0.5f, 0.5f, 0.4f, 1.0f},			{0.7f, 0.7f, 0.04f, 0.078125f * 128.0f} }			// Yellow rubber
+};
+//=============================================================================
+
+// Returns index of material in library (for u_MaterialIndex), -1 if library is full
+int addMaterial(MaterialLibrary *library, const GLfloat *ambient, const GLfloat *diffuse, const GLfloat *specular, GLfloat shininess) {
+	// Variable declaration
+	MaterialStd140 *material;
+
+	// Code
+	if(library->count >= MATERIAL_MAX) {
+		printf("\n ERROR : Material library is full (%d materials).", MATERIAL_MAX);
+		return -1;
+	}
+	material = &library->material[library->count];
+	memcpy(material->ambient, ambient, 3 * sizeof(GLfloat));
+	memcpy(material->diffuse, diffuse, 3 * sizeof(GLfloat));
+	memcpy(material->specular, specular, 3 * sizeof(GLfloat));
+	material->ambient[3] = 1.0f;
+	material->diffuse[3] = 1.0f;
+	material->specular[3] = shininess;
+	return (int)library->count++;
+}
+
+// Adds all standard materials; returns index of first one (MATERIAL_EMERALD), -1 if they do not fit
+int addStandardMaterials(MaterialLibrary *library) {
+	// Variable declaration
+	unsigned int first = library->count;
+
+	// Code
+	if(first + MATERIAL_STANDARD_COUNT > MATERIAL_MAX) {
+		printf("\n ERROR : Material library is full (%d materials).", MATERIAL_MAX);
+		return -1;
+	}
+	memcpy(&library->material[first], gStandardMaterials, sizeof(gStandardMaterials));
+	library->count += MATERIAL_STANDARD_COUNT;
+	return (int)first;
+}
+
+// Creates uniform buffer with all added materials and binds it to MATERIAL_BINDING. Call once.
+void uploadMaterialLibrary(MaterialLibrary *library) {
+	// Code
+	if(library->buffer == 0)
+		glGenBuffers(1, &library->buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, library->buffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(library->material), library->material, GL_STATIC_DRAW);	// Whole block, as declared in shader
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BINDING, library->buffer);
+}
+
+void deleteMaterialLibrary(MaterialLibrary *library) {
+	// Code
+	if(library->buffer) {
+		glDeleteBuffers(1, &library->buffer);
+		library->buffer = 0;
+	}
+	library->count = 0;
+}
+//=============================================================================
+
+// Creates uniform buffer of lights and binds it to LIGHT_BINDING
+void createLightBlock(LightBlock *block) {
+	// Code
+	memset(&block->data, 0, sizeof(block->data));
+	glGenBuffers(1, &block->buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, block->buffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(block->data), &block->data, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BINDING, block->buffer);
+}
+
+// Sets light 'index' on CPU side only; position is vec4 (w = 1 for point light). Lights [0, index] become active.
+void setLight(LightBlock *block, int index, const GLfloat *ambient, const GLfloat *diffuse, const GLfloat *specular, const GLfloat *position) {
+	// Variable declaration
+	LightStd140 *light;
+
+	// Code
+	if(index < 0 || index >= LIGHT_MAX)
+		return;
+	light = &block->data.light[index];
+	memcpy(light->ambient, ambient, 3 * sizeof(GLfloat));
+	memcpy(light->diffuse, diffuse, 3 * sizeof(GLfloat));
+	memcpy(light->specular, specular, 3 * sizeof(GLfloat));
+	memcpy(light->position, position, 4 * sizeof(GLfloat));
+	light->ambient[3] = light->diffuse[3] = light->specular[3] = 1.0f;
+	if(block->data.count < index + 1)
+		block->data.count = index + 1;
+}
+
+// Sends count and active lights with one buffer update (once per frame)
+void updateLightBlock(LightBlock *block) {
+	// Code
+	glBindBuffer(GL_UNIFORM_BUFFER, block->buffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, offsetof(LightBlockStd140, light) + (block->data.count * sizeof(LightStd140)), &block->data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void deleteLightBlock(LightBlock *block) {
+	// Code
+	if(block->buffer) {
+		glDeleteBuffers(1, &block->buffer);
+		block->buffer = 0;
+	}
+}
+//=============================================================================
@@ -0,0 +1,336 @@
+// Header file for SIMD 4x4 matrix kernels (AVX2/FMA, SSE or scalar)
+// By : Darshan Vikam
+//
+// Matrices are 16 floats in column major order, same as vmath::mat4 and OpenGL,
+// vectors are 4 floats. No alignment is needed. Output may alias any input.
+// Instruction set is chosen at compile time :
+//	-mavx2 -mfma	- AVX2/FMA (2 columns per instruction)
+//	x86-64 default	- SSE2
+//	other		- scalar
+// At the end, vmath::mat4/vec4 overloads (multiply(), transpose(), inverse()) call these kernels.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <math.h>
+#include <string.h>
+#include "vmath.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+	#define MATRIX_SIMD_AVX2
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+	#define MATRIX_SIMD_SSE
+	#include <emmintrin.h>
+#endif
+
+#if defined(MATRIX_SIMD_AVX2)
+	#define MATRIX_SIMD_NAME	"AVX2/FMA"
+#elif defined(MATRIX_SIMD_SSE)
+	#define MATRIX_SIMD_NAME	"SSE2"
+#else
+	#define MATRIX_SIMD_NAME	"Scalar"
+#endif
+
+#if defined(MATRIX_SIMD_AVX2) || defined(MATRIX_SIMD_SSE)
+	#define MATRIX_SWIZZLE(v, x, y, z, w)		_mm_shuffle_ps((v), (v), _MM_SHUFFLE(w, z, y, x))
+	#define MATRIX_SHUFFLE(a, b, x, y, z, w)	_mm_shuffle_ps((a), (b), _MM_SHUFFLE(w, z, y, x))
+#endif
+//=============================================================================
+
+// Scalar reference kernels (also used on non x86 targets)
+void mat4MultiplyScalar(float *r, const float *a, const float *b) {
+	// Variable declaration
+	float t[16];
+
+	// Code
+	for(int j = 0; j < 4; j++) {
+		for(int i = 0; i < 4; i++)
+			t[(j * 4) + i] = (a[i] * b[(j * 4) + 0]) + (a[4 + i] * b[(j * 4) + 1]) + (a[8 + i] * b[(j * 4) + 2]) + (a[12 + i] * b[(j * 4) + 3]);
+	}
+	memcpy(r, t, sizeof(t));
+}
+
+void mat4TransformScalar(float *r, const float *m, const float *v) {
+	// Variable declaration
+	float t[4];
+
+	// Code
+	for(int i = 0; i < 4; i++)
+		t[i] = (m[i] * v[0]) + (m[4 + i] * v[1]) + (m[8 + i] * v[2]) + (m[12 + i] * v[3]);
+	memcpy(r, t, sizeof(t));
+}
+
+void mat4TransposeScalar(float *r, const float *m) {
+	// Variable declaration
+	float t[16];
+
+	// Code
+	for(int j = 0; j < 4; j++) {
+		for(int i = 0; i < 4; i++)
+			t[(i * 4) + j] = m[(j * 4) + i];
+	}
+	memcpy(r, t, sizeof(t));
+}
+
+// Returns false (and leaves 'r' untouched) if matrix is singular
+bool mat4InverseScalar(float *r, const float *m) {
+	// Variable declaration
+	float inv[16], det;
+
+	// Code (cofactor expansion)
+	inv[0] = m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+	inv[4] = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+	inv[8] = m[4]*m[9]*m[15] - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+	inv[12] = -m[4]*m[9]*m[14] + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+	inv[1] = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+	inv[5] = m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+	inv[9] = -m[0]*m[9]*m[15] + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+	inv[13] = m[0]*m[9]*m[14] - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+	inv[2] = m[1]*m[6]*m[15] - m[1]*m[7]*m[14] - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7] - m[13]*m[3]*m[6];
+	inv[6] = -m[0]*m[6]*m[15] + m[0]*m[7]*m[14] + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7] + m[12]*m[3]*m[6];
+	inv[10] = m[0]*m[5]*m[15] - m[0]*m[7]*m[13] - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7] - m[12]*m[3]*m[5];
+	inv[14] = -m[0]*m[5]*m[14] + m[0]*m[6]*m[13] + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6] + m[12]*m[2]*m[5];
+	inv[3] = -m[1]*m[6]*m[11] + m[1]*m[7]*m[10] + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7] + m[9]*m[3]*m[6];
+	inv[7] = m[0]*m[6]*m[11] - m[0]*m[7]*m[10] - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7] - m[8]*m[3]*m[6];
+	inv[11] = -m[0]*m[5]*m[11] + m[0]*m[7]*m[9] + m[4]*m[1]*m[11] - m[4]*m[3]*m[9] - m[8]*m[1]*m[7] + m[8]*m[3]*m[5];
+	inv[15] = m[0]*m[5]*m[10] - m[0]*m[6]*m[9] - m[4]*m[1]*m[10] + m[4]*m[2]*m[9] + m[8]*m[1]*m[6] - m[8]*m[2]*m[5];
+
+	det = (m[0] * inv[0]) + (m[1] * inv[4]) + (m[2] * inv[8]) + (m[3] * inv[12]);
+	if(det == 0.0f)
+		return false;
+	det = 1.0f / det;
+	for(int i = 0; i < 16; i++)
+		r[i] = inv[i] * det;
+	return true;
+}
+//=============================================================================
+
+// r = a * b
+static inline void mat4Multiply(float *r, const float *a, const float *b) {
+#if defined(MATRIX_SIMD_AVX2)
+	// Every column of 'a' in both 128 bit lanes; columns j and j+1 of 'b' in lower and upper lane
+	__m256 a0 = _mm256_broadcast_ps((const __m128 *)&a[0]);
+	__m256 a1 = _mm256_broadcast_ps((const __m128 *)&a[4]);
+	__m256 a2 = _mm256_broadcast_ps((const __m128 *)&a[8]);
+	__m256 a3 = _mm256_broadcast_ps((const __m128 *)&a[12]);
+	__m256 b01 = _mm256_loadu_ps(&b[0]);
+	__m256 b23 = _mm256_loadu_ps(&b[8]);
+	__m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+	__m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+	r01 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55), r01);
+	r23 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55), r23);
+	r01 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b01, b01, 0xaa), r01);
+	r23 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b23, b23, 0xaa), r23);
+	r01 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b01, b01, 0xff), r01);
+	r23 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b23, b23, 0xff), r23);
+	_mm256_storeu_ps(&r[0], r01);
+	_mm256_storeu_ps(&r[8], r23);
+#elif defined(MATRIX_SIMD_SSE)
+	__m128 a0 = _mm_loadu_ps(&a[0]);
+	__m128 a1 = _mm_loadu_ps(&a[4]);
+	__m128 a2 = _mm_loadu_ps(&a[8]);
+	__m128 a3 = _mm_loadu_ps(&a[12]);
+	__m128 col[4];
+	for(int j = 0; j < 4; j++) {
+		__m128 bj = _mm_loadu_ps(&b[j * 4]);
+		col[j] = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(a0, MATRIX_SWIZZLE(bj, 0, 0, 0, 0)), _mm_mul_ps(a1, MATRIX_SWIZZLE(bj, 1, 1, 1, 1))),
+			_mm_add_ps(_mm_mul_ps(a2, MATRIX_SWIZZLE(bj, 2, 2, 2, 2)), _mm_mul_ps(a3, MATRIX_SWIZZLE(bj, 3, 3, 3, 3))));
+	}
+	for(int j = 0; j < 4; j++)
+		_mm_storeu_ps(&r[j * 4], col[j]);
+#else
+	mat4MultiplyScalar(r, a, b);
+#endif
+}
+
+// r = m * v
+static inline void mat4Transform(float *r, const float *m, const float *v) {
+#if defined(MATRIX_SIMD_AVX2) || defined(MATRIX_SIMD_SSE)
+	__m128 vv = _mm_loadu_ps(v);
+	__m128 t = _mm_add_ps(
+		_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m[0]), MATRIX_SWIZZLE(vv, 0, 0, 0, 0)), _mm_mul_ps(_mm_loadu_ps(&m[4]), MATRIX_SWIZZLE(vv, 1, 1, 1, 1))),
+		_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m[8]), MATRIX_SWIZZLE(vv, 2, 2, 2, 2)), _mm_mul_ps(_mm_loadu_ps(&m[12]), MATRIX_SWIZZLE(vv, 3, 3, 3, 3))));
+	_mm_storeu_ps(r, t);
+#else
+	mat4TransformScalar(r, m, v);
+#endif
+}
+
+// r = transpose(m)
+static inline void mat4Transpose(float *r, const float *m) {
+#if defined(MATRIX_SIMD_AVX2) || defined(MATRIX_SIMD_SSE)
+	__m128 c0 = _mm_loadu_ps(&m[0]);
+	__m128 c1 = _mm_loadu_ps(&m[4]);
+	__m128 c2 = _mm_loadu_ps(&m[8]);
+	__m128 c3 = _mm_loadu_ps(&m[12]);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	_mm_storeu_ps(&r[0], c0);
+	_mm_storeu_ps(&r[4], c1);
+	_mm_storeu_ps(&r[8], c2);
+	_mm_storeu_ps(&r[12], c3);
+#else
+	mat4TransposeScalar(r, m);
+#endif
+}
+
+#if defined(MATRIX_SIMD_AVX2) || defined(MATRIX_SIMD_SSE)
+// Internal : 2x2 matrices packed as (m00, m01, m10, m11)
+static inline __m128 mat2Multiply(__m128 a, __m128 b) {				// a * b
+	return _mm_add_ps(_mm_mul_ps(a, MATRIX_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(MATRIX_SWIZZLE(a, 1, 0, 3, 2), MATRIX_SWIZZLE(b, 2, 1, 2, 1)));
+}
+static inline __m128 mat2AdjugateMultiply(__m128 a, __m128 b) {		// adj(a) * b
+	return _mm_sub_ps(_mm_mul_ps(MATRIX_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(MATRIX_SWIZZLE(a, 1, 1, 2, 2), MATRIX_SWIZZLE(b, 2, 3, 0, 1)));
+}
+static inline __m128 mat2MultiplyAdjugate(__m128 a, __m128 b) {		// a * adj(b)
+	return _mm_sub_ps(_mm_mul_ps(a, MATRIX_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(MATRIX_SWIZZLE(a, 1, 0, 3, 2), MATRIX_SWIZZLE(b, 2, 1, 2, 1)));
+}
+#endif
+
+// r = inverse(m); returns false (and leaves 'r' untouched) if matrix is singular.
+// SIMD path inverts by 2x2 blocks; as inverse(transpose(m)) == transpose(inverse(m)), storage order does not matter.
+static inline bool mat4Inverse(float *r, const float *m) {
+#if defined(MATRIX_SIMD_AVX2) || defined(MATRIX_SIMD_SSE)
+	__m128 c0 = _mm_loadu_ps(&m[0]);
+	__m128 c1 = _mm_loadu_ps(&m[4]);
+	__m128 c2 = _mm_loadu_ps(&m[8]);
+	__m128 c3 = _mm_loadu_ps(&m[12]);
+
+	// Blocks | A B |
+	//        | C D |
+	__m128 A = _mm_movelh_ps(c0, c1);
+	__m128 B = _mm_movehl_ps(c1, c0);
+	__m128 C = _mm_movelh_ps(c2, c3);
+	__m128 D = _mm_movehl_ps(c3, c2);
+
+	// (|A|, |B|, |C|, |D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(MATRIX_SHUFFLE(c0, c2, 0, 2, 0, 2), MATRIX_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+		_mm_mul_ps(MATRIX_SHUFFLE(c0, c2, 1, 3, 1, 3), MATRIX_SHUFFLE(c1, c3, 0, 2, 0, 2)));
+	__m128 detA = MATRIX_SWIZZLE(detSub, 0, 0, 0, 0);
+	__m128 detB = MATRIX_SWIZZLE(detSub, 1, 1, 1, 1);
+	__m128 detC = MATRIX_SWIZZLE(detSub, 2, 2, 2, 2);
+	__m128 detD = MATRIX_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	__m128 D_C = mat2AdjugateMultiply(D, C);
+	__m128 A_B = mat2AdjugateMultiply(A, B);
+	__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), mat2Multiply(B, D_C));
+	__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), mat2Multiply(C, A_B));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), mat2MultiplyAdjugate(D, A_B));
+	__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), mat2MultiplyAdjugate(A, D_C));
+
+	// |M| = |A||D| + |B||C| - trace(adj(A)B * adj(D)C)
+	__m128 tr = _mm_mul_ps(A_B, MATRIX_SWIZZLE(D_C, 0, 2, 1, 3));
+	tr = _mm_add_ps(tr, MATRIX_SWIZZLE(tr, 2, 3, 0, 1));
+	tr = _mm_add_ps(tr, MATRIX_SWIZZLE(tr, 1, 0, 3, 2));
+	__m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+	if(_mm_cvtss_f32(detM) == 0.0f)
+		return false;
+
+	__m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+	X = _mm_mul_ps(X, rDetM);
+	Y = _mm_mul_ps(Y, rDetM);
+	Z = _mm_mul_ps(Z, rDetM);
+	W = _mm_mul_ps(W, rDetM);
+
+	// Adjugate of every block and store
+	_mm_storeu_ps(&r[0], MATRIX_SHUFFLE(X, Y, 3, 1, 3, 1));
+	_mm_storeu_ps(&r[4], MATRIX_SHUFFLE(X, Y, 2, 0, 2, 0));
+	_mm_storeu_ps(&r[8], MATRIX_SHUFFLE(Z, W, 3, 1, 3, 1));
+	_mm_storeu_ps(&r[12], MATRIX_SHUFFLE(Z, W, 2, 0, 2, 0));
+	return true;
+#else
+	return mat4InverseScalar(r, m);
+#endif
+}
+//=============================================================================
+
+// Batch : r[i] = a * b[i], for 'count' matrices (e.g. view-projection times every model matrix)
+void mat4MultiplyBatch(float *r, const float *a, const float *b, unsigned int count) {
+#if defined(MATRIX_SIMD_AVX2)
+	// Code
+	__m256 a0 = _mm256_broadcast_ps((const __m128 *)&a[0]);
+	__m256 a1 = _mm256_broadcast_ps((const __m128 *)&a[4]);
+	__m256 a2 = _mm256_broadcast_ps((const __m128 *)&a[8]);
+	__m256 a3 = _mm256_broadcast_ps((const __m128 *)&a[12]);
+	for(unsigned int i = 0; i < count * 2; i++) {		// Two columns per iteration
+		__m256 bj = _mm256_loadu_ps(&b[i * 8]);
+		__m256 rj = _mm256_mul_ps(a0, _mm256_shuffle_ps(bj, bj, 0x00));
+		rj = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(bj, bj, 0x55), rj);
+		rj = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(bj, bj, 0xaa), rj);
+		rj = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(bj, bj, 0xff), rj);
+		_mm256_storeu_ps(&r[i * 8], rj);
+	}
+#elif defined(MATRIX_SIMD_SSE)
+	// Code
+	__m128 a0 = _mm_loadu_ps(&a[0]);
+	__m128 a1 = _mm_loadu_ps(&a[4]);
+	__m128 a2 = _mm_loadu_ps(&a[8]);
+	__m128 a3 = _mm_loadu_ps(&a[12]);
+	for(unsigned int i = 0; i < count * 4; i++) {		// One column per iteration
+		__m128 bj = _mm_loadu_ps(&b[i * 4]);
+		_mm_storeu_ps(&r[i * 4], _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(a0, MATRIX_SWIZZLE(bj, 0, 0, 0, 0)), _mm_mul_ps(a1, MATRIX_SWIZZLE(bj, 1, 1, 1, 1))),
+			_mm_add_ps(_mm_mul_ps(a2, MATRIX_SWIZZLE(bj, 2, 2, 2, 2)), _mm_mul_ps(a3, MATRIX_SWIZZLE(bj, 3, 3, 3, 3)))));
+	}
+#else
+	// Code
+	for(unsigned int i = 0; i < count; i++)
+		mat4MultiplyScalar(&r[i * 16], a, &b[i * 16]);
+#endif
+}
+
+// Batch : r[i] = m * v[i], for 'count' vec4s. Product of matrix and column is same operation as
+// above, so mat4MultiplyBatch() handles 4 vectors at a time and only the remainder is done here.
+void mat4TransformBatch(float *r, const float *m, const float *v, unsigned int count) {
+	// Code
+	mat4MultiplyBatch(r, m, v, count / 4);
+	for(unsigned int i = count & ~3u; i < count; i++)
+		mat4Transform(&r[i * 4], m, &v[i * 4]);
+}
+
+// Batch : r[i] = inverse(m[i]); returns number of singular matrices (those are left untouched)
+unsigned int mat4InverseBatch(float *r, const float *m, unsigned int count) {
+	// Variable declaration
+	unsigned int singular = 0;
+
+	// Code
+	for(unsigned int i = 0; i < count; i++) {
+		if(mat4Inverse(&r[i * 16], &m[i * 16]) == false)
+			singular++;
+	}
+	return singular;
+}
+//=============================================================================
+
+// vmath overloads. Non template overloads are preferred over vmath's own templates,
+// so existing transpose()/inverse() calls on mat4 pick these up without any change.
+namespace vmath {
+	static inline mat4 multiply(const mat4 &a, const mat4 &b) {
+		mat4 r;
+		mat4Multiply(r, a, b);
+		return r;
+	}
+
+	static inline vec4 multiply(const mat4 &m, const vec4 &v) {
+		vec4 r;
+		mat4Transform(r, m, v);
+		return r;
+	}
+
+	static inline mat4 transpose(const mat4 &m) {
+		mat4 r;
+		mat4Transpose(r, m);
+		return r;
+	}
+
+	// Identity for singular matrix
+	static inline mat4 inverse(const mat4 &m) {
+		mat4 r = mat4::identity();
+		mat4Inverse(r, m);
+		return r;
+	}
+}
+//=============================================================================
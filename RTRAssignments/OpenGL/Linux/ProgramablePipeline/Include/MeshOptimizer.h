@@ -0,0 +1,468 @@
+// Header file for index/vertex buffer optimization (offline or at load time)
+// By : Darshan Vikam
+//
+// Stages, in the order they should be run :
+//	optimizeVertexCache()	- reorders triangles for post-transform cache (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+//	optimizeOverdraw()	- optional; sorts cache friendly clusters of triangles from outside to inside
+//	optimizeVertexFetch()	- reorders vertices in first use order and remaps indices
+// analyzeVertexCache() and analyzeOverdraw() measure the result (ACMR and overdraw).
+//
+// All functions work on absolute indices of 'indexSize' bytes which lie in
+// [baseVertex, baseVertex + numVertices), so one level of a packed buffer
+// (e.g. SphereLODChain) can be optimized in place. Scratch memory is malloc()ed
+// and freed before return; functions return false if it can not be allocated.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+
+#define MESH_ANALYZE_CACHE_SIZE		16		// FIFO entries, as on most GPUs
+#define MESH_FORSYTH_CACHE_SIZE		32		// LRU entries of scoring model
+#define MESH_OVERDRAW_GRID		256		// Resolution of software rasterizer used by analyzeOverdraw()
+//=============================================================================
+
+// Internal : reads/writes one index of given size
+static inline unsigned int meshGetIndex(const void *indices, unsigned int indexSize, unsigned int at) {
+	// Code
+	if(indexSize == sizeof(unsigned short))
+		return ((const unsigned short *)indices)[at];
+	return ((const unsigned int *)indices)[at];
+}
+
+static inline void meshSetIndex(void *indices, unsigned int indexSize, unsigned int at, unsigned int value) {
+	// Code
+	if(indexSize == sizeof(unsigned short))
+		((unsigned short *)indices)[at] = (unsigned short)value;
+	else
+		((unsigned int *)indices)[at] = value;
+}
+
+// Internal : position of a vertex
+static inline const float *meshGetPosition(const void *vertices, unsigned int vertexStride, unsigned int positionOffset, unsigned int vertex) {
+	// Code
+	return (const float *)((const char *)vertices + ((size_t)vertex * vertexStride) + positionOffset);
+}
+//=============================================================================
+
+// Average cache miss ratio : transformed vertices per triangle with a FIFO cache of 'cacheSize'.
+// 0.5 is ideal for large regular grids, 3.0 is worst (no reuse at all).
+float analyzeVertexCache(const void *indices, unsigned int indexSize, unsigned int numIndices, unsigned int baseVertex, unsigned int numVertices, unsigned int cacheSize) {
+	// Variable declaration
+	unsigned int *timestamp = NULL;		// Time at which vertex entered FIFO + cacheSize
+	unsigned int time = cacheSize + 1;
+	unsigned int misses = 0;
+
+	// Code
+	if(numIndices < 3)
+		return 0.0f;
+	timestamp = (unsigned int *)calloc(numVertices, sizeof(unsigned int));
+	if(timestamp == NULL)
+		return 0.0f;
+
+	for(unsigned int i = 0; i < numIndices; i++) {
+		unsigned int v = meshGetIndex(indices, indexSize, i) - baseVertex;
+		if(time - timestamp[v] > cacheSize) {
+			timestamp[v] = time++;
+			misses++;
+		}
+	}
+	free(timestamp);
+	return (float)misses / (float)(numIndices / 3);
+}
+
+// Internal : Forsyth vertex score from LRU position and number of not yet emitted triangles
+static float meshForsythScore(int cachePosition, unsigned int liveTriangles) {
+	// Variable declaration
+	float score = 0.0f;
+
+	// Code
+	if(liveTriangles == 0)
+		return -1.0f;
+	if(cachePosition >= 0) {
+		if(cachePosition < 3)
+			score = 0.75f;		// Vertices of last triangle; fixed score so triangle is not reused straight away
+		else
+			score = powf(1.0f - ((float)(cachePosition - 3) / (float)(MESH_FORSYTH_CACHE_SIZE - 3)), 1.5f);
+	}
+	return score + (2.0f / sqrtf((float)liveTriangles));	// Valence boost : finish off lonely vertices first
+}
+
+// Reorders triangles in place so that consecutive triangles share vertices
+bool optimizeVertexCache(void *indices, unsigned int indexSize, unsigned int numIndices, unsigned int baseVertex, unsigned int numVertices) {
+	// Variable declaration
+	unsigned int numTriangles = numIndices / 3;
+	unsigned int *liveTriangles = NULL;	// per vertex
+	unsigned int *adjacencyOffset = NULL;	// per vertex, into adjacency
+	unsigned int *adjacency = NULL;		// triangles of every vertex (not yet emitted ones first)
+	int *cachePosition = NULL;		// per vertex, -1 if not in cache
+	float *vertexScore = NULL;
+	float *triangleScore = NULL;
+	bool *emitted = NULL;
+	unsigned int *output = NULL;		// emitted triangle order
+	unsigned int cache[MESH_FORSYTH_CACHE_SIZE + 3];
+	unsigned int newCache[MESH_FORSYTH_CACHE_SIZE + 3];
+	unsigned int cacheCount = 0;
+	unsigned int nextScan = 0;
+	int bestTriangle = -1;
+	bool status = false;
+
+	// Code
+	if(numTriangles == 0)
+		return true;
+
+	liveTriangles = (unsigned int *)calloc(numVertices, sizeof(unsigned int));
+	adjacencyOffset = (unsigned int *)malloc((numVertices + 1) * sizeof(unsigned int));
+	adjacency = (unsigned int *)malloc(numTriangles * 3 * sizeof(unsigned int));
+	cachePosition = (int *)malloc(numVertices * sizeof(int));
+	vertexScore = (float *)malloc(numVertices * sizeof(float));
+	triangleScore = (float *)malloc(numTriangles * sizeof(float));
+	emitted = (bool *)calloc(numTriangles, sizeof(bool));
+	output = (unsigned int *)malloc(numTriangles * 3 * sizeof(unsigned int));
+	if(liveTriangles == NULL || adjacencyOffset == NULL || adjacency == NULL || cachePosition == NULL || vertexScore == NULL || triangleScore == NULL || emitted == NULL || output == NULL)
+		goto cleanup;
+
+	// Adjacency (vertex -> triangles)
+	for(unsigned int i = 0; i < numTriangles * 3; i++)
+		liveTriangles[meshGetIndex(indices, indexSize, i) - baseVertex]++;
+	adjacencyOffset[0] = 0;
+	for(unsigned int v = 0; v < numVertices; v++)
+		adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+	memset(liveTriangles, 0, numVertices * sizeof(unsigned int));
+	for(unsigned int t = 0; t < numTriangles; t++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			unsigned int v = meshGetIndex(indices, indexSize, (t * 3) + k) - baseVertex;
+			adjacency[adjacencyOffset[v] + liveTriangles[v]++] = t;
+		}
+	}
+
+	// Initial scores
+	for(unsigned int v = 0; v < numVertices; v++) {
+		cachePosition[v] = -1;
+		vertexScore[v] = meshForsythScore(-1, liveTriangles[v]);
+	}
+	for(unsigned int t = 0; t < numTriangles; t++) {
+		triangleScore[t] = 0.0f;
+		for(unsigned int k = 0; k < 3; k++)
+			triangleScore[t] += vertexScore[meshGetIndex(indices, indexSize, (t * 3) + k) - baseVertex];
+	}
+
+	for(unsigned int emitCount = 0; emitCount < numTriangles; emitCount++) {
+		unsigned int newCount = 0;
+		unsigned int tri[3];
+		float bestScore = -1.0f;
+
+		// No candidate among cached vertices; take next triangle not emitted yet
+		if(bestTriangle < 0) {
+			while(emitted[nextScan])
+				nextScan++;
+			bestTriangle = (int)nextScan;
+		}
+
+		// Emit
+		emitted[bestTriangle] = true;
+		for(unsigned int k = 0; k < 3; k++) {
+			tri[k] = meshGetIndex(indices, indexSize, (bestTriangle * 3) + k) - baseVertex;
+			output[(emitCount * 3) + k] = tri[k] + baseVertex;
+
+			// Move emitted triangle to dead end of adjacency of vertex
+			unsigned int *adj = &adjacency[adjacencyOffset[tri[k]]];
+			for(unsigned int a = 0; a < liveTriangles[tri[k]]; a++) {
+				if(adj[a] == (unsigned int)bestTriangle) {
+					adj[a] = adj[liveTriangles[tri[k]] - 1];
+					adj[liveTriangles[tri[k]] - 1] = (unsigned int)bestTriangle;
+					break;
+				}
+			}
+			liveTriangles[tri[k]]--;
+			newCache[newCount++] = tri[k];
+		}
+
+		// New LRU : triangle vertices first, then old entries except them
+		for(unsigned int c = 0; c < cacheCount; c++) {
+			unsigned int v = cache[c];
+			if(v != tri[0] && v != tri[1] && v != tri[2])
+				newCache[newCount++] = v;
+		}
+		for(unsigned int c = MESH_FORSYTH_CACHE_SIZE; c < newCount; c++)
+			cachePosition[newCache[c]] = -1;	// Pushed out
+		cacheCount = (newCount < MESH_FORSYTH_CACHE_SIZE) ? newCount : MESH_FORSYTH_CACHE_SIZE;
+		memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+
+		// Rescore vertices which were touched and their live triangles
+		for(unsigned int c = 0; c < newCount; c++) {
+			unsigned int v = newCache[c];
+			float oldScore = vertexScore[v];
+			if(c < cacheCount)
+				cachePosition[v] = (int)c;
+			vertexScore[v] = meshForsythScore(cachePosition[v], liveTriangles[v]);
+			for(unsigned int a = 0; a < liveTriangles[v]; a++)
+				triangleScore[adjacency[adjacencyOffset[v] + a]] += vertexScore[v] - oldScore;
+		}
+
+		// Best triangle among those touching cache
+		bestTriangle = -1;
+		for(unsigned int c = 0; c < cacheCount; c++) {
+			unsigned int v = cache[c];
+			for(unsigned int a = 0; a < liveTriangles[v]; a++) {
+				unsigned int t = adjacency[adjacencyOffset[v] + a];
+				if(triangleScore[t] > bestScore) {
+					bestScore = triangleScore[t];
+					bestTriangle = (int)t;
+				}
+			}
+		}
+	}
+
+	for(unsigned int i = 0; i < numTriangles * 3; i++)
+		meshSetIndex(indices, indexSize, i, output[i]);
+	status = true;
+
+cleanup :
+	free(liveTriangles);
+	free(adjacencyOffset);
+	free(adjacency);
+	free(cachePosition);
+	free(vertexScore);
+	free(triangleScore);
+	free(emitted);
+	free(output);
+	return status;
+}
+
+// Internal : cluster of triangles for overdraw sort
+typedef struct {
+	float key;
+	unsigned int firstTriangle, numTriangles;
+} MeshCluster;
+
+static int meshCompareClusters(const void *a, const void *b) {
+	// Code
+	float keyA = ((const MeshCluster *)a)->key;
+	float keyB = ((const MeshCluster *)b)->key;
+	return (keyA < keyB) - (keyA > keyB);		// Descending
+}
+
+// Sorts clusters of an already cache optimized index buffer so that outward facing
+// parts are drawn first. Clusters are cut only where FIFO cache restarts anyway
+// (a triangle with 3 misses), hence ACMR stays the same.
+bool optimizeOverdraw(void *indices, unsigned int indexSize, unsigned int numIndices, unsigned int baseVertex, unsigned int numVertices, const void *vertices, unsigned int vertexStride, unsigned int positionOffset) {
+	// Variable declaration
+	unsigned int numTriangles = numIndices / 3;
+	unsigned int *timestamp = NULL;
+	unsigned int *original = NULL;
+	MeshCluster *clusters = NULL;
+	unsigned int numClusters = 0;
+	unsigned int time = MESH_ANALYZE_CACHE_SIZE + 1;
+	float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+	bool status = false;
+
+	// Code
+	if(numTriangles < 2)
+		return true;
+
+	timestamp = (unsigned int *)calloc(numVertices, sizeof(unsigned int));
+	original = (unsigned int *)malloc(numTriangles * 3 * sizeof(unsigned int));
+	clusters = (MeshCluster *)malloc(numTriangles * sizeof(MeshCluster));
+	if(timestamp == NULL || original == NULL || clusters == NULL)
+		goto cleanup;
+
+	for(unsigned int v = 0; v < numVertices; v++) {
+		const float *p = meshGetPosition(vertices, vertexStride, positionOffset, baseVertex + v);
+		meshCentroid[0] += p[0] / (float)numVertices;
+		meshCentroid[1] += p[1] / (float)numVertices;
+		meshCentroid[2] += p[2] / (float)numVertices;
+	}
+
+	// Cut clusters at cache restarts
+	for(unsigned int t = 0; t < numTriangles; t++) {
+		unsigned int misses = 0;
+		for(unsigned int k = 0; k < 3; k++) {
+			original[(t * 3) + k] = meshGetIndex(indices, indexSize, (t * 3) + k);
+			unsigned int v = original[(t * 3) + k] - baseVertex;
+			if(time - timestamp[v] > MESH_ANALYZE_CACHE_SIZE) {
+				timestamp[v] = time++;
+				misses++;
+			}
+		}
+		if(t == 0 || misses == 3) {
+			clusters[numClusters].firstTriangle = t;
+			clusters[numClusters].numTriangles = 0;
+			numClusters++;
+		}
+		clusters[numClusters - 1].numTriangles++;
+	}
+
+	// Key : how far cluster faces outwards (centroid offset along average normal)
+	for(unsigned int c = 0; c < numClusters; c++) {
+		float centroid[3] = { 0.0f, 0.0f, 0.0f };
+		float normal[3] = { 0.0f, 0.0f, 0.0f };
+		float area = 0.0f, length;
+
+		for(unsigned int t = clusters[c].firstTriangle; t < clusters[c].firstTriangle + clusters[c].numTriangles; t++) {
+			const float *p0 = meshGetPosition(vertices, vertexStride, positionOffset, original[(t * 3) + 0]);
+			const float *p1 = meshGetPosition(vertices, vertexStride, positionOffset, original[(t * 3) + 1]);
+			const float *p2 = meshGetPosition(vertices, vertexStride, positionOffset, original[(t * 3) + 2]);
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float n[3] = { (e1[1] * e2[2]) - (e1[2] * e2[1]), (e1[2] * e2[0]) - (e1[0] * e2[2]), (e1[0] * e2[1]) - (e1[1] * e2[0]) };
+			float a = sqrtf((n[0] * n[0]) + (n[1] * n[1]) + (n[2] * n[2]));
+
+			for(unsigned int k = 0; k < 3; k++) {
+				centroid[k] += (p0[k] + p1[k] + p2[k]) * a / 3.0f;
+				normal[k] += n[k];
+			}
+			area += a;
+		}
+		length = sqrtf((normal[0] * normal[0]) + (normal[1] * normal[1]) + (normal[2] * normal[2]));
+		clusters[c].key = 0.0f;
+		if(area > 0.0f && length > 0.0f) {
+			for(unsigned int k = 0; k < 3; k++)
+				clusters[c].key += ((centroid[k] / area) - meshCentroid[k]) * (normal[k] / length);
+		}
+	}
+
+	qsort(clusters, numClusters, sizeof(MeshCluster), meshCompareClusters);
+
+	numIndices = 0;
+	for(unsigned int c = 0; c < numClusters; c++) {
+		for(unsigned int i = clusters[c].firstTriangle * 3; i < (clusters[c].firstTriangle + clusters[c].numTriangles) * 3; i++)
+			meshSetIndex(indices, indexSize, numIndices++, original[i]);
+	}
+	status = true;
+
+cleanup :
+	free(timestamp);
+	free(original);
+	free(clusters);
+	return status;
+}
+
+// Reorders vertices (of 'vertexStride' bytes) in order of first use and remaps indices.
+// Vertices not referenced at all are moved to the end.
+bool optimizeVertexFetch(void *vertices, unsigned int vertexStride, void *indices, unsigned int indexSize, unsigned int numIndices, unsigned int baseVertex, unsigned int numVertices) {
+	// Variable declaration
+	unsigned int *remap = NULL;		// old -> new
+	char *reordered = NULL;
+	char *block = (char *)vertices + ((size_t)baseVertex * vertexStride);
+	unsigned int next = 0;
+
+	// Code
+	remap = (unsigned int *)malloc(numVertices * sizeof(unsigned int));
+	reordered = (char *)malloc((size_t)numVertices * vertexStride);
+	if(remap == NULL || reordered == NULL) {
+		free(remap);
+		free(reordered);
+		return false;
+	}
+	memset(remap, 0xff, numVertices * sizeof(unsigned int));
+
+	for(unsigned int i = 0; i < numIndices; i++) {
+		unsigned int v = meshGetIndex(indices, indexSize, i) - baseVertex;
+		if(remap[v] == 0xffffffff) {
+			remap[v] = next;
+			memcpy(reordered + ((size_t)next * vertexStride), block + ((size_t)v * vertexStride), vertexStride);
+			next++;
+		}
+		meshSetIndex(indices, indexSize, i, remap[v] + baseVertex);
+	}
+	for(unsigned int v = 0; v < numVertices; v++) {
+		if(remap[v] == 0xffffffff) {
+			memcpy(reordered + ((size_t)next * vertexStride), block + ((size_t)v * vertexStride), vertexStride);
+			next++;
+		}
+	}
+
+	memcpy(block, reordered, (size_t)numVertices * vertexStride);
+	free(remap);
+	free(reordered);
+	return true;
+}
+//=============================================================================
+
+// Overdraw : pixels shaded / pixels covered, averaged over 6 axis aligned orthographic views
+// with back face culling (counter clockwise front faces) and LESS depth test in submission order.
+// 1.0 means every covered pixel is shaded exactly once.
+float analyzeOverdraw(const void *indices, unsigned int indexSize, unsigned int numIndices, const void *vertices, unsigned int vertexStride, unsigned int positionOffset, unsigned int baseVertex, unsigned int numVertices) {
+	// Variable declaration
+	const int grid = MESH_OVERDRAW_GRID;
+	float *depth = NULL;
+	float minimum[3] = { 1e30f, 1e30f, 1e30f };
+	float maximum[3] = { -1e30f, -1e30f, -1e30f };
+	float extent = 0.0f;
+	unsigned long long shaded = 0, covered = 0;
+
+	// Code
+	if(numIndices < 3)
+		return 0.0f;
+	depth = (float *)malloc(grid * grid * sizeof(float));
+	if(depth == NULL)
+		return 0.0f;
+
+	for(unsigned int v = 0; v < numVertices; v++) {
+		const float *p = meshGetPosition(vertices, vertexStride, positionOffset, baseVertex + v);
+		for(int k = 0; k < 3; k++) {
+			minimum[k] = fminf(minimum[k], p[k]);
+			maximum[k] = fmaxf(maximum[k], p[k]);
+		}
+	}
+	for(int k = 0; k < 3; k++)
+		extent = fmaxf(extent, maximum[k] - minimum[k]);
+	if(extent <= 0.0f) {
+		free(depth);
+		return 0.0f;
+	}
+
+	for(int view = 0; view < 6; view++) {
+		int axis = view >> 1;					// Looking along -axis (even view) or +axis (odd view)
+		float sign = (view & 1) ? -1.0f : 1.0f;
+		int uAxis = (axis + 1) % 3, vAxis = (axis + 2) % 3;	// Screen axes; u mirrored for odd views keeps winding
+
+		for(int p = 0; p < grid * grid; p++)
+			depth[p] = 1e30f;
+
+		for(unsigned int t = 0; t < numIndices / 3; t++) {
+			float x[3], y[3], z[3];
+			for(int k = 0; k < 3; k++) {
+				const float *p = meshGetPosition(vertices, vertexStride, positionOffset, meshGetIndex(indices, indexSize, (t * 3) + k));
+				x[k] = (sign * (p[uAxis] - minimum[uAxis]) / extent) * (grid - 1) + ((sign < 0.0f) ? (float)(grid - 1) : 0.0f);
+				y[k] = ((p[vAxis] - minimum[vAxis]) / extent) * (grid - 1);
+				z[k] = -sign * p[axis];				// Smaller is nearer
+			}
+
+			float area = ((x[1] - x[0]) * (y[2] - y[0])) - ((x[2] - x[0]) * (y[1] - y[0]));
+			if(area <= 0.0f)
+				continue;					// Back facing or degenerate
+
+			int x0 = (int)fmaxf(0.0f, floorf(fminf(x[0], fminf(x[1], x[2]))));
+			int x1 = (int)fminf((float)(grid - 1), ceilf(fmaxf(x[0], fmaxf(x[1], x[2]))));
+			int y0 = (int)fmaxf(0.0f, floorf(fminf(y[0], fminf(y[1], y[2]))));
+			int y1 = (int)fminf((float)(grid - 1), ceilf(fmaxf(y[0], fmaxf(y[1], y[2]))));
+			for(int py = y0; py <= y1; py++) {
+				for(int px = x0; px <= x1; px++) {
+					float cx = (float)px + 0.5f, cy = (float)py + 0.5f;
+					float w0 = ((x[2] - x[1]) * (cy - y[1])) - ((y[2] - y[1]) * (cx - x[1]));
+					float w1 = ((x[0] - x[2]) * (cy - y[2])) - ((y[0] - y[2]) * (cx - x[2]));
+					float w2 = ((x[1] - x[0]) * (cy - y[0])) - ((y[1] - y[0]) * (cx - x[0]));
+					if(w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+						continue;
+					float d = ((w0 * z[0]) + (w1 * z[1]) + (w2 * z[2])) / area;
+					if(d < depth[(py * grid) + px]) {
+						if(depth[(py * grid) + px] == 1e30f)
+							covered++;
+						depth[(py * grid) + px] = d;
+						shaded++;
+					}
+				}
+			}
+		}
+	}
+
+	free(depth);
+	return (covered != 0) ? (float)shaded / (float)covered : 0.0f;
+}
+//=============================================================================
@@ -0,0 +1,213 @@
+// Header file for cache of unit size 2D primitives (circle, regular polygon, ring) in one shared buffer
+// By : Darshan Vikam
+//
+// Every primitive is generated once, with radius 1 around origin, for its key (kind, segments,
+// start angle, inner radius) and appended to one static vertex buffer; asking for same key again
+// returns same entry. Actual size and place come from model matrix : scale(radius, radius, 1) then
+// translate, so circles of any radius share one set of vertices and drawing needs no cos()/sin().
+// Only positions (x, y) are stored, bind constant color of a primitive with glVertexAttrib*().
+// Add all primitives in Initialize(), then primitiveCacheUpload(); adding later uploads again on next draw.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <GL/glew.h>
+
+#define PRIMITIVE_CACHE_MAX_ENTRIES	32
+//=============================================================================
+
+typedef enum {
+	PRIMITIVE_CIRCLE = 0,		// 'segments' points on unit circle (regular polygon when few); GL_POINTS / GL_LINE_LOOP / GL_TRIANGLE_FAN
+	PRIMITIVE_RING			// Triangle strip between innerRadius and 1; GL_TRIANGLE_STRIP
+} PrimitiveKind;
+
+typedef struct {
+	PrimitiveKind kind;
+	unsigned int segments;
+	GLfloat startAngle;		// Degrees, angle of first vertex
+	GLfloat innerRadius;		// PRIMITIVE_RING only
+	GLint first;			// First vertex in shared buffer
+	GLsizei count;
+} PrimitiveEntry;
+
+typedef struct {
+	PrimitiveEntry entry[PRIMITIVE_CACHE_MAX_ENTRIES];
+	unsigned int numEntries;
+
+	GLfloat *vertices;		// CPU copy of all entries, x and y per vertex
+	GLsizei numVertices, capacity;
+	bool dirty;			// Entries added since last upload
+
+	GLuint vao, vbo;
+	GLuint positionAttrib;
+} PrimitiveCache;
+//=============================================================================
+
+void primitiveCacheInitialize(PrimitiveCache *cache, GLuint positionAttrib) {
+	// Code
+	memset(cache, 0, sizeof(PrimitiveCache));
+	cache->positionAttrib = positionAttrib;
+}
+
+// Internal : returns pointer to 'count' more vertices at end of CPU copy, NULL if out of memory
+static GLfloat *primitiveCacheGrow(PrimitiveCache *cache, GLsizei count) {
+	// Variable declaration
+	GLfloat *vertices;
+	GLsizei capacity;
+
+	// Code
+	if(cache->numVertices + count > cache->capacity) {
+		capacity = (cache->capacity > 0) ? cache->capacity : 1024;
+		while(capacity < cache->numVertices + count)
+			capacity *= 2;
+		vertices = (GLfloat *)realloc(cache->vertices, capacity * 2 * sizeof(GLfloat));
+		if(vertices == NULL) {
+			printf("\n ERROR : Unable to allocate memory for primitive cache.");
+			return NULL;
+		}
+		cache->vertices = vertices;
+		cache->capacity = capacity;
+	}
+	return cache->vertices + (cache->numVertices * 2);
+}
+
+// Internal : returns index of entry with given key, creating its geometry on first request; -1 on failure
+static int primitiveCacheFind(PrimitiveCache *cache, PrimitiveKind kind, unsigned int segments, GLfloat startAngle, GLfloat innerRadius) {
+	// Variable declaration
+	PrimitiveEntry *entry;
+	GLfloat *v, angle;
+	GLsizei count;
+
+	// Code
+	for(unsigned int i = 0; i < cache->numEntries; i++) {
+		entry = &cache->entry[i];
+		if(entry->kind == kind && entry->segments == segments && entry->startAngle == startAngle && entry->innerRadius == innerRadius)
+			return (int)i;
+	}
+	if(cache->numEntries == PRIMITIVE_CACHE_MAX_ENTRIES) {
+		printf("\n ERROR : Primitive cache is full (%d entries).", PRIMITIVE_CACHE_MAX_ENTRIES);
+		return -1;
+	}
+	if(segments < 3) {
+		printf("\n ERROR : Primitive needs at least 3 segments.");
+		return -1;
+	}
+
+	count = (kind == PRIMITIVE_RING) ? (segments + 1) * 2 : segments;
+	v = primitiveCacheGrow(cache, count);
+	if(v == NULL)
+		return -1;
+	for(unsigned int i = 0; i < segments + ((kind == PRIMITIVE_RING) ? 1 : 0); i++) {
+		angle = (startAngle + (360.0f * i) / segments) * (M_PI / 180.0f);
+		if(kind == PRIMITIVE_RING) {
+			*v++ = innerRadius * cos(angle);
+			*v++ = innerRadius * sin(angle);
+		}
+		*v++ = cos(angle);
+		*v++ = sin(angle);
+	}
+
+	entry = &cache->entry[cache->numEntries];
+	entry->kind = kind;
+	entry->segments = segments;
+	entry->startAngle = startAngle;
+	entry->innerRadius = innerRadius;
+	entry->first = cache->numVertices;
+	entry->count = count;
+	cache->numVertices += count;
+	cache->dirty = true;
+	return (int)cache->numEntries++;
+}
+
+// Unit circle outline drawn with 'segments' vertices; returns entry index, -1 on failure
+int primitiveCacheCircle(PrimitiveCache *cache, unsigned int segments) {
+	// Code
+	return primitiveCacheFind(cache, PRIMITIVE_CIRCLE, segments, 0.0f, 0.0f);
+}
+
+// Regular polygon inscribed in unit circle, first vertex at 'startAngle' degrees (90 - apex on top)
+int primitiveCachePolygon(PrimitiveCache *cache, unsigned int sides, GLfloat startAngle) {
+	// Code
+	return primitiveCacheFind(cache, PRIMITIVE_CIRCLE, sides, startAngle, 0.0f);
+}
+
+// Ring between innerRadius (fraction of outer radius) and 1, as a triangle strip
+int primitiveCacheRing(PrimitiveCache *cache, unsigned int segments, GLfloat innerRadius) {
+	// Code
+	return primitiveCacheFind(cache, PRIMITIVE_RING, segments, 0.0f, innerRadius);
+}
+
+// Copies all entries into shared buffer; called by primitiveCacheDraw() too when entries were added
+void primitiveCacheUpload(PrimitiveCache *cache) {
+	// Code
+	if(cache->vao == 0) {
+		glGenVertexArrays(1, &cache->vao);
+		glGenBuffers(1, &cache->vbo);
+		glBindVertexArray(cache->vao);
+			glBindBuffer(GL_ARRAY_BUFFER, cache->vbo);
+			glVertexAttribPointer(cache->positionAttrib, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+			glEnableVertexAttribArray(cache->positionAttrib);
+		glBindVertexArray(0);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, cache->vbo);
+	glBufferData(GL_ARRAY_BUFFER, cache->numVertices * 2 * sizeof(GLfloat), cache->vertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	cache->dirty = false;
+}
+
+// Draws one entry; caller sets program, model-view-projection (with radius as scale) and color
+void primitiveCacheDraw(PrimitiveCache *cache, int entry, GLenum mode) {
+	// Code
+	if(entry < 0 || (unsigned int)entry >= cache->numEntries)
+		return;
+	if(cache->dirty == true)
+		primitiveCacheUpload(cache);
+	glBindVertexArray(cache->vao);
+	glDrawArrays(mode, cache->entry[entry].first, cache->entry[entry].count);
+	glBindVertexArray(0);
+}
+
+void primitiveCacheDelete(PrimitiveCache *cache) {
+	// Code
+	if(cache->vao) {
+		glDeleteVertexArrays(1, &cache->vao);
+		cache->vao = 0;
+	}
+	if(cache->vbo) {
+		glDeleteBuffers(1, &cache->vbo);
+		cache->vbo = 0;
+	}
+	free(cache->vertices);
+	cache->vertices = NULL;
+	cache->numVertices = cache->capacity = 0;
+	cache->numEntries = 0;
+}
+//=============================================================================
+
+// Incircle of triangle abc : center and radius, to place a cached unit circle inside any triangle
+void triangleIncircle(const GLfloat a[2], const GLfloat b[2], const GLfloat c[2], GLfloat center[2], GLfloat *radius) {
+	// Variable declaration
+	GLfloat lenA, lenB, lenC, perimeter, area;
+
+	// Code
+	lenA = hypot(b[0] - c[0], b[1] - c[1]);		// Side opposite to a
+	lenB = hypot(a[0] - c[0], a[1] - c[1]);
+	lenC = hypot(a[0] - b[0], a[1] - b[1]);
+	perimeter = lenA + lenB + lenC;
+	area = fabs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1])) / 2.0f;
+	if(perimeter <= 0.0f) {
+		center[0] = a[0];
+		center[1] = a[1];
+		*radius = 0.0f;
+		return;
+	}
+	center[0] = (lenA * a[0] + lenB * b[0] + lenC * c[0]) / perimeter;
+	center[1] = (lenA * a[1] + lenB * b[1] + lenC * c[1]) / perimeter;
+	*radius = (2.0f * area) / perimeter;
+}
+//=============================================================================
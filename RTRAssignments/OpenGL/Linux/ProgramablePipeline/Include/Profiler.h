@@ -0,0 +1,445 @@
+// Header file for CPU / GPU frame profiler with nested named scopes
+// By : Darshan Vikam
+//
+// Every scope measures CPU time with CLOCK_MONOTONIC and GPU time with two GL_TIMESTAMP queries
+// (glQueryCounter(), timestamps can nest unlike GL_TIME_ELAPSED). Queries of a frame are read back
+// PROFILER_FRAME_LATENCY frames later, and only if they are available, so profiling never stalls
+// the pipeline; frames whose results are still pending are dropped and counted.
+// Last PROFILER_HISTORY samples of every scope are kept for p50 / p95 / p99; profilerDump() prints them
+// and writes <name>.csv and <name>.json. profilerDrawGraph() draws CPU (light) and GPU (dark) bar
+// of every scope at bottom left, full width being PROFILER_GRAPH_RANGE_MS.
+// Timer queries are core since OpenGL 3.3 and work on Mesa llvmpipe too; without them only CPU is measured.
+// Usage in display() :
+//	profilerBeginFrame(&profiler);
+//	profilerBeginScope(&profiler, "Spheres"); ... profilerEndScope(&profiler);
+//	profilerDrawGraph(&profiler);		// Optional
+//	profilerEndFrame(&profiler);
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <GL/glew.h>
+
+#define PROFILER_MAX_SCOPES		32
+#define PROFILER_MAX_DEPTH		16
+#define PROFILER_MAX_RECORDS		64		// Scopes entered in one frame
+#define PROFILER_FRAME_LATENCY		4		// Frames between issuing and reading queries
+#define PROFILER_HISTORY		512		// Samples per scope for percentiles
+#define PROFILER_GRAPH_RANGE_MS		33.3f		// Time of full width bar
+//=============================================================================
+
+typedef struct {
+	const char *name;
+	int parent, depth;
+
+	// Rolling window for percentiles; totals for mean of whole run
+	float cpu[PROFILER_HISTORY], gpu[PROFILER_HISTORY];
+	unsigned int cpuCount, gpuCount;		// Samples ever recorded
+	double cpuTotal, gpuTotal;
+} ProfilerScope;
+
+typedef struct {
+	int scope;
+	double cpuBegin;
+} ProfilerRecord;
+
+typedef struct {
+	ProfilerScope scope[PROFILER_MAX_SCOPES];
+	int numScopes;
+	int stack[PROFILER_MAX_DEPTH];			// Open scopes, innermost last (-1 - not measured)
+	int stackRecord[PROFILER_MAX_DEPTH];		// Record of every open scope in current slot
+	int depth;
+
+	bool gpuTiming;					// Timestamp queries are usable
+	GLuint query[PROFILER_FRAME_LATENCY][PROFILER_MAX_RECORDS * 2];	// Begin and end timestamp of every record
+	ProfilerRecord record[PROFILER_FRAME_LATENCY][PROFILER_MAX_RECORDS];
+	int numRecords[PROFILER_FRAME_LATENCY];
+	int lastQuery[PROFILER_FRAME_LATENCY];		// Query issued last in the slot, GPU finishes it last
+	unsigned int frame, slot;			// Frame counter and its slot in query ring
+	unsigned int droppedFrames, overflows;
+
+	// On screen graph
+	GLuint graphProgram, graphVAO, graphVBO;
+} Profiler;
+//=============================================================================
+
+static inline double profilerTime(void) {
+	// Variable declaration
+	struct timespec now;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((double)now.tv_sec * 1000.0) + ((double)now.tv_nsec / 1000000.0);	// Milliseconds
+}
+
+// Internal : scope with given name under currently open scope, created on first use; -1 if table is full
+static int profilerFindScope(Profiler *profiler, const char *name) {
+	// Variable declaration
+	int parent = (profiler->depth > 0) ? profiler->stack[profiler->depth - 1] : -1;
+	ProfilerScope *scope;
+
+	// Code
+	for(int i = 0; i < profiler->numScopes; i++) {
+		scope = &profiler->scope[i];
+		if(scope->parent == parent && (scope->name == name || strcmp(scope->name, name) == 0))
+			return i;
+	}
+	if(profiler->numScopes == PROFILER_MAX_SCOPES)
+		return -1;
+	scope = &profiler->scope[profiler->numScopes];
+	memset(scope, 0, sizeof(ProfilerScope));
+	scope->name = name;
+	scope->parent = parent;
+	scope->depth = profiler->depth;
+	return profiler->numScopes++;
+}
+
+// Internal : reads GPU times of one ring slot; if wait is false and results are not ready, slot is dropped
+static void profilerCollect(Profiler *profiler, unsigned int slot, bool wait) {
+	// Variable declaration
+	int count = profiler->numRecords[slot];
+	GLint available = GL_TRUE;
+	GLuint64 begin, end;
+	ProfilerScope *scope;
+
+	// Code
+	if(profiler->gpuTiming == false || count == 0)
+		return;
+	if(wait == false)
+		glGetQueryObjectiv(profiler->query[slot][profiler->lastQuery[slot]], GL_QUERY_RESULT_AVAILABLE, &available);
+	if(available == GL_FALSE) {
+		profiler->droppedFrames++;
+	}
+	else {
+		for(int r = 0; r < count; r++) {
+			glGetQueryObjectui64v(profiler->query[slot][r * 2], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(profiler->query[slot][(r * 2) + 1], GL_QUERY_RESULT, &end);
+			scope = &profiler->scope[profiler->record[slot][r].scope];
+			scope->gpu[scope->gpuCount % PROFILER_HISTORY] = (float)((double)(end - begin) / 1000000.0);
+			scope->gpuTotal += (double)(end - begin) / 1000000.0;
+			scope->gpuCount++;
+		}
+	}
+	profiler->numRecords[slot] = 0;
+}
+
+// Call after context is current and glewInit(); returns false if graph shaders failed (profiling still works)
+bool profilerInitialize(Profiler *profiler) {
+	// Variable declaration
+	GLint bits = 0;
+	GLint status;
+	GLuint vs, fs;
+	const GLchar *vsSrc =
+		"#version 450 core\n" \
+		"layout(location = 0) in vec2 vPosition;" \
+		"layout(location = 1) in vec3 vColor;" \
+		"out vec3 out_color;" \
+		"void main(void) {" \
+			"out_color = vColor;" \
+			"gl_Position = vec4(vPosition, 0.0f, 1.0f);" \
+		"}";
+	const GLchar *fsSrc =
+		"#version 450 core\n" \
+		"in vec3 out_color;" \
+		"out vec4 FragColor;" \
+		"void main(void) {" \
+			"FragColor = vec4(out_color, 1.0f);" \
+		"}";
+
+	// Code
+	memset(profiler, 0, sizeof(Profiler));
+	if(glQueryCounter != NULL && glGetQueryObjectui64v != NULL)
+		glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+	profiler->gpuTiming = (bits > 0);
+	if(profiler->gpuTiming == true) {
+		for(int s = 0; s < PROFILER_FRAME_LATENCY; s++)
+			glGenQueries(PROFILER_MAX_RECORDS * 2, profiler->query[s]);
+	}
+	else
+		printf("\n Profiler : GL_TIMESTAMP queries are not supported, measuring CPU time only.");
+
+	vs = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vs, 1, &vsSrc, NULL);
+	glCompileShader(vs);
+	fs = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fs, 1, &fsSrc, NULL);
+	glCompileShader(fs);
+	profiler->graphProgram = glCreateProgram();
+	glAttachShader(profiler->graphProgram, vs);
+	glAttachShader(profiler->graphProgram, fs);
+	glLinkProgram(profiler->graphProgram);
+	glDetachShader(profiler->graphProgram, vs);
+	glDetachShader(profiler->graphProgram, fs);
+	glDeleteShader(vs);
+	glDeleteShader(fs);
+	glGetProgramiv(profiler->graphProgram, GL_LINK_STATUS, &status);
+	if(status == GL_FALSE) {
+		printf("\n Profiler : Unable to build graph shader, graph is disabled.");
+		glDeleteProgram(profiler->graphProgram);
+		profiler->graphProgram = 0;
+		return false;
+	}
+
+	// 2 bars (CPU and GPU) of 6 vertices per scope, position(2) and color(3) interleaved
+	glGenVertexArrays(1, &profiler->graphVAO);
+	glBindVertexArray(profiler->graphVAO);
+		glGenBuffers(1, &profiler->graphVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, profiler->graphVBO);
+		glBufferData(GL_ARRAY_BUFFER, PROFILER_MAX_SCOPES * 2 * 6 * 5 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void *)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void *)(2 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(1);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	return true;
+}
+
+void profilerBeginScope(Profiler *profiler, const char *name) {
+	// Variable declaration
+	unsigned int slot = profiler->slot;
+	int scope, r;
+
+	// Code
+	if(profiler->depth >= PROFILER_MAX_DEPTH) {	// Counted only, so that end calls still match
+		if(profiler->overflows++ == 0)
+			printf("\n Profiler : scopes nested too deep, scope '%s' is not measured.", name);
+		profiler->depth++;
+		return;
+	}
+	scope = profilerFindScope(profiler, name);
+	if(scope < 0 || profiler->numRecords[slot] == PROFILER_MAX_RECORDS) {
+		if(profiler->overflows++ == 0)
+			printf("\n Profiler : too many scopes, scope '%s' is not measured.", name);
+		scope = -1;
+	}
+	profiler->stack[profiler->depth] = scope;
+	if(scope < 0) {
+		profiler->depth++;
+		return;
+	}
+
+	r = profiler->numRecords[slot]++;
+	profiler->stackRecord[profiler->depth++] = r;
+	profiler->record[slot][r].scope = scope;
+	if(profiler->gpuTiming == true)
+		glQueryCounter(profiler->query[slot][r * 2], GL_TIMESTAMP);
+	profiler->record[slot][r].cpuBegin = profilerTime();
+}
+
+void profilerEndScope(Profiler *profiler) {
+	// Variable declaration
+	unsigned int slot = profiler->slot;
+	ProfilerScope *scope;
+	int r;
+	double cpu;
+
+	// Code
+	if(profiler->depth == 0)
+		return;
+	profiler->depth--;
+	if(profiler->depth >= PROFILER_MAX_DEPTH || profiler->stack[profiler->depth] < 0)
+		return;
+
+	r = profiler->stackRecord[profiler->depth];
+	if(profiler->gpuTiming == true) {
+		glQueryCounter(profiler->query[slot][(r * 2) + 1], GL_TIMESTAMP);
+		profiler->lastQuery[slot] = (r * 2) + 1;
+	}
+	cpu = profilerTime() - profiler->record[slot][r].cpuBegin;
+
+	scope = &profiler->scope[profiler->stack[profiler->depth]];
+	scope->cpu[scope->cpuCount % PROFILER_HISTORY] = (float)cpu;
+	scope->cpuTotal += cpu;
+	scope->cpuCount++;
+}
+
+// Opens implicit "Frame" scope; results of frame issued PROFILER_FRAME_LATENCY frames ago are read here
+void profilerBeginFrame(Profiler *profiler) {
+	// Code
+	profiler->slot = profiler->frame % PROFILER_FRAME_LATENCY;
+	profilerCollect(profiler, profiler->slot, false);
+	profiler->depth = 0;
+	profilerBeginScope(profiler, "Frame");
+}
+
+void profilerEndFrame(Profiler *profiler) {
+	// Code
+	while(profiler->depth > 0)
+		profilerEndScope(profiler);
+	profiler->frame++;
+}
+//=============================================================================
+
+// Internal : most recent sample of a history, 0 if none
+static inline float profilerLast(const float *history, unsigned int count) {
+	// Code
+	return (count > 0) ? history[(count - 1) % PROFILER_HISTORY] : 0.0f;
+}
+
+// Draws bars of last measured times; call inside a frame, before swap
+void profilerDrawGraph(Profiler *profiler) {
+	// Variable declaration
+	GLfloat vertices[PROFILER_MAX_SCOPES * 2 * 6 * 5];
+	GLfloat *v = vertices;
+	GLfloat barHeight = 0.03f, x0, x1, y0, y1, shade;
+	GLboolean depthTest;
+	GLint program;
+	int numVertices = 0;
+
+	// Code
+	if(profiler->graphProgram == 0)
+		return;
+	for(int i = 0; i < profiler->numScopes; i++) {
+		const ProfilerScope *s = &profiler->scope[i];
+		for(int bar = 0; bar < 2; bar++) {
+			float ms = (bar == 0) ? profilerLast(s->cpu, s->cpuCount) : profilerLast(s->gpu, s->gpuCount);
+			x0 = -0.98f + (0.02f * s->depth);
+			x1 = x0 + (fminf(ms / PROFILER_GRAPH_RANGE_MS, 1.0f) * 0.9f);
+			y0 = -0.98f + (((i * 2) + (1 - bar)) * barHeight);
+			y1 = y0 + (barHeight * 0.8f);
+			shade = (bar == 0) ? 1.0f : 0.6f;
+			GLfloat r = shade * (0.4f + 0.6f * ((i * 37) % 5) / 4.0f);	// A different color per scope
+			GLfloat g = shade * (0.4f + 0.6f * ((i * 53) % 7) / 6.0f);
+			GLfloat b = shade * (0.4f + 0.6f * ((i * 71) % 3) / 2.0f);
+			const GLfloat quad[6][2] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y0 }, { x1, y1 }, { x0, y1 } };
+			for(int k = 0; k < 6; k++) {
+				*v++ = quad[k][0];
+				*v++ = quad[k][1];
+				*v++ = r;
+				*v++ = g;
+				*v++ = b;
+			}
+			numVertices += 6;
+		}
+	}
+	if(numVertices == 0)
+		return;
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+	depthTest = glIsEnabled(GL_DEPTH_TEST);
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(profiler->graphProgram);
+	glBindBuffer(GL_ARRAY_BUFFER, profiler->graphVBO);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, numVertices * 5 * sizeof(GLfloat), vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(profiler->graphVAO);
+	glDrawArrays(GL_TRIANGLES, 0, numVertices);
+	glBindVertexArray(0);
+	glUseProgram(program);
+	if(depthTest == GL_TRUE)
+		glEnable(GL_DEPTH_TEST);
+}
+//=============================================================================
+
+static int profilerCompare(const void *a, const void *b) {
+	// Code
+	float x = *(const float *)a, y = *(const float *)b;
+	return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+// Internal : p50, p95, p99 of rolling window (nearest rank)
+static void profilerPercentiles(const float *history, unsigned int count, float result[3]) {
+	// Variable declaration
+	float sorted[PROFILER_HISTORY];
+	unsigned int n = (count < PROFILER_HISTORY) ? count : PROFILER_HISTORY;
+	const float rank[3] = { 0.50f, 0.95f, 0.99f };
+
+	// Code
+	if(n == 0) {
+		result[0] = result[1] = result[2] = 0.0f;
+		return;
+	}
+	memcpy(sorted, history, n * sizeof(float));
+	qsort(sorted, n, sizeof(float), profilerCompare);
+	for(int i = 0; i < 3; i++) {
+		unsigned int index = (unsigned int)ceilf(rank[i] * n);
+		result[i] = sorted[(index > 0) ? index - 1 : 0];
+	}
+}
+
+// Reads pending GPU results, prints summary and writes <name>.csv and <name>.json; call before profilerUninitialize()
+void profilerDump(Profiler *profiler, const char *name) {
+	// Variable declaration
+	char path[512];
+	float cpu[3], gpu[3];
+	FILE *csv, *json;
+
+	// Code
+	if(profiler->frame == 0)
+		return;
+	if(profiler->gpuTiming == true) {
+		glFinish();
+		for(unsigned int s = 0; s < PROFILER_FRAME_LATENCY; s++)
+			profilerCollect(profiler, s, true);
+	}
+
+	snprintf(path, sizeof(path), "%s.csv", name);
+	csv = fopen(path, "w");
+	snprintf(path, sizeof(path), "%s.json", name);
+	json = fopen(path, "w");
+	if(csv == NULL || json == NULL)
+		printf("\n Profiler : Unable to open '%s.csv' / '%s.json' for writing.", name, name);
+
+	printf("\n Profiler : %u frames, %u dropped GPU frames", profiler->frame, profiler->droppedFrames);
+	printf("\n %-24s %9s %9s %9s %9s %9s %9s", "Scope (ms)", "CPU p50", "CPU p95", "CPU p99", "GPU p50", "GPU p95", "GPU p99");
+	if(csv != NULL)
+		fprintf(csv, "scope,parent,depth,cpu_samples,cpu_mean_ms,cpu_p50_ms,cpu_p95_ms,cpu_p99_ms,gpu_samples,gpu_mean_ms,gpu_p50_ms,gpu_p95_ms,gpu_p99_ms\n");
+	if(json != NULL)
+		fprintf(json, "{\n\t\"frames\": %u,\n\t\"droppedGpuFrames\": %u,\n\t\"gpuTiming\": %s,\n\t\"scopes\": [", profiler->frame, profiler->droppedFrames, profiler->gpuTiming ? "true" : "false");
+
+	for(int i = 0; i < profiler->numScopes; i++) {
+		const ProfilerScope *s = &profiler->scope[i];
+		const char *parent = (s->parent >= 0) ? profiler->scope[s->parent].name : "";
+		double cpuMean = (s->cpuCount > 0) ? s->cpuTotal / s->cpuCount : 0.0;
+		double gpuMean = (s->gpuCount > 0) ? s->gpuTotal / s->gpuCount : 0.0;
+		profilerPercentiles(s->cpu, s->cpuCount, cpu);
+		profilerPercentiles(s->gpu, s->gpuCount, gpu);
+
+		printf("\n %*s%-*s %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f", s->depth * 2, "", 24 - (s->depth * 2), s->name, cpu[0], cpu[1], cpu[2], gpu[0], gpu[1], gpu[2]);
+		if(csv != NULL)
+			fprintf(csv, "%s,%s,%d,%u,%.4f,%.4f,%.4f,%.4f,%u,%.4f,%.4f,%.4f,%.4f\n", s->name, parent, s->depth,
+				s->cpuCount, cpuMean, cpu[0], cpu[1], cpu[2], s->gpuCount, gpuMean, gpu[0], gpu[1], gpu[2]);
+		if(json != NULL)
+			fprintf(json, "%s\n\t\t{ \"scope\": \"%s\", \"parent\": \"%s\", \"depth\": %d,"
+				" \"cpu\": { \"samples\": %u, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f },"
+				" \"gpu\": { \"samples\": %u, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f } }",
+				(i > 0) ? "," : "", s->name, parent, s->depth,
+				s->cpuCount, cpuMean, cpu[0], cpu[1], cpu[2], s->gpuCount, gpuMean, gpu[0], gpu[1], gpu[2]);
+	}
+	if(json != NULL) {
+		fprintf(json, "\n\t]\n}\n");
+		fclose(json);
+	}
+	if(csv != NULL)
+		fclose(csv);
+	fflush(stdout);
+}
+
+void profilerUninitialize(Profiler *profiler) {
+	// Code
+	if(profiler->gpuTiming == true) {
+		for(int s = 0; s < PROFILER_FRAME_LATENCY; s++)
+			glDeleteQueries(PROFILER_MAX_RECORDS * 2, profiler->query[s]);
+		profiler->gpuTiming = false;
+	}
+	if(profiler->graphVAO) {
+		glDeleteVertexArrays(1, &profiler->graphVAO);
+		profiler->graphVAO = 0;
+	}
+	if(profiler->graphVBO) {
+		glDeleteBuffers(1, &profiler->graphVBO);
+		profiler->graphVBO = 0;
+	}
+	if(profiler->graphProgram) {
+		glDeleteProgram(profiler->graphProgram);
+		profiler->graphProgram = 0;
+	}
+}
+//=============================================================================
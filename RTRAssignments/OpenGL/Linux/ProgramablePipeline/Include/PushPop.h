@@ -0,0 +1,177 @@
+// Header file for fixed capacity matrix stack with cached projection * modelview
+// By : Darshan Vikam
+//
+// Every level of the stack is kept in one static array, so pushing and popping never touch the heap.
+// Push copies the top level one step up; pop only moves the top back, the level below is still there.
+// projection * modelview(MVP) is multiplied only when matrixStackGetMVP() is called after a change,
+// and is cached per level, so drawing again after a pop costs no multiplication.
+// Capacity is fixed at compile time, define MATRIX_STACK_CAPACITY before including to change it.
+// Old PushMatrix4x4()/PopMatrix4x4() are kept on top of a global stack.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <string.h>
+#include "vmath.h"
+#include "MatrixSIMD.h"
+
+#ifndef MATRIX_STACK_CAPACITY
+	#define MATRIX_STACK_CAPACITY	32
+#endif
+//=============================================================================
+
+typedef struct {
+	vmath::mat4 modelview[MATRIX_STACK_CAPACITY];
+	vmath::mat4 mvp[MATRIX_STACK_CAPACITY];		// projection * modelview[], valid if mvpVersion[] == projectionVersion
+	unsigned int mvpVersion[MATRIX_STACK_CAPACITY];
+	vmath::mat4 projection;
+	unsigned int projectionVersion;			// Bumped on every projection change, invalidates all levels at once
+	unsigned int top;
+	unsigned int overflows, underflows;		// Failed push()/pop() calls
+	unsigned int compositions;			// MVP multiplications since last matrixStackResetStats()
+} MatrixStack;
+//=============================================================================
+
+static inline void matrixStackInitialize(MatrixStack *stack) {
+	// Code
+	stack->top = 0;
+	stack->modelview[0] = vmath::mat4::identity();
+	stack->projection = vmath::mat4::identity();
+	stack->projectionVersion = 1;
+	stack->mvpVersion[0] = 0;
+	stack->overflows = 0;
+	stack->underflows = 0;
+	stack->compositions = 0;
+}
+
+// Initialized stack by value, for globals
+static inline MatrixStack matrixStackCreate(void) {
+	// Variable declaration
+	MatrixStack stack;
+
+	// Code
+	matrixStackInitialize(&stack);
+	return stack;
+}
+
+static inline void matrixStackResetStats(MatrixStack *stack) {
+	// Code
+	stack->compositions = 0;
+}
+
+static inline void matrixStackSetProjection(MatrixStack *stack, const vmath::mat4 &projection) {
+	// Code
+	stack->projection = projection;
+	stack->projectionVersion++;
+	if(stack->projectionVersion == 0)		// 0 is reserved for 'never composed'
+		stack->projectionVersion = 1;
+}
+
+// Returns false (and keeps stack unchanged) if stack is full
+static inline bool matrixStackPush(MatrixStack *stack) {
+	// Variable declaration
+	unsigned int top = stack->top;
+
+	// Code
+	if(top + 1 >= MATRIX_STACK_CAPACITY) {
+		if(stack->overflows++ == 0)
+			printf("\n ERROR : Matrix stack overflow (capacity %d).", MATRIX_STACK_CAPACITY);
+		return false;
+	}
+	memcpy(&stack->modelview[top + 1], &stack->modelview[top], sizeof(vmath::mat4));
+	stack->mvpVersion[top + 1] = 0;			// Usually changed right after push, so cached MVP is not copied
+	stack->top = top + 1;
+	return true;
+}
+
+// Returns false (and keeps stack unchanged) if only the bottom level is left
+static inline bool matrixStackPop(MatrixStack *stack) {
+	// Code
+	if(stack->top == 0) {
+		if(stack->underflows++ == 0)
+			printf("\n ERROR : Matrix stack underflow.");
+		return false;
+	}
+	stack->top--;
+	return true;
+}
+
+static inline void matrixStackLoad(MatrixStack *stack, const vmath::mat4 &m) {
+	// Code
+	stack->modelview[stack->top] = m;
+	stack->mvpVersion[stack->top] = 0;
+}
+
+static inline void matrixStackLoadIdentity(MatrixStack *stack) {
+	// Code
+	matrixStackLoad(stack, vmath::mat4::identity());
+}
+
+// top = top * m
+static inline void matrixStackMultiply(MatrixStack *stack, const vmath::mat4 &m) {
+	// Code
+	mat4Multiply(stack->modelview[stack->top], stack->modelview[stack->top], m);
+	stack->mvpVersion[stack->top] = 0;
+}
+
+static inline void matrixStackTranslate(MatrixStack *stack, float x, float y, float z) {
+	// Code
+	matrixStackMultiply(stack, vmath::translate(x, y, z));
+}
+
+static inline void matrixStackRotate(MatrixStack *stack, float angle, float x, float y, float z) {
+	// Code
+	matrixStackMultiply(stack, vmath::rotate(angle, x, y, z));
+}
+
+static inline void matrixStackScale(MatrixStack *stack, float x, float y, float z) {
+	// Code
+	matrixStackMultiply(stack, vmath::scale(x, y, z));
+}
+
+static inline const vmath::mat4 &matrixStackGetModelView(const MatrixStack *stack) {
+	// Code
+	return stack->modelview[stack->top];
+}
+
+// projection * top, ready for glUniformMatrix4fv()
+static inline const float *matrixStackGetMVP(MatrixStack *stack) {
+	// Variable declaration
+	unsigned int top = stack->top;
+
+	// Code
+	if(stack->mvpVersion[top] != stack->projectionVersion) {
+		mat4Multiply(stack->mvp[top], stack->projection, stack->modelview[top]);
+		stack->mvpVersion[top] = stack->projectionVersion;
+		stack->compositions++;
+	}
+	return stack->mvp[top];
+}
+//=============================================================================
+
+// Old interface : caller keeps current matrix, stack only saves and restores copies of it.
+// Bottom level is identity and is never overwritten, so an unmatched pop returns identity, not a zero matrix.
+MatrixStack gPushPopStack = matrixStackCreate();
+
+void PushMatrix4x4(vmath::mat4 matrix) {
+	// Code
+	if(matrixStackPush(&gPushPopStack) == true)
+		matrixStackLoad(&gPushPopStack, matrix);
+}
+
+vmath::mat4 PopMatrix4x4(void) {
+	// Variable declaration
+	vmath::mat4 matrix = matrixStackGetModelView(&gPushPopStack);
+
+	// Code
+	if(gPushPopStack.top == 0) {
+		gPushPopStack.underflows++;
+		printf("\n ERROR : PopMatrix4x4() without matching PushMatrix4x4(), returning identity.");
+		return matrix;
+	}
+	matrixStackPop(&gPushPopStack);
+	return matrix;
+}
+//=============================================================================
@@ -0,0 +1,149 @@
+// Header file for render on demand message loop (like RENDERMODE_WHEN_DIRTY of Android samples)
+// By : Darshan Vikam
+//
+// Instead of drawing in every iteration, loop blocks in poll() on X server connection and, while an
+// animation runs, on a timerfd ticking at animation rate. A frame is drawn only after something asked
+// for it : Expose, ConfigureNotify, input (renderOnDemandInvalidate()) or a timer tick. A static scene
+// therefore sleeps in kernel between events and uses no CPU.
+// Message loop :
+//	renderOnDemandWait(&loop);			// Returns when X events are queued or a frame is due
+//	while(XPending(display)) { ... renderOnDemandInvalidate(&loop) on Expose / ConfigureNotify / input ... }
+//	if(renderOnDemandShouldDraw(&loop) == true) { Update(renderOnDemandElapsed(&loop)); display(); }
+// Frames come at uneven times (events draw extra ones, missed ticks draw fewer), so animation must be
+// advanced by renderOnDemandElapsed() and not by a fixed step per frame.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/timerfd.h>
+#include <X11/Xlib.h>
+//=============================================================================
+
+typedef struct {
+	Display *display;
+	int timerFd;				// Animation timer, -1 if it could not be created
+	bool animating;				// Timer is armed
+	bool dirty;				// A frame is due
+
+	// Statistics
+	unsigned long frames, wakeups;		// Frames drawn and returns from poll()
+	struct timespec startTime;
+	struct timespec lastFrameTime;		// For renderOnDemandElapsed()
+} RenderOnDemand;
+//=============================================================================
+
+void renderOnDemandInitialize(RenderOnDemand *loop, Display *display) {
+	// Code
+	memset(loop, 0, sizeof(RenderOnDemand));
+	loop->display = display;
+	loop->dirty = true;				// First frame
+	loop->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if(loop->timerFd < 0)
+		printf("\n Unable to create animation timer, animation is drawn only on events.");
+	clock_gettime(CLOCK_MONOTONIC, &loop->startTime);
+	loop->lastFrameTime = loop->startTime;
+}
+
+void renderOnDemandUninitialize(RenderOnDemand *loop) {
+	// Variable declaration
+	struct timespec now;
+	double seconds;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	seconds = (double)(now.tv_sec - loop->startTime.tv_sec) + ((double)(now.tv_nsec - loop->startTime.tv_nsec) / 1000000000.0);
+	printf("\n Render on demand : %lu frames and %lu wake ups in %.1f seconds", loop->frames, loop->wakeups, seconds);
+	if(loop->timerFd >= 0) {
+		close(loop->timerFd);
+		loop->timerFd = -1;
+	}
+}
+
+// Asks for one frame, e.g. after input changed state of scene
+static inline void renderOnDemandInvalidate(RenderOnDemand *loop) {
+	// Code
+	loop->dirty = true;
+}
+
+// Starts animation timer with 'fps' ticks per second, 0 stops it
+void renderOnDemandSetAnimation(RenderOnDemand *loop, double fps) {
+	// Variable declaration
+	struct itimerspec timer;
+
+	// Code
+	if(loop->timerFd < 0 || (fps > 0.0) == loop->animating)
+		return;
+	memset(&timer, 0, sizeof(timer));
+	if(fps > 0.0) {
+		long interval = (long)(1000000000.0 / fps);
+		timer.it_interval.tv_sec = interval / 1000000000L;
+		timer.it_interval.tv_nsec = interval % 1000000000L;
+		timer.it_value = timer.it_interval;
+	}
+	timerfd_settime(loop->timerFd, 0, &timer, NULL);	// All zero disarms
+	loop->animating = (fps > 0.0);
+	if(loop->animating == true)
+		loop->dirty = true;
+}
+
+// Blocks until X events are queued or a frame is due; returns at once if a frame is already due
+void renderOnDemandWait(RenderOnDemand *loop) {
+	// Variable declaration
+	struct pollfd fds[2];
+	nfds_t numFds = 1;
+	uint64_t expirations;
+
+	// Code
+	if(loop->dirty == true || XPending(loop->display) > 0)	// XPending() also flushes requests before sleeping
+		return;
+
+	fds[0].fd = ConnectionNumber(loop->display);
+	fds[0].events = POLLIN;
+	fds[0].revents = 0;
+	if(loop->animating == true) {
+		fds[1].fd = loop->timerFd;
+		fds[1].events = POLLIN;
+		fds[1].revents = 0;
+		numFds = 2;
+	}
+	while(poll(fds, numFds, -1) < 0 && errno == EINTR);
+	loop->wakeups++;
+
+	if(numFds == 2 && (fds[1].revents & POLLIN)) {
+		if(read(loop->timerFd, &expirations, sizeof(expirations)) == sizeof(expirations))	// Missed ticks give one frame
+			loop->dirty = true;
+	}
+}
+
+// Returns seconds since previous call (since initialization for first call), at most 0.1 s so that
+// animation does not jump after a long sleep
+double renderOnDemandElapsed(RenderOnDemand *loop) {
+	// Variable declaration
+	struct timespec now;
+	double seconds;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	seconds = (double)(now.tv_sec - loop->lastFrameTime.tv_sec) + ((double)(now.tv_nsec - loop->lastFrameTime.tv_nsec) / 1000000000.0);
+	loop->lastFrameTime = now;
+	return (seconds < 0.1) ? seconds : 0.1;
+}
+
+// Returns true (once) if a frame has to be drawn now
+static inline bool renderOnDemandShouldDraw(RenderOnDemand *loop) {
+	// Code
+	if(loop->dirty == false)
+		return false;
+	loop->dirty = false;
+	loop->frames++;
+	return true;
+}
+//=============================================================================
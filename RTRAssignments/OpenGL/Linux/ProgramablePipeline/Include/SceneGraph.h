@@ -0,0 +1,339 @@
+// Header file for flat transform hierarchy (scene graph) in structure-of-arrays order
+// By : Darshan Vikam
+//
+// Nodes are stored in depth first order, same order in which nested push/pop calls visit them :
+// a parent is always before its children and every subtree is one contiguous range of nodes.
+// Every property is its own array (parent, depth, local, world, ...), so update walks them linearly.
+// Only nodes whose local transform changed, and their descendants, are multiplied again.
+// projection * world (MVP) is cached per node, as in PushPop.h : it is multiplied only when
+// sceneGraphGetMVP() is called after that node's world transform or the projection changed.
+// Big hierarchies are split at depth SCENE_SPLIT_DEPTH : nodes above it are updated first on calling
+// thread, then subtrees below it are shared among worker threads, each taking a contiguous range.
+// Link with -lpthread.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "vmath.h"
+#include "MatrixSIMD.h"
+
+#define SCENE_MAX_THREADS		16
+#define SCENE_SPLIT_DEPTH		1		// Children of roots are roots of parallel subtrees
+#define SCENE_MIN_NODES_PER_THREAD	4096		// Smaller hierarchies are updated on calling thread only
+//=============================================================================
+
+struct SceneGraph;
+
+typedef struct {
+	struct SceneGraph *graph;
+	unsigned int first, last;		// Node range [first, last) of this job
+	unsigned int updated;			// Nodes multiplied in last update
+} SceneJob;
+
+typedef struct SceneGraph {
+	unsigned int count, capacity;
+
+	// Per node arrays (structure of arrays)
+	int *parent;				// -1 for root
+	unsigned short *depth;
+	unsigned int *subtreeEnd;		// One past last node of subtree
+	vmath::mat4 *local;
+	vmath::mat4 *world;
+	unsigned char *dirty;			// Local transform changed since last update
+	unsigned char *changed;			// World transform changed in last update
+	vmath::mat4 *mvp;			// projection * world[], valid if mvpVersion[] == projectionVersion
+	unsigned int *mvpVersion;
+
+	vmath::mat4 projection;
+	unsigned int projectionVersion;		// Bumped on every projection change, invalidates all nodes at once
+
+	// Partition of nodes, rebuilt after nodes are added
+	bool layoutDirty;
+	unsigned int *shallow;			// Nodes above SCENE_SPLIT_DEPTH
+	unsigned int numShallow;
+	SceneJob job[SCENE_MAX_THREADS];
+	unsigned int numJobs;
+
+	// Worker threads (job[0] runs on calling thread)
+	pthread_t thread[SCENE_MAX_THREADS];
+	unsigned int numThreads;
+	pthread_mutex_t mutex;
+	pthread_cond_t startCond, doneCond;
+	unsigned int generation, pending;
+	bool quit;
+} SceneGraph;
+//=============================================================================
+
+// Internal : update nodes [first, last); shallow nodes are already done in phase 1
+static unsigned int sceneUpdateRange(SceneGraph *graph, unsigned int first, unsigned int last, unsigned int minDepth) {
+	// Variable declaration
+	const int *parent = graph->parent;
+	const unsigned short *depth = graph->depth;
+	unsigned char *dirty = graph->dirty;
+	unsigned char *changed = graph->changed;
+	unsigned int updated = 0;
+
+	// Code
+	for(unsigned int i = first; i < last; i++) {
+		if(depth[i] < minDepth)
+			continue;
+		int p = parent[i];
+		if(p < 0) {
+			changed[i] = dirty[i];
+			if(dirty[i]) {
+				graph->world[i] = graph->local[i];
+				graph->mvpVersion[i] = 0;
+				updated++;
+			}
+		}
+		else {
+			changed[i] = dirty[i] | changed[p];
+			if(changed[i]) {
+				mat4Multiply(graph->world[i], graph->world[p], graph->local[i]);
+				graph->mvpVersion[i] = 0;
+				updated++;
+			}
+		}
+		dirty[i] = 0;
+	}
+	return updated;
+}
+
+static void *sceneWorker(void *param) {
+	// Variable declaration
+	SceneJob *job = (SceneJob *)param;
+	SceneGraph *graph = job->graph;
+	unsigned int seen = 0;
+
+	// Code
+	pthread_mutex_lock(&graph->mutex);
+	for(;;) {
+		while(graph->generation == seen && graph->quit == false)
+			pthread_cond_wait(&graph->startCond, &graph->mutex);
+		if(graph->quit == true)
+			break;
+		seen = graph->generation;
+		pthread_mutex_unlock(&graph->mutex);
+
+		if(job->first < job->last)
+			job->updated = sceneUpdateRange(graph, job->first, job->last, SCENE_SPLIT_DEPTH);
+
+		pthread_mutex_lock(&graph->mutex);
+		if(--graph->pending == 0)
+			pthread_cond_signal(&graph->doneCond);
+	}
+	pthread_mutex_unlock(&graph->mutex);
+	return NULL;
+}
+
+// Internal : split nodes below SCENE_SPLIT_DEPTH into numThreads ranges of about same node count
+static void sceneBuildLayout(SceneGraph *graph) {
+	// Variable declaration
+	unsigned int target, jobIndex = 0;
+	unsigned int i = 0;
+
+	// Code
+	graph->numShallow = 0;
+	for(i = 0; i < graph->count; i++) {
+		if(graph->depth[i] < SCENE_SPLIT_DEPTH)
+			graph->shallow[graph->numShallow++] = i;
+	}
+
+	for(unsigned int t = 0; t < SCENE_MAX_THREADS; t++) {
+		graph->job[t].first = graph->job[t].last = graph->count;
+		graph->job[t].updated = 0;
+	}
+
+	graph->numJobs = (graph->count >= graph->numThreads * SCENE_MIN_NODES_PER_THREAD) ? graph->numThreads : 1;
+	target = (graph->count + graph->numJobs - 1) / graph->numJobs;
+	graph->job[0].first = 0;
+	i = 0;
+	while(i < graph->count) {
+		if(graph->depth[i] < SCENE_SPLIT_DEPTH) {		// Shallow node, its children follow it
+			i++;
+			continue;
+		}
+		// Root of a parallel subtree; jobs are only cut here
+		if(jobIndex + 1 < graph->numJobs && i - graph->job[jobIndex].first >= target) {
+			graph->job[jobIndex].last = i;
+			graph->job[++jobIndex].first = i;
+		}
+		i = graph->subtreeEnd[i];
+	}
+	graph->job[jobIndex].last = graph->count;
+	graph->numJobs = jobIndex + 1;
+	graph->layoutDirty = false;
+}
+//=============================================================================
+
+// Returns false if memory or threads could not be allocated. numThreads includes calling thread.
+bool sceneGraphCreate(SceneGraph *graph, unsigned int capacity, unsigned int numThreads) {
+	// Code
+	memset(graph, 0, sizeof(SceneGraph));
+	graph->capacity = capacity;
+	graph->parent = (int *)malloc(capacity * sizeof(int));
+	graph->depth = (unsigned short *)malloc(capacity * sizeof(unsigned short));
+	graph->subtreeEnd = (unsigned int *)malloc(capacity * sizeof(unsigned int));
+	graph->local = (vmath::mat4 *)malloc(capacity * sizeof(vmath::mat4));
+	graph->world = (vmath::mat4 *)malloc(capacity * sizeof(vmath::mat4));
+	graph->dirty = (unsigned char *)malloc(capacity);
+	graph->changed = (unsigned char *)malloc(capacity);
+	graph->mvp = (vmath::mat4 *)malloc(capacity * sizeof(vmath::mat4));
+	graph->mvpVersion = (unsigned int *)malloc(capacity * sizeof(unsigned int));
+	graph->shallow = (unsigned int *)malloc(capacity * sizeof(unsigned int));
+	if(graph->parent == NULL || graph->depth == NULL || graph->subtreeEnd == NULL || graph->local == NULL || graph->world == NULL || graph->dirty == NULL || graph->changed == NULL ||
+		graph->mvp == NULL || graph->mvpVersion == NULL || graph->shallow == NULL) {
+		printf("\n ERROR : Unable to allocate memory for scene graph.");
+		return false;
+	}
+	graph->layoutDirty = true;
+	graph->projection = vmath::mat4::identity();
+	graph->projectionVersion = 1;
+
+	if(numThreads < 1)
+		numThreads = 1;
+	if(numThreads > SCENE_MAX_THREADS)
+		numThreads = SCENE_MAX_THREADS;
+	graph->numThreads = 1;
+	pthread_mutex_init(&graph->mutex, NULL);
+	pthread_cond_init(&graph->startCond, NULL);
+	pthread_cond_init(&graph->doneCond, NULL);
+	for(unsigned int t = 0; t < SCENE_MAX_THREADS; t++)
+		graph->job[t].graph = graph;
+	for(unsigned int t = 1; t < numThreads; t++) {
+		if(pthread_create(&graph->thread[t], NULL, sceneWorker, &graph->job[t]) != 0) {
+			printf("\n Unable to create scene graph worker thread, using %d thread(s).", graph->numThreads);
+			break;
+		}
+		graph->numThreads++;
+	}
+	return true;
+}
+
+void sceneGraphDestroy(SceneGraph *graph) {
+	// Code
+	if(graph->numThreads > 0) {
+		pthread_mutex_lock(&graph->mutex);
+		graph->quit = true;
+		pthread_cond_broadcast(&graph->startCond);
+		pthread_mutex_unlock(&graph->mutex);
+		for(unsigned int t = 1; t < graph->numThreads; t++)
+			pthread_join(graph->thread[t], NULL);
+		pthread_mutex_destroy(&graph->mutex);
+		pthread_cond_destroy(&graph->startCond);
+		pthread_cond_destroy(&graph->doneCond);
+	}
+	free(graph->parent);
+	free(graph->depth);
+	free(graph->subtreeEnd);
+	free(graph->local);
+	free(graph->world);
+	free(graph->dirty);
+	free(graph->changed);
+	free(graph->mvp);
+	free(graph->mvpVersion);
+	free(graph->shallow);
+	memset(graph, 0, sizeof(SceneGraph));
+}
+
+// Adds node as last child of 'parent' (-1 for new root) and returns its index, -1 on failure.
+// Nodes must be added depth first : parent has to be the last added node or one of its ancestors.
+int sceneGraphAddNode(SceneGraph *graph, int parent, const vmath::mat4 &local) {
+	// Variable declaration
+	unsigned int index = graph->count;
+
+	// Code
+	if(index >= graph->capacity) {
+		printf("\n ERROR : Scene graph is full (capacity %d).", graph->capacity);
+		return -1;
+	}
+	if(parent >= (int)index || (parent >= 0 && graph->subtreeEnd[parent] != index)) {
+		printf("\n ERROR : Scene graph node %d is not added in depth first order.", index);
+		return -1;
+	}
+
+	graph->parent[index] = parent;
+	graph->depth[index] = (parent < 0) ? 0 : graph->depth[parent] + 1;
+	graph->subtreeEnd[index] = index + 1;
+	for(int a = parent; a >= 0; a = graph->parent[a])
+		graph->subtreeEnd[a] = index + 1;
+	graph->local[index] = local;
+	graph->world[index] = local;
+	graph->dirty[index] = 1;
+	graph->changed[index] = 0;
+	graph->mvpVersion[index] = 0;
+	graph->count++;
+	graph->layoutDirty = true;
+	return (int)index;
+}
+
+static inline void sceneGraphSetLocal(SceneGraph *graph, int node, const vmath::mat4 &local) {
+	// Code
+	graph->local[node] = local;
+	graph->dirty[node] = 1;
+}
+
+static inline const vmath::mat4 &sceneGraphGetWorld(const SceneGraph *graph, int node) {
+	// Code
+	return graph->world[node];
+}
+
+static inline void sceneGraphSetProjection(SceneGraph *graph, const vmath::mat4 &projection) {
+	// Code
+	graph->projection = projection;
+	graph->projectionVersion++;
+	if(graph->projectionVersion == 0)		// 0 is reserved for 'never composed'
+		graph->projectionVersion = 1;
+}
+
+// projection * world of 'node', ready for glUniformMatrix4fv(); call after sceneGraphUpdate()
+static inline const float *sceneGraphGetMVP(SceneGraph *graph, int node) {
+	// Code
+	if(graph->mvpVersion[node] != graph->projectionVersion) {
+		mat4Multiply(graph->mvp[node], graph->projection, graph->world[node]);
+		graph->mvpVersion[node] = graph->projectionVersion;
+	}
+	return graph->mvp[node];
+}
+
+// Brings every world transform up to date; returns number of nodes recomputed
+unsigned int sceneGraphUpdate(SceneGraph *graph) {
+	// Variable declaration
+	unsigned int updated = 0;
+
+	// Code
+	if(graph->layoutDirty == true)
+		sceneBuildLayout(graph);
+
+	// Phase 1 : nodes above split depth, in order
+	for(unsigned int s = 0; s < graph->numShallow; s++) {
+		unsigned int i = graph->shallow[s];
+		updated += sceneUpdateRange(graph, i, i + 1, 0);
+	}
+
+	// Phase 2 : independent subtrees, job[0] on this thread and rest on workers
+	if(graph->numJobs > 1) {
+		pthread_mutex_lock(&graph->mutex);
+		graph->pending = graph->numThreads - 1;
+		graph->generation++;
+		pthread_cond_broadcast(&graph->startCond);
+		pthread_mutex_unlock(&graph->mutex);
+	}
+	graph->job[0].updated = sceneUpdateRange(graph, graph->job[0].first, graph->job[0].last, SCENE_SPLIT_DEPTH);
+	if(graph->numJobs > 1) {
+		pthread_mutex_lock(&graph->mutex);
+		while(graph->pending > 0)
+			pthread_cond_wait(&graph->doneCond, &graph->mutex);
+		pthread_mutex_unlock(&graph->mutex);
+	}
+
+	for(unsigned int t = 0; t < graph->numJobs; t++)
+		updated += graph->job[t].updated;
+	return updated;
+}
+//=============================================================================
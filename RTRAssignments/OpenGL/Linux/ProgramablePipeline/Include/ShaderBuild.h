@@ -0,0 +1,254 @@
+// Header file for shader stages and batched (parallel) shader program building
+// By : Darshan Vikam
+//
+// ShaderStage names a shader stage, or a linked program, for status checks and error logs.
+// Querying compile or link status right after glCompileShader() / glLinkProgram() makes driver finish
+// that work first, so programs are built one after another. ShaderBuild instead submits every stage
+// and program of a sample first and asks for status once, in shaderBuildFinish(); with
+// GL_KHR_parallel_shader_compile (or ARB) driver compiles them on its own threads meanwhile.
+// Work which does not need programs (buffers, textures) can be done between add and finish.
+// Uniform locations must be taken only after shaderBuildFinish(), programs are 0 before it.
+//	shaderBuildBegin(&build);
+//	shaderBuildAdd(&build, &gSPObj_A, sourcesA, 2, attribs, 2);
+//	shaderBuildAdd(&build, &gSPObj_B, sourcesB, 2, attribs, 2);
+//	... create buffers ...
+//	if(shaderBuildFinish(&build) == false) { ... exit ... }
+//	gUniform = glGetUniformLocation(gSPObj_A, "u_...");
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <GL/glew.h>
+#include <GL/glx.h>
+
+#define SHADER_BUILD_MAX_PROGRAMS	8
+#define SHADER_BUILD_MAX_STAGES		6
+
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR		// GL_KHR_parallel_shader_compile, same value as ARB
+	#define GL_MAX_SHADER_COMPILER_THREADS_KHR	0x91B0
+#endif
+//=============================================================================
+
+typedef enum {
+	SHADER_STAGE_VERTEX = 0,
+	SHADER_STAGE_TESS_CONTROL,
+	SHADER_STAGE_TESS_EVALUATION,
+	SHADER_STAGE_GEOMETRY,
+	SHADER_STAGE_FRAGMENT,
+	SHADER_STAGE_COMPUTE,
+	SHADER_STAGE_PROGRAM			// Linked program, not a shader
+} ShaderStage;
+
+typedef struct {
+	ShaderStage stage;
+	const GLchar *source;
+} ShaderSource;
+
+typedef struct {
+	GLuint index;				// As in glBindAttribLocation()
+	const GLchar *name;
+} ShaderAttrib;
+
+typedef void (* glMaxShaderCompilerThreadsProc)(GLuint);
+
+typedef struct {
+	GLuint *program;			// Set by shaderBuildFinish()
+	GLuint object;
+	GLuint shader[SHADER_BUILD_MAX_STAGES];
+	ShaderStage stage[SHADER_BUILD_MAX_STAGES];
+	int numStages;
+} ShaderBuildProgram;
+
+typedef struct {
+	ShaderBuildProgram program[SHADER_BUILD_MAX_PROGRAMS];
+	int numPrograms;
+	bool parallel;				// Driver compiles on its own threads
+	bool failed;				// shaderBuildAdd() was given invalid arguments
+	bool retrievable;			// Link with GL_PROGRAM_BINARY_RETRIEVABLE_HINT (set by ShaderCache)
+	double startTime;
+} ShaderBuild;
+//=============================================================================
+
+static inline GLenum shaderStageType(ShaderStage stage) {
+	// Code
+	switch(stage) {
+		case SHADER_STAGE_VERTEX :
+			return GL_VERTEX_SHADER;
+		case SHADER_STAGE_TESS_CONTROL :
+			return GL_TESS_CONTROL_SHADER;
+		case SHADER_STAGE_TESS_EVALUATION :
+			return GL_TESS_EVALUATION_SHADER;
+		case SHADER_STAGE_GEOMETRY :
+			return GL_GEOMETRY_SHADER;
+		case SHADER_STAGE_FRAGMENT :
+			return GL_FRAGMENT_SHADER;
+		case SHADER_STAGE_COMPUTE :
+			return GL_COMPUTE_SHADER;
+		default :
+			return GL_NONE;
+	}
+}
+
+static inline const char *shaderStageName(ShaderStage stage) {
+	// Variable declaration
+	static const char *names[] = { "VERTEX", "TESS_CONTROL", "TESS_EVALUATION", "GEOMETRY", "FRAGMENT", "COMPUTE", "PROGRAM" };
+
+	// Code
+	return ((unsigned int)stage <= SHADER_STAGE_PROGRAM) ? names[stage] : "UNKNOWN";
+}
+
+// Compile status of a shader (link status for SHADER_STAGE_PROGRAM); prints info log and returns false on failure
+bool shaderStatusCheck(GLuint object, ShaderStage stage) {
+	// Variable declaration
+	GLint iStatus = GL_FALSE;
+	GLint iErrorLen = 0;
+	char *szError = NULL;
+	bool isProgram = (stage == SHADER_STAGE_PROGRAM);
+
+	// Code
+	if(isProgram == true)
+		glGetProgramiv(object, GL_LINK_STATUS, &iStatus);
+	else
+		glGetShaderiv(object, GL_COMPILE_STATUS, &iStatus);
+	if(iStatus == GL_TRUE)
+		return true;
+
+	if(isProgram == true)
+		glGetProgramiv(object, GL_INFO_LOG_LENGTH, &iErrorLen);
+	else
+		glGetShaderiv(object, GL_INFO_LOG_LENGTH, &iErrorLen);
+	if(iErrorLen > 0 && (szError = (char *)malloc(iErrorLen)) != NULL) {
+		if(isProgram == true) {
+			glGetProgramInfoLog(object, iErrorLen, NULL, szError);
+			printf("Shader %s linking Error log : \n", shaderStageName(stage));
+		}
+		else {
+			glGetShaderInfoLog(object, iErrorLen, NULL, szError);
+			printf("%s Shader Compilation Error log : \n", shaderStageName(stage));
+		}
+		printf("%s \n", szError);
+		free(szError);
+	}
+	else
+		printf("Error occured during compilation/linking. No error message. \n");
+	return false;
+}
+//=============================================================================
+
+static inline double shaderBuildClock(void) {
+	// Variable declaration
+	struct timespec now;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1000000000.0);
+}
+
+// Call after glewInit(); asks driver for parallel compilation when it has GL_KHR/ARB_parallel_shader_compile
+void shaderBuildBegin(ShaderBuild *build) {
+	// Variable declaration
+	glMaxShaderCompilerThreadsProc maxShaderCompilerThreads = NULL;
+	GLint numExts = 0;
+	const char *ext;
+
+	// Code
+	memset(build, 0, sizeof(ShaderBuild));
+	build->startTime = shaderBuildClock();
+
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numExts);
+	for(int i = 0; i < numExts && maxShaderCompilerThreads == NULL; i++) {
+		ext = (const char *)glGetStringi(GL_EXTENSIONS, i);
+		if(ext == NULL)
+			continue;
+		if(strcmp(ext, "GL_KHR_parallel_shader_compile") == 0)
+			maxShaderCompilerThreads = (glMaxShaderCompilerThreadsProc)glXGetProcAddressARB((const GLubyte *)"glMaxShaderCompilerThreadsKHR");
+		else if(strcmp(ext, "GL_ARB_parallel_shader_compile") == 0)
+			maxShaderCompilerThreads = (glMaxShaderCompilerThreadsProc)glXGetProcAddressARB((const GLubyte *)"glMaxShaderCompilerThreadsARB");
+	}
+	if(maxShaderCompilerThreads != NULL) {
+		maxShaderCompilerThreads(0xFFFFFFFF);	// As many threads as implementation likes
+		build->parallel = true;
+	}
+}
+
+// Submits compilation of all stages and linking of program; no status is queried here.
+// *program stays 0 until shaderBuildFinish(). Returns false on invalid arguments.
+bool shaderBuildAdd(ShaderBuild *build, GLuint *program, const ShaderSource *sources, int numSources, const ShaderAttrib *attribs, int numAttribs) {
+	// Variable declaration
+	ShaderBuildProgram *entry;
+
+	// Code
+	*program = 0;
+	if(build->numPrograms == SHADER_BUILD_MAX_PROGRAMS || numSources <= 0 || numSources > SHADER_BUILD_MAX_STAGES) {
+		printf("\n ERROR : Shader build : too many programs (%d at most) or invalid number of stages (%d).", SHADER_BUILD_MAX_PROGRAMS, numSources);
+		build->failed = true;
+		return false;
+	}
+
+	entry = &build->program[build->numPrograms++];
+	entry->program = program;
+	entry->numStages = numSources;
+	for(int i = 0; i < numSources; i++) {
+		entry->stage[i] = sources[i].stage;
+		entry->shader[i] = glCreateShader(shaderStageType(sources[i].stage));
+		glShaderSource(entry->shader[i], 1, &sources[i].source, NULL);
+		glCompileShader(entry->shader[i]);
+	}
+
+	entry->object = glCreateProgram();
+	for(int i = 0; i < numSources; i++)
+		glAttachShader(entry->object, entry->shader[i]);
+	for(int i = 0; i < numAttribs; i++)
+		glBindAttribLocation(entry->object, attribs[i].index, attribs[i].name);
+	if(build->retrievable == true)
+		glProgramParameteri(entry->object, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(entry->object);
+	return true;
+}
+
+// Waits for all programs, prints logs of failed ones and hands out programs; false if any failed (all are then 0)
+bool shaderBuildFinish(ShaderBuild *build) {
+	// Variable declaration
+	ShaderBuildProgram *entry;
+	GLint linked = GL_FALSE;
+	bool success = (build->failed == false);
+	bool compiled;
+
+	// Code
+	for(int i = 0; i < build->numPrograms; i++) {
+		entry = &build->program[i];
+		glGetProgramiv(entry->object, GL_LINK_STATUS, &linked);	// First status query, waits for this program
+		if(linked == GL_FALSE) {
+			compiled = true;
+			for(int j = 0; j < entry->numStages; j++)	// Compilation logs tell more than link log
+				compiled = shaderStatusCheck(entry->shader[j], entry->stage[j]) && compiled;
+			if(compiled == true)
+				shaderStatusCheck(entry->object, SHADER_STAGE_PROGRAM);
+			success = false;
+		}
+		for(int j = 0; j < entry->numStages; j++) {	// Linked program does not need them any more
+			glDetachShader(entry->object, entry->shader[j]);
+			glDeleteShader(entry->shader[j]);
+			entry->shader[j] = 0;
+		}
+	}
+
+	for(int i = 0; i < build->numPrograms; i++) {
+		entry = &build->program[i];
+		if(success == true)
+			*entry->program = entry->object;
+		else
+			glDeleteProgram(entry->object);
+		entry->object = 0;
+	}
+	printf("\n Shader build : %d programs in %.1f ms (%s)", build->numPrograms, (shaderBuildClock() - build->startTime) * 1000.0,
+		(build->parallel == true) ? "parallel compile" : "driver default compile");
+	build->numPrograms = 0;
+	return success;
+}
+//=============================================================================
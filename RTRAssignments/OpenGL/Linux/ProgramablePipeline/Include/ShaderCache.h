@@ -0,0 +1,286 @@
+// Header file for program binary cache : linked shader programs are stored on disk and reloaded on next start
+// By : Darshan Vikam
+//
+// Key of a program is 64 bit FNV-1a hash of its stage types and sources, attribute bindings and driver
+// identity (GL_VENDOR, GL_RENDERER, GL_VERSION), so an edited shader or updated driver simply misses.
+// On a hit in shaderCacheAdd(), program is created from SHADER_CACHE_DIR/<key>.bin with glProgramBinary();
+// a miss is submitted to a ShaderBuild batch, so all missing programs compile together (in parallel where
+// driver can), and shaderCacheFinish() waits for them once and writes their glGetProgramBinary() images.
+// A file with wrong magic, key, size or checksum, or one which driver refuses to link, is deleted and
+// program is compiled from source instead. Without any program binary format caching is skipped.
+// Shader objects never outlive shaderCacheFinish(), Uninitialize() only deletes returned programs.
+// As with ShaderBuild, uniform locations must be taken only after shaderCacheFinish() :
+//	shaderCacheAdd(&cache, &gSPObj_A, stagesA, 2, attribs, 2);
+//	shaderCacheAdd(&cache, &gSPObj_B, stagesB, 2, attribs, 2);
+//	if(shaderCacheFinish(&cache) == false) { ... exit ... }
+// Call shaderCacheInitialize() right after glewInit() and shaderCacheFirstFrame() after every
+// glXSwapBuffers(); first call prints time to first frame, so cold (misses) and warm (all hits)
+// starts can be compared.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <GL/glew.h>
+#include "ShaderBuild.h"			// ShaderStage, ShaderSource, ShaderAttrib
+
+#ifndef SHADER_CACHE_DIR
+	#define SHADER_CACHE_DIR	"ShaderCache"		// Relative to working directory, like OpenGL_info.txt
+#endif
+#define SHADER_CACHE_MAGIC	0x42505644u		// "DVPB"
+#define SHADER_CACHE_VERSION	1
+//=============================================================================
+
+typedef struct {				// Header of a cache file, binary follows it
+	uint32_t magic, version;
+	uint64_t key;
+	uint64_t checksum;			// FNV-1a of binary
+	GLenum binaryFormat;
+	GLint length;
+} ShaderCacheFileHeader;
+
+typedef struct {				// Missed program, stored once its batch has linked
+	GLuint *program;
+	uint64_t key;
+	char path[128];
+} ShaderCachePending;
+
+typedef struct {
+	bool enabled;				// Driver has at least one program binary format
+	uint64_t driverKey;			// Hash of driver identity, seed of every program key
+	ShaderBuild build;			// Batch of missed programs
+	ShaderCachePending pending[SHADER_BUILD_MAX_PROGRAMS];
+	int numPending;
+
+	// Statistics
+	unsigned int hits, misses, rejected;	// rejected - corrupt or stale files which were deleted
+	double startTime, buildTime;		// Seconds
+	bool firstFrameReported;
+} ShaderCache;
+//=============================================================================
+
+static inline double shaderCacheClock(void) {
+	// Variable declaration
+	struct timespec now;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1000000000.0);
+}
+
+static inline uint64_t shaderCacheHash(uint64_t hash, const void *data, size_t size) {
+	// Variable declaration
+	const unsigned char *bytes = (const unsigned char *)data;
+
+	// Code
+	for(size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;		// FNV-1a 64 bit prime
+	}
+	return hash;
+}
+
+static inline uint64_t shaderCacheHashString(uint64_t hash, const char *string) {
+	// Code
+	if(string == NULL)
+		string = "";
+	return shaderCacheHash(hash, string, strlen(string) + 1);	// Terminator too, so "ab"+"c" differs from "a"+"bc"
+}
+
+// Call after glewInit(); also starts clock of time to first frame
+void shaderCacheInitialize(ShaderCache *cache) {
+	// Variable declaration
+	GLint numFormats = 0;
+
+	// Code
+	memset(cache, 0, sizeof(ShaderCache));
+	cache->startTime = shaderCacheClock();
+	shaderBuildBegin(&cache->build);
+
+	cache->driverKey = 0xcbf29ce484222325ull;	// FNV-1a 64 bit offset basis
+	cache->driverKey = shaderCacheHashString(cache->driverKey, (const char *)glGetString(GL_VENDOR));
+	cache->driverKey = shaderCacheHashString(cache->driverKey, (const char *)glGetString(GL_RENDERER));
+	cache->driverKey = shaderCacheHashString(cache->driverKey, (const char *)glGetString(GL_VERSION));
+
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+	if(numFormats <= 0) {
+		printf("\n Shader cache : driver has no program binary format, shaders are compiled on every start");
+		return;
+	}
+	if(mkdir(SHADER_CACHE_DIR, 0755) != 0 && errno != EEXIST) {
+		printf("\n Shader cache : unable to create directory '%s', shaders are compiled on every start", SHADER_CACHE_DIR);
+		return;
+	}
+	cache->enabled = true;
+	cache->build.retrievable = true;
+}
+
+// Internal : program from cache file, 0 if there is no usable file (an unusable one is deleted)
+static GLuint shaderCacheLoad(ShaderCache *cache, uint64_t key, const char *path) {
+	// Variable declaration
+	FILE *file = NULL;
+	ShaderCacheFileHeader header;
+	void *binary = NULL;
+	GLuint program = 0;
+	GLint status = GL_FALSE;
+	bool corrupt = true;
+
+	// Code
+	file = fopen(path, "rb");
+	if(file == NULL)
+		return 0;
+	if(fread(&header, sizeof(header), 1, file) == 1 && header.magic == SHADER_CACHE_MAGIC && header.version == SHADER_CACHE_VERSION &&
+		header.key == key && header.length > 0 && (binary = malloc(header.length)) != NULL) {
+		if(fread(binary, 1, header.length, file) == (size_t)header.length && fgetc(file) == EOF &&
+			shaderCacheHash(0xcbf29ce484222325ull, binary, header.length) == header.checksum)
+			corrupt = false;
+	}
+	fclose(file);
+
+	if(corrupt == false) {
+		program = glCreateProgram();
+		glProgramBinary(program, header.binaryFormat, binary, header.length);
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if(status == GL_FALSE) {		// Driver changed without changing its identity strings, or refused image
+			glDeleteProgram(program);
+			program = 0;
+		}
+	}
+	free(binary);
+
+	if(program == 0) {
+		printf("\n Shader cache : discarding stale or corrupt '%s'", path);
+		remove(path);
+		cache->rejected++;
+	}
+	return program;
+}
+
+// Internal : writes binary of linked program; failure only costs a compilation next time
+static void shaderCacheStore(uint64_t key, const char *path, GLuint program) {
+	// Variable declaration
+	ShaderCacheFileHeader header;
+	char tempPath[128];
+	void *binary = NULL;
+	FILE *file = NULL;
+	bool written = false;
+
+	// Code
+	memset(&header, 0, sizeof(header));
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &header.length);
+	if(header.length <= 0 || (binary = malloc(header.length)) == NULL)
+		return;
+	glGetProgramBinary(program, header.length, &header.length, &header.binaryFormat, binary);
+	header.magic = SHADER_CACHE_MAGIC;
+	header.version = SHADER_CACHE_VERSION;
+	header.key = key;
+	header.checksum = shaderCacheHash(0xcbf29ce484222325ull, binary, header.length);
+
+	// Written aside and renamed, so a crash never leaves a half written entry under real name
+	snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+	file = fopen(tempPath, "wb");
+	if(file != NULL) {
+		written = (fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(binary, 1, header.length, file) == (size_t)header.length);
+		written = (fclose(file) == 0) && written;
+		if(written == false || rename(tempPath, path) != 0) {
+			printf("\n Shader cache : unable to write '%s'", path);
+			remove(tempPath);
+		}
+	}
+	free(binary);
+}
+
+// Sets *program from cache if possible, else submits its stages to batch and leaves *program 0 until
+// shaderCacheFinish(). Returns false on invalid arguments.
+bool shaderCacheAdd(ShaderCache *cache, GLuint *program, const ShaderSource *stages, int numStages, const ShaderAttrib *attribs, int numAttribs) {
+	// Variable declaration
+	ShaderCachePending *pending;
+	uint64_t key;
+	char path[128];
+	double start;
+
+	// Code
+	start = shaderCacheClock();
+	*program = 0;
+	if(numStages <= 0 || numStages > SHADER_BUILD_MAX_STAGES) {
+		printf("\n ERROR : Shader cache : invalid number of stages (%d).", numStages);
+		cache->build.failed = true;
+		return false;
+	}
+
+	key = cache->driverKey;
+	for(int i = 0; i < numStages; i++) {
+		key = shaderCacheHash(key, &stages[i].stage, sizeof(stages[i].stage));
+		key = shaderCacheHashString(key, stages[i].source);
+	}
+	for(int i = 0; i < numAttribs; i++) {
+		key = shaderCacheHash(key, &attribs[i].index, sizeof(attribs[i].index));
+		key = shaderCacheHashString(key, attribs[i].name);
+	}
+	snprintf(path, sizeof(path), "%s/%016llx.bin", SHADER_CACHE_DIR, (unsigned long long)key);
+
+	if(cache->enabled == true) {
+		*program = shaderCacheLoad(cache, key, path);
+		if(*program != 0) {
+			cache->hits++;
+			cache->buildTime += shaderCacheClock() - start;
+			return true;
+		}
+	}
+	cache->misses++;
+
+	// Compiled and linked with other misses; status is asked only in shaderCacheFinish()
+	if(cache->build.numPrograms == 0)
+		cache->build.startTime = start;
+	if(shaderBuildAdd(&cache->build, program, stages, numStages, attribs, numAttribs) == false)
+		return false;
+	pending = &cache->pending[cache->numPending++];
+	pending->program = program;
+	pending->key = key;
+	memcpy(pending->path, path, sizeof(path));
+	cache->buildTime += shaderCacheClock() - start;
+	return true;
+}
+
+// Waits for missed programs, then stores their binaries; false if any program failed (every program of batch is then 0)
+bool shaderCacheFinish(ShaderCache *cache) {
+	// Variable declaration
+	double start;
+	bool success;
+
+	// Code
+	if(cache->build.numPrograms == 0 && cache->build.failed == false)	// All hits
+		return true;
+
+	start = shaderCacheClock();
+	success = shaderBuildFinish(&cache->build);
+	cache->build.failed = false;
+	if(success == true && cache->enabled == true) {
+		for(int i = 0; i < cache->numPending; i++)
+			shaderCacheStore(cache->pending[i].key, cache->pending[i].path, *cache->pending[i].program);
+	}
+	cache->numPending = 0;
+	cache->buildTime += shaderCacheClock() - start;
+	return success;
+}
+
+// Call after glXSwapBuffers(); first call waits for frame to finish and prints startup time
+void shaderCacheFirstFrame(ShaderCache *cache) {
+	// Code
+	if(cache->firstFrameReported == true)
+		return;
+	cache->firstFrameReported = true;
+	glFinish();
+	printf("\n Shader cache : %s start, first frame after %.1f ms (%.1f ms building programs : %u hits, %u misses, %u rejected)",
+		(cache->misses > 0) ? "cold" : "warm", (shaderCacheClock() - cache->startTime) * 1000.0, cache->buildTime * 1000.0,
+		cache->hits, cache->misses, cache->rejected);
+	fflush(stdout);
+}
+//=============================================================================
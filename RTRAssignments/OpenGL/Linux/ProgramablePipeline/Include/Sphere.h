@@ -0,0 +1,326 @@
+// Header file for Sphere generation (source level replacement of libSphere.so)
+// By : Darshan Vikam
+//
+// Old entry points (getSphereVertexData() & friends) are kept with the same
+// signature, so existing samples build without '-lSphere'.
+// New entry points take slices/stacks, write shared(indexed) vertices into
+// caller owned interleaved buffers and can build a level-of-detail(LOD) chain.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <math.h>
+#include <string.h>
+//=============================================================================
+
+// Interleaved vertex layout : position(3), normal(3), texcoord(2)
+#define SPHERE_VERTEX_STRIDE		8		// floats per vertex
+#define SPHERE_POSITION_OFFSET		0		// float offset of position
+#define SPHERE_NORMAL_OFFSET		3		// float offset of normal
+#define SPHERE_TEXCOORD_OFFSET		6		// float offset of texcoord
+
+#define SPHERE_MAX_SLICES		512		// limit of trig table (per column)
+#define SPHERE_MAX_LOD			8		// limit of levels in LOD chain
+#define SPHERE_MIN_LOD_SLICES		6
+#define SPHERE_MIN_LOD_STACKS		4
+
+// Layout of old libSphere.so mesh : 20 slices x 20 stacks with shared poles
+#define SPHERE_LEGACY_SLICES		20
+#define SPHERE_LEGACY_STACKS		20
+#define SPHERE_LEGACY_RADIUS		0.75f
+
+// One level of LOD chain. Elements are absolute (base vertex already added),
+// so a level is drawn with plain glDrawElements() at 'firstElement'.
+typedef struct {
+	unsigned int slices, stacks;
+	unsigned int baseVertex, numVertices;
+	unsigned int firstElement, numElements;
+} SphereLOD;
+
+typedef struct {
+	unsigned int numLevels;
+	unsigned int numVertices;	// of all levels together
+	unsigned int numElements;	// of all levels together
+	unsigned int indexSize;		// 2 - unsigned short, 4 - unsigned int
+	SphereLOD level[SPHERE_MAX_LOD];
+} SphereLODChain;
+//=============================================================================
+
+// Number of vertices of sphere (with texture seam and one pole vertex per column)
+unsigned int getSphereVertexCount(unsigned int slices, unsigned int stacks) {
+	// Code
+	if(slices < 3 || stacks < 2 || slices > SPHERE_MAX_SLICES)
+		return 0;
+	return (stacks + 1) * (slices + 1);
+}
+
+// Number of elements (indices) of sphere; degenerate triangles at poles are skipped
+unsigned int getSphereElementCount(unsigned int slices, unsigned int stacks) {
+	// Code
+	if(slices < 3 || stacks < 2 || slices > SPHERE_MAX_SLICES)
+		return 0;
+	return slices * (stacks - 1) * 6;
+}
+
+// Index size (in bytes) which can address 'numVertices' vertices
+unsigned int getSphereIndexSize(unsigned int numVertices) {
+	// Code
+	return (numVertices <= 65536) ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
+// Internal : writes one index of given size
+static inline void sphereSetIndex(void *elements, unsigned int indexSize, unsigned int at, unsigned int value) {
+	// Code
+	if(indexSize == sizeof(unsigned short))
+		((unsigned short *)elements)[at] = (unsigned short)value;
+	else
+		((unsigned int *)elements)[at] = value;
+}
+
+// Internal : sin/cos of every column, evaluated once per mesh instead of once per vertex
+static void sphereColumnTable(unsigned int columns, unsigned int slices, float *colSin, float *colCos) {
+	// Code
+	for(unsigned int c = 0; c < columns; c++) {
+		float theta = 2.0f * (float)M_PI * (float)(c % slices) / (float)slices;
+		colSin[c] = sinf(theta);
+		colCos[c] = cosf(theta);
+	}
+}
+
+// Internal : writes one interleaved vertex (Y axis is the pole axis)
+static inline void sphereSetVertex(float *v, float radius, float sinPhi, float cosPhi, float sinTheta, float cosTheta, float u, float t) {
+	// Code
+	float x = cosTheta * sinPhi;
+	float y = cosPhi;
+	float z = -sinTheta * sinPhi;
+
+	v[SPHERE_POSITION_OFFSET + 0] = radius * x;
+	v[SPHERE_POSITION_OFFSET + 1] = radius * y;
+	v[SPHERE_POSITION_OFFSET + 2] = radius * z;
+	v[SPHERE_NORMAL_OFFSET + 0] = x;
+	v[SPHERE_NORMAL_OFFSET + 1] = y;
+	v[SPHERE_NORMAL_OFFSET + 2] = z;
+	v[SPHERE_TEXCOORD_OFFSET + 0] = u;
+	v[SPHERE_TEXCOORD_OFFSET + 1] = t;
+}
+
+// Generates sphere of 'slices' x 'stacks' into caller owned buffers.
+// 'vertices' must hold getSphereVertexCount() * SPHERE_VERTEX_STRIDE floats and
+// 'elements' must hold getSphereElementCount() indices of 'indexSize' bytes.
+// 'baseVertex' is added to every index (used while packing several meshes in one buffer).
+// Returns number of elements written (0 on invalid arguments).
+unsigned int generateSphere(float radius, unsigned int slices, unsigned int stacks, float *vertices, void *elements, unsigned int indexSize, unsigned int baseVertex) {
+	// Variable declaration
+	float colSin[SPHERE_MAX_SLICES + 1], colCos[SPHERE_MAX_SLICES + 1];
+	unsigned int columns = slices + 1;
+	unsigned int numElements = 0;
+
+	// Code
+	if(getSphereVertexCount(slices, stacks) == 0 || vertices == NULL || elements == NULL)
+		return 0;
+	if(indexSize != sizeof(unsigned short) && indexSize != sizeof(unsigned int))
+		return 0;
+	if(indexSize == sizeof(unsigned short) && baseVertex + getSphereVertexCount(slices, stacks) > 65536)
+		return 0;
+
+	sphereColumnTable(columns, slices, colSin, colCos);
+
+	// Vertices : one ring at a time, ring trig evaluated once
+	for(unsigned int r = 0; r <= stacks; r++) {
+		float phi = (float)M_PI * (float)r / (float)stacks;
+		float sinPhi = (r == 0 || r == stacks) ? 0.0f : sinf(phi);
+		float cosPhi = (r == 0) ? 1.0f : ((r == stacks) ? -1.0f : cosf(phi));
+		float t = 1.0f - ((float)r / (float)stacks);
+
+		for(unsigned int c = 0; c < columns; c++) {
+			float u = (float)c / (float)slices;
+			if(r == 0 || r == stacks)	// Pole vertex sits in the middle of its column
+				u += 0.5f / (float)slices;
+			sphereSetVertex(&vertices[((r * columns) + c) * SPHERE_VERTEX_STRIDE], radius, sinPhi, cosPhi, colSin[c], colCos[c], u, t);
+		}
+	}
+
+	// Elements : two counter clockwise triangles per quad, pole quads give one
+	for(unsigned int r = 0; r < stacks; r++) {
+		for(unsigned int c = 0; c < slices; c++) {
+			unsigned int a = baseVertex + (r * columns) + c;
+			unsigned int b = a + columns;
+			unsigned int d = a + 1;
+			unsigned int e = b + 1;
+
+			if(r != stacks - 1) {
+				sphereSetIndex(elements, indexSize, numElements++, a);
+				sphereSetIndex(elements, indexSize, numElements++, b);
+				sphereSetIndex(elements, indexSize, numElements++, e);
+			}
+			if(r != 0) {
+				sphereSetIndex(elements, indexSize, numElements++, a);
+				sphereSetIndex(elements, indexSize, numElements++, e);
+				sphereSetIndex(elements, indexSize, numElements++, d);
+			}
+		}
+	}
+	return numElements;
+}
+//=============================================================================
+
+// Fills layout (counts and offsets) of LOD chain. Every level halves slices and stacks
+// of previous one. Caller allocates chain->numVertices * SPHERE_VERTEX_STRIDE floats
+// and chain->numElements * chain->indexSize bytes, then calls generateSphereLODChain().
+// Returns number of levels (0 on invalid arguments).
+unsigned int makeSphereLODChain(SphereLODChain *chain, unsigned int slices, unsigned int stacks, unsigned int numLevels) {
+	// Code
+	if(chain == NULL || getSphereVertexCount(slices, stacks) == 0)
+		return 0;
+	if(numLevels > SPHERE_MAX_LOD)
+		numLevels = SPHERE_MAX_LOD;
+
+	memset(chain, 0, sizeof(SphereLODChain));
+	for(unsigned int i = 0; i < numLevels; i++) {
+		SphereLOD *lod = &chain->level[i];
+
+		lod->slices = slices;
+		lod->stacks = stacks;
+		lod->baseVertex = chain->numVertices;
+		lod->numVertices = getSphereVertexCount(slices, stacks);
+		lod->firstElement = chain->numElements;
+		lod->numElements = getSphereElementCount(slices, stacks);
+		chain->numVertices += lod->numVertices;
+		chain->numElements += lod->numElements;
+		chain->numLevels++;
+
+		if(slices / 2 < SPHERE_MIN_LOD_SLICES || stacks / 2 < SPHERE_MIN_LOD_STACKS)
+			break;
+		slices /= 2;
+		stacks /= 2;
+	}
+	chain->indexSize = getSphereIndexSize(chain->numVertices);
+	return chain->numLevels;
+}
+
+// Generates all levels of chain into caller owned buffers
+unsigned int generateSphereLODChain(const SphereLODChain *chain, float radius, float *vertices, void *elements) {
+	// Code
+	if(chain == NULL || vertices == NULL || elements == NULL)
+		return 0;
+
+	for(unsigned int i = 0; i < chain->numLevels; i++) {
+		const SphereLOD *lod = &chain->level[i];
+		void *levelElements = (char *)elements + ((size_t)lod->firstElement * chain->indexSize);
+
+		if(generateSphere(radius, lod->slices, lod->stacks, &vertices[(size_t)lod->baseVertex * SPHERE_VERTEX_STRIDE], levelElements, chain->indexSize, lod->baseVertex) != lod->numElements)
+			return 0;
+	}
+	return chain->numLevels;
+}
+
+// Selects level of chain for a sphere covering 'projectedRadius' pixels on screen.
+// Keeps roughly 'pixelsPerEdge' pixels between silhouette vertices.
+unsigned int selectSphereLOD(const SphereLODChain *chain, float projectedRadius, float pixelsPerEdge) {
+	// Variable declaration
+	float neededSlices;
+	unsigned int level = 0;
+
+	// Code
+	if(chain == NULL || chain->numLevels == 0)
+		return 0;
+	if(pixelsPerEdge <= 0.0f)
+		pixelsPerEdge = 4.0f;
+
+	neededSlices = (2.0f * (float)M_PI * projectedRadius) / pixelsPerEdge;
+	while(level + 1 < chain->numLevels && (float)chain->level[level + 1].slices >= neededSlices)
+		level++;
+	return level;
+}
+
+// Radius (in pixels) of sphere of 'radius' at 'distance' from eye, for perspective of
+// vertical field of view 'fovY' (in degrees) over viewport of 'viewportHeight' pixels
+float getSphereProjectedRadius(float radius, float distance, float fovY, float viewportHeight) {
+	// Code
+	if(distance <= radius)
+		return viewportHeight;
+	return (radius * viewportHeight) / (2.0f * distance * tanf(fovY * (float)M_PI / 360.0f));
+}
+//=============================================================================
+
+// Old libSphere.so entry points (20 x 20, radius 0.75, unsigned short elements, shared poles)
+extern "C" unsigned int getNumberOfSphereVertices(void) {
+	// Code
+	return ((SPHERE_LEGACY_STACKS - 1) * SPHERE_LEGACY_SLICES) + 2;
+}
+
+extern "C" unsigned int getNumberOfSphereElements(void) {
+	// Code
+	return SPHERE_LEGACY_SLICES * (SPHERE_LEGACY_STACKS - 1) * 6;
+}
+
+extern "C" void getSphereVertexData(float spherePositionCoords[1146], float sphereNormalCoords[1146], float sphereTexCoords[764], unsigned short sphereElements[2280]) {
+	// Variable declaration
+	const unsigned int slices = SPHERE_LEGACY_SLICES;
+	const unsigned int stacks = SPHERE_LEGACY_STACKS;
+	const unsigned int southPole = getNumberOfSphereVertices() - 1;
+	float colSin[SPHERE_LEGACY_SLICES], colCos[SPHERE_LEGACY_SLICES];
+	float v[SPHERE_VERTEX_STRIDE];
+	unsigned int numElements = 0;
+
+	// Code
+	sphereColumnTable(slices, slices, colSin, colCos);
+
+	// Vertices : north pole, (stacks - 1) rings of 'slices' vertices, south pole
+	for(unsigned int i = 0; i <= southPole; i++) {
+		unsigned int r, c;
+		float sinPhi, cosPhi;
+
+		if(i == 0) {
+			r = 0;
+			c = 0;
+		}
+		else if(i == southPole) {
+			r = stacks;
+			c = 0;
+		}
+		else {
+			r = ((i - 1) / slices) + 1;
+			c = (i - 1) % slices;
+		}
+		sinPhi = (r == 0 || r == stacks) ? 0.0f : sinf((float)M_PI * (float)r / (float)stacks);
+		cosPhi = (r == 0) ? 1.0f : ((r == stacks) ? -1.0f : cosf((float)M_PI * (float)r / (float)stacks));
+
+		sphereSetVertex(v, SPHERE_LEGACY_RADIUS, sinPhi, cosPhi, colSin[c], colCos[c], (float)c / (float)slices, 1.0f - ((float)r / (float)stacks));
+		memcpy(&spherePositionCoords[i * 3], &v[SPHERE_POSITION_OFFSET], 3 * sizeof(float));
+		memcpy(&sphereNormalCoords[i * 3], &v[SPHERE_NORMAL_OFFSET], 3 * sizeof(float));
+		memcpy(&sphereTexCoords[i * 2], &v[SPHERE_TEXCOORD_OFFSET], 2 * sizeof(float));
+	}
+
+	// Elements
+	for(unsigned int c = 0; c < slices; c++) {
+		unsigned int cNext = (c + 1) % slices;
+
+		// North cap
+		sphereElements[numElements++] = 0;
+		sphereElements[numElements++] = 1 + c;
+		sphereElements[numElements++] = 1 + cNext;
+
+		// Body
+		for(unsigned int r = 1; r < stacks - 1; r++) {
+			unsigned short a = (unsigned short)(1 + ((r - 1) * slices) + c);
+			unsigned short b = (unsigned short)(a + slices);
+			unsigned short d = (unsigned short)(1 + ((r - 1) * slices) + cNext);
+			unsigned short e = (unsigned short)(d + slices);
+
+			sphereElements[numElements++] = a;
+			sphereElements[numElements++] = b;
+			sphereElements[numElements++] = e;
+			sphereElements[numElements++] = a;
+			sphereElements[numElements++] = e;
+			sphereElements[numElements++] = d;
+		}
+
+		// South cap
+		sphereElements[numElements++] = (unsigned short)(1 + ((stacks - 2) * slices) + c);
+		sphereElements[numElements++] = (unsigned short)southPole;
+		sphereElements[numElements++] = (unsigned short)(1 + ((stacks - 2) * slices) + cNext);
+	}
+}
+//=============================================================================
@@ -0,0 +1,168 @@
+// Header file for persistently mapped, triple buffered streaming vertex buffer
+// By : Darshan Vikam
+//
+// One buffer object is created once with glBufferStorage() and stays mapped for its whole life, so
+// per frame uploads are plain memcpy() into it; storage is never re-specified (no orphaning).
+// Buffer is split into STREAM_BUFFER_SEGMENTS segments, one per frame in flight. Every frame takes
+// next segment and hands out space in it with a bump allocator; a fence is placed after the frame's
+// draws, and CPU waits on it only when it comes back to that segment before GPU is done with it.
+// Offsets returned by allocator are used as 'pointer' argument of glVertexAttribPointer().
+// Needs OpenGL 4.4 (or ARB_buffer_storage).
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <string.h>
+#include <GL/glew.h>
+
+#define STREAM_BUFFER_SEGMENTS		3		// Frames in flight
+#define STREAM_BUFFER_ALIGNMENT		16		// Alignment of every allocation (bytes)
+#ifndef STREAM_BUFFER_REPORT_FRAMES
+	#define STREAM_BUFFER_REPORT_FRAMES	256		// Statistics are printed every these many frames, 0 - never
+#endif
+//=============================================================================
+
+typedef struct {
+	GLuint buffer;
+	GLubyte *mapped;				// Persistent pointer to whole buffer
+	GLsizeiptr segmentSize;
+	GLsync fence[STREAM_BUFFER_SEGMENTS];		// Placed after last frame which used the segment
+	unsigned int segment;				// Segment of current frame
+	GLsizeiptr offset;				// Next free byte in current segment
+
+	// Statistics
+	GLsizeiptr frameBytes;				// Bytes streamed in current frame
+	unsigned int frameWaits;			// Fence waits at start of current frame
+	unsigned long long reportBytes, reportWaits;	// Since last report
+	unsigned int reportFrames;
+	bool overflowReported;
+} StreamBuffer;
+//=============================================================================
+
+// Returns false if buffer could not be created; segmentSize is maximum bytes streamed in one frame
+bool streamBufferCreate(StreamBuffer *stream, GLsizeiptr segmentSize) {
+	// Variable declaration
+	GLsizeiptr totalSize;
+
+	// Code
+	memset(stream, 0, sizeof(StreamBuffer));
+	if(glBufferStorage == NULL) {
+		printf("\n ERROR : glBufferStorage() is not supported, streaming buffer needs OpenGL 4.4.");
+		return false;
+	}
+
+	stream->segmentSize = (segmentSize + STREAM_BUFFER_ALIGNMENT - 1) & ~(GLsizeiptr)(STREAM_BUFFER_ALIGNMENT - 1);
+	totalSize = stream->segmentSize * STREAM_BUFFER_SEGMENTS;
+	glGenBuffers(1, &stream->buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+	glBufferStorage(GL_ARRAY_BUFFER, totalSize, NULL, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+	stream->mapped = (GLubyte *)glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if(stream->mapped == NULL) {
+		printf("\n ERROR : Unable to map streaming buffer persistently.");
+		glDeleteBuffers(1, &stream->buffer);
+		stream->buffer = 0;
+		return false;
+	}
+	stream->segment = STREAM_BUFFER_SEGMENTS - 1;		// First streamBufferBeginFrame() moves to segment 0
+	return true;
+}
+
+void streamBufferDestroy(StreamBuffer *stream) {
+	// Code
+	for(int i = 0; i < STREAM_BUFFER_SEGMENTS; i++) {
+		if(stream->fence[i]) {
+			glDeleteSync(stream->fence[i]);
+			stream->fence[i] = NULL;
+		}
+	}
+	if(stream->buffer) {
+		glBindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDeleteBuffers(1, &stream->buffer);
+		stream->buffer = 0;
+	}
+	stream->mapped = NULL;
+}
+
+// Moves to next segment, waiting only if GPU still reads it from STREAM_BUFFER_SEGMENTS frames ago
+void streamBufferBeginFrame(StreamBuffer *stream) {
+	// Variable declaration
+	GLsync fence;
+	GLenum result;
+
+	// Code
+	stream->segment = (stream->segment + 1) % STREAM_BUFFER_SEGMENTS;
+	stream->offset = 0;
+	stream->frameBytes = 0;
+	stream->frameWaits = 0;
+
+	fence = stream->fence[stream->segment];
+	if(fence == NULL)
+		return;
+	result = glClientWaitSync(fence, 0, 0);
+	if(result == GL_TIMEOUT_EXPIRED) {
+		stream->frameWaits++;
+		do {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);	// 1 ms per try
+		} while(result == GL_TIMEOUT_EXPIRED);
+	}
+	glDeleteSync(fence);
+	stream->fence[stream->segment] = NULL;
+}
+
+// Reserves 'size' bytes in current segment; returns offset in buffer (or -1 if segment is full) and CPU pointer in *data
+GLintptr streamBufferAlloc(StreamBuffer *stream, GLsizeiptr size, void **data) {
+	// Variable declaration
+	GLintptr offset;
+
+	// Code
+	if(stream->offset + size > stream->segmentSize) {
+		if(stream->overflowReported == false) {
+			printf("\n ERROR : Streaming buffer segment is full (%ld bytes).", (long)stream->segmentSize);
+			stream->overflowReported = true;
+		}
+		*data = NULL;
+		return -1;
+	}
+	offset = (stream->segment * stream->segmentSize) + stream->offset;
+	stream->offset = (stream->offset + size + STREAM_BUFFER_ALIGNMENT - 1) & ~(GLsizeiptr)(STREAM_BUFFER_ALIGNMENT - 1);
+	stream->frameBytes += size;
+	*data = stream->mapped + offset;
+	return offset;
+}
+
+// Copies 'size' bytes into current segment; returns offset in buffer, -1 if segment is full
+GLintptr streamBufferUpload(StreamBuffer *stream, const void *source, GLsizeiptr size) {
+	// Variable declaration
+	void *data;
+	GLintptr offset;
+
+	// Code
+	offset = streamBufferAlloc(stream, size, &data);
+	if(offset >= 0)
+		memcpy(data, source, size);
+	return offset;
+}
+
+// Call after last draw which uses data of this frame
+void streamBufferEndFrame(StreamBuffer *stream) {
+	// Code
+	stream->fence[stream->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	stream->reportBytes += stream->frameBytes;
+	stream->reportWaits += stream->frameWaits;
+	stream->reportFrames++;
+	if(STREAM_BUFFER_REPORT_FRAMES > 0 && stream->reportFrames == STREAM_BUFFER_REPORT_FRAMES) {
+		printf("\n Streaming buffer : %.1f bytes and %.3f fence waits per frame (%d frames)",
+			(double)stream->reportBytes / stream->reportFrames, (double)stream->reportWaits / stream->reportFrames, stream->reportFrames);
+		fflush(stdout);
+		stream->reportBytes = 0;
+		stream->reportWaits = 0;
+		stream->reportFrames = 0;
+	}
+}
+//=============================================================================
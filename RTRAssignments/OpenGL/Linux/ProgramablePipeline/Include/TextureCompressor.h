@@ -0,0 +1,517 @@
+// Header file for texture compressor : gamma correct mip chain and BC1 / BC3 (DXT1 / DXT5) block encoding
+// By : Darshan Vikam
+//
+// Mip levels are averaged in linear light : texels are converted from sRGB, weighted by alpha
+// (so transparent texels do not darken edges), 2x2 box filtered and converted back to sRGB.
+// Averaging sRGB bytes directly, as glGenerateMipmap() does for GL_RGB8 textures, darkens every level.
+// Blocks are encoded with a bounding box endpoint fit (inset, and diagonal picked by sign of covariance)
+// and projection of texels on endpoint line; bounds and projections use SSE2 when compiled for it.
+// Block rows of all levels are shared among 'numThreads' threads. Result is a TextureFile in memory,
+// ready for textureFileWrite() or for upload. Link with -lpthread.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <SOIL/SOIL.h>
+#include "TextureFile.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+	#define TEXTURE_COMPRESSOR_SSE
+	#include <emmintrin.h>
+	#define TEXTURE_COMPRESSOR_SIMD_NAME	"SSE2"
+#else
+	#define TEXTURE_COMPRESSOR_SIMD_NAME	"Scalar"
+#endif
+
+#define TEXTURE_COMPRESSOR_MAX_THREADS	16
+//=============================================================================
+
+typedef struct {
+	const unsigned char *levelPixels[TEXTURE_FILE_MAX_LEVELS];	// RGBA8 image of every level
+	unsigned char *output;						// Start of file
+	const TextureFileHeader *header;
+	unsigned int numRows;						// Block rows of all levels together
+	int numThreads;
+} TextureCompressJob;
+
+typedef struct {
+	TextureCompressJob *job;
+	int index;
+} TextureCompressThread;
+//=============================================================================
+
+// sRGB <-> linear tables, filled once
+static float gTextureSRGBToLinear[256];
+static unsigned char gTextureLinearToSRGB[4096];
+static pthread_once_t gTextureTablesOnce = PTHREAD_ONCE_INIT;
+
+static void textureCompressorTables(void) {
+	// Variable declaration
+	float c;
+
+	// Code
+	for(int i = 0; i < 256; i++) {
+		c = (float)i / 255.0f;
+		gTextureSRGBToLinear[i] = (c <= 0.04045f) ? (c / 12.92f) : powf((c + 0.055f) / 1.055f, 2.4f);
+	}
+	for(int i = 0; i < 4096; i++) {
+		c = (float)i / 4095.0f;
+		c = (c <= 0.0031308f) ? (c * 12.92f) : ((1.055f * powf(c, 1.0f / 2.4f)) - 0.055f);
+		gTextureLinearToSRGB[i] = (unsigned char)((c * 255.0f) + 0.5f);
+	}
+}
+
+static inline unsigned char textureLinearToSRGB(float c) {
+	// Code
+	if(c <= 0.0f)
+		return 0;
+	if(c >= 1.0f)
+		return 255;
+	return gTextureLinearToSRGB[(int)((c * 4095.0f) + 0.5f)];
+}
+
+// Internal : source texels and weights making destination texel 'x' along an axis of 'size' texels.
+// Even size : 2 taps of 1/2. Odd size : 3 taps, weighted so that every source texel counts equally in level
+// ((n - x) / size, n / size, (x + 1) / size with n = size / 2). Size 1 : the texel itself.
+static inline int textureFilterTaps(unsigned int x, unsigned int size, unsigned int destSize, unsigned int *index, float *weight) {
+	// Code
+	if(size == 1) {
+		index[0] = 0;
+		weight[0] = 1.0f;
+		return 1;
+	}
+	index[0] = x * 2;
+	index[1] = (x * 2) + 1;
+	if((size % 2) == 0) {
+		weight[0] = weight[1] = 0.5f;
+		return 2;
+	}
+	index[2] = (x * 2) + 2;
+	weight[0] = (float)(destSize - x) / (float)size;
+	weight[1] = (float)destSize / (float)size;
+	weight[2] = (float)(x + 1) / (float)size;
+	return 3;
+}
+
+// Internal : box filter in linear light, 2x2 texels or 3 wide / high along an odd axis; 'source' and 'dest' are
+// premultiplied linear RGBA floats
+static void textureDownsample(const float *source, unsigned int width, unsigned int height, float *dest, unsigned int destWidth, unsigned int destHeight) {
+	// Variable declaration
+	unsigned int xIndex[3], yIndex[3];
+	float xWeight[3], yWeight[3];
+	int numX, numY;
+
+	// Code
+	for(unsigned int y = 0; y < destHeight; y++) {
+		numY = textureFilterTaps(y, height, destHeight, yIndex, yWeight);
+		for(unsigned int x = 0; x < destWidth; x++) {
+			float *r = &dest[((y * destWidth) + x) * 4];
+			numX = textureFilterTaps(x, width, destWidth, xIndex, xWeight);
+			r[0] = r[1] = r[2] = r[3] = 0.0f;
+			for(int j = 0; j < numY; j++) {
+				for(int i = 0; i < numX; i++) {
+					const float *t = &source[((yIndex[j] * width) + xIndex[i]) * 4];
+					float w = yWeight[j] * xWeight[i];
+					for(int k = 0; k < 4; k++)
+						r[k] += t[k] * w;
+				}
+			}
+		}
+	}
+}
+
+// Internal : premultiplied linear floats back to straight sRGB bytes
+static void textureToSRGB(const float *source, unsigned int numTexels, unsigned char *dest) {
+	// Code
+	for(unsigned int i = 0; i < numTexels; i++) {
+		float alpha = source[(i * 4) + 3];
+		float scale = (alpha > 0.0f) ? 1.0f / alpha : 0.0f;
+		dest[(i * 4) + 0] = textureLinearToSRGB(source[(i * 4) + 0] * scale);
+		dest[(i * 4) + 1] = textureLinearToSRGB(source[(i * 4) + 1] * scale);
+		dest[(i * 4) + 2] = textureLinearToSRGB(source[(i * 4) + 2] * scale);
+		dest[(i * 4) + 3] = (unsigned char)((alpha * 255.0f) + 0.5f);
+	}
+}
+//=============================================================================
+
+// Internal : per channel minimum and maximum of 16 RGBA texels
+static inline void textureBlockBounds(const unsigned char *block, unsigned char *minColor, unsigned char *maxColor) {
+#if defined(TEXTURE_COMPRESSOR_SSE)
+	// Variable declaration
+	__m128i r0 = _mm_loadu_si128((const __m128i *)&block[0]), r1 = _mm_loadu_si128((const __m128i *)&block[16]);
+	__m128i r2 = _mm_loadu_si128((const __m128i *)&block[32]), r3 = _mm_loadu_si128((const __m128i *)&block[48]);
+	__m128i lo = _mm_min_epu8(_mm_min_epu8(r0, r1), _mm_min_epu8(r2, r3));
+	__m128i hi = _mm_max_epu8(_mm_max_epu8(r0, r1), _mm_max_epu8(r2, r3));
+	int packed;
+
+	// Code
+	lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));	// 4 texels -> 2 -> 1
+	lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+	hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(1, 0, 3, 2)));
+	hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1)));
+	packed = _mm_cvtsi128_si32(lo);
+	memcpy(minColor, &packed, 4);
+	packed = _mm_cvtsi128_si32(hi);
+	memcpy(maxColor, &packed, 4);
+#else
+	// Code
+	memcpy(minColor, block, 4);
+	memcpy(maxColor, block, 4);
+	for(int i = 1; i < 16; i++) {
+		for(int k = 0; k < 4; k++) {
+			if(block[(i * 4) + k] < minColor[k])
+				minColor[k] = block[(i * 4) + k];
+			if(block[(i * 4) + k] > maxColor[k])
+				maxColor[k] = block[(i * 4) + k];
+		}
+	}
+#endif
+}
+
+// Internal : dot product of RGB of each of 16 texels with 'dir' (components within -255..255)
+static inline void textureBlockDots(const unsigned char *block, const int *dir, int *dots) {
+#if defined(TEXTURE_COMPRESSOR_SSE)
+	// Variable declaration
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i axis = _mm_setr_epi16((short)dir[0], (short)dir[1], (short)dir[2], 0, (short)dir[0], (short)dir[1], (short)dir[2], 0);
+	__m128i texels, sums;
+	int result[4];
+
+	// Code
+	for(int i = 0; i < 16; i += 4) {
+		texels = _mm_loadu_si128((const __m128i *)&block[i * 4]);
+		// (r*dr + g*dg, b*db) per texel, then both halves added
+		__m128i a = _mm_madd_epi16(_mm_unpacklo_epi8(texels, zero), axis);
+		__m128i b = _mm_madd_epi16(_mm_unpackhi_epi8(texels, zero), axis);
+		a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+		b = _mm_add_epi32(b, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 3, 0, 1)));
+		sums = _mm_unpacklo_epi64(_mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 2, 0)), _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 3, 2, 0)));
+		_mm_storeu_si128((__m128i *)result, sums);
+		memcpy(&dots[i], result, sizeof(result));
+	}
+#else
+	// Code
+	for(int i = 0; i < 16; i++)
+		dots[i] = (block[(i * 4) + 0] * dir[0]) + (block[(i * 4) + 1] * dir[1]) + (block[(i * 4) + 2] * dir[2]);
+#endif
+}
+
+static inline unsigned short textureColorTo565(const int *color) {
+	// Code
+	return (unsigned short)(((((color[0] * 31) + 127) / 255) << 11) | ((((color[1] * 63) + 127) / 255) << 5) | (((color[2] * 31) + 127) / 255));
+}
+
+static inline void textureColorFrom565(unsigned short packed, int *color) {
+	// Variable declaration
+	int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+
+	// Code
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+// Internal : 8 byte BC1 color block of 16 RGBA texels, always in 4 color mode (as BC3 expects)
+static void textureEncodeColorBlock(const unsigned char *block, unsigned char *output) {
+	// Variable declaration
+	static const unsigned int order[4] = { 0, 2, 3, 1 };	// Position on line c0 -> c1 to index
+	unsigned char minColor[4], maxColor[4];
+	int c0[3], c1[3], p0[3], p1[3], dir[3], dots[16];
+	int mean[3] = { 0, 0, 0 }, covRG = 0, covRB = 0;
+	unsigned short e0, e1, swap;
+	unsigned int indices = 0;
+	int inset, length, start, position, temp;
+
+	// Code
+	textureBlockBounds(block, minColor, maxColor);
+	for(int k = 0; k < 3; k++) {
+		inset = (maxColor[k] - minColor[k]) >> 4;	// Pull box in by 1/16, endpoints are rarely extremes
+		c0[k] = maxColor[k] - inset;
+		c1[k] = minColor[k] + inset;
+	}
+
+	// Box diagonal : green and blue run against red when they are negatively correlated with it
+	for(int i = 0; i < 16; i++)
+		for(int k = 0; k < 3; k++)
+			mean[k] += block[(i * 4) + k];
+	for(int i = 0; i < 16; i++) {
+		int r = (block[(i * 4) + 0] * 16) - mean[0];
+		covRG += r * ((block[(i * 4) + 1] * 16) - mean[1]);
+		covRB += r * ((block[(i * 4) + 2] * 16) - mean[2]);
+	}
+	if(covRG < 0) {
+		temp = c0[1]; c0[1] = c1[1]; c1[1] = temp;
+	}
+	if(covRB < 0) {
+		temp = c0[2]; c0[2] = c1[2]; c1[2] = temp;
+	}
+
+	e0 = textureColorTo565(c0);
+	e1 = textureColorTo565(c1);
+	if(e0 < e1) {				// c0 > c1 selects 4 color mode
+		swap = e0; e0 = e1; e1 = swap;
+	}
+	if(e0 != e1) {
+		textureColorFrom565(e0, p0);
+		textureColorFrom565(e1, p1);
+		for(int k = 0; k < 3; k++)
+			dir[k] = p1[k] - p0[k];
+		length = (dir[0] * dir[0]) + (dir[1] * dir[1]) + (dir[2] * dir[2]);
+		start = (p0[0] * dir[0]) + (p0[1] * dir[1]) + (p0[2] * dir[2]);
+		textureBlockDots(block, dir, dots);
+		for(int i = 15; i >= 0; i--) {		// Texel 0 ends in lowest bits
+			position = (((dots[i] - start) * 6) + length) / (length * 2);	// Rounded (dot - start) * 3 / length
+			position = (dots[i] < start) ? 0 : ((position > 3) ? 3 : position);
+			indices = (indices << 2) | order[position];
+		}
+	}
+	output[0] = (unsigned char)(e0 & 0xFF);
+	output[1] = (unsigned char)(e0 >> 8);
+	output[2] = (unsigned char)(e1 & 0xFF);
+	output[3] = (unsigned char)(e1 >> 8);
+	memcpy(&output[4], &indices, 4);
+}
+
+// Internal : 8 byte BC3 alpha block of 16 RGBA texels, in 8 value mode
+static void textureEncodeAlphaBlock(const unsigned char *block, unsigned char *output) {
+	// Variable declaration
+	unsigned char minColor[4], maxColor[4];
+	int a0, a1, range, position;
+	uint64_t indices = 0;
+
+	// Code
+	textureBlockBounds(block, minColor, maxColor);
+	a0 = maxColor[3];
+	a1 = minColor[3];
+	range = a0 - a1;
+	if(range > 0) {
+		for(int i = 15; i >= 0; i--) {
+			position = ((((a0 - block[(i * 4) + 3]) * 14) + range) / (range * 2));	// Rounded, 0 = a0 .. 7 = a1
+			position = (position == 0) ? 0 : ((position == 7) ? 1 : position + 1);
+			indices = (indices << 3) | (uint64_t)position;
+		}
+	}
+	output[0] = (unsigned char)a0;
+	output[1] = (unsigned char)a1;
+	for(int i = 0; i < 6; i++)
+		output[2 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+// Internal : encodes block row 'row' of level 'levelIndex'
+static void textureEncodeRow(TextureCompressJob *job, unsigned int levelIndex, unsigned int row) {
+	// Variable declaration
+	const TextureFileLevel *level = &job->header->level[levelIndex];
+	const unsigned char *pixels = job->levelPixels[levelIndex];
+	unsigned int blocksWide = (level->width + 3) / 4;
+	unsigned int blockSize = (job->header->format == TEXTURE_FORMAT_BC1) ? 8 : 16;
+	unsigned char *output = job->output + level->offset + ((size_t)row * blocksWide * blockSize);
+	unsigned char block[64];
+
+	// Code
+	for(unsigned int bx = 0; bx < blocksWide; bx++) {
+		for(unsigned int y = 0; y < 4; y++) {	// Texels outside a small or odd level repeat last row / column
+			unsigned int sy = (row * 4) + y < level->height ? (row * 4) + y : level->height - 1;
+			for(unsigned int x = 0; x < 4; x++) {
+				unsigned int sx = (bx * 4) + x < level->width ? (bx * 4) + x : level->width - 1;
+				memcpy(&block[((y * 4) + x) * 4], &pixels[(((size_t)sy * level->width) + sx) * 4], 4);
+			}
+		}
+		if(job->header->format == TEXTURE_FORMAT_BC3) {
+			textureEncodeAlphaBlock(block, output);
+			textureEncodeColorBlock(block, output + 8);
+		}
+		else
+			textureEncodeColorBlock(block, output);
+		output += blockSize;
+	}
+}
+
+static void *textureCompressWorker(void *param) {
+	// Variable declaration
+	TextureCompressThread *thread = (TextureCompressThread *)param;
+	TextureCompressJob *job = thread->job;
+	unsigned int levelIndex = 0, levelStart = 0, levelRows;
+
+	// Code
+	for(unsigned int row = (unsigned int)thread->index; row < job->numRows; row += job->numThreads) {	// Interleaved rows balance levels
+		levelRows = (job->header->level[levelIndex].height + 3) / 4;
+		while(row >= levelStart + levelRows) {
+			levelStart += levelRows;
+			levelIndex++;
+			levelRows = (job->header->level[levelIndex].height + 3) / 4;
+		}
+		textureEncodeRow(job, levelIndex, row - levelStart);
+	}
+	return NULL;
+}
+//=============================================================================
+
+// Builds full mip chain of 'rgba' (straight alpha, sRGB) and encodes it; TEXTURE_FORMAT_AUTO picks BC1 or BC3.
+// 'numThreads' <= 0 uses every CPU. Free result with textureFileUnload().
+bool textureCompress(const unsigned char *rgba, unsigned int width, unsigned int height, TextureFormat format, int numThreads, TextureFile *file) {
+	// Variable declaration
+	TextureFileHeader header;
+	TextureCompressJob job;
+	TextureCompressThread threadParam[TEXTURE_COMPRESSOR_MAX_THREADS];
+	pthread_t thread[TEXTURE_COMPRESSOR_MAX_THREADS];
+	float *linear = NULL, *next = NULL, *swap;
+	unsigned char *output = NULL, *scratch = NULL, *levelPixels;
+	size_t offset, scratchSize = 0, numTexels = (size_t)width * height;
+	unsigned int w, h;
+	int numStarted = 0;
+
+	// Code
+	memset(file, 0, sizeof(TextureFile));
+	if(width == 0 || height == 0 || width > 32768 || height > 32768) {
+		printf("\n ERROR : Texture compressor : invalid image size %u x %u.", width, height);
+		return false;
+	}
+	pthread_once(&gTextureTablesOnce, textureCompressorTables);
+
+	if(format == TEXTURE_FORMAT_AUTO) {
+		format = TEXTURE_FORMAT_BC1;
+		for(size_t i = 0; i < numTexels && format == TEXTURE_FORMAT_BC1; i++)
+			if(rgba[(i * 4) + 3] != 255)
+				format = TEXTURE_FORMAT_BC3;
+	}
+
+	// Layout
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TEXTURE_FILE_MAGIC, 4);
+	header.version = TEXTURE_FILE_VERSION;
+	header.format = format;
+	header.width = width;
+	header.height = height;
+	offset = (sizeof(TextureFileHeader) + TEXTURE_FILE_ALIGNMENT - 1) & ~(size_t)(TEXTURE_FILE_ALIGNMENT - 1);
+	w = width;
+	h = height;
+	while(true) {
+		TextureFileLevel *level = &header.level[header.numLevels++];
+		level->width = w;
+		level->height = h;
+		level->offset = (unsigned int)offset;
+		level->size = (unsigned int)textureLevelSize(format, w, h);
+		offset = (offset + level->size + TEXTURE_FILE_ALIGNMENT - 1) & ~(size_t)(TEXTURE_FILE_ALIGNMENT - 1);
+		if(header.numLevels > 1)
+			scratchSize += (size_t)w * h * 4;
+		if(w == 1 && h == 1)
+			break;
+		w = (w > 1) ? w / 2 : 1;
+		h = (h > 1) ? h / 2 : 1;
+	}
+	header.fileSize = (unsigned int)offset;
+
+	output = (unsigned char *)calloc(1, header.fileSize);
+	linear = (float *)malloc(numTexels * 4 * sizeof(float));
+	next = (float *)malloc(((size_t)header.level[1 % header.numLevels].width * header.level[1 % header.numLevels].height * 4 + 4) * sizeof(float));
+	if(format != TEXTURE_FORMAT_RGBA8)
+		scratch = (unsigned char *)malloc(scratchSize + 4);
+	if(output == NULL || linear == NULL || next == NULL || (format != TEXTURE_FORMAT_RGBA8 && scratch == NULL)) {
+		printf("\n ERROR : Texture compressor : unable to allocate memory for %u x %u image.", width, height);
+		free(output); free(linear); free(next); free(scratch);
+		return false;
+	}
+	memcpy(output, &header, sizeof(header));
+
+	// Mip chain : level 0 is source itself, every other level is filtered in linear light from the one before
+	memset(&job, 0, sizeof(job));
+	job.output = output;
+	job.header = (const TextureFileHeader *)output;
+	job.levelPixels[0] = rgba;
+	for(size_t i = 0; i < numTexels; i++) {
+		float alpha = rgba[(i * 4) + 3] / 255.0f;
+		linear[(i * 4) + 0] = gTextureSRGBToLinear[rgba[(i * 4) + 0]] * alpha;
+		linear[(i * 4) + 1] = gTextureSRGBToLinear[rgba[(i * 4) + 1]] * alpha;
+		linear[(i * 4) + 2] = gTextureSRGBToLinear[rgba[(i * 4) + 2]] * alpha;
+		linear[(i * 4) + 3] = alpha;
+	}
+	levelPixels = scratch;
+	for(unsigned int i = 1; i < header.numLevels; i++) {
+		const TextureFileLevel *source = &header.level[i - 1], *level = &header.level[i];
+		textureDownsample(linear, source->width, source->height, next, level->width, level->height);
+		swap = linear; linear = next; next = swap;	// 'linear' now holds level i, and is big enough for level i + 1
+		if(format == TEXTURE_FORMAT_RGBA8)
+			textureToSRGB(linear, level->width * level->height, output + level->offset);
+		else {
+			textureToSRGB(linear, level->width * level->height, levelPixels);
+			job.levelPixels[i] = levelPixels;
+			levelPixels += (size_t)level->width * level->height * 4;
+		}
+	}
+	free(linear);
+	free(next);
+
+	// Encoding
+	if(format == TEXTURE_FORMAT_RGBA8)
+		memcpy(output + header.level[0].offset, rgba, header.level[0].size);
+	else {
+		for(unsigned int i = 0; i < header.numLevels; i++)
+			job.numRows += (header.level[i].height + 3) / 4;
+		if(numThreads <= 0)
+			numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		if(numThreads > TEXTURE_COMPRESSOR_MAX_THREADS)
+			numThreads = TEXTURE_COMPRESSOR_MAX_THREADS;
+		if(numThreads > (int)job.numRows)
+			numThreads = (int)job.numRows;
+		if(numThreads < 1)
+			numThreads = 1;
+		job.numThreads = numThreads;
+
+		for(int t = 1; t < numThreads; t++) {	// Calling thread is thread 0
+			threadParam[t].job = &job;
+			threadParam[t].index = t;
+			if(pthread_create(&thread[t], NULL, textureCompressWorker, &threadParam[t]) != 0)
+				break;
+			numStarted++;
+		}
+		if(numStarted != numThreads - 1) {	// Rows of threads which did not start are left to calling thread
+			for(int t = 0; t < numStarted; t++)
+				pthread_join(thread[t + 1], NULL);
+			numStarted = 0;
+			job.numThreads = 1;
+		}
+		threadParam[0].job = &job;
+		threadParam[0].index = 0;
+		textureCompressWorker(&threadParam[0]);
+		for(int t = 0; t < numStarted; t++)
+			pthread_join(thread[t + 1], NULL);
+		free(scratch);
+	}
+
+	file->memory = output;
+	file->header = (const TextureFileHeader *)output;
+	file->data = output;
+	return true;
+}
+
+// Loads image with SOIL and compresses it; result carries stamp of image so loader can notice an edited source
+bool textureCompressImage(const char *imagePath, TextureFormat format, int numThreads, TextureFile *file) {
+	// Variable declaration
+	unsigned char *pixels = NULL;
+	int width = 0, height = 0;
+	struct stat imageStat;
+	bool result;
+
+	// Code
+	memset(file, 0, sizeof(TextureFile));
+	pixels = SOIL_load_image(imagePath, &width, &height, NULL, SOIL_LOAD_RGBA);
+	if(pixels == NULL)
+		return false;
+	result = textureCompress(pixels, (unsigned int)width, (unsigned int)height, format, numThreads, file);
+	SOIL_free_image_data(pixels);
+	if(result == true && stat(imagePath, &imageStat) == 0) {
+		TextureFileHeader *header = (TextureFileHeader *)file->memory;
+		header->sourceSize = (int64_t)imageStat.st_size;
+		header->sourceTime = (int64_t)imageStat.st_mtime;
+	}
+	return result;
+}
+//=============================================================================
@@ -0,0 +1,218 @@
+// Header file for compressed texture container (.dvtx) and its memory mapped loader
+// By : Darshan Vikam
+//
+// File layout (little endian) :
+//	TextureFileHeader	- format, size of level 0, source stamp and offset / size of every level
+//	level data		- numLevels blocks, largest first, each at TEXTURE_FILE_ALIGNMENT
+// Every level is ready to be given to glCompressedTexImage2D() (BC1 / BC3) or glTexImage2D() (RGBA8)
+// as it is, so a loaded texture needs neither decoding nor glGenerateMipmap().
+// Source stamp (size and modification time of image it was made from) lets loader notice an edited image.
+// Files are written by TextureCompressor.h, offline by TextureConverter or by TextureLoader on first run.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <GL/glew.h>
+
+#define TEXTURE_FILE_MAGIC		"DVTX"
+#define TEXTURE_FILE_VERSION		1
+#define TEXTURE_FILE_EXTENSION		".dvtx"		// Replaces extension of source image
+#define TEXTURE_FILE_ALIGNMENT		16
+#define TEXTURE_FILE_MAX_LEVELS		16		// Up to 32768 x 32768
+//=============================================================================
+
+typedef enum {
+	TEXTURE_FORMAT_RGBA8 = 0,		// 4 bytes per texel, for drivers without S3TC
+	TEXTURE_FORMAT_BC1,			// DXT1, 8 bytes per 4x4 block, opaque images
+	TEXTURE_FORMAT_BC3,			// DXT5, 16 bytes per 4x4 block, images with alpha
+	TEXTURE_FORMAT_AUTO			// Compressor only : BC1 if image is opaque, else BC3
+} TextureFormat;
+
+typedef struct {
+	unsigned int width, height;
+	unsigned int offset;			// From start of file
+	unsigned int size;			// Bytes
+} TextureFileLevel;
+
+typedef struct {
+	char magic[4];				// TEXTURE_FILE_MAGIC
+	unsigned int version;			// TEXTURE_FILE_VERSION
+	unsigned int fileSize;			// Total size, for truncation check
+	unsigned int format;			// TextureFormat
+	unsigned int width, height;		// Of level 0
+	unsigned int numLevels;			// Full chain, down to 1 x 1
+	unsigned int reserved;
+	int64_t sourceSize, sourceTime;		// Stamp of source image (st_size, st_mtime), 0 if unknown
+	TextureFileLevel level[TEXTURE_FILE_MAX_LEVELS];
+} TextureFileHeader;
+
+// Loaded texture; header and levels point either into mapping or into memory
+typedef struct {
+	const TextureFileHeader *header;
+	const unsigned char *data;		// Start of file, add level offset
+	void *mapping;
+	size_t mappingSize;
+	void *memory;				// Made by compressor, not yet (or never) written
+} TextureFile;
+//=============================================================================
+
+static inline const char *textureFormatName(unsigned int format) {
+	// Variable declaration
+	static const char *names[] = { "RGBA8", "BC1", "BC3", "AUTO" };
+
+	// Code
+	return (format <= TEXTURE_FORMAT_AUTO) ? names[format] : "UNKNOWN";
+}
+
+// Internal format for glCompressedTexImage2D(), or GL_RGBA8 for glTexImage2D()
+static inline GLenum textureFormatGL(unsigned int format) {
+	// Code
+	switch(format) {
+		case TEXTURE_FORMAT_BC1 :
+			return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case TEXTURE_FORMAT_BC3 :
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		default :
+			return GL_RGBA8;
+	}
+}
+
+// Bytes of one level of given size
+static inline size_t textureLevelSize(unsigned int format, unsigned int width, unsigned int height) {
+	// Code
+	if(format == TEXTURE_FORMAT_RGBA8)
+		return (size_t)width * height * 4;
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * ((format == TEXTURE_FORMAT_BC1) ? 8 : 16);
+}
+
+// Cache path of an image : "stone.png" -> "stone.dvtx"
+void textureFilePath(const char *imagePath, char *path, size_t size) {
+	// Variable declaration
+	const char *dot = strrchr(imagePath, '.');
+	const char *slash = strrchr(imagePath, '/');
+	size_t length = strlen(imagePath);
+
+	// Code
+	if(dot != NULL && (slash == NULL || dot > slash))
+		length = (size_t)(dot - imagePath);
+	snprintf(path, size, "%.*s%s", (int)length, imagePath, TEXTURE_FILE_EXTENSION);
+}
+
+// Internal : checks header against 'size' bytes it was read from. Levels must follow header and each other in
+// order, each at next TEXTURE_FILE_ALIGNMENT, up to end of file; loader uploads them as one block from level 0.
+static bool textureFileValid(const TextureFileHeader *header, size_t size) {
+	// Variable declaration
+	unsigned int width, height;
+	size_t offset = (sizeof(TextureFileHeader) + TEXTURE_FILE_ALIGNMENT - 1) & ~(size_t)(TEXTURE_FILE_ALIGNMENT - 1);
+
+	// Code
+	if(size < sizeof(TextureFileHeader) || memcmp(header->magic, TEXTURE_FILE_MAGIC, 4) != 0 || header->version != TEXTURE_FILE_VERSION ||
+		header->fileSize != size || header->format >= TEXTURE_FORMAT_AUTO || header->numLevels == 0 || header->numLevels > TEXTURE_FILE_MAX_LEVELS)
+		return false;
+
+	width = header->width;
+	height = header->height;
+	for(unsigned int i = 0; i < header->numLevels; i++) {
+		const TextureFileLevel *level = &header->level[i];
+		if(level->width != width || level->height != height || level->size != textureLevelSize(header->format, width, height) ||
+			level->offset != offset || (size_t)level->offset + level->size > size)
+			return false;
+		offset = (offset + level->size + TEXTURE_FILE_ALIGNMENT - 1) & ~(size_t)(TEXTURE_FILE_ALIGNMENT - 1);
+		width = (width > 1) ? width / 2 : 1;
+		height = (height > 1) ? height / 2 : 1;
+	}
+	return (offset == size);
+}
+
+// Maps 'path' read only and validates it. Returns false, without message, if there is no such file.
+bool textureFileLoad(const char *path, TextureFile *file) {
+	// Variable declaration
+	int fd;
+	struct stat fileStat;
+
+	// Code
+	memset(file, 0, sizeof(TextureFile));
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return false;
+	if(fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(TextureFileHeader)) {
+		printf("\n ERROR : Texture file %s is too small.", path);
+		close(fd);
+		return false;
+	}
+
+	file->mappingSize = (size_t)fileStat.st_size;
+	file->mapping = mmap(NULL, file->mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);		// Mapping stays valid after close
+	if(file->mapping == MAP_FAILED) {
+		printf("\n ERROR : Unable to map texture file %s.", path);
+		file->mapping = NULL;
+		return false;
+	}
+	madvise(file->mapping, file->mappingSize, MADV_WILLNEED);	// Page in whole file at once
+
+	if(textureFileValid((const TextureFileHeader *)file->mapping, file->mappingSize) == false) {
+		printf("\n ERROR : Texture file %s is invalid or of other version.", path);
+		munmap(file->mapping, file->mappingSize);
+		memset(file, 0, sizeof(TextureFile));
+		return false;
+	}
+
+	file->header = (const TextureFileHeader *)file->mapping;
+	file->data = (const unsigned char *)file->mapping;
+	return true;
+}
+
+void textureFileUnload(TextureFile *file) {
+	// Code
+	if(file->mapping)
+		munmap(file->mapping, file->mappingSize);
+	free(file->memory);
+	memset(file, 0, sizeof(TextureFile));
+}
+
+// True if file was made from image at 'imagePath' as it is now; also true if image is not there (only cache is shipped)
+bool textureFileCurrent(const TextureFile *file, const char *imagePath) {
+	// Variable declaration
+	struct stat imageStat;
+
+	// Code
+	if(stat(imagePath, &imageStat) != 0)
+		return true;
+	return (file->header->sourceSize == (int64_t)imageStat.st_size && file->header->sourceTime == (int64_t)imageStat.st_mtime);
+}
+
+// Writes texture made by compressor; written aside and renamed, so a reader never maps a half written file
+bool textureFileWrite(const char *path, const TextureFile *file) {
+	// Variable declaration
+	char tempPath[512];
+	FILE *fp = NULL;
+	bool written = false;
+
+	// Code
+	snprintf(tempPath, sizeof(tempPath), "%s.%d.tmp", path, (int)getpid());
+	fp = fopen(tempPath, "wb");
+	if(fp == NULL) {
+		printf("\n ERROR : Unable to create texture file %s.", path);
+		return false;
+	}
+	written = (fwrite(file->data, 1, file->header->fileSize, fp) == file->header->fileSize);
+	written = (fclose(fp) == 0) && written;
+	if(written == false || rename(tempPath, path) != 0) {
+		printf("\n ERROR : Unable to write texture file %s.", path);
+		remove(tempPath);
+		return false;
+	}
+	return true;
+}
+//=============================================================================
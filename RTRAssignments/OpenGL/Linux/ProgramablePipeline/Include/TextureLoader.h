@@ -0,0 +1,376 @@
+// Header file for asynchronous texture loading : images are decoded on worker threads and uploaded through pixel buffer ring
+// By : Darshan Vikam
+//
+// textureLoaderRequest() only queues an image and sets sample's texture to a 1x1 grey placeholder, so
+// Initialize() returns and first frame is drawn without waiting for any image. Worker threads map
+// compressed texture file of image ("stone.png" -> "stone.dvtx", see TextureFile.h) with its whole mip
+// chain. When there is none, or image is newer, they decode image with SOIL, compress it (BC1 / BC3 with
+// gamma correct mip levels, see TextureCompressor.h) and write file for next start. Without S3TC in
+// driver, an RGBA8 chain is made in memory instead and nothing is written.
+// textureLoaderUpdate(), called once per frame on rendering thread, copies all levels of a texture into next
+// pixel unpack buffer of a ring of TEXTURE_LOADER_PBO_COUNT, uploads from it and then swaps sample's
+// texture name from placeholder to real texture. A ring buffer is written again only after fence of its
+// previous upload has passed, so mapping never stalls; at most TEXTURE_LOADER_FRAME_BYTES are uploaded per frame.
+// Needs OpenGL 3.2 for buffer ring (fence sync), else uploads straight from file. Link with -lSOIL -lpthread.
+// Sample's texture names belong to loader, textureLoaderUninitialize() deletes them and sets them to 0.
+//	textureLoaderInitialize(&loader);			// After glewInit()
+//	textureLoaderRequest(&loader, "stone.png", &Stone_texture);
+//	... every frame : textureLoaderUpdate(&loader); display(); ...
+//	textureLoaderUninitialize(&loader);			// In Uninitialize(), context still current
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <GL/glew.h>
+#include "TextureFile.h"
+#include "TextureCompressor.h"
+
+#define TEXTURE_LOADER_MAX_TEXTURES	16
+#define TEXTURE_LOADER_MAX_THREADS	4
+#define TEXTURE_LOADER_PBO_COUNT	3
+#ifndef TEXTURE_LOADER_FRAME_BYTES
+	#define TEXTURE_LOADER_FRAME_BYTES	(8 * 1024 * 1024)	// Upload budget per frame, at least one texture goes anyway
+#endif
+//=============================================================================
+
+typedef enum {
+	TEXTURE_QUEUED = 0,
+	TEXTURE_DECODED,			// file is ready for upload
+	TEXTURE_RESIDENT,
+	TEXTURE_FAILED				// Placeholder stays
+} TextureState;
+
+typedef struct {
+	char path[256];
+	GLuint *texture;			// Sample's texture name
+	GLuint real;				// 0 until resident
+	TextureFile file;			// Mapped from disk or made by compressor
+	bool cached;				// file came from disk
+	TextureState state;
+	bool failureReported;
+} TextureRequest;
+
+typedef struct {
+	TextureRequest request[TEXTURE_LOADER_MAX_TEXTURES];
+	int numRequests, nextDecode;		// Guarded by mutex, like state and file of requests
+
+	pthread_t thread[TEXTURE_LOADER_MAX_THREADS];
+	int numThreads;
+	int compressThreads;			// Threads of each compression, CPUs are shared with other workers
+	pthread_mutex_t mutex;
+	pthread_cond_t queueCond;
+	bool quit;
+
+	GLuint placeholder;
+	bool compressed;			// Driver has S3TC, BC1 / BC3 files can be used
+	bool useBuffers;			// Upload through pixel buffer ring
+	GLuint pbo[TEXTURE_LOADER_PBO_COUNT];
+	GLsizeiptr pboSize[TEXTURE_LOADER_PBO_COUNT];
+	GLsync fence[TEXTURE_LOADER_PBO_COUNT];	// Last upload from each buffer
+	int nextBuffer;
+
+	// Statistics
+	int resident, failed, cacheHits;
+	size_t textureBytes, uncompressedBytes;	// Resident mip chains, and same as RGBA8
+	double startTime, firstFrameTime;
+	bool reported;
+} TextureLoader;
+//=============================================================================
+
+static inline double textureLoaderClock(void) {
+	// Variable declaration
+	struct timespec now;
+
+	// Code
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1000000000.0);
+}
+
+// Internal : maps or makes texture file of one request (SOIL keeps only a failure string globally, decoding itself is reentrant)
+static void textureLoaderDecode(TextureLoader *loader, TextureRequest *request) {
+	// Variable declaration
+	TextureFile file;
+	char cachePath[512];
+	bool cached, loaded;
+
+	// Code
+	textureFilePath(request->path, cachePath, sizeof(cachePath));
+	cached = textureFileLoad(cachePath, &file);
+	if(cached == true && (textureFileCurrent(&file, request->path) == false ||
+		(loader->compressed == false && file.header->format != TEXTURE_FORMAT_RGBA8))) {
+		textureFileUnload(&file);
+		cached = false;
+	}
+
+	loaded = cached;
+	if(cached == false) {
+		loaded = textureCompressImage(request->path, (loader->compressed == true) ? TEXTURE_FORMAT_AUTO : TEXTURE_FORMAT_RGBA8,
+			loader->compressThreads, &file);
+		if(loaded == true && loader->compressed == true)
+			textureFileWrite(cachePath, &file);	// Failure only costs compression next time
+	}
+
+	pthread_mutex_lock(&loader->mutex);
+	request->file = file;
+	request->cached = cached;
+	request->state = (loaded == true) ? TEXTURE_DECODED : TEXTURE_FAILED;
+	pthread_mutex_unlock(&loader->mutex);
+}
+
+static void *textureLoaderWorker(void *param) {
+	// Variable declaration
+	TextureLoader *loader = (TextureLoader *)param;
+	TextureRequest *request;
+
+	// Code
+	pthread_mutex_lock(&loader->mutex);
+	while(true) {
+		while(loader->quit == false && loader->nextDecode == loader->numRequests)
+			pthread_cond_wait(&loader->queueCond, &loader->mutex);
+		if(loader->quit == true)
+			break;
+		request = &loader->request[loader->nextDecode++];
+		pthread_mutex_unlock(&loader->mutex);
+		textureLoaderDecode(loader, request);
+		pthread_mutex_lock(&loader->mutex);
+	}
+	pthread_mutex_unlock(&loader->mutex);
+	return NULL;
+}
+
+// Call after glewInit(); creates placeholder, buffer ring and decoding threads
+void textureLoaderInitialize(TextureLoader *loader) {
+	// Variable declaration
+	const GLubyte grey[4] = { 128, 128, 128, 255 };
+	long numCPU;
+
+	// Code
+	memset(loader, 0, sizeof(TextureLoader));
+	loader->startTime = textureLoaderClock();
+
+	glGenTextures(1, &loader->placeholder);
+	glBindTexture(GL_TEXTURE_2D, loader->placeholder);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	loader->compressed = (GLEW_EXT_texture_compression_s3tc == GL_TRUE);
+	loader->useBuffers = (glFenceSync != NULL && glMapBufferRange != NULL);
+	if(loader->useBuffers == true)
+		glGenBuffers(TEXTURE_LOADER_PBO_COUNT, loader->pbo);
+
+	pthread_mutex_init(&loader->mutex, NULL);
+	pthread_cond_init(&loader->queueCond, NULL);
+	numCPU = sysconf(_SC_NPROCESSORS_ONLN);
+	for(long t = 0; t < TEXTURE_LOADER_MAX_THREADS && t < numCPU; t++) {
+		if(pthread_create(&loader->thread[t], NULL, textureLoaderWorker, loader) != 0)
+			break;
+		loader->numThreads++;
+	}
+	if(loader->numThreads == 0)
+		printf("\n Unable to create texture decoding thread, textures are decoded on request.");
+	loader->compressThreads = (int)(numCPU / ((loader->numThreads > 0) ? loader->numThreads : 1));
+	if(loader->compressThreads < 1)
+		loader->compressThreads = 1;
+}
+
+// Queues image at 'path'; *texture is placeholder now and real texture once it is resident. False if queue is full.
+bool textureLoaderRequest(TextureLoader *loader, const char *path, GLuint *texture) {
+	// Variable declaration
+	TextureRequest *request;
+
+	// Code
+	*texture = loader->placeholder;
+	pthread_mutex_lock(&loader->mutex);
+	if(loader->numRequests == TEXTURE_LOADER_MAX_TEXTURES) {
+		pthread_mutex_unlock(&loader->mutex);
+		printf("\n ERROR : Texture loader is full (%d textures), '%s' is not loaded.", TEXTURE_LOADER_MAX_TEXTURES, path);
+		return false;
+	}
+	request = &loader->request[loader->numRequests];
+	memset(request, 0, sizeof(TextureRequest));
+	strncpy(request->path, path, sizeof(request->path) - 1);
+	request->texture = texture;
+	request->state = TEXTURE_QUEUED;
+	loader->numRequests++;
+	if(loader->numThreads > 0)
+		pthread_cond_signal(&loader->queueCond);
+	else
+		loader->nextDecode++;
+	pthread_mutex_unlock(&loader->mutex);
+
+	if(loader->numThreads == 0)
+		textureLoaderDecode(loader, request);
+	return true;
+}
+
+// Internal : bytes of all levels of a decoded request, stored one after other from level 0
+static inline GLsizeiptr textureLoaderSize(const TextureRequest *request) {
+	// Code
+	return (GLsizeiptr)(request->file.header->fileSize - request->file.header->level[0].offset);
+}
+
+// Internal : creates texture of a decoded request; false if ring buffer is still in use by GPU (try next frame)
+static bool textureLoaderUpload(TextureLoader *loader, TextureRequest *request) {
+	// Variable declaration
+	const TextureFileHeader *header = request->file.header;
+	const unsigned char *levels = request->file.data + header->level[0].offset;
+	GLsizeiptr size = textureLoaderSize(request);
+	const unsigned char *source = levels;
+	GLenum internalFormat = textureFormatGL(header->format);
+	int slot = loader->nextBuffer;
+	void *mapped = NULL;
+
+	// Code
+	if(loader->useBuffers == true) {
+		if(loader->fence[slot] != 0) {
+			if(glClientWaitSync(loader->fence[slot], 0, 0) == GL_TIMEOUT_EXPIRED)
+				return false;
+			glDeleteSync(loader->fence[slot]);
+			loader->fence[slot] = 0;
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, loader->pbo[slot]);
+		if(loader->pboSize[slot] < size) {
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+			loader->pboSize[slot] = size;
+		}
+		// Fence has passed, so no synchronization is needed for mapping
+		mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if(mapped != NULL) {
+			memcpy(mapped, levels, size);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			source = NULL;			// Offset 0 in bound buffer
+		}
+		else
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	glGenTextures(1, &request->real);
+	glBindTexture(GL_TEXTURE_2D, request->real);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header->numLevels - 1);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	for(unsigned int i = 0; i < header->numLevels; i++) {	// Precomputed chain, no glGenerateMipmap()
+		const TextureFileLevel *level = &header->level[i];
+		const unsigned char *data = source + (level->offset - header->level[0].offset);	// Offset in buffer when source is NULL
+		if(header->format == TEXTURE_FORMAT_RGBA8)
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level->width, level->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		else
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level->width, level->height, 0, level->size, data);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	if(mapped != NULL) {
+		loader->fence[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		loader->nextBuffer = (slot + 1) % TEXTURE_LOADER_PBO_COUNT;
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	return true;
+}
+
+// Call once per frame before drawing; uploads decoded images within frame budget. True when nothing is pending.
+bool textureLoaderUpdate(TextureLoader *loader) {
+	// Variable declaration
+	TextureRequest *request;
+	GLsizeiptr uploaded = 0;
+	bool pending = false;
+
+	// Code
+	if(loader->firstFrameTime == 0.0)
+		loader->firstFrameTime = textureLoaderClock();
+
+	for(int i = 0; i < loader->numRequests; i++) {
+		request = &loader->request[i];
+		pthread_mutex_lock(&loader->mutex);
+		TextureState state = request->state;
+		pthread_mutex_unlock(&loader->mutex);
+
+		if(state == TEXTURE_QUEUED) {
+			pending = true;
+			continue;
+		}
+		if(state == TEXTURE_FAILED && request->failureReported == false) {
+			printf("\n ERROR : Unable to load texture '%s', placeholder is used.", request->path);
+			request->failureReported = true;
+			loader->failed++;
+		}
+		if(state != TEXTURE_DECODED)
+			continue;
+		if((uploaded > 0 && uploaded + textureLoaderSize(request) > TEXTURE_LOADER_FRAME_BYTES) ||
+			textureLoaderUpload(loader, request) == false) {
+			pending = true;
+			continue;
+		}
+		uploaded += textureLoaderSize(request);
+		loader->textureBytes += (size_t)textureLoaderSize(request);
+		for(unsigned int l = 0; l < request->file.header->numLevels; l++)
+			loader->uncompressedBytes += (size_t)request->file.header->level[l].width * request->file.header->level[l].height * 4;
+		if(request->cached == true)
+			loader->cacheHits++;
+		textureFileUnload(&request->file);
+		request->state = TEXTURE_RESIDENT;	// Workers do not touch decoded requests, no lock needed
+		*request->texture = request->real;
+		loader->resident++;
+	}
+
+	if(pending == false && loader->reported == false && loader->numRequests > 0) {
+		printf("\n Texture loader : %d textures resident %.1f ms after start (first frame at %.1f ms), %d failed, %d decoding threads",
+			loader->resident, (textureLoaderClock() - loader->startTime) * 1000.0, (loader->firstFrameTime - loader->startTime) * 1000.0,
+			loader->failed, loader->numThreads);
+		printf("\n Texture loader : %d of %d from texture files, %zu KB of mip chains in video memory (%zu KB as RGBA8)%s",
+			loader->cacheHits, loader->resident, loader->textureBytes / 1024, loader->uncompressedBytes / 1024,
+			(loader->compressed == true) ? "" : ", no S3TC in driver");
+		fflush(stdout);
+		loader->reported = true;
+	}
+	return (pending == false);
+}
+
+// Stops workers and deletes every texture, buffer and placeholder; sample's texture names become 0
+void textureLoaderUninitialize(TextureLoader *loader) {
+	// Code
+	if(loader->placeholder == 0)		// Never initialized (Uninitialize() after an early failure)
+		return;
+	pthread_mutex_lock(&loader->mutex);
+	loader->quit = true;
+	pthread_cond_broadcast(&loader->queueCond);
+	pthread_mutex_unlock(&loader->mutex);
+	for(int t = 0; t < loader->numThreads; t++)
+		pthread_join(loader->thread[t], NULL);
+	loader->numThreads = 0;
+	pthread_mutex_destroy(&loader->mutex);
+	pthread_cond_destroy(&loader->queueCond);
+
+	for(int i = 0; i < loader->numRequests; i++) {
+		TextureRequest *request = &loader->request[i];
+		textureFileUnload(&request->file);
+		if(request->real)
+			glDeleteTextures(1, &request->real);
+		*request->texture = 0;
+		memset(request, 0, sizeof(TextureRequest));
+	}
+	loader->numRequests = loader->nextDecode = 0;
+
+	for(int i = 0; i < TEXTURE_LOADER_PBO_COUNT; i++) {
+		if(loader->fence[i] != 0)
+			glDeleteSync(loader->fence[i]);
+		loader->fence[i] = 0;
+	}
+	if(loader->useBuffers == true)
+		glDeleteBuffers(TEXTURE_LOADER_PBO_COUNT, loader->pbo);
+	memset(loader->pbo, 0, sizeof(loader->pbo));
+	if(loader->placeholder) {
+		glDeleteTextures(1, &loader->placeholder);
+		loader->placeholder = 0;
+	}
+}
+//=============================================================================
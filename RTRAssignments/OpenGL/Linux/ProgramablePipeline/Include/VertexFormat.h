@@ -0,0 +1,311 @@
+// Header file for quantized (compressed) vertex formats
+// By : Darshan Vikam
+//
+// Encodes interleaved float vertices into smaller interleaved vertices :
+//	position	- float x3 (12 bytes)	-> normalized short x4 (8 bytes), decoded with per-mesh scale & bias
+//	normal		- float x3 (12 bytes)	-> octahedral normalized short x2 or GL_INT_2_10_10_10_REV (4 bytes)
+//	texcoord	- float x2 (8 bytes)	-> half float x2 (4 bytes)
+//	color		- float x3 (12 bytes)	-> normalized unsigned byte x4 (4 bytes)
+// Every attribute starts at 4 byte boundary. Attributes of *_FLOAT format are copied as they are.
+//=============================================================================
+
+#pragma once
+
+// Header files
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <GL/glew.h>
+//=============================================================================
+
+// Attribute formats
+enum {
+	VF_NONE = 0,		// Attribute not present
+	VF_FLOAT,		// Same as source
+	VF_SNORM16,		// Position : x, y, z, 1 as normalized shorts (needs vfDecodePosition() in shader)
+	VF_OCTAHEDRAL16,	// Normal : 2 normalized shorts (needs vfDecodeOctahedral() in shader)
+	VF_INT_2_10_10_10,	// Normal : GL_INT_2_10_10_10_REV, decoded by vertex fetch
+	VF_HALF,		// Texcoord : GL_HALF_FLOAT, decoded by vertex fetch
+	VF_UNORM8,		// Color : normalized unsigned bytes, decoded by vertex fetch
+};
+
+// Layout of float source vertices; offsets are in floats, -1 if attribute is not present
+typedef struct {
+	unsigned int stride;		// floats per vertex
+	int positionOffset, normalOffset, texcoordOffset, colorOffset;
+} VertexSource;
+
+// Layout of encoded vertices; offsets are in bytes
+typedef struct {
+	int positionFormat, normalFormat, texcoordFormat, colorFormat;
+	unsigned int stride;
+	unsigned int positionOffset, normalOffset, texcoordOffset, colorOffset;
+	float positionScale[3], positionBias[3];	// position = encoded * scale + bias
+} VertexFormat;
+
+// GLSL decode functions; to be placed right after '#version' line of vertex shader
+#define VERTEX_FORMAT_GLSL_DECODE \
+	"uniform vec3 u_PositionScale, u_PositionBias;" \
+	"vec4 vfDecodePosition(vec4 p) {" \
+		"return vec4((p.xyz * u_PositionScale) + u_PositionBias, 1.0);" \
+	"}" \
+	"vec3 vfDecodeOctahedral(vec2 e) {" \
+		"vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));" \
+		"float t = max(-n.z, 0.0);" \
+		"n.x += (n.x >= 0.0) ? -t : t;" \
+		"n.y += (n.y >= 0.0) ? -t : t;" \
+		"return normalize(n);" \
+	"}"
+//=============================================================================
+
+// Internal : size (in bytes) of attribute in given format
+static unsigned int vfAttributeSize(int format, unsigned int floatComponents) {
+	// Code
+	switch(format) {
+		case VF_FLOAT :
+			return floatComponents * sizeof(float);
+		case VF_SNORM16 :
+			return 4 * sizeof(short);
+		case VF_OCTAHEDRAL16 :
+			return 2 * sizeof(short);
+		case VF_INT_2_10_10_10 :
+		case VF_UNORM8 :
+			return 4;
+		case VF_HALF :
+			return 2 * sizeof(unsigned short);
+		default :
+			return 0;
+	}
+}
+
+// Computes offsets and stride of encoded vertex. Returns stride in bytes.
+unsigned int makeVertexFormat(VertexFormat *format, const VertexSource *source, int positionFormat, int normalFormat, int texcoordFormat, int colorFormat) {
+	// Code
+	memset(format, 0, sizeof(VertexFormat));
+	format->positionFormat = (source->positionOffset >= 0) ? positionFormat : VF_NONE;
+	format->normalFormat = (source->normalOffset >= 0) ? normalFormat : VF_NONE;
+	format->texcoordFormat = (source->texcoordOffset >= 0) ? texcoordFormat : VF_NONE;
+	format->colorFormat = (source->colorOffset >= 0) ? colorFormat : VF_NONE;
+
+	format->positionOffset = format->stride;
+	format->stride += vfAttributeSize(format->positionFormat, 3);
+	format->normalOffset = format->stride;
+	format->stride += vfAttributeSize(format->normalFormat, 3);
+	format->texcoordOffset = format->stride;
+	format->stride += vfAttributeSize(format->texcoordFormat, 2);
+	format->colorOffset = format->stride;
+	format->stride += vfAttributeSize(format->colorFormat, 3);
+
+	for(int k = 0; k < 3; k++) {
+		format->positionScale[k] = 1.0f;
+		format->positionBias[k] = 0.0f;
+	}
+	return format->stride;
+}
+
+// Internal : float to normalized short/byte with rounding
+static inline short vfFloatToSnorm16(float f) {
+	// Code
+	f = fminf(fmaxf(f, -1.0f), 1.0f);
+	return (short)lrintf(f * 32767.0f);
+}
+
+static inline int vfFloatToSnorm10(float f) {
+	// Code
+	f = fminf(fmaxf(f, -1.0f), 1.0f);
+	return (int)lrintf(f * 511.0f);
+}
+
+static inline unsigned char vfFloatToUnorm8(float f) {
+	// Code
+	f = fminf(fmaxf(f, 0.0f), 1.0f);
+	return (unsigned char)lrintf(f * 255.0f);
+}
+
+// Internal : float to IEEE half float (round to nearest even), for texcoords
+static unsigned short vfFloatToHalf(float f) {
+	// Variable declaration
+	unsigned int bits, sign, mantissa;
+	int exponent;
+
+	// Code
+	memcpy(&bits, &f, sizeof(bits));
+	sign = (bits >> 16) & 0x8000;
+	exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+	mantissa = bits & 0x007fffff;
+
+	if(((bits >> 23) & 0xff) == 0xff)			// Inf / NaN
+		return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+	if(exponent >= 31)					// Overflow
+		return (unsigned short)(sign | 0x7c00);
+	if(exponent <= 0) {					// Denormal or zero
+		if(exponent < -10)
+			return (unsigned short)sign;
+		mantissa |= 0x00800000;
+		unsigned int shift = (unsigned int)(14 - exponent);
+		unsigned int half = mantissa >> shift;
+		unsigned int rest = mantissa & ((1u << shift) - 1);
+		unsigned int midpoint = 1u << (shift - 1);
+		if(rest > midpoint || (rest == midpoint && (half & 1)))
+			half++;
+		return (unsigned short)(sign | half);
+	}
+	unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+	unsigned int rest = mantissa & 0x1fff;
+	if(rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+		half++;							// May carry into exponent, which is correct
+	return (unsigned short)half;
+}
+
+// Internal : unit vector to octahedral coordinates in [-1, 1]
+static void vfOctahedralEncode(const float *n, float *e) {
+	// Variable declaration
+	float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+	float x, y;
+
+	// Code
+	if(l1 == 0.0f) {
+		e[0] = e[1] = 0.0f;
+		return;
+	}
+	x = n[0] / l1;
+	y = n[1] / l1;
+	if(n[2] < 0.0f) {
+		float ox = x;
+		x = (1.0f - fabsf(y)) * ((ox >= 0.0f) ? 1.0f : -1.0f);
+		y = (1.0f - fabsf(ox)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+	}
+	e[0] = x;
+	e[1] = y;
+}
+
+// Encodes 'numVertices' float vertices into 'output' (numVertices * format->stride bytes, 4 byte aligned).
+// Fills position scale and bias of format from bounding box of positions.
+void encodeVertices(VertexFormat *format, const VertexSource *source, const float *vertices, unsigned int numVertices, void *output) {
+	// Variable declaration
+	float minimum[3] = { 1e30f, 1e30f, 1e30f };
+	float maximum[3] = { -1e30f, -1e30f, -1e30f };
+
+	// Code
+	if(format->positionFormat == VF_SNORM16) {
+		for(unsigned int i = 0; i < numVertices; i++) {
+			const float *p = &vertices[(i * source->stride) + source->positionOffset];
+			for(int k = 0; k < 3; k++) {
+				minimum[k] = fminf(minimum[k], p[k]);
+				maximum[k] = fmaxf(maximum[k], p[k]);
+			}
+		}
+		for(int k = 0; k < 3; k++) {
+			format->positionBias[k] = (numVertices != 0) ? (maximum[k] + minimum[k]) * 0.5f : 0.0f;
+			format->positionScale[k] = (numVertices != 0) ? (maximum[k] - minimum[k]) * 0.5f : 1.0f;
+			if(format->positionScale[k] <= 0.0f)
+				format->positionScale[k] = 1.0f;	// Flat along this axis
+		}
+	}
+
+	for(unsigned int i = 0; i < numVertices; i++) {
+		const float *src = &vertices[i * source->stride];
+		char *dst = (char *)output + ((size_t)i * format->stride);
+
+		// Position
+		if(format->positionFormat == VF_FLOAT)
+			memcpy(dst + format->positionOffset, src + source->positionOffset, 3 * sizeof(float));
+		else if(format->positionFormat == VF_SNORM16) {
+			short *p = (short *)(dst + format->positionOffset);
+			for(int k = 0; k < 3; k++)
+				p[k] = vfFloatToSnorm16((src[source->positionOffset + k] - format->positionBias[k]) / format->positionScale[k]);
+			p[3] = 32767;
+		}
+
+		// Normal
+		if(format->normalFormat == VF_FLOAT)
+			memcpy(dst + format->normalOffset, src + source->normalOffset, 3 * sizeof(float));
+		else if(format->normalFormat == VF_OCTAHEDRAL16) {
+			short *n = (short *)(dst + format->normalOffset);
+			float e[2];
+			vfOctahedralEncode(src + source->normalOffset, e);
+			n[0] = vfFloatToSnorm16(e[0]);
+			n[1] = vfFloatToSnorm16(e[1]);
+		}
+		else if(format->normalFormat == VF_INT_2_10_10_10) {
+			const float *n = src + source->normalOffset;
+			unsigned int packed = ((unsigned int)vfFloatToSnorm10(n[0]) & 0x3ff) | (((unsigned int)vfFloatToSnorm10(n[1]) & 0x3ff) << 10) | (((unsigned int)vfFloatToSnorm10(n[2]) & 0x3ff) << 20);
+			memcpy(dst + format->normalOffset, &packed, sizeof(packed));
+		}
+
+		// Texcoord
+		if(format->texcoordFormat == VF_FLOAT)
+			memcpy(dst + format->texcoordOffset, src + source->texcoordOffset, 2 * sizeof(float));
+		else if(format->texcoordFormat == VF_HALF) {
+			unsigned short *t = (unsigned short *)(dst + format->texcoordOffset);
+			t[0] = vfFloatToHalf(src[source->texcoordOffset + 0]);
+			t[1] = vfFloatToHalf(src[source->texcoordOffset + 1]);
+		}
+
+		// Color
+		if(format->colorFormat == VF_FLOAT)
+			memcpy(dst + format->colorOffset, src + source->colorOffset, 3 * sizeof(float));
+		else if(format->colorFormat == VF_UNORM8) {
+			unsigned char *c = (unsigned char *)(dst + format->colorOffset);
+			for(int k = 0; k < 3; k++)
+				c[k] = vfFloatToUnorm8(src[source->colorOffset + k]);
+			c[3] = 255;
+		}
+	}
+}
+
+// Internal : glVertexAttribPointer() of one attribute
+static void vfAttribPointer(GLuint attrib, int format, GLint floatComponents, GLsizei stride, unsigned int offset) {
+	// Code
+	switch(format) {
+		case VF_FLOAT :
+			glVertexAttribPointer(attrib, floatComponents, GL_FLOAT, GL_FALSE, stride, (void *)(size_t)offset);
+			break;
+		case VF_SNORM16 :
+			glVertexAttribPointer(attrib, 4, GL_SHORT, GL_TRUE, stride, (void *)(size_t)offset);
+			break;
+		case VF_OCTAHEDRAL16 :
+			glVertexAttribPointer(attrib, 2, GL_SHORT, GL_TRUE, stride, (void *)(size_t)offset);
+			break;
+		case VF_INT_2_10_10_10 :
+			glVertexAttribPointer(attrib, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void *)(size_t)offset);
+			break;
+		case VF_HALF :
+			glVertexAttribPointer(attrib, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void *)(size_t)offset);
+			break;
+		case VF_UNORM8 :
+			glVertexAttribPointer(attrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void *)(size_t)offset);
+			break;
+		default :
+			return;
+	}
+	glEnableVertexAttribArray(attrib);
+}
+
+// Sets and enables attribute pointers of all present attributes (for currently bound GL_ARRAY_BUFFER)
+void setVertexFormatAttribPointers(const VertexFormat *format, GLuint positionAttrib, GLuint normalAttrib, GLuint texcoordAttrib, GLuint colorAttrib) {
+	// Code
+	vfAttribPointer(positionAttrib, format->positionFormat, 3, format->stride, format->positionOffset);
+	vfAttribPointer(normalAttrib, format->normalFormat, 3, format->stride, format->normalOffset);
+	vfAttribPointer(texcoordAttrib, format->texcoordFormat, 2, format->stride, format->texcoordOffset);
+	vfAttribPointer(colorAttrib, format->colorFormat, 3, format->stride, format->colorOffset);
+}
+
+// Sets u_PositionScale and u_PositionBias of VERTEX_FORMAT_GLSL_DECODE (program must be in use)
+void setVertexFormatUniforms(const VertexFormat *format, GLint scaleUniform, GLint biasUniform) {
+	// Code
+	glUniform3fv(scaleUniform, 1, format->positionScale);
+	glUniform3fv(biasUniform, 1, format->positionBias);
+}
+
+// Prints size of mesh before and after encoding
+void printVertexFormatReport(const char *name, const VertexFormat *format, const VertexSource *source, unsigned int numVertices) {
+	// Variable declaration
+	unsigned int sourceBytes = source->stride * sizeof(float);
+
+	// Code
+	printf("\n %s : %u vertices, %u -> %u bytes per vertex, %u -> %u bytes (%.2fx smaller)", name, numVertices,
+		sourceBytes, format->stride, numVertices * sourceBytes, numVertices * format->stride,
+		(format->stride != 0) ? (float)sourceBytes / (float)format->stride : 0.0f);
+}
+//=============================================================================